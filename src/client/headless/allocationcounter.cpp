@@ -0,0 +1,78 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "client/headless/allocationcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace cqsp::client::headless {
+namespace {
+std::atomic_bool counting = false;
+std::atomic_size_t allocations = 0;
+}  // namespace
+
+bool CountsAllocations() {
+#ifdef CQSP_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void StartCountingAllocations() {
+    allocations = 0;
+    counting = true;
+}
+
+size_t StopCountingAllocations() {
+    counting = false;
+    return allocations;
+}
+
+#ifdef CQSP_COUNT_ALLOCATIONS
+namespace {
+void* CountedAllocate(std::size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Same as the default operator new, keep asking the new handler for memory until there's none
+    while (true) {
+        void* pointer = std::malloc(size == 0 ? 1 : size);
+        if (pointer != nullptr) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+}  // namespace
+#endif
+}  // namespace cqsp::client::headless
+
+#ifdef CQSP_COUNT_ALLOCATIONS
+// The aligned and nothrow versions are left alone, they forward to these or to aligned_alloc/free
+void* operator new(std::size_t size) { return cqsp::client::headless::CountedAllocate(size); }
+void* operator new[](std::size_t size) { return cqsp::client::headless::CountedAllocate(size); }
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+#endif
@@ -0,0 +1,35 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace cqsp::client::headless {
+/// <summary>
+/// Counts calls to the global operator new between the start and stop calls, on every thread.
+/// </summary>
+/// Only one count can be running at a time, and the counting itself is a single relaxed atomic load
+/// when it's turned off.
+///
+/// Replacing operator new affects the whole program, GUI included, so it's only built with the
+/// CQSP_COUNT_ALLOCATIONS CMake option. Without it every count is 0.
+void StartCountingAllocations();
+size_t StopCountingAllocations();
+
+/// If this build replaces operator new to count allocations
+bool CountsAllocations();
+}  // namespace cqsp::client::headless
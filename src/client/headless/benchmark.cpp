@@ -0,0 +1,638 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "client/headless/benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "client/headless/allocationcounter.h"
+#include "core/actions/economy/auctionhandler.h"
+#include "core/components/auction.h"
+#include "core/components/conjunction.h"
+#include "core/components/market.h"
+#include "core/components/orbit.h"
+#include "core/components/orbitbatch.h"
+#include "core/components/resourceexpression.h"
+#include "core/components/resourceledger.h"
+#include "core/components/resourceledgerkernels.h"
+#include "core/components/stardate.h"
+#include "core/game.h"
+#include "core/systems/economy/tradematching.h"
+#include "core/util/threadpool.h"
+
+namespace cqsp::client::headless {
+namespace {
+using core::components::GetLedgerKernels;
+using core::components::IsSimdLevelSupported;
+using core::components::ResourceLedger;
+using core::components::ResourceMap;
+using core::components::ResourceVector;
+using core::components::SimdLevel;
+using core::components::SparseLedger;
+using core::components::ToGoodEntity;
+using core::components::expr::Lazy;
+
+// Runs the function a few times, and returns the fastest run in microseconds
+double TimeMicroseconds(const std::function<void()>& function, int repeats = 5) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < repeats; i++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return best;
+}
+
+// Does the same kind of work as SysMarket::DetermineSupplyDemand over every market, for every instruction set
+int BenchmarkLedger(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    const size_t markets = arguments.empty() ? 500 : std::stoul(arguments[0]);
+    const size_t goods = arguments.size() < 2 ? 256 : std::stoul(arguments[1]);
+    std::cout << "Ledger kernels, " << markets << " markets with " << goods << " goods\n";
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> dist(0, 1000);
+    std::vector<std::vector<double>> supply(markets, std::vector<double>(goods));
+    std::vector<std::vector<double>> demand(markets, std::vector<double>(goods));
+    std::vector<std::vector<double>> result(markets, std::vector<double>(goods));
+    for (size_t m = 0; m < markets; m++) {
+        for (size_t g = 0; g < goods; g++) {
+            supply[m][g] = dist(gen);
+            demand[m][g] = (g % 7 == 0) ? 0 : dist(gen);
+        }
+    }
+
+    std::cout << std::setw(10) << "level" << std::setw(14) << "add (us)" << std::setw(18) << "multiply add (us)"
+              << std::setw(18) << "safe divide (us)" << std::setw(18) << "multiply sum (us)" << std::setw(22)
+              << "interleaved sum (us)" << '\n';
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (!IsSimdLevelSupported(level)) {
+            std::cout << std::setw(10) << ToString(level) << "  not supported\n";
+            continue;
+        }
+        const auto& kernels = GetLedgerKernels(level);
+        double add = TimeMicroseconds([&]() {
+            for (size_t m = 0; m < markets; m++) kernels.add(result[m].data(), supply[m].data(), goods);
+        });
+        double multiply_add = TimeMicroseconds([&]() {
+            for (size_t m = 0; m < markets; m++) kernels.multiply_add(result[m].data(), demand[m].data(), 0.5, goods);
+        });
+        double safe_division = TimeMicroseconds([&]() {
+            for (size_t m = 0; m < markets; m++) {
+                result[m] = supply[m];
+                kernels.safe_division(result[m].data(), demand[m].data(), 1., goods);
+            }
+        });
+        volatile double sink = 0;
+        double multiply_sum = TimeMicroseconds([&]() {
+            for (size_t m = 0; m < markets; m++) {
+                sink = sink + kernels.multiply_sum(supply[m].data(), demand[m].data(), goods);
+            }
+        });
+        double interleaved_sum = TimeMicroseconds([&]() {
+            for (size_t m = 0; m < markets; m++) {
+                sink = sink + kernels.multiply_sum_interleaved(supply[m].data(), demand[m].data(), goods);
+            }
+        });
+        std::cout << std::setw(10) << ToString(level) << std::setw(14) << add << std::setw(18) << multiply_add
+                  << std::setw(18) << safe_division << std::setw(18) << multiply_sum << std::setw(22)
+                  << interleaved_sum << '\n';
+    }
+    std::cout << "ResourceLedger uses " << ToString(GetLedgerKernels().level) << '\n';
+    return 0;
+}
+
+ResourceVector RandomVector(std::mt19937& gen, size_t count, size_t goods) {
+    std::uniform_int_distribution<uint32_t> good_dist(0, static_cast<uint32_t>(goods - 1));
+    std::uniform_real_distribution<> amount_dist(0.1, 100);
+    ResourceVector vector;
+    for (size_t i = 0; i < count; i++) {
+        vector.emplace_back(ToGoodEntity(good_dist(gen)), amount_dist(gen));
+    }
+    // Merging needs unique and sorted goods
+    vector.Finalize();
+    vector.erase(std::unique(vector.begin(), vector.end(),
+                             [](const auto& first, const auto& second) { return first.first == second.first; }),
+                 vector.end());
+    return vector;
+}
+
+void WarnIfNotCountingAllocations() {
+    if (!CountsAllocations()) {
+        std::cout << "Allocations aren't counted in this build, configure with -DCQSP_COUNT_ALLOCATIONS=ON\n";
+    }
+}
+
+// Compares the allocations and time of the production and population math with and without expression templates
+int BenchmarkExpressions(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    const size_t industries = arguments.empty() ? 10000 : std::stoul(arguments[0]);
+    const size_t goods = 256;
+    std::cout << "Resource expressions, " << industries << " industries and population segments\n";
+    WarnIfNotCountingAllocations();
+
+    std::mt19937 gen(42);
+    std::vector<ResourceVector> inputs;
+    std::vector<ResourceVector> capital;
+    std::vector<ResourceMap> consumption(industries);
+    for (size_t i = 0; i < industries; i++) {
+        inputs.push_back(RandomVector(gen, 6, goods));
+        capital.push_back(RandomVector(gen, 3, goods));
+        for (auto& [good, amount] : RandomVector(gen, 20, goods)) {
+            consumption[i][good] = amount;
+        }
+    }
+    // What SysPopulationConsumption does for every segment, with the consumer goods in a map and a sparse ledger
+    ResourceMap autonomous_map;
+    ResourceMap marginal_map;
+    SparseLedger autonomous_sparse;
+    SparseLedger marginal_sparse;
+    for (auto& [good, amount] : RandomVector(gen, 20, goods)) {
+        autonomous_map[good] = amount;
+        marginal_map[good] = amount * 0.1;
+        autonomous_sparse[good] = amount;
+        marginal_sparse[good] = amount * 0.1;
+    }
+    std::vector<ResourceMap> segment_maps(industries);
+    std::vector<SparseLedger> segment_sparse(industries);
+    core::components::Market market(goods);
+    for (size_t g = 0; g < goods; g++) {
+        market.price[ToGoodEntity(static_cast<uint32_t>(g))] = 1 + static_cast<double>(g % 13);
+    }
+
+    auto run = [&](const std::string& name, const std::function<double()>& function) {
+        StartCountingAllocations();
+        auto start = std::chrono::steady_clock::now();
+        double checksum = function();
+        auto end = std::chrono::steady_clock::now();
+        size_t allocations = StopCountingAllocations();
+        std::cout << std::setw(32) << name << std::setw(12) << allocations << " allocations" << std::setw(12)
+                  << std::chrono::duration<double, std::micro>(end - start).count() << " us"
+                  << "  (checksum " << checksum << ")\n";
+    };
+
+    run("production, eager", [&]() {
+        double total = 0;
+        for (size_t i = 0; i < industries; i++) {
+            ResourceVector capital_input = capital[i] * 3.5;
+            ResourceVector input = (inputs[i] * 12.5) + capital_input;
+            total += market.PurchaseFromMarket(input).first;
+        }
+        return total;
+    });
+    run("production, lazy", [&]() {
+        double total = 0;
+        for (size_t i = 0; i < industries; i++) {
+            total += market.PurchaseFromMarket(Lazy(inputs[i]) * 12.5 + Lazy(capital[i]) * 3.5).first;
+        }
+        return total;
+    });
+    run("population cost, eager", [&]() {
+        double total = 0;
+        for (size_t i = 0; i < industries; i++) {
+            total += (consumption[i] * market.price).GetSum();
+        }
+        return total;
+    });
+    run("population cost, lazy", [&]() {
+        double total = 0;
+        for (size_t i = 0; i < industries; i++) {
+            total += (Lazy(consumption[i]) * market.price).GetSum();
+        }
+        return total;
+    });
+    auto segments = [&](auto& segment_consumption, const auto& autonomous, const auto& marginal) {
+        double total = 0;
+        for (size_t i = 0; i < industries; i++) {
+            auto& segment = segment_consumption[i];
+            segment = autonomous;
+            segment *= static_cast<double>(1000 + i);
+            total += (Lazy(segment) * market.price).GetSum();
+            segment += Lazy(marginal) * 2.5;
+            total += market.PurchaseFromMarket(Lazy(segment)).first;
+        }
+        return total;
+    };
+    // Run twice, because the first tick has to grow the containers
+    for (int tick = 0; tick < 2; tick++) {
+        run("population segments, map", [&]() { return segments(segment_maps, autonomous_map, marginal_map); });
+        run("population segments, sparse",
+            [&]() { return segments(segment_sparse, autonomous_sparse, marginal_sparse); });
+    }
+    return 0;
+}
+
+// Matching interplanetary trades by checking every pair of markets, against the per good price index
+int BenchmarkTrade(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    const size_t goods = arguments.empty() ? 64 : std::stoul(arguments[0]);
+    std::cout << "Interplanetary trade matching, " << goods << " goods\n";
+    std::cout << std::setw(10) << "markets" << std::setw(14) << "orders" << std::setw(18) << "every pair (us)"
+              << std::setw(18) << "indexed (us)" << '\n';
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> price_dist(1, 100);
+    std::uniform_real_distribution<> real_dist(-1, 1);
+    for (size_t market_count : {5, 10, 20, 50, 100, 200, 500}) {
+        std::deque<core::components::Market> markets;
+        std::deque<core::components::PlanetaryMarket> planetary_markets;
+        std::vector<core::systems::TradingMarket> trading;
+        for (size_t i = 0; i < market_count; i++) {
+            auto& market = markets.emplace_back(goods);
+            auto& planetary = planetary_markets.emplace_back(goods);
+            for (size_t g = 0; g < goods; g++) {
+                const auto good = ToGoodEntity(static_cast<uint32_t>(g));
+                market.price[good] = price_dist(gen);
+                market.chronic_shortages[good] = std::max(real_dist(gen), 0.);
+                planetary.supply_difference[good] = real_dist(gen);
+            }
+            trading.push_back({static_cast<entt::entity>(i), &market, &planetary});
+        }
+
+        size_t every_pair_orders = 0;
+        double every_pair = TimeMicroseconds([&]() {
+            every_pair_orders = 0;
+            for (size_t seller = 0; seller < market_count; seller++) {
+                for (size_t buyer = 0; buyer < market_count; buyer++) {
+                    if (seller == buyer) {
+                        continue;
+                    }
+                    for (size_t g = 0; g < goods; g++) {
+                        const auto good = ToGoodEntity(static_cast<uint32_t>(g));
+                        if (trading[buyer].planetary_market->supply_difference[good] > 0 &&
+                            trading[buyer].market->price[good] > trading[seller].market->price[good] &&
+                            trading[seller].market->chronic_shortages[good] <= 0) {
+                            every_pair_orders++;
+                        }
+                    }
+                }
+            }
+        });
+        size_t indexed_orders = 0;
+        double indexed = TimeMicroseconds([&]() {
+            indexed_orders = 0;
+            core::systems::MatchArbitrage(trading, goods, std::pmr::get_default_resource(),
+                                          [&](uint32_t, uint32_t, core::components::GoodEntity) { indexed_orders++; });
+        });
+        std::cout << std::setw(10) << market_count << std::setw(14) << indexed_orders << std::setw(18) << every_pair
+                  << std::setw(18) << indexed << '\n';
+        if (indexed_orders != every_pair_orders) {
+            std::cout << "Order count doesn't match: " << every_pair_orders << " vs " << indexed_orders << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Auction house matching with price level books, against keeping every order in one sorted vector
+int BenchmarkAuction(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    using core::components::Order;
+    const size_t goods = 16;
+    const size_t batch = arguments.empty() ? 100 : std::stoul(arguments[0]);
+    std::cout << "Auction house matching, " << goods << " goods, " << batch << " orders per side per good\n";
+    std::cout << std::setw(10) << "orders" << std::setw(14) << "filled" << std::setw(18) << "vector (us)"
+              << std::setw(18) << "price levels (us)" << '\n';
+
+    // Best order at the front, like the books, but every fill shifts the whole vector
+    struct VectorBook {
+        std::vector<Order> sell_orders;
+        std::vector<Order> buy_orders;
+
+        static bool Fill(std::vector<Order>& opposite, std::vector<Order>& own, Order order, bool buying) {
+            while (!opposite.empty() && order.quantity > 0) {
+                Order& first = opposite.front();
+                if (buying ? first.price > order.price : first.price < order.price) {
+                    break;
+                }
+                if (first.quantity > order.quantity) {
+                    first.quantity -= order.quantity;
+                    return true;
+                }
+                order.quantity -= first.quantity;
+                opposite.erase(opposite.begin());
+            }
+            if (order.quantity <= 0) {
+                return true;
+            }
+            auto better = [buying](const Order& a, const Order& b) {
+                return buying ? a.price > b.price : a.price < b.price;
+            };
+            own.insert(std::upper_bound(own.begin(), own.end(), order, better), order);
+            return false;
+        }
+    };
+
+    std::mt19937 gen(42);
+    // Buyers and sellers overlap a little, so the books fill up over time
+    std::uniform_int_distribution<int> buy_price(900, 1020);
+    std::uniform_int_distribution<int> sell_price(980, 1100);
+    std::uniform_int_distribution<int> quantity_dist(1, 100);
+    for (size_t order_count : {10000, 100000, 1000000}) {
+        const size_t ticks = order_count / (goods * batch * 2);
+        std::vector<Order> orders;
+        orders.reserve(ticks * goods * batch * 2);
+        for (size_t i = 0; i < ticks * goods; i++) {
+            for (size_t j = 0; j < batch; j++) {
+                orders.emplace_back(sell_price(gen) / 10., quantity_dist(gen), entt::null);
+            }
+            for (size_t j = 0; j < batch; j++) {
+                orders.emplace_back(buy_price(gen) / 10., quantity_dist(gen), entt::null);
+            }
+        }
+
+        size_t vector_filled = 0;
+        double vector_time = TimeMicroseconds(
+            [&]() {
+                std::vector<VectorBook> books(goods);
+                vector_filled = 0;
+                for (size_t i = 0; i < orders.size(); i++) {
+                    VectorBook& book = books[(i / (batch * 2)) % goods];
+                    if ((i / batch) % 2 == 0) {
+                        vector_filled += VectorBook::Fill(book.buy_orders, book.sell_orders, orders[i], false);
+                    } else {
+                        vector_filled += VectorBook::Fill(book.sell_orders, book.buy_orders, orders[i], true);
+                    }
+                }
+            },
+            1);
+
+        size_t book_filled = 0;
+        double book_time = TimeMicroseconds(
+            [&]() {
+                core::components::AuctionHouse auction_house;
+                book_filled = 0;
+                std::span<const Order> all(orders);
+                for (size_t i = 0; i < orders.size(); i += batch * 2) {
+                    const auto good = static_cast<entt::entity>((i / (batch * 2)) % goods);
+                    book_filled += core::actions::SellGoods(auction_house, good, all.subspan(i, batch));
+                    book_filled += core::actions::BuyGoods(auction_house, good, all.subspan(i + batch, batch));
+                }
+            },
+            1);
+
+        std::cout << std::setw(10) << orders.size() << std::setw(14) << book_filled << std::setw(18) << vector_time
+                  << std::setw(18) << book_time << '\n';
+        if (book_filled != vector_filled) {
+            std::cout << "Filled order count doesn't match: " << vector_filled << " vs " << book_filled << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Propagating satellites one at a time like SysOrbit used to, against propagating them as one batch
+int BenchmarkOrbits(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    namespace types = core::components::types;
+    const double time = 3600;
+    const double future_time = time + core::components::StarDate::TIME_INCREMENT;
+    std::cout << "Orbit propagation\n";
+    std::cout << std::setw(10) << "orbits" << std::setw(18) << "one by one (us)" << std::setw(18) << "batched (us)"
+              << std::setw(18) << "max error (km)" << '\n';
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> e_dist(0, 0.9);
+    std::uniform_real_distribution<> a_dist(6800, 50000);
+    std::uniform_real_distribution<> angle_dist(0, types::TWOPI);
+    for (size_t orbit_count : {1000, 10000, 50000}) {
+        std::vector<types::Orbit> orbits;
+        for (size_t i = 0; i < orbit_count; i++) {
+            types::Orbit orbit(a_dist(gen), e_dist(gen), angle_dist(gen) / 2, angle_dist(gen), angle_dist(gen),
+                               angle_dist(gen));
+            orbit.GM = 398600;
+            orbits.push_back(orbit);
+        }
+
+        std::vector<types::Kinematics> kinematics(orbit_count);
+        std::vector<types::FuturePosition> future(orbit_count);
+        double one_by_one = TimeMicroseconds([&]() {
+            for (size_t i = 0; i < orbit_count; i++) {
+                types::UpdateOrbit(orbits[i], time);
+                kinematics[i].position = types::toVec3(orbits[i]);
+                kinematics[i].velocity = types::OrbitVelocityToVec3(orbits[i], orbits[i].v);
+                future[i].position = types::OrbitTimeToVec3(orbits[i], future_time);
+            }
+        });
+
+        types::OrbitBatch batch;
+        double batched = TimeMicroseconds([&]() {
+            batch.clear();
+            for (const types::Orbit& orbit : orbits) {
+                batch.push_back(orbit);
+            }
+            types::PropagateOrbits(batch, time, future_time);
+        });
+
+        double max_error = 0;
+        for (size_t i = 0; i < orbit_count; i++) {
+            max_error = std::max(max_error, glm::length(kinematics[i].position - batch.position[i]));
+            max_error = std::max(max_error, glm::length(future[i].position - batch.future_position[i]));
+        }
+        std::cout << std::setw(10) << orbit_count << std::setw(18) << one_by_one << std::setw(18) << batched
+                  << std::setw(18) << max_error << '\n';
+    }
+    return 0;
+}
+
+// Time and accuracy of the Newton and fast Kepler solvers, over a sweep of eccentricities
+int BenchmarkKepler(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    namespace types = core::components::types;
+    const int samples = 20000;
+    std::cout << "Kepler's equation, " << samples << " mean anomalies per eccentricity\n";
+    std::cout << std::setw(10) << "e" << std::setw(16) << "newton (ns)" << std::setw(16) << "fast (ns)"
+              << std::setw(18) << "newton residual" << std::setw(18) << "fast residual" << '\n';
+
+    auto sweep = [&](double e, bool hyperbolic) {
+        std::vector<double> mean_anomalies(samples);
+        for (int i = 0; i < samples; i++) {
+            // Elliptic orbits go around once, hyperbolic ones go from 1e-6 to 1e6
+            mean_anomalies[i] = hyperbolic ? std::pow(10.0, 12.0 * i / samples - 6) : types::TWOPI * i / samples;
+        }
+        std::vector<double> newton(samples);
+        std::vector<double> fast(samples);
+        double newton_time = TimeMicroseconds([&]() {
+            for (int i = 0; i < samples; i++) {
+                newton[i] = hyperbolic ? types::SolveKeplerHyperbolic(mean_anomalies[i], e)
+                                       : types::SolveKeplerElliptic(mean_anomalies[i], e);
+            }
+        });
+        double fast_time = TimeMicroseconds([&]() {
+            for (int i = 0; i < samples; i++) {
+                fast[i] = hyperbolic ? types::SolveKeplerHyperbolicFast(mean_anomalies[i], e)
+                                     : types::SolveKeplerEllipticFast(mean_anomalies[i], e);
+            }
+        });
+
+        // How far each answer is from solving the equation, relative to the mean anomaly
+        auto residual = [&](double anomaly, double M) {
+            const double solved = hyperbolic ? e * std::sinh(anomaly) - anomaly : anomaly - e * std::sin(anomaly);
+            return std::abs(solved - M) / std::max(1.0, std::abs(M));
+        };
+        double newton_residual = 0;
+        double fast_residual = 0;
+        for (int i = 0; i < samples; i++) {
+            newton_residual = std::max(newton_residual, residual(newton[i], mean_anomalies[i]));
+            fast_residual = std::max(fast_residual, residual(fast[i], mean_anomalies[i]));
+        }
+        std::cout << std::setw(10) << e << std::setw(16) << newton_time * 1000 / samples << std::setw(16)
+                  << fast_time * 1000 / samples << std::setw(18) << newton_residual << std::setw(18) << fast_residual
+                  << '\n';
+    };
+    for (double e : {0.0, 0.1, 0.5, 0.9, 0.99, 0.999}) {
+        sweep(e, false);
+    }
+    for (double e : {1.01, 1.5, 2.0, 5.0, 10.0}) {
+        sweep(e, true);
+    }
+    return 0;
+}
+
+// Screens satellites around a planet and its moon for close approaches, and compares it to checking every pair
+int BenchmarkConjunctions(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    namespace types = core::components::types;
+    const double miss_distance = arguments.empty() ? 10 : std::stod(arguments[0]);
+    std::cout << "Conjunction screening, " << miss_distance << " km miss distance\n";
+    std::cout << std::setw(10) << "objects" << std::setw(18) << "every pair (us)" << std::setw(18) << "hashed (us)"
+              << std::setw(18) << "threaded (us)" << std::setw(12) << "pairs" << '\n';
+
+    auto& pool = application.GetGame().GetGame().GetThreadPool();
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> radius_dist(6800, 8000);
+    std::uniform_real_distribution<> moon_radius_dist(1800, 5000);
+    std::uniform_real_distribution<> unit_dist(-1, 1);
+    for (size_t object_count : {10000, 50000, 100000}) {
+        // Mostly low orbit around the planet, with a tenth around the moon
+        std::vector<glm::dvec3> positions(object_count);
+        std::vector<uint32_t> groups(object_count);
+        for (size_t i = 0; i < object_count; i++) {
+            glm::dvec3 direction;
+            do {
+                direction = glm::dvec3(unit_dist(gen), unit_dist(gen), unit_dist(gen));
+            } while (glm::length(direction) > 1 || glm::length(direction) < 1e-3);
+            groups[i] = (i % 10 == 0) ? 1 : 0;
+            positions[i] = glm::normalize(direction) * (groups[i] == 0 ? radius_dist(gen) : moon_radius_dist(gen));
+        }
+
+        // Checking every pair takes far too long past this
+        double every_pair = -1;
+        if (object_count <= 10000) {
+            volatile size_t sink = 0;
+            every_pair = TimeMicroseconds(
+                [&]() {
+                    size_t pairs = 0;
+                    for (size_t i = 0; i < object_count; i++) {
+                        for (size_t j = i + 1; j < object_count; j++) {
+                            pairs += (groups[i] == groups[j] &&
+                                      glm::length(positions[i] - positions[j]) <= miss_distance);
+                        }
+                    }
+                    sink = pairs;
+                },
+                1);
+        }
+
+        types::ConjunctionScreen screen;
+        std::vector<types::CloseApproach> approaches;
+        double hashed = TimeMicroseconds([&]() { screen.Screen(positions, groups, miss_distance, approaches); });
+        double threaded =
+            TimeMicroseconds([&]() { screen.Screen(positions, groups, miss_distance, approaches, &pool); });
+        std::cout << std::setw(10) << object_count << std::setw(18);
+        if (every_pair < 0) {
+            std::cout << "-";
+        } else {
+            std::cout << every_pair;
+        }
+        std::cout << std::setw(18) << hashed << std::setw(18) << threaded << std::setw(12) << approaches.size()
+                  << '\n';
+    }
+    return 0;
+}
+
+// Allocations and time for each tick of the universe that was made with @generate
+int BenchmarkTick(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    if (!application.HasSimulation()) {
+        std::cout << "Generate a universe with @generate first\n";
+        return 1;
+    }
+    const int ticks = arguments.empty() ? 10 : std::stoi(arguments[0]);
+    WarnIfNotCountingAllocations();
+    size_t total_allocations = 0;
+    double total_time = 0;
+    for (int i = 0; i < ticks; i++) {
+        StartCountingAllocations();
+        auto start = std::chrono::steady_clock::now();
+        application.GetSimulation().tick();
+        auto end = std::chrono::steady_clock::now();
+        size_t allocations = StopCountingAllocations();
+        double time = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << "Tick " << i << ": " << allocations << " allocations, " << time << " ms\n";
+        total_allocations += allocations;
+        total_time += time;
+    }
+    std::cout << "Average: " << total_allocations / ticks << " allocations, " << total_time / ticks
+              << " ms per tick\n";
+    std::cout << "Scratch memory (bytes in the last tick, peak bytes):\n";
+    for (const auto& usage : application.GetSimulation().GetScratchUsage()) {
+        if (usage.peak == 0) {
+            continue;
+        }
+        std::cout << std::setw(60) << usage.system << std::setw(12) << usage.used << std::setw(12) << usage.peak
+                  << '\n';
+    }
+    return 0;
+}
+
+const std::map<std::string, std::function<int(HeadlessApplication&, const std::vector<std::string>&)>> benchmarks =
+    {
+        {"ledger", BenchmarkLedger},
+        {"expressions", BenchmarkExpressions},
+        {"tick", BenchmarkTick},
+        {"trade", BenchmarkTrade},
+        {"auction", BenchmarkAuction},
+        {"orbits", BenchmarkOrbits},
+        {"kepler", BenchmarkKepler},
+        {"conjunctions", BenchmarkConjunctions},
+};
+}  // namespace
+
+int benchmark(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    // Drop the command name if it was written as `-- benchmark`
+    std::vector<std::string> args = arguments;
+    if (!args.empty() && args[0] == "benchmark") {
+        args.erase(args.begin());
+    }
+    if (args.empty() || !benchmarks.contains(args[0])) {
+        std::cout << "Usage:\n";
+        std::cout << "\t@benchmark [name] [arguments...]\n";
+        std::cout << "Benchmarks:\n";
+        for (const auto& [name, function] : benchmarks) {
+            std::cout << "\t" << name << "\n";
+        }
+        return 1;
+    }
+    return benchmarks.at(args[0])(application, std::vector<std::string>(args.begin() + 1, args.end()));
+}
+}  // namespace cqsp::client::headless
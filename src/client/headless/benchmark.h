@@ -0,0 +1,30 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "client/headless/headlessapplication.h"
+
+namespace cqsp::client::headless {
+/// <summary>
+/// Micro benchmarks for the hot parts of the simulation, so that changes to them can be measured
+/// without a profiler. Run `-- benchmark` to list them.
+/// </summary>
+int benchmark(HeadlessApplication& application, const std::vector<std::string>& arguments);
+}  // namespace cqsp::client::headless
@@ -16,11 +16,29 @@
  */
 #include "client/headless/generate.h"
 
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "client/systems/assetloading.h"
 #include "client/systems/universeloader.h"
 
 namespace cqsp::client::headless {
-int generate(HeadlessApplication& application) {
-    LoadUniverse(application.GetAssetManager(), application.GetGame());
+int generate(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    // `-- generate cold` ignores the game data cache, and makes it again
+    const bool cold = std::find(arguments.begin(), arguments.end(), "cold") != arguments.end();
+    systems::GameDataLoad game_data = LoadUniverse(application.GetAssetManager(), application.GetGame(), !cold);
+    std::cout << "Loaded game data " << (game_data.from_cache ? "from the cache" : "from the assets") << " in "
+              << game_data.milliseconds << " ms\n";
+    if (!game_data.from_cache) {
+        // Time how long the next start would take with the cache that was just made
+        core::Universe scratch;
+        systems::GameDataLoad warm = systems::LoadGameData(application.GetAssetManager(), scratch);
+        if (warm.from_cache) {
+            std::cout << "Cold start " << game_data.milliseconds << " ms, warm start " << warm.milliseconds << " ms\n";
+        }
+    }
     application.InitSimulationPtr();
     // Now we also tick the simulation by one
     application.GetSimulation().Init();
@@ -16,8 +16,11 @@
  */
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "client/headless/headlessapplication.h"
 
 namespace cqsp::client::headless {
-int generate(HeadlessApplication& application);
+int generate(HeadlessApplication& application, const std::vector<std::string>& arguments);
 }  // namespace cqsp::client::headless
@@ -21,9 +21,11 @@
 
 #include <sol/error.hpp>
 
+#include "client/headless/benchmark.h"
 #include "client/headless/generate.h"
 #include "client/headless/headlessluafunctions.h"
 #include "client/headless/loadluafile.h"
+#include "client/headless/snapshot.h"
 #include "core/util/logging.h"
 #include "core/util/string.h"
 
@@ -67,10 +69,22 @@ int HeadlessApplication::run() {
                 line = line.substr(0, line.find(' '));
             }
             if (IsCommandComment(line, arguments, "generate")) {
-                generate(*this);
+                generate(*this, arguments);
                 // Now generate the simulation
             } else if (IsCommandComment(line, arguments, "loadluafile")) {
                 loadluafile(*this, arguments);
+            } else if (IsCommandComment(line, arguments, "benchmark")) {
+                benchmark(*this, arguments);
+            } else if (IsCommandComment(line, arguments, "savesnapshot")) {
+                savesnapshot(*this, arguments);
+            } else if (IsCommandComment(line, arguments, "loadsnapshot")) {
+                loadsnapshot(*this, arguments);
+            } else if (IsCommandComment(line, arguments, "autosave")) {
+                autosave(*this, arguments);
+            } else if (IsCommandComment(line, arguments, "checkpoint")) {
+                checkpoint(*this, arguments);
+            } else if (IsCommandComment(line, arguments, "loadcheckpoints")) {
+                loadcheckpoints(*this, arguments);
             } else if (IsCommandComment(line, arguments, "exit")) {
                 break;
             } else if (line != "--") {
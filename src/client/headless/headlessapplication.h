@@ -41,6 +41,7 @@ class HeadlessApplication {
 
     void InitSimulationPtr();
     core::systems::simulation::Simulation& GetSimulation();
+    bool HasSimulation() const { return simulation != nullptr; }
 
  private:
     asset::AssetManager asset_manager;
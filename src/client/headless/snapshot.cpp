@@ -0,0 +1,216 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "client/headless/snapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/util/save/autosave.h"
+#include "core/util/save/checkpoint.h"
+#include "core/util/save/snapshot.h"
+
+namespace cqsp::client::headless {
+namespace {
+// Drops the command name if it was written as `-- savesnapshot path`
+std::vector<std::string> StripCommand(const std::vector<std::string>& arguments, const std::string& command) {
+    std::vector<std::string> args = arguments;
+    if (!args.empty() && args[0] == command) {
+        args.erase(args.begin());
+    }
+    return args;
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+int savesnapshot(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    std::vector<std::string> args = StripCommand(arguments, "savesnapshot");
+    if (args.empty()) {
+        std::cout << "Usage:\n";
+        std::cout << "\t@savesnapshot [file]\n";
+        return 1;
+    }
+    if (!application.HasSimulation()) {
+        std::cout << "Generate a universe with @generate first\n";
+        return 1;
+    }
+    core::Universe& universe = application.GetGame().GetUniverse();
+    auto start = std::chrono::steady_clock::now();
+    if (!core::save::SaveSnapshot(universe, args[0])) {
+        std::cout << "Could not write " << args[0] << "\n";
+        return 1;
+    }
+    std::cout << "Saved " << universe.alive() << " entities (" << std::filesystem::file_size(args[0]) / 1024
+              << " KiB) in " << MillisecondsSince(start) << " ms\n";
+    return 0;
+}
+
+int loadsnapshot(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    std::vector<std::string> args = StripCommand(arguments, "loadsnapshot");
+    if (args.empty()) {
+        std::cout << "Usage:\n";
+        std::cout << "\t@loadsnapshot [file]\n";
+        return 1;
+    }
+    // The game data and scripts still come from generating
+    if (!application.HasSimulation()) {
+        std::cout << "Generate a universe with @generate first\n";
+        return 1;
+    }
+    core::Universe& universe = application.GetGame().GetUniverse();
+    auto start = std::chrono::steady_clock::now();
+    if (!core::save::LoadSnapshot(universe, args[0])) {
+        std::cout << "Could not load " << args[0] << "\n";
+        return 1;
+    }
+    const double load_time = MillisecondsSince(start);
+
+    // The systems hold on to things from the old universe, so they are made again
+    application.InitSimulationPtr();
+    application.GetSimulation().Init();
+    std::cout << "Loaded " << universe.alive() << " entities in " << load_time << " ms, and started the simulation in "
+              << MillisecondsSince(start) - load_time << " ms\n";
+    return 0;
+}
+
+int autosave(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    std::vector<std::string> args = StripCommand(arguments, "autosave");
+    if (args.size() < 3) {
+        std::cout << "Usage:\n";
+        std::cout << "\t@autosave [folder] [ticks] [ticks between saves]\n";
+        return 1;
+    }
+    if (!application.HasSimulation()) {
+        std::cout << "Generate a universe with @generate first\n";
+        return 1;
+    }
+    const int ticks = std::stoi(args[1]);
+    const int interval = std::stoi(args[2]);
+    if (ticks <= 0 || interval <= 0) {
+        std::cout << "Ticks have to be more than 0\n";
+        return 1;
+    }
+    core::Universe& universe = application.GetGame().GetUniverse();
+    core::save::Autosave saver(application.GetGame().GetGame().GetThreadPool(), args[0], interval);
+
+    std::vector<double> stalls;
+    double tick_time = 0;
+    for (int tick = 0; tick < ticks; tick++) {
+        auto start = std::chrono::steady_clock::now();
+        application.GetSimulation().tick();
+        tick_time += MillisecondsSince(start);
+
+        if (saver.Tick(universe)) {
+            stalls.push_back(saver.GetLastStall());
+        }
+    }
+    saver.Wait();
+
+    std::cout << "Ticked " << ticks << " times in " << tick_time / ticks << " ms per tick\n";
+    std::cout << "Held up the simulation for (ms):";
+    for (double stall : stalls) {
+        std::cout << " " << stall;
+    }
+    std::cout << "\n" << saver.GetSkipped() << " autosaves were skipped because the last one was still being written\n";
+    return 0;
+}
+
+int checkpoint(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    std::vector<std::string> args = StripCommand(arguments, "checkpoint");
+    if (args.size() < 2) {
+        std::cout << "Usage:\n";
+        std::cout << "\t@checkpoint [folder] [days]\n";
+        return 1;
+    }
+    if (!application.HasSimulation()) {
+        std::cout << "Generate a universe with @generate first\n";
+        return 1;
+    }
+    const int days = std::stoi(args[1]);
+    if (days <= 0) {
+        std::cout << "Days have to be more than 0\n";
+        return 1;
+    }
+    core::Universe& universe = application.GetGame().GetUniverse();
+    core::save::CheckpointWriter writer(universe, application.GetGame().GetGame().GetThreadPool(), args[0]);
+
+    auto start = std::chrono::steady_clock::now();
+    const size_t base = writer.Checkpoint();
+    const double base_time = MillisecondsSince(start);
+
+    size_t total = 0;
+    size_t largest = 0;
+    size_t records = 0;
+    double checkpoint_time = 0;
+    for (int day = 0; day < days; day++) {
+        for (int tick = 0; tick < core::components::StarDate::DAY; tick++) {
+            application.GetSimulation().tick();
+        }
+        start = std::chrono::steady_clock::now();
+        const size_t size = writer.Checkpoint();
+        checkpoint_time += MillisecondsSince(start);
+        if (size == 0) {
+            std::cout << "Could not write a checkpoint to " << args[0] << "\n";
+            return 1;
+        }
+        total += size;
+        largest = std::max(largest, size);
+        records += writer.GetChangedRecords();
+    }
+    std::cout << "Base checkpoint: " << base / 1024 << " KiB in " << base_time << " ms\n";
+    std::cout << "Daily checkpoints: " << total / days / 1024 << " KiB on average, " << largest / 1024
+              << " KiB at most, " << checkpoint_time / days << " ms each, " << records / days
+              << " components written or removed on average\n";
+
+    start = std::chrono::steady_clock::now();
+    if (!core::save::CompactCheckpoints(args[0])) {
+        std::cout << "Could not compact the checkpoints in " << args[0] << "\n";
+        return 1;
+    }
+    std::cout << "Compacted " << days + 1 << " checkpoints in " << MillisecondsSince(start) << " ms\n";
+    return 0;
+}
+
+int loadcheckpoints(HeadlessApplication& application, const std::vector<std::string>& arguments) {
+    std::vector<std::string> args = StripCommand(arguments, "loadcheckpoints");
+    if (args.empty()) {
+        std::cout << "Usage:\n";
+        std::cout << "\t@loadcheckpoints [folder]\n";
+        return 1;
+    }
+    if (!application.HasSimulation()) {
+        std::cout << "Generate a universe with @generate first\n";
+        return 1;
+    }
+    core::Universe& universe = application.GetGame().GetUniverse();
+    auto start = std::chrono::steady_clock::now();
+    if (!core::save::LoadCheckpoints(universe, args[0])) {
+        std::cout << "Could not load the checkpoints in " << args[0] << "\n";
+        return 1;
+    }
+    application.InitSimulationPtr();
+    application.GetSimulation().Init();
+    std::cout << "Loaded " << universe.alive() << " entities in " << MillisecondsSince(start) << " ms\n";
+    return 0;
+}
+}  // namespace cqsp::client::headless
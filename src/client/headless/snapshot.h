@@ -0,0 +1,35 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "client/headless/headlessapplication.h"
+
+namespace cqsp::client::headless {
+/// Writes the universe to a snapshot file, so that a long run can be picked up again later
+int savesnapshot(HeadlessApplication& application, const std::vector<std::string>& arguments);
+/// Replaces the universe with the one in a snapshot file, and starts the simulation again
+int loadsnapshot(HeadlessApplication& application, const std::vector<std::string>& arguments);
+/// Ticks the simulation with autosaves turned on, and reports how long each save held up the simulation
+int autosave(HeadlessApplication& application, const std::vector<std::string>& arguments);
+/// Ticks the simulation for some days with a checkpoint every day, and reports how big the checkpoints are
+int checkpoint(HeadlessApplication& application, const std::vector<std::string>& arguments);
+/// Replaces the universe with the last checkpoint in a folder, and starts the simulation again
+int loadcheckpoints(HeadlessApplication& application, const std::vector<std::string>& arguments);
+}  // namespace cqsp::client::headless
@@ -43,6 +43,7 @@
 #include "client/scenes/universe/interface/taxwindow.h"
 #include "client/scenes/universe/interface/turnsavewindow.h"
 #include "core/components/organizations.h"
+#include "core/util/save/savegame.h"
 #include "glad/glad.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtx/polar_coordinates.hpp"
@@ -93,6 +94,11 @@ void UniverseScene::Init() {
         auto& country = GetUniverse().get<components::Country>(player);
         client::ctx::ZoomOntoProvince(GetUniverse(), country.capital_city);
     }
+
+    autosave = std::make_unique<core::save::Autosave>(
+        dynamic_cast<ConquerSpace*>(GetApp().GetGame())->GetGame().GetThreadPool(),
+        core::save::GetSaveFolder(GetUniverse()) + "_autosave",
+        static_cast<int>(GetApp().GetClientOptions().GetOptions()["autosave"]["interval"]));
 }
 
 void UniverseScene::Update(float deltaTime) {
@@ -171,9 +177,11 @@ void UniverseScene::ManageTick() {
         if (ctx::tick_speeds[pause_opt.tick_speed] < 0) {
             for (int i = 0; i < -ctx::tick_speeds[pause_opt.tick_speed]; i++) {
                 simulation->tick();
+                autosave->Tick(GetUniverse());
             }
         } else {
             simulation->tick();
+            autosave->Tick(GetUniverse());
         }
         system_renderer->OnTick();
 
@@ -27,6 +27,7 @@
 #include "core/components/bodies.h"
 #include "core/components/organizations.h"
 #include "core/simulation.h"
+#include "core/util/save/autosave.h"
 #include "engine/application.h"
 #include "engine/graphics/renderable.h"
 #include "engine/renderer/renderer.h"
@@ -60,6 +61,7 @@ class UniverseScene : public RmlClientScene {
 
     std::unique_ptr<systems::SysStarSystemRenderer> system_renderer;
     std::unique_ptr<cqsp::core::systems::simulation::Simulation> simulation;
+    std::unique_ptr<cqsp::core::save::Autosave> autosave;
     std::vector<std::unique_ptr<cqsp::client::systems::SysUserInterface>> user_interfaces;
 
     double last_tick = 0;
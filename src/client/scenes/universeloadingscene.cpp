@@ -65,9 +65,13 @@ void UniverseLoadingScene::LoadCurrentUniverse() {
     LoadUniverse(GetAssetManager(), *dynamic_cast<ConquerSpace*>(GetApp().GetGame()));
     // Load saves
     if (GetUniverse().ctx().contains<ctx::GameLoad>()) {
-        const std::string& load_dir = GetUniverse().ctx().at<ctx::GameLoad>().load_dir;
+        const std::string load_dir = GetUniverse().ctx().at<ctx::GameLoad>().load_dir;
         SPDLOG_INFO("Loading save {}", load_dir);
-        core::save::load_game(GetUniverse(), load_dir);
+        if (!core::save::load_game(GetUniverse(), load_dir)) {
+            // The universe is left as it was made above, so go on with a new game rather than a broken one
+            SPDLOG_ERROR("Save {} could not be loaded, starting a new game instead", load_dir);
+            GetUniverse().ctx().erase<ctx::GameLoad>();
+        }
     }
 
     SPDLOG_INFO("Done loading the universe, entering game");
@@ -44,6 +44,8 @@
 #include "core/loading/zoningloader.h"
 #include "core/scripting/luafunctions.h"
 #include "core/systems/sysuniversegenerator.h"
+#include "core/util/hash.h"
+#include "core/util/save/gamedatacache.h"
 #include "engine/asset/assetmanager.h"
 
 namespace cqsp::client::systems {
@@ -97,26 +99,64 @@ void LoadResource(AssetManager& asset_manager, Universe& universe, const std::st
                 std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
 }
 
-void LoadAllResources(AssetManager& asset_manager, ConquerSpace& conquer_space) {
-    LoadResource<loading::GoodLoader>(asset_manager, conquer_space.GetUniverse(), "goods");
-    LoadResource<loading::ModifierLoader>(asset_manager, conquer_space.GetUniverse(), "modifiers");
-    LoadResource<loading::LaborLoader>(asset_manager, conquer_space.GetUniverse(), "labor");
-    LoadResource<loading::ZoningLoader>(asset_manager, conquer_space.GetUniverse(), "zoning");
-    LoadResource<loading::RecipeLoader>(asset_manager, conquer_space.GetUniverse(), "recipes");
-    LoadResource<loading::PlanetLoader>(asset_manager, conquer_space.GetUniverse(), "planets");
-    LoadResource<loading::TimezoneLoader>(asset_manager, conquer_space.GetUniverse(), "timezones");
-    LoadResource<loading::CountryLoader>(asset_manager, conquer_space.GetUniverse(), "countries");
-    LoadResource<loading::ProjectLoader>(asset_manager, conquer_space.GetUniverse(), "projects");
+// Changes whenever any hjson asset in any package does. The packages and their assets are kept sorted by name, so
+// this is the same on every machine. Changes to the loaders themselves are caught by the build id in the cache.
+uint64_t GameDataKey(AssetManager& asset_manager) {
+    uint64_t key = core::util::fnv_offset;
+    for (const auto& it : asset_manager) {
+        for (const auto& [name, asset] : *it.second) {
+            auto* hjson = dynamic_cast<HjsonAsset*>(asset.get());
+            if (hjson == nullptr) {
+                continue;
+            }
+            key = core::util::HashBytes(it.first + ":" + name, key);
+            key = core::util::HashBytes(std::to_string(hjson->content_hash), key);
+        }
+    }
+    return key;
+}
+
+GameDataLoad LoadGameData(AssetManager& asset_manager, Universe& universe, bool use_cache) {
+    auto start = std::chrono::steady_clock::now();
+    auto milliseconds = [&]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    const uint64_t key = GameDataKey(asset_manager);
+    const std::string cache_path = core::save::GetGameDataCachePath();
+    if (use_cache && core::save::LoadGameDataCache(universe, key, cache_path)) {
+        SPDLOG_INFO("Loaded game data from {} in {} ms", cache_path, milliseconds());
+        return {true, milliseconds()};
+    }
 
-    LoadResource<loading::ProvinceLoader>(asset_manager, conquer_space.GetUniverse(), "provinces");
-    LoadResource<loading::CityLoader>(asset_manager, conquer_space.GetUniverse(), "cities");
-    LoadResource<loading::SatelliteLoader>(asset_manager, conquer_space.GetUniverse(), "satellites");
+    LoadResource<loading::GoodLoader>(asset_manager, universe, "goods");
+    LoadResource<loading::ModifierLoader>(asset_manager, universe, "modifiers");
+    LoadResource<loading::LaborLoader>(asset_manager, universe, "labor");
+    LoadResource<loading::ZoningLoader>(asset_manager, universe, "zoning");
+    LoadResource<loading::RecipeLoader>(asset_manager, universe, "recipes");
+    LoadResource<loading::PlanetLoader>(asset_manager, universe, "planets");
+    LoadResource<loading::TimezoneLoader>(asset_manager, universe, "timezones");
+    LoadResource<loading::CountryLoader>(asset_manager, universe, "countries");
+    LoadResource<loading::ProjectLoader>(asset_manager, universe, "projects");
 
-    LoadResource(asset_manager, conquer_space.m_universe, "economy_config", loading::LoadEconomyConfig);
+    LoadResource<loading::ProvinceLoader>(asset_manager, universe, "provinces");
+    LoadResource<loading::CityLoader>(asset_manager, universe, "cities");
+    LoadResource<loading::SatelliteLoader>(asset_manager, universe, "satellites");
+
+    LoadResource(asset_manager, universe, "economy_config", loading::LoadEconomyConfig);
+
+    LoadResource(asset_manager, universe, "names", loading::LoadNameLists);
+    LoadResource(asset_manager, universe, "tech_fields", loading::LoadFields);
+    LoadResource(asset_manager, universe, "tech_list", loading::LoadTechnologies);
+    const double load_time = milliseconds();
+
+    if (core::save::SaveGameDataCache(universe, key, cache_path)) {
+        SPDLOG_INFO("Cached game data to {}", cache_path);
+    }
+    return {false, load_time};
+}
 
-    LoadResource(asset_manager, conquer_space.m_universe, "names", loading::LoadNameLists);
-    LoadResource(asset_manager, conquer_space.m_universe, "tech_fields", loading::LoadFields);
-    LoadResource(asset_manager, conquer_space.m_universe, "tech_list", loading::LoadTechnologies);
+GameDataLoad LoadAllResources(AssetManager& asset_manager, ConquerSpace& conquer_space, bool use_cache) {
+    GameDataLoad game_data = LoadGameData(asset_manager, conquer_space.GetUniverse(), use_cache);
 
     // Load scripts
     // Load lua functions
@@ -132,5 +172,6 @@ void LoadAllResources(AssetManager& asset_manager, ConquerSpace& conquer_space)
     script_interface.RegisterDataGroup("generators");
     script_interface.RegisterDataGroup("events");
     script_interface.RegisterDataGroup("interfaces");
+    return game_data;
 }
 }  // namespace cqsp::client::systems
@@ -20,6 +20,18 @@
 #include "engine/application.h"
 
 namespace cqsp::client::systems {
+struct GameDataLoad {
+    bool from_cache;
+    double milliseconds;
+};
+
+/// <summary>
+/// Makes the goods, recipes, planets, provinces, cities and the rest of the game data into game objects.
+/// </summary>
+/// If the game data hasn't changed since the last time, the universe is read from the game data cache instead
+/// (see gamedatacache.h), otherwise the cache is made again.
+GameDataLoad LoadGameData(asset::AssetManager& asset_manager, core::Universe& universe, bool use_cache = true);
+
 // Loads all the goods and the like into the game.
-void LoadAllResources(asset::AssetManager& asset_manager, ConquerSpace& conquer_space);
+GameDataLoad LoadAllResources(asset::AssetManager& asset_manager, ConquerSpace& conquer_space, bool use_cache = true);
 }  // namespace cqsp::client::systems
@@ -24,8 +24,8 @@ namespace cqsp::client {
 
 using core::systems::universegenerator::SysUniverseGenerator;
 
-void LoadUniverse(asset::AssetManager& asset_manager, ConquerSpace& conquer_space) {
-    systems::LoadAllResources(asset_manager, conquer_space);
+systems::GameDataLoad LoadUniverse(asset::AssetManager& asset_manager, ConquerSpace& conquer_space, bool use_cache) {
+    systems::GameDataLoad game_data = systems::LoadAllResources(asset_manager, conquer_space, use_cache);
     SPDLOG_INFO("Made all game resources into game objects");
     using asset::TextAsset;
     // Process scripts for core
@@ -36,5 +36,6 @@ void LoadUniverse(asset::AssetManager& asset_manager, ConquerSpace& conquer_spac
     SysUniverseGenerator script_generator(conquer_space.GetScriptInterface());
 
     script_generator.Generate(conquer_space.GetUniverse());
+    return game_data;
 }
 }  // namespace cqsp::client
@@ -17,10 +17,13 @@
 #pragma once
 
 #include "client/conquerspace.h"
+#include "client/systems/assetloading.h"
 #include "core/scripting/scripting.h"
 #include "core/universe.h"
 #include "engine/asset/assetmanager.h"
 
 namespace cqsp::client {
-void LoadUniverse(asset::AssetManager& asset_manager, client::ConquerSpace& conquer_space);
+/// Loads the game data and scripts, and generates the universe. Returns how the game data was loaded.
+systems::GameDataLoad LoadUniverse(asset::AssetManager& asset_manager, client::ConquerSpace& conquer_space,
+                                   bool use_cache = true);
 }  // namespace cqsp::client
@@ -17,98 +17,78 @@
 #include "core/actions/economy/auctionhandler.h"
 
 #include <spdlog/spdlog.h>
+
+#include <functional>
+
 namespace cqsp::core::actions {
 
 using components::AuctionHouse;
+using components::Order;
 
-bool BuyGood(AuctionHouse& auction_house, Node& agent, Node& good, double price, double quantity) {
-    // The orders we want to try and fufill
-    auto& sell_order_list = auction_house.sell_orders[good];
-    auto& buy_order_list = auction_house.buy_orders[good];
-
-    // Check if goods are being sold
-    if (sell_order_list.empty()) {
-        // Then make new buy order
-        components::Order order(price, quantity, agent);
-        buy_order_list.put(order);
+namespace {
+/// <summary>
+/// Fills the order from the best orders on the other side of the book, and puts what cannot be filled on its own
+/// side. Crosses(resting price, order price) is true if the resting order can be taken at that price.
+/// </summary>
+/// <returns>True if the order was filled immediately</returns>
+template <typename Crosses, typename Opposite, typename Own>
+bool FillOrder(Opposite& opposite, Own& own, Order order) {
+    if (opposite.empty()) {
+        own.put(order);
         return false;
     }
-    // Then pop the first in the list, and check if the price works
-    while (!sell_order_list.empty()) {
-        components::Order& first = sell_order_list.front();
-        // Then check if the price is right
-        if (first.price > price) {
+    while (!opposite.empty()) {
+        Order& first = opposite.front();
+        if (!Crosses()(first.price, order.price)) {
             break;
         }
-        // Buy good, and fufill demand
-        if (first.quantity > quantity) {
-            first.quantity -= quantity;
-            quantity = 0;
-            // Also subtract wallet
-            // Thing done!
+        if (first.quantity > order.quantity) {
+            first.quantity -= order.quantity;
             return true;
-        } else {
-            // remove order, remove quantity
-            quantity -= first.quantity;
-            // Remove buy order
-            sell_order_list.erase(sell_order_list.begin());
+        }
+        order.quantity -= first.quantity;
+        opposite.pop_front();
+        if (order.quantity == 0) {
+            break;
         }
     }
 
-    if (quantity <= 0) {
+    if (order.quantity <= 0) {
         return true;
     }
-    // Then place a buy order because the order could not be fufulled.
-    components::Order order(price, quantity, agent);
-    buy_order_list.put(order);
+    // Then place an order because the order could not be fufilled.
+    own.put(order);
     return false;
 }
+}  // namespace
+
+bool BuyGood(AuctionHouse& auction_house, Node& agent, Node& good, double price, double quantity) {
+    return FillOrder<std::less_equal<double>>(auction_house.sell_orders[good], auction_house.buy_orders[good],
+                                              Order(price, quantity, agent));
+}
 
 bool SellGood(AuctionHouse& auction_house, Node& agent, Node& good, double price, double quantity) {
-    // The place we will put our order if we cannot fufill it
-    auto& sell_order_list = auction_house.sell_orders[good];
+    return FillOrder<std::greater_equal<double>>(auction_house.buy_orders[good], auction_house.sell_orders[good],
+                                                 Order(price, quantity, agent));
+}
 
-    // The orders we want to try and fufill
+size_t BuyGoods(AuctionHouse& auction_house, entt::entity good, std::span<const Order> orders) {
+    auto& sell_order_list = auction_house.sell_orders[good];
     auto& buy_order_list = auction_house.buy_orders[good];
-
-    // Check if goods are being sold
-    if (buy_order_list.empty()) {
-        // Then make new order
-        components::Order order(price, quantity, agent);
-        sell_order_list.put(order);
-        return false;
-    }
-    // Then pop the first in the list, and check if the price works
-    while (!buy_order_list.empty()) {
-        components::Order& first = buy_order_list.front();
-        // Then check if the price is right
-        if (first.price < price) {
-            break;
-        }
-        // Buy good, and fufill demand
-        if (first.quantity > quantity) {
-            first.quantity -= quantity;
-            quantity = 0;
-            // Also subtract wallet
-            // Thing done!
-            return true;
-        } else {
-            // remove order, remove quantity
-            quantity -= first.quantity;
-            // Remove buy order
-            buy_order_list.erase(buy_order_list.begin());
-            if (quantity == 0) {
-                break;
-            }
-        }
+    size_t filled = 0;
+    for (const Order& order : orders) {
+        filled += FillOrder<std::less_equal<double>>(sell_order_list, buy_order_list, order) ? 1 : 0;
     }
+    return filled;
+}
 
-    if (quantity <= 0) {
-        return true;
+size_t SellGoods(AuctionHouse& auction_house, entt::entity good, std::span<const Order> orders) {
+    auto& sell_order_list = auction_house.sell_orders[good];
+    auto& buy_order_list = auction_house.buy_orders[good];
+    size_t filled = 0;
+    for (const Order& order : orders) {
+        filled += FillOrder<std::greater_equal<double>>(buy_order_list, sell_order_list, order) ? 1 : 0;
     }
-    // Then place a sell order because the order could not be fufulled.
-    components::Order order(price, quantity, agent);
-    sell_order_list.put(order);
-    return false;
+    return filled;
 }
-}  // namespace cqsp::core::actions
\ No newline at end of file
+}  // namespace cqsp::core::actions
@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <span>
+
 #include <entt/entt.hpp>
 
 #include "core/components/auction.h"
@@ -43,4 +45,18 @@ bool BuyGood(components::AuctionHouse& auction_house, Node& agent, Node& good, d
 /// <returns>True if the order is fufilled immediately, false if a sell order is
 /// placed.</returns>
 bool SellGood(components::AuctionHouse& auction_house, Node& agent, Node&, double price, double quantity);
+
+/// <summary>
+/// Buys a good for many orders at once. This is the same as calling BuyGood for each order in turn, but the
+/// books of the good are only looked up once.
+/// </summary>
+/// <returns>The number of orders that were fufilled immediately</returns>
+size_t BuyGoods(components::AuctionHouse& auction_house, entt::entity good, std::span<const components::Order> orders);
+
+/// <summary>
+/// Sells a good for many orders at once, see BuyGoods.
+/// </summary>
+/// <returns>The number of orders that were fufilled immediately</returns>
+size_t SellGoods(components::AuctionHouse& auction_house, entt::entity good,
+                 std::span<const components::Order> orders);
 }  // namespace cqsp::core::actions
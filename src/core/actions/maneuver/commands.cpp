@@ -152,6 +152,7 @@ void ExecuteCommand(Universe& universe, entt::entity entity, entt::entity comman
 
             orbit.LAN = target_orbit.LAN;
             orbit.inclination = target_orbit.inclination;
+            orbit.UpdateRotation();
             // Add a maneuver. This is a hack so that we run the next maneuver command after this
             // TODO(EhWhoAmI): Fix this when we are able to figure out why plane matching doesn't work as well as we would hope.
             PushManeuver(universe, entity, MakeManeuver(glm::dvec3(0, 0, 0), 100.));
@@ -259,27 +260,37 @@ void TransferToMoon(Universe& universe, entt::entity agent, entt::entity target)
     command_queue.commands.push_back(circularize);
 }
 
+components::ManeuverSchedule& GetManeuverSchedule(Universe& universe) {
+    return universe.ctx().at<components::ManeuverSchedule>();
+}
+
 /**
  * @param offset the time offset in ticks to push back the command
  */
 void PushManeuver(Universe& universe, entt::entity entity, components::Maneuver_t maneuver, double offset) {
     auto& queue = universe.get_or_emplace<components::CommandQueue>(entity);
     queue.maneuvers.emplace_back(maneuver, universe.date() + offset);
+    GetManeuverSchedule(universe).Push(entity, queue.maneuvers.back().time);
 }
 
 void PushManeuvers(Universe& universe, entt::entity entity, std::initializer_list<components::Maneuver_t> maneuver,
                    double offset) {
     // Now push back all the commands or something
     auto& queue = universe.get_or_emplace<components::CommandQueue>(entity);
+    auto& schedule = GetManeuverSchedule(universe);
     for (auto& man_t : maneuver) {
         queue.maneuvers.emplace_back(man_t, universe.date() + offset);
+        schedule.Push(entity, queue.maneuvers.back().time);
     }
 }
 
 void PushManeuvers(Universe& universe, entt::entity entity, components::HohmannPair_t hohmann_pair, double offset) {
     auto& queue = universe.get_or_emplace<components::CommandQueue>(entity);
+    auto& schedule = GetManeuverSchedule(universe);
     queue.maneuvers.emplace_back(hohmann_pair.first, universe.date() + offset);
+    schedule.Push(entity, queue.maneuvers.back().time);
     queue.maneuvers.emplace_back(hohmann_pair.second, universe.date() + offset);
+    schedule.Push(entity, queue.maneuvers.back().time);
 }
 
 void LandOnMoon(Universe& universe, entt::entity agent, entt::entity target, entt::entity city) {
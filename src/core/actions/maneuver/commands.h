@@ -35,6 +35,11 @@ void TransferToMoon(Universe& universe, entt::entity agent, entt::entity target)
 void LeaveSOI(Universe& universe, entt::entity agent, double altitude);
 void LandOnMoon(Universe& universe, entt::entity agent, entt::entity target, entt::entity city);
 components::Maneuver_t MakeManeuver(const glm::dvec3& vector, double time);
+/// <summary>
+/// The schedule of every maneuver that has been pushed. It is made by `SysOrbit::Init` (or `ReadSnapshot`), so that
+/// nothing adds to the universe context while systems run at the same time.
+/// </summary>
+components::ManeuverSchedule& GetManeuverSchedule(Universe& universe);
 void PushManeuver(Universe& universe, entt::entity entity, components::Maneuver_t maneuver, double offset = 0);
 void PushManeuvers(Universe& universe, entt::entity entity, std::initializer_list<components::Maneuver_t> maneuver,
                    double offset = 0);
@@ -16,11 +16,215 @@
  */
 #include "core/actions/maneuver/lambert/izzo.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <limits>
 #include <numbers>
 #include <ostream>
 
+#include "core/util/threadpool.h"
+
 namespace cqsp::core::systems::lambert {
+namespace {
+// The geometry of a problem, which every solution shares
+struct Geometry {
+    double c;
+    double s;
+    double lambda;
+    double lambda2;
+    double lambda3;
+    double R1;
+    double R2;
+    // Non dimensional time of flight
+    double T;
+    glm::dvec3 ir1;
+    glm::dvec3 ir2;
+    glm::dvec3 it1;
+    glm::dvec3 it2;
+};
+
+Geometry GetGeometry(const glm::dvec3 &r1, const glm::dvec3 &r2, const double tof, const double mu, const bool cw) {
+    Geometry geometry;
+    // 1 - Getting lambda and T
+    geometry.c =
+        sqrt((r2[0] - r1[0]) * (r2[0] - r1[0]) + (r2[1] - r1[1]) * (r2[1] - r1[1]) + (r2[2] - r1[2]) * (r2[2] - r1[2]));
+    geometry.R1 = glm::length(r1);
+    geometry.R2 = glm::length(r2);
+    geometry.s = (geometry.c + geometry.R1 + geometry.R2) / 2.0;
+    geometry.ir1 = r1 / geometry.R1;
+    geometry.ir2 = r2 / geometry.R2;
+    glm::dvec3 ih = glm::cross(geometry.ir1, geometry.ir2);
+
+    ih = glm::normalize(ih);
+    if (ih[2] == 0) {
+        //  throw_value_error("The angular momentum vector has no z component, impossible to define automatically clock or "
+        //                    "counterclockwise");
+    }
+    geometry.lambda2 = 1.0 - geometry.c / geometry.s;
+    geometry.lambda = sqrt(geometry.lambda2);
+
+    if (ih[2] < 0.0)  // Transfer angle is larger than 180 degrees as seen from abive the z axis
+    {
+        geometry.lambda = -geometry.lambda;
+        geometry.it1 = glm::cross(geometry.ir1, ih);
+        geometry.it2 = glm::cross(geometry.ir2, ih);
+    } else {
+        geometry.it1 = glm::cross(ih, geometry.ir1);
+        geometry.it2 = glm::cross(ih, geometry.ir2);
+    }
+    geometry.it1 = glm::normalize(geometry.it1);
+    geometry.it2 = glm::normalize(geometry.it2);
+
+    if (cw) {  // Retrograde motion
+        geometry.lambda = -geometry.lambda;
+        geometry.it1 = -geometry.it1;
+        geometry.it2 = -geometry.it2;
+    }
+    geometry.lambda3 = geometry.lambda * geometry.lambda2;
+    geometry.T = sqrt(2.0 * mu / geometry.s / geometry.s / geometry.s) * tof;
+    return geometry;
+}
+
+void dTdx(double &DT, double &DDT, double &DDDT, const double x, const double T, const double lambda) {
+    double l2 = lambda * lambda;
+    double l3 = l2 * lambda;
+    double umx2 = 1.0 - x * x;
+    double y = sqrt(1.0 - l2 * umx2);
+    double y2 = y * y;
+    double y3 = y2 * y;
+    DT = 1.0 / umx2 * (3.0 * T * x - 2.0 + 2.0 * l3 * x / y);
+    DDT = 1.0 / umx2 * (3.0 * T + 5.0 * x * DT + 2.0 * (1.0 - l2) * l3 / y3);
+    DDDT = 1.0 / umx2 * (7.0 * x * DDT + 8.0 * DT - 6.0 * (1.0 - l2) * l2 * l3 * x / y3 / y2);
+}
+
+void x2tof2(double &tof, const double x, const int N, const double lambda) {
+    double a = 1.0 / (1.0 - x * x);
+    if (a > 0)  // ellipse
+    {
+        double alfa = 2.0 * acos(x);
+        double beta = 2.0 * asin(sqrt(lambda * lambda / a));
+        if (lambda < 0.0) beta = -beta;
+        tof = ((a * sqrt(a) * ((alfa - sin(alfa)) - (beta - sin(beta)) + 2.0 * std::numbers::pi * N)) / 2.0);
+    } else {
+        double alfa = 2.0 * acosh(x);
+        double beta = 2.0 * asinh(sqrt(-lambda * lambda / a));
+        if (lambda < 0.0) beta = -beta;
+        tof = (-a * sqrt(-a) * ((beta - sinh(beta)) - (alfa - sinh(alfa))) / 2.0);
+    }
+}
+
+double hypergeometricF(double z, double tol) {
+    double Sj = 1.0;
+    double Cj = 1.0;
+    double err = 1.0;
+    double Cj1 = 0.0;
+    double Sj1 = 0.0;
+    int j = 0;
+    while (err > tol) {
+        Cj1 = Cj * (3.0 + j) * (1.0 + j) / (2.5 + j) * z / (j + 1);
+        Sj1 = Sj + Cj1;
+        err = fabs(Cj1);
+        Sj = Sj1;
+        Cj = Cj1;
+        j = j + 1;
+    }
+    return Sj;
+}
+
+void x2tof(double &tof, const double x, const int N, const double lambda) {
+    double battin = 0.01;
+    double lagrange = 0.2;
+    double dist = fabs(x - 1);
+    if (dist < lagrange && dist > battin) {  // We use Lagrange tof expression
+        x2tof2(tof, x, N, lambda);
+        return;
+    }
+    double K = lambda * lambda;
+    double E = x * x - 1.0;
+    double rho = fabs(E);
+    double z = sqrt(1 + K * E);
+    if (dist < battin) {  // We use Battin series tof expression
+        double eta = z - lambda * x;
+        double S1 = 0.5 * (1.0 - lambda - x * eta);
+        double Q = hypergeometricF(S1, 1e-11);
+        Q = 4.0 / 3.0 * Q;
+        tof = (eta * eta * eta * Q + 4.0 * lambda * eta) / 2.0 + N * std::numbers::pi / pow(rho, 1.5);
+        return;
+    } else {  // We use Lancaster tof expresion
+        double y = sqrt(rho);
+        double g = x * z - lambda * E;
+        double d = 0.0;
+        if (E < 0) {
+            double l = acos(g);
+            d = N * std::numbers::pi + l;
+        } else {
+            double f = y * (z - lambda * x);
+            d = log(f + g);
+        }
+        tof = (x - lambda * z - d / y) / E;
+        return;
+    }
+}
+
+int householder(const double T, double &x0, const int N, const double eps, const int iter_max, const double lambda) {
+    int it = 0;
+    double err = 1.0;
+    double xnew = 0.0;
+    double tof = 0.0;
+    double delta = 0.0;
+    double DT = 0.0;
+    double DDT = 0.0;
+    double DDDT = 0.0;
+    while ((err > eps) && (it < iter_max)) {
+        x2tof(tof, x0, N, lambda);
+        dTdx(DT, DDT, DDDT, x0, tof, lambda);
+        delta = tof - T;
+        double DT2 = DT * DT;
+        xnew = x0 - delta * (DT2 - delta * DDT / 2.0) / (DT * (DT2 - delta * DDT) + DDDT * delta * delta / 6.0);
+        err = fabs(x0 - xnew);
+        x0 = xnew;
+        it++;
+    }
+    return it;
+}
+
+// Initial guess and Householder iterations for the zero revolution solution
+double SolveZeroRevolutionX(const Geometry &geometry, int &iterations) {
+    const double T = geometry.T;
+    const double T00 = acos(geometry.lambda) + geometry.lambda * sqrt(1.0 - geometry.lambda2);
+    const double T1 = 2.0 / 3.0 * (1.0 - geometry.lambda3);
+    double x = 0;
+    // 3.1.1 initial guess
+    if (T >= T00) {
+        x = -(T - T00) / (T - T00 + 4);
+    } else if (T <= T1) {
+        x = T1 * (T1 - T) / (2.0 / 5.0 * (1 - geometry.lambda2 * geometry.lambda3) * T) + 1;
+    } else {
+        x = pow((T / T00), std::numbers::ln2 / log(T1 / T00)) - 1.0;
+    }
+    // 3.1.2 Householder iterations
+    iterations = householder(T, x, 0, 1e-5, 15, geometry.lambda);
+    return x;
+}
+
+// 4 - Reconstructs the terminal velocities from x
+void TerminalVelocities(const Geometry &geometry, const double mu, const double x, glm::dvec3 &v1, glm::dvec3 &v2) {
+    double gamma = sqrt(mu * geometry.s / 2.0);
+    double rho = (geometry.R1 - geometry.R2) / geometry.c;
+    double sigma = sqrt(1 - rho * rho);
+    double y = sqrt(1.0 - geometry.lambda2 + geometry.lambda2 * x * x);
+    double vr1 = gamma * ((geometry.lambda * y - x) - rho * (geometry.lambda * y + x)) / geometry.R1;
+    double vr2 = -gamma * ((geometry.lambda * y - x) + rho * (geometry.lambda * y + x)) / geometry.R2;
+    double vt = gamma * sigma * (y + geometry.lambda * x);
+    double vt1 = vt / geometry.R1;
+    double vt2 = vt / geometry.R2;
+    for (int j = 0; j < 3; ++j) v1[j] = vr1 * geometry.ir1[j] + vt1 * geometry.it1[j];
+    for (int j = 0; j < 3; ++j) v2[j] = vr2 * geometry.ir2[j] + vt2 * geometry.it2[j];
+}
+}  // namespace
+
 /** Constructs and solves a Lambert problem.
   *
   * \param[in] R1 first cartesian position
@@ -43,54 +247,19 @@ void Izzo::solve() {
         //  throw_value_error("Gravity parameter is zero or negative!");
     }
     // 1 - Getting lambda and T
-    m_c =
-        sqrt((r2[0] - r1[0]) * (r2[0] - r1[0]) + (r2[1] - r1[1]) * (r2[1] - r1[1]) + (r2[2] - r1[2]) * (r2[2] - r1[2]));
-    double R1 = glm::length(r1);
-    double R2 = glm::length(r2);
-    m_s = (m_c + R1 + R2) / 2.0;
-    glm::dvec3 ir1;
-    glm::dvec3 ir2;
-    glm::dvec3 ih;
-    glm::dvec3 it1;
-    glm::dvec3 it2;
-    ir1 = r1 / R1;
-    ir2 = r2 / R2;
-    ih = glm::cross(ir1, ir2);
-
-    ih = glm::normalize(ih);
-    if (ih[2] == 0) {
-        //  throw_value_error("The angular momentum vector has no z component, impossible to define automatically clock or "
-        //                    "counterclockwise");
-    }
-    double lambda2 = 1.0 - m_c / m_s;
-    m_lambda = sqrt(lambda2);
-
-    if (ih[2] < 0.0)  // Transfer angle is larger than 180 degrees as seen from abive the z axis
-    {
-        m_lambda = -m_lambda;
-        it1 = glm::cross(ir1, ih);
-        it2 = glm::cross(ir2, ih);
-    } else {
-        it1 = glm::cross(ih, ir1);
-        it2 = glm::cross(ih, ir2);
-    }
-    it1 = glm::normalize(it1);
-    it2 = glm::normalize(it2);
-
-    if (cw) {  // Retrograde motion
-        m_lambda = -m_lambda;
-        it1 = -it1;
-        it2 = -it2;
-    }
-    double lambda3 = m_lambda * lambda2;
-    double T = sqrt(2.0 * mu / m_s / m_s / m_s) * tof;
+    const Geometry geometry = GetGeometry(r1, r2, tof, mu, cw);
+    m_c = geometry.c;
+    m_s = geometry.s;
+    m_lambda = geometry.lambda;
+    double lambda2 = geometry.lambda2;
+    double lambda3 = geometry.lambda3;
+    double T = geometry.T;
 
     // 2 - We now have lambda, T and we will find all x
     // 2.1 - Let us first detect the maximum number of revolutions for which there exists a solution
     m_Nmax = static_cast<int>(T / std::numbers::pi);
     double T00 = acos(m_lambda) + m_lambda * sqrt(1.0 - lambda2);
     double T0 = (T00 + m_Nmax * std::numbers::pi);
-    double T1 = 2.0 / 3.0 * (1.0 - lambda3);
     double DT = 0.0;
     double DDT = 0.0;
     double DDDT = 0.0;
@@ -131,16 +300,7 @@ void Izzo::solve() {
 
     // 3 - We may now find all solutions in x,y
     // 3.1 0 rev solution
-    // 3.1.1 initial guess
-    if (T >= T00) {
-        m_x[0] = -(T - T00) / (T - T00 + 4);
-    } else if (T <= T1) {
-        m_x[0] = T1 * (T1 - T) / (2.0 / 5.0 * (1 - lambda2 * lambda3) * T) + 1;
-    } else {
-        m_x[0] = pow((T / T00), std::numbers::ln2 / log(T1 / T00)) - 1.0;
-    }
-    // 3.1.2 Householder iterations
-    m_iters[0] = householder(T, m_x[0], 0, 1e-5, 15);
+    m_x[0] = SolveZeroRevolutionX(geometry, m_iters[0]);
     // 3.2 multi rev solutions
     double tmp;
     for (size_t i = 1; i < m_Nmax + 1; ++i) {
@@ -155,127 +315,54 @@ void Izzo::solve() {
     }
 
     // 4 - For each found x value we reconstruct the terminal velocities
-    double gamma = sqrt(mu * m_s / 2.0);
-    double rho = (R1 - R2) / m_c;
-    double sigma = sqrt(1 - rho * rho);
-    double vr1;
-    double vt1;
-    double vr2;
-    double vt2;
-    double y;
     for (size_t i = 0; i < m_x.size(); ++i) {
-        y = sqrt(1.0 - lambda2 + lambda2 * m_x[i] * m_x[i]);
-        vr1 = gamma * ((m_lambda * y - m_x[i]) - rho * (m_lambda * y + m_x[i])) / R1;
-        vr2 = -gamma * ((m_lambda * y - m_x[i]) + rho * (m_lambda * y + m_x[i])) / R2;
-        double vt = gamma * sigma * (y + m_lambda * m_x[i]);
-        vt1 = vt / R1;
-        vt2 = vt / R2;
-        for (int j = 0; j < 3; ++j) m_v1[i][j] = vr1 * ir1[j] + vt1 * it1[j];
-        for (int j = 0; j < 3; ++j) m_v2[i][j] = vr2 * ir2[j] + vt2 * it2[j];
+        TerminalVelocities(geometry, mu, m_x[i], m_v1[i], m_v2[i]);
     }
 }
 
 int Izzo::householder(const double T, double &x0, const int N, const double eps, const int iter_max) {
-    int it = 0;
-    double err = 1.0;
-    double xnew = 0.0;
-    double tof = 0.0;
-    double delta = 0.0;
-    double DT = 0.0;
-    double DDT = 0.0;
-    double DDDT = 0.0;
-    while ((err > eps) && (it < iter_max)) {
-        x2tof(tof, x0, N);
-        dTdx(DT, DDT, DDDT, x0, tof);
-        delta = tof - T;
-        double DT2 = DT * DT;
-        xnew = x0 - delta * (DT2 - delta * DDT / 2.0) / (DT * (DT2 - delta * DDT) + DDDT * delta * delta / 6.0);
-        err = fabs(x0 - xnew);
-        x0 = xnew;
-        it++;
-    }
-    return it;
+    return lambert::householder(T, x0, N, eps, iter_max, m_lambda);
 }
 
 void Izzo::dTdx(double &DT, double &DDT, double &DDDT, const double x, const double T) {
-    double l2 = m_lambda * m_lambda;
-    double l3 = l2 * m_lambda;
-    double umx2 = 1.0 - x * x;
-    double y = sqrt(1.0 - l2 * umx2);
-    double y2 = y * y;
-    double y3 = y2 * y;
-    DT = 1.0 / umx2 * (3.0 * T * x - 2.0 + 2.0 * l3 * x / y);
-    DDT = 1.0 / umx2 * (3.0 * T + 5.0 * x * DT + 2.0 * (1.0 - l2) * l3 / y3);
-    DDDT = 1.0 / umx2 * (7.0 * x * DDT + 8.0 * DT - 6.0 * (1.0 - l2) * l2 * l3 * x / y3 / y2);
+    lambert::dTdx(DT, DDT, DDDT, x, T, m_lambda);
 }
 
-void Izzo::x2tof2(double &tof, const double x, const int N) {
-    double a = 1.0 / (1.0 - x * x);
-    if (a > 0)  // ellipse
-    {
-        double alfa = 2.0 * acos(x);
-        double beta = 2.0 * asin(sqrt(m_lambda * m_lambda / a));
-        if (m_lambda < 0.0) beta = -beta;
-        tof = ((a * sqrt(a) * ((alfa - sin(alfa)) - (beta - sin(beta)) + 2.0 * std::numbers::pi * N)) / 2.0);
-    } else {
-        double alfa = 2.0 * acosh(x);
-        double beta = 2.0 * asinh(sqrt(-m_lambda * m_lambda / a));
-        if (m_lambda < 0.0) beta = -beta;
-        tof = (-a * sqrt(-a) * ((beta - sinh(beta)) - (alfa - sinh(alfa))) / 2.0);
-    }
-}
+void Izzo::x2tof2(double &tof, const double x, const int N) { lambert::x2tof2(tof, x, N, m_lambda); }
 
-void Izzo::x2tof(double &tof, const double x, const int N) {
-    double battin = 0.01;
-    double lagrange = 0.2;
-    double dist = fabs(x - 1);
-    if (dist < lagrange && dist > battin) {  // We use Lagrange tof expression
-        x2tof2(tof, x, N);
-        return;
-    }
-    double K = m_lambda * m_lambda;
-    double E = x * x - 1.0;
-    double rho = fabs(E);
-    double z = sqrt(1 + K * E);
-    if (dist < battin) {  // We use Battin series tof expression
-        double eta = z - m_lambda * x;
-        double S1 = 0.5 * (1.0 - m_lambda - x * eta);
-        double Q = hypergeometricF(S1, 1e-11);
-        Q = 4.0 / 3.0 * Q;
-        tof = (eta * eta * eta * Q + 4.0 * m_lambda * eta) / 2.0 + N * std::numbers::pi / pow(rho, 1.5);
-        return;
-    } else {  // We use Lancaster tof expresion
-        double y = sqrt(rho);
-        double g = x * z - m_lambda * E;
-        double d = 0.0;
-        if (E < 0) {
-            double l = acos(g);
-            d = N * std::numbers::pi + l;
-        } else {
-            double f = y * (z - m_lambda * x);
-            d = log(f + g);
-        }
-        tof = (x - m_lambda * z - d / y) / E;
-        return;
+void Izzo::x2tof(double &tof, const double x, const int N) { lambert::x2tof(tof, x, N, m_lambda); }
+
+double Izzo::hypergeometricF(double z, double tol) { return lambert::hypergeometricF(z, tol); }
+
+bool SolveZeroRevolution(const glm::dvec3 &r1, const glm::dvec3 &r2, double tof, double mu, bool cw, glm::dvec3 &v1,
+                         glm::dvec3 &v2) {
+    if (!(tof > 0) || !(mu > 0)) {
+        return false;
     }
+    const Geometry geometry = GetGeometry(r1, r2, tof, mu, cw);
+    int iterations = 0;
+    const double x = SolveZeroRevolutionX(geometry, iterations);
+    TerminalVelocities(geometry, mu, x, v1, v2);
+    return std::isfinite(v1.x) && std::isfinite(v1.y) && std::isfinite(v1.z) && std::isfinite(v2.x) &&
+           std::isfinite(v2.y) && std::isfinite(v2.z);
 }
 
-double Izzo::hypergeometricF(double z, double tol) {
-    double Sj = 1.0;
-    double Cj = 1.0;
-    double err = 1.0;
-    double Cj1 = 0.0;
-    double Sj1 = 0.0;
-    int j = 0;
-    while (err > tol) {
-        Cj1 = Cj * (3.0 + j) * (1.0 + j) / (2.5 + j) * z / (j + 1);
-        Sj1 = Sj + Cj1;
-        err = fabs(Cj1);
-        Sj = Sj1;
-        Cj = Cj1;
-        j = j + 1;
+void SolveBatch(std::span<const glm::dvec3> r1, std::span<const glm::dvec3> r2, std::span<const double> tof,
+                double mu, std::span<glm::dvec3> v1, std::span<glm::dvec3> v2, util::ThreadPool *pool, bool cw) {
+    assert(r1.size() == r2.size() && r1.size() == tof.size() && r1.size() == v1.size() && r1.size() == v2.size());
+    auto solve = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (!SolveZeroRevolution(r1[i], r2[i], tof[i], mu, cw, v1[i], v2[i])) {
+                v1[i] = glm::dvec3(std::numeric_limits<double>::quiet_NaN());
+                v2[i] = glm::dvec3(std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+    };
+    if (pool == nullptr) {
+        solve(0, r1.size());
+    } else {
+        pool->ParallelFor(0, r1.size(), solve, batch_grain);
     }
-    return Sj;
 }
 
 /**
@@ -17,10 +17,16 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+namespace cqsp::core::util {
+class ThreadPool;
+}  // namespace cqsp::core::util
+
 namespace cqsp::core::systems::lambert {
 /**
  * This class represent a Lambert's problem. When instantiated it assumes a prograde orbit (unless otherwise stated)
@@ -71,4 +77,27 @@ class Izzo {
     int m_multi_revs;
     bool cw;
 };
+
+/// <summary>
+/// Solves the zero revolution Lambert problem without allocating anything, which is what Izzo::solve does for
+/// the first solution.
+/// </summary>
+/// <param name="cw">If the transfer is retrograde</param>
+/// <returns>false if there isn't a solution, and v1 and v2 can't be used</returns>
+bool SolveZeroRevolution(const glm::dvec3 &r1, const glm::dvec3 &r2, double tof, double mu, bool cw, glm::dvec3 &v1,
+                         glm::dvec3 &v2);
+
+/// <summary>
+/// Solves the zero revolution problem from r1[i] to r2[i] in tof[i] for every i, and writes the velocities at
+/// r1 and r2 into v1[i] and v2[i]. Problems without a solution get NaN velocities.
+/// </summary>
+/// Nothing is allocated, so porkchop plots and the like can reuse their buffers. Every span has to be the same
+/// size.
+/// <param name="pool">The problems are split across the pool if it isn't null</param>
+void SolveBatch(std::span<const glm::dvec3> r1, std::span<const glm::dvec3> r2, std::span<const double> tof,
+                double mu, std::span<glm::dvec3> v1, std::span<glm::dvec3> v2, util::ThreadPool *pool = nullptr,
+                bool cw = false);
+
+/// How many problems each task of SolveBatch gets
+constexpr size_t batch_grain = 64;
 }  // namespace cqsp::core::systems::lambert
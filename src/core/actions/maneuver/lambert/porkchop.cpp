@@ -0,0 +1,101 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/actions/maneuver/lambert/porkchop.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "core/actions/maneuver/lambert/izzo.h"
+#include "core/util/threadpool.h"
+
+namespace cqsp::core::systems::lambert {
+namespace types = components::types;
+
+void ComputePorkchop(const types::Orbit& departure, const types::Orbit& arrival,
+                     std::span<const double> departure_times, std::span<const double> flight_times,
+                     std::span<double> delta_v, PorkchopBuffers& buffers, util::ThreadPool* pool) {
+    assert(delta_v.size() == departure_times.size() * flight_times.size());
+    const size_t rows = departure_times.size();
+    const size_t columns = flight_times.size();
+    buffers.r1.resize(delta_v.size());
+    buffers.r2.resize(delta_v.size());
+    buffers.tof.resize(delta_v.size());
+    buffers.v1.resize(delta_v.size());
+    buffers.v2.resize(delta_v.size());
+    buffers.departure_velocity.resize(rows);
+    buffers.arrival_velocity.resize(delta_v.size());
+
+    // Set up the problem of every cell, then solve them all in one batch
+    auto set_up_rows = [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+            // Every cell of the row leaves from the same place
+            const double leave = departure_times[row];
+            const glm::dvec3 r1 = types::OrbitTimeToVec3(departure, leave);
+            buffers.departure_velocity[row] = types::OrbitTimeToVelocityVec3(departure, leave);
+            for (size_t column = 0; column < columns; column++) {
+                const size_t cell = row * columns + column;
+                const double arrive = leave + flight_times[column];
+                buffers.r1[cell] = r1;
+                buffers.r2[cell] = types::OrbitTimeToVec3(arrival, arrive);
+                buffers.tof[cell] = flight_times[column];
+                buffers.arrival_velocity[cell] = types::OrbitTimeToVelocityVec3(arrival, arrive);
+            }
+        }
+    };
+    if (pool == nullptr) {
+        set_up_rows(0, rows);
+    } else {
+        pool->ParallelFor(0, rows, set_up_rows, 1);
+    }
+
+    SolveBatch(buffers.r1, buffers.r2, buffers.tof, departure.GM, buffers.v1, buffers.v2, pool);
+
+    for (size_t cell = 0; cell < delta_v.size(); cell++) {
+        const glm::dvec3& v1 = buffers.v1[cell];
+        // SolveBatch gives NaN velocities to the problems that have no solution
+        if (std::isnan(v1.x)) {
+            delta_v[cell] = std::numeric_limits<double>::infinity();
+            continue;
+        }
+        delta_v[cell] = glm::length(v1 - buffers.departure_velocity[cell / columns]) +
+                        glm::length(buffers.arrival_velocity[cell] - buffers.v2[cell]);
+    }
+}
+
+void ComputePorkchop(const types::Orbit& departure, const types::Orbit& arrival,
+                     std::span<const double> departure_times, std::span<const double> flight_times,
+                     std::span<double> delta_v, util::ThreadPool* pool) {
+    PorkchopBuffers buffers;
+    ComputePorkchop(departure, arrival, departure_times, flight_times, delta_v, buffers, pool);
+}
+
+TransferWindow BestTransfer(std::span<const double> departure_times, std::span<const double> flight_times,
+                            std::span<const double> delta_v) {
+    assert(delta_v.size() == departure_times.size() * flight_times.size());
+    TransferWindow best {.delta_v = std::numeric_limits<double>::infinity()};
+    for (size_t i = 0; i < delta_v.size(); i++) {
+        // NaN never compares less, so broken cells are skipped too
+        if (delta_v[i] < best.delta_v) {
+            best.departure = departure_times[i / flight_times.size()];
+            best.flight_time = flight_times[i % flight_times.size()];
+            best.delta_v = delta_v[i];
+        }
+    }
+    return best;
+}
+}  // namespace cqsp::core::systems::lambert
@@ -0,0 +1,78 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/components/orbit.h"
+
+namespace cqsp::core::util {
+class ThreadPool;
+}  // namespace cqsp::core::util
+
+namespace cqsp::core::systems::lambert {
+/// <summary>
+/// A transfer picked out of a porkchop plot
+/// </summary>
+struct TransferWindow {
+    double departure = 0;
+    double flight_time = 0;
+    /// Infinity if no cell of the plot had a transfer
+    double delta_v = 0;
+};
+
+/// <summary>
+/// The Lambert problems of a porkchop plot, one for each cell, which are solved with SolveBatch. Keep it around
+/// between plots of the same size so that nothing is allocated.
+/// </summary>
+struct PorkchopBuffers {
+    std::vector<glm::dvec3> r1;
+    std::vector<glm::dvec3> r2;
+    std::vector<double> tof;
+    std::vector<glm::dvec3> v1;
+    std::vector<glm::dvec3> v2;
+    /// Velocity of the departure orbit for each row, and of the arrival orbit for each cell
+    std::vector<glm::dvec3> departure_velocity;
+    std::vector<glm::dvec3> arrival_velocity;
+};
+
+/// <summary>
+/// Fills a porkchop plot of the transfer from `departure` to `arrival`, which have to orbit the same body.
+/// </summary>
+/// Every cell is the delta-v of the zero revolution transfer leaving at departure_times[i] and taking
+/// flight_times[j], written to delta_v[i * flight_times.size() + j]. The delta-v is the burn to leave the departure
+/// orbit plus the burn to match the arrival orbit. Cells that have no transfer are infinity.
+/// <param name="delta_v">Has to have departure_times.size() * flight_times.size() elements</param>
+/// <param name="pool">The rows and the Lambert problems are split across the pool if it isn't null</param>
+void ComputePorkchop(const components::types::Orbit& departure, const components::types::Orbit& arrival,
+                     std::span<const double> departure_times, std::span<const double> flight_times,
+                     std::span<double> delta_v, PorkchopBuffers& buffers, util::ThreadPool* pool = nullptr);
+
+/// Same as above, with buffers that are only kept for this plot
+void ComputePorkchop(const components::types::Orbit& departure, const components::types::Orbit& arrival,
+                     std::span<const double> departure_times, std::span<const double> flight_times,
+                     std::span<double> delta_v, util::ThreadPool* pool = nullptr);
+
+/// <summary>
+/// Gets the cheapest transfer out of a plot filled by ComputePorkchop
+/// </summary>
+TransferWindow BestTransfer(std::span<const double> departure_times, std::span<const double> flight_times,
+                            std::span<const double> delta_v);
+}  // namespace cqsp::core::systems::lambert
@@ -60,6 +60,12 @@ class NameGenerator {
 
     const std::string& GetName() { return name; }
 
+    /// For the game data cache, see core/util/save/binaryarchive.h. The random generator has to be set again.
+    template <typename Archive>
+    friend void Serialize(Archive& archive, NameGenerator& generator) {
+        archive.Fields(generator.syllables_list, generator.rule_list, generator.name);
+    }
+
  private:
     std::map<std::string, std::vector<std::string>> syllables_list;
     std::map<std::string, std::string> rule_list;
@@ -16,8 +16,11 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include <entt/entt.hpp>
@@ -44,49 +47,126 @@ inline bool operator<(const Order& lhs, const Order& rhs) { return lhs.price < r
 
 inline bool operator>(const Order& lhs, const Order& rhs) { return lhs.price > rhs.price; }
 
-template <class T>
-class SortedOrderList : public std::vector<Order> {
+/// <summary>
+/// One side of an order book. Orders are kept in price levels, and orders at the same price are filled in the
+/// order they came in.
+/// </summary>
+/// Better(a, b) is true if price a should be filled before price b, so the buy side is
+/// `PriceLevelBook<std::greater<double>>` (highest bid first) and the sell side is
+/// `PriceLevelBook<std::less<double>>` (lowest ask first).
+///
+/// The levels are kept in a flat vector from the worst price to the best price, so the best order is always at
+/// the back, and filling orders never moves the other levels around.
+template <typename Better>
+class PriceLevelBook {
  public:
-    using std::vector<Order>::vector;
     void put(const Order& order) {
-        SortedOrderList<T>::iterator it = std::lower_bound(begin(), end(), order, T());
-        insert(it, order);
+        auto level = levels.end();
+        // Most orders go in at or near the best price, so check that first
+        if (levels.empty() || levels.back().price != order.price) {
+            level = std::partition_point(levels.begin(), levels.end(),
+                                         [&order](const Level& level) { return Better()(order.price, level.price); });
+            if (level == levels.end() || level->price != order.price) {
+                level = levels.insert(level, Level {order.price, TakeSpareQueue(), 0});
+            }
+        } else {
+            level = levels.end() - 1;
+        }
+        level->orders.push_back(order);
+        order_count++;
+    }
+
+    bool empty() const { return levels.empty(); }
+
+    /// Number of orders, not levels
+    size_t size() const { return order_count; }
+
+    /// The order at the best price that came in first
+    Order& front() { return levels.back().orders[levels.back().head]; }
+    const Order& front() const { return levels.back().orders[levels.back().head]; }
+
+    void pop_front() {
+        Level& best = levels.back();
+        best.head++;
+        order_count--;
+        if (best.head == best.orders.size()) {
+            best.orders.clear();
+            spare_queues.push_back(std::move(best.orders));
+            levels.pop_back();
+        } else if (best.head > 32 && best.head * 2 > best.orders.size()) {
+            // Don't let a busy level grow forever
+            best.orders.erase(best.orders.begin(), best.orders.begin() + static_cast<std::ptrdiff_t>(best.head));
+            best.head = 0;
+        }
+    }
+
+    /// Calls function(order) for every order, in the order they would be filled
+    template <typename Function>
+    void ForEach(Function&& function) const {
+        for (auto level = levels.rbegin(); level != levels.rend(); level++) {
+            for (size_t i = level->head; i < level->orders.size(); i++) {
+                function(level->orders[i]);
+            }
+        }
+    }
+
+    size_t LevelCount() const { return levels.size(); }
+
+    void clear() {
+        levels.clear();
+        order_count = 0;
     }
+
+ private:
+    struct Level {
+        double price;
+        std::vector<Order> orders;
+        // Orders before this have been filled
+        size_t head;
+    };
+
+    std::vector<Order> TakeSpareQueue() {
+        if (spare_queues.empty()) {
+            return {};
+        }
+        std::vector<Order> queue = std::move(spare_queues.back());
+        spare_queues.pop_back();
+        return queue;
+    }
+
+    std::vector<Level> levels;
+    // Memory from levels that were emptied, so that new levels don't have to allocate
+    std::vector<std::vector<Order>> spare_queues;
+    size_t order_count = 0;
 };
 
 /// <summary>
-/// Greatest to smallest
+/// Buy orders, highest price first
 /// </summary>
-typedef SortedOrderList<std::greater<Order>> DescendingSortedOrderList;
+typedef PriceLevelBook<std::greater<double>> BuyOrderBook;
 
 /// <summary>
-/// Smallest to greatest
+/// Sell orders, lowest price first
 /// </summary>
-typedef SortedOrderList<std::less<Order>> AscendingSortedOrderList;
+typedef PriceLevelBook<std::less<double>> SellOrderBook;
 
 struct AuctionHouse {
-    std::map<entt::entity, DescendingSortedOrderList> sell_orders;
-    std::map<entt::entity, AscendingSortedOrderList> buy_orders;
+    std::map<entt::entity, SellOrderBook> sell_orders;
+    std::map<entt::entity, BuyOrderBook> buy_orders;
 
     void AddSellOrder(entt::entity good, Order&& order) { sell_orders[good].put(order); }
 
     void AddBuyOrder(entt::entity good, Order&& order) { buy_orders[good].put(order); }
 
     double GetDemand(entt::entity good) {
-        const AscendingSortedOrderList& buy_list = buy_orders[good];
         double demand = 0;
-        for (const Order& order : buy_list) {
-            demand += order.quantity;
-        }
+        buy_orders[good].ForEach([&demand](const Order& order) { demand += order.quantity; });
         return demand;
     }
 
     double GetSupply(entt::entity good) {
-        const DescendingSortedOrderList& sell_list = sell_orders[good];
         double supply = 0;
-        for (const Order& order : sell_list) {
-            supply += order.quantity;
-        }
+        sell_orders[good].ForEach([&supply](const Order& order) { supply += order.quantity; });
         return supply;
     }
 };
@@ -0,0 +1,82 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/bodyhierarchy.h"
+
+#include <cassert>
+
+namespace cqsp::core::components::bodies {
+uint32_t BodyHierarchy::push_back(entt::entity entity, uint32_t parent) {
+    assert(parent == npos || parent < size());
+    const uint32_t index = static_cast<uint32_t>(size());
+    entities.push_back(entity);
+    parents.push_back(parent);
+    position.emplace_back(0, 0, 0);
+    future_position.emplace_back(0, 0, 0);
+    center.emplace_back(0, 0, 0);
+    future_center.emplace_back(0, 0, 0);
+    SOI.push_back(0);
+    radius.push_back(0);
+
+    const auto id = static_cast<size_t>(entt::to_entity(entity));
+    if (id >= sparse.size()) {
+        sparse.resize(id + 1, npos);
+    }
+    sparse[id] = index;
+    return index;
+}
+
+void BodyHierarchy::clear() {
+    entities.clear();
+    parents.clear();
+    position.clear();
+    future_position.clear();
+    center.clear();
+    future_center.clear();
+    SOI.clear();
+    radius.clear();
+    sparse.clear();
+}
+
+uint32_t BodyHierarchy::IndexOf(entt::entity entity) const {
+    if (entity == entt::null) {
+        return npos;
+    }
+    const auto id = static_cast<size_t>(entt::to_entity(entity));
+    if (id >= sparse.size()) {
+        return npos;
+    }
+    // The id could have been reused by another entity
+    const uint32_t index = sparse[id];
+    return (index != npos && entities[index] == entity) ? index : npos;
+}
+
+void BodyHierarchy::ComputeCenters() {
+    // Parents come first, so their centers are always done by the time their children get to them
+    for (size_t i = 0; i < size(); i++) {
+        center[i] = position[i] + ParentCenter(i);
+        future_center[i] = future_position[i] + FutureParentCenter(i);
+    }
+}
+
+glm::dvec3 BodyHierarchy::ParentCenter(uint32_t index) const {
+    return (parents[index] == npos) ? glm::dvec3(0, 0, 0) : center[parents[index]];
+}
+
+glm::dvec3 BodyHierarchy::FutureParentCenter(uint32_t index) const {
+    return (parents[index] == npos) ? glm::dvec3(0, 0, 0) : future_center[parents[index]];
+}
+}  // namespace cqsp::core::components::bodies
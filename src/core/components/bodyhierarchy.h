@@ -0,0 +1,72 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+
+namespace cqsp::core::components::bodies {
+/// <summary>
+/// The tree of bodies under the star, flattened into arrays with every parent before its children, so that the
+/// centers can be worked out in one pass over the arrays.
+/// </summary>
+/// Positions are relative to the parent, centers are the positions relative to the star.
+struct BodyHierarchy {
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    std::vector<entt::entity> entities;
+    /// Index of the parent, or npos for the root
+    std::vector<uint32_t> parents;
+    std::vector<glm::dvec3> position;
+    std::vector<glm::dvec3> future_position;
+    std::vector<glm::dvec3> center;
+    std::vector<glm::dvec3> future_center;
+    std::vector<double> SOI;
+    std::vector<double> radius;
+
+    /// <summary>
+    /// Adds a body to the end of the hierarchy. The parent has to be added before it.
+    /// </summary>
+    /// <returns>Index of the body</returns>
+    uint32_t push_back(entt::entity entity, uint32_t parent);
+
+    size_t size() const { return entities.size(); }
+    bool empty() const { return entities.empty(); }
+    void clear();
+
+    /// <returns>npos if the entity isn't in the hierarchy</returns>
+    uint32_t IndexOf(entt::entity entity) const;
+    bool Contains(entt::entity entity) const { return IndexOf(entity) != npos; }
+
+    /// <summary>
+    /// Adds up the positions down the tree to get the centers
+    /// </summary>
+    void ComputeCenters();
+
+    /// Center of the parent of the body, or the origin for the root
+    glm::dvec3 ParentCenter(uint32_t index) const;
+    glm::dvec3 FutureParentCenter(uint32_t index) const;
+
+ private:
+    // Index of each entity, by entity id
+    std::vector<uint32_t> sparse;
+};
+}  // namespace cqsp::core::components::bodies
@@ -0,0 +1,204 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/conjunction.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "core/util/threadpool.h"
+
+namespace cqsp::core::components::types {
+namespace {
+// Neighbouring cubes that come after a cube, so that every pair of cubes is only looked at once
+constexpr std::array<std::array<int64_t, 3>, 13> forward_offsets = {{
+    {0, 0, 1},
+    {0, 1, -1},
+    {0, 1, 0},
+    {0, 1, 1},
+    {1, -1, -1},
+    {1, -1, 0},
+    {1, -1, 1},
+    {1, 0, -1},
+    {1, 0, 0},
+    {1, 0, 1},
+    {1, 1, -1},
+    {1, 1, 0},
+    {1, 1, 1},
+}};
+
+// How many cubes each task screens
+constexpr size_t block_size = 256;
+constexpr uint32_t empty_slot = static_cast<uint32_t>(-1);
+
+int64_t CellCoordinate(double position, double cell_size) {
+    // Anything this far out is broken anyway, but casting it would be undefined
+    return static_cast<int64_t>(std::clamp(std::floor(position / cell_size), -1e18, 1e18));
+}
+
+template <typename Cell>
+uint64_t HashCell(const Cell& cell) {
+    uint64_t hash = cell.group;
+    for (int64_t coordinate : {cell.x, cell.y, cell.z}) {
+        hash = (hash ^ static_cast<uint64_t>(coordinate)) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+}  // namespace
+
+void ConjunctionScreen::Screen(std::span<const glm::dvec3> positions, std::span<const uint32_t> groups,
+                               kilometer miss_distance, std::vector<CloseApproach>& approaches,
+                               util::ThreadPool* pool) {
+    assert(groups.empty() || groups.size() == positions.size());
+    approaches.clear();
+    cells.clear();
+    cell_begin.clear();
+    if (!(miss_distance > 0) || positions.empty()) {
+        return;
+    }
+
+    // Keep the table at most half full so that probes stay short
+    const size_t mask = std::bit_ceil(positions.size() * 2) - 1;
+    table.assign(mask + 1, empty_slot);
+    occupied.assign(std::max<size_t>(std::bit_ceil(positions.size() * 16) / 64, 1), 0);
+    point_cell.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        const glm::dvec3& position = positions[i];
+        if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z)) {
+            point_cell[i] = empty_slot;
+            continue;
+        }
+        Cell cell {groups.empty() ? 0 : groups[i], CellCoordinate(position.x, miss_distance),
+                   CellCoordinate(position.y, miss_distance), CellCoordinate(position.z, miss_distance)};
+        const uint64_t hash = HashCell(cell);
+        size_t slot = hash & mask;
+        while (table[slot] != empty_slot && cells[table[slot]] != cell) {
+            slot = (slot + 1) & mask;
+        }
+        if (table[slot] == empty_slot) {
+            table[slot] = static_cast<uint32_t>(cells.size());
+            cells.push_back(cell);
+            cell_begin.push_back(0);
+            const size_t bit = (hash >> 32) % (occupied.size() * 64);
+            occupied[bit / 64] |= uint64_t {1} << (bit % 64);
+        }
+        point_cell[i] = table[slot];
+        cell_begin[table[slot]]++;
+    }
+    if (cells.empty()) {
+        return;
+    }
+
+    // Turn the counts into where each cube starts, and then put the points in their cubes
+    uint32_t total = 0;
+    for (uint32_t& begin : cell_begin) {
+        total += std::exchange(begin, total);
+    }
+    cell_begin.push_back(total);
+    indices.resize(total);
+    grouped_positions.resize(total);
+    for (size_t i = 0; i < positions.size(); i++) {
+        if (point_cell[i] == empty_slot) {
+            continue;
+        }
+        const uint32_t index = cell_begin[point_cell[i]]++;
+        indices[index] = static_cast<uint32_t>(i);
+        grouped_positions[index] = positions[i];
+    }
+    // Filling moved every start to the start of the next cube
+    std::shift_right(cell_begin.begin(), cell_begin.end() - 1, 1);
+    cell_begin[0] = 0;
+
+    const size_t block_count = (cells.size() + block_size - 1) / block_size;
+    if (block_approaches.size() < block_count) {
+        block_approaches.resize(block_count);
+    }
+    auto screen_blocks = [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; block++) {
+            block_approaches[block].clear();
+            ScreenCells(block * block_size, std::min(cells.size(), (block + 1) * block_size), miss_distance,
+                        block_approaches[block]);
+        }
+    };
+    if (pool == nullptr) {
+        screen_blocks(0, block_count);
+    } else {
+        pool->ParallelFor(0, block_count, screen_blocks, 1);
+    }
+    for (size_t block = 0; block < block_count; block++) {
+        approaches.insert(approaches.end(), block_approaches[block].begin(), block_approaches[block].end());
+    }
+    std::sort(approaches.begin(), approaches.end(), [](const CloseApproach& first, const CloseApproach& second) {
+        return std::tie(first.first, first.second) < std::tie(second.first, second.second);
+    });
+}
+
+size_t ConjunctionScreen::Find(const Cell& cell) const {
+    const uint64_t hash = HashCell(cell);
+    const size_t bit = (hash >> 32) % (occupied.size() * 64);
+    if ((occupied[bit / 64] & (uint64_t {1} << (bit % 64))) == 0) {
+        return npos;
+    }
+    const size_t mask = table.size() - 1;
+    for (size_t slot = hash & mask; table[slot] != empty_slot; slot = (slot + 1) & mask) {
+        if (cells[table[slot]] == cell) {
+            return table[slot];
+        }
+    }
+    return npos;
+}
+
+void ConjunctionScreen::ScreenCells(size_t begin, size_t end, double miss_distance,
+                                    std::vector<CloseApproach>& approaches) const {
+    const double miss_distance2 = miss_distance * miss_distance;
+    auto check = [&](uint32_t first, uint32_t second) {
+        const glm::dvec3 difference = grouped_positions[first] - grouped_positions[second];
+        const double distance2 = glm::dot(difference, difference);
+        if (distance2 <= miss_distance2) {
+            approaches.push_back(CloseApproach {std::min(indices[first], indices[second]),
+                                                std::max(indices[first], indices[second]), std::sqrt(distance2)});
+        }
+    };
+    for (size_t c = begin; c < end; c++) {
+        const Cell& cell = cells[c];
+        // Same cube
+        for (uint32_t i = cell_begin[c]; i < cell_begin[c + 1]; i++) {
+            for (uint32_t j = i + 1; j < cell_begin[c + 1]; j++) {
+                check(i, j);
+            }
+        }
+        for (const auto& offset : forward_offsets) {
+            size_t other = Find(Cell {cell.group, cell.x + offset[0], cell.y + offset[1], cell.z + offset[2]});
+            if (other == npos) {
+                continue;
+            }
+            for (uint32_t i = cell_begin[c]; i < cell_begin[c + 1]; i++) {
+                for (uint32_t j = cell_begin[other]; j < cell_begin[other + 1]; j++) {
+                    check(i, j);
+                }
+            }
+        }
+    }
+}
+}  // namespace cqsp::core::components::types
@@ -0,0 +1,114 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+
+#include "core/components/units.h"
+
+namespace cqsp::core::util {
+class ThreadPool;
+}  // namespace cqsp::core::util
+
+namespace cqsp::core::components::types {
+/// <summary>
+/// Two points of a screen that are inside the miss distance. first is always less than second.
+/// </summary>
+struct CloseApproach {
+    uint32_t first;
+    uint32_t second;
+    kilometer distance;
+};
+
+/// <summary>
+/// Finds every pair of points that are closer than a miss distance with a uniform spatial hash, so that it doesn't
+/// have to check every pair.
+/// </summary>
+/// The points are hashed into cubes as large as the miss distance, so every pair that is close enough is either
+/// in the same cube or in neighbouring cubes. Points are only compared to points in the same group, which is meant
+/// for points that are relative to different bodies.
+///
+/// The buffers are kept between screens, so screening every tick doesn't allocate once they are big enough.
+class ConjunctionScreen {
+ public:
+    /// <param name="positions">Positions of the points, in km</param>
+    /// <param name="groups">Group of each point, or empty if they are all in the same group</param>
+    /// <param name="approaches">Cleared, and filled with the pairs sorted by first and then second</param>
+    /// <param name="pool">The cubes are split across the pool if it isn't null</param>
+    void Screen(std::span<const glm::dvec3> positions, std::span<const uint32_t> groups, kilometer miss_distance,
+                std::vector<CloseApproach>& approaches, util::ThreadPool* pool = nullptr);
+
+ private:
+    struct Cell {
+        uint32_t group;
+        int64_t x;
+        int64_t y;
+        int64_t z;
+
+        bool operator==(const Cell&) const = default;
+    };
+
+    size_t Find(const Cell& cell) const;
+    void ScreenCells(size_t begin, size_t end, double miss_distance, std::vector<CloseApproach>& approaches) const;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // The cubes that have points in them, in the order that they were first seen
+    std::vector<Cell> cells;
+    // Where the points of each cube start in indices and grouped_positions
+    std::vector<uint32_t> cell_begin;
+    // Cube of each point
+    std::vector<uint32_t> point_cell;
+    // Points grouped by their cube, so that the points of a cube are next to each other
+    std::vector<uint32_t> indices;
+    std::vector<glm::dvec3> grouped_positions;
+    // Open addressing table from a cube to its index in cells
+    std::vector<uint32_t> table;
+    // One bit per hash of the cubes in the table. Most neighbouring cubes are empty, and this is small enough to
+    // stay in cache, so it answers most lookups without going to the table.
+    std::vector<uint64_t> occupied;
+    // Approaches found by each block of cubes, which are put together in order
+    std::vector<std::vector<CloseApproach>> block_approaches;
+};
+
+/// <summary>
+/// Two orbiting objects that are closer than the miss distance
+/// </summary>
+struct Conjunction {
+    entt::entity object;
+    entt::entity other;
+    kilometer distance;
+    /// When the objects first came inside the miss distance, so conjunctions that start this tick have the
+    /// current time
+    second start;
+};
+
+/// <summary>
+/// Conjunctions found by SysConjunction, kept in the universe context.
+/// </summary>
+struct Conjunctions {
+    kilometer miss_distance = 10;
+    /// Sorted by object and then other
+    std::vector<Conjunction> conjunctions;
+};
+}  // namespace cqsp::core::components::types
@@ -0,0 +1,188 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/ephemeris.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "core/util/threadpool.h"
+
+namespace cqsp::core::components::types {
+namespace {
+bool SameChain(const std::vector<Orbit>& first, const std::vector<Orbit>& second) {
+    return std::equal(first.begin(), first.end(), second.begin(), second.end(), SameElements);
+}
+
+// Sum of c[i] * T_i(x), with Clenshaw's recurrence
+glm::dvec3 EvaluateChebyshev(const std::array<glm::dvec3, EphemerisSegment::coefficient_count>& coefficients,
+                             double x) {
+    glm::dvec3 next(0, 0, 0);
+    glm::dvec3 after_next(0, 0, 0);
+    for (size_t i = coefficients.size() - 1; i > 0; i--) {
+        glm::dvec3 current = coefficients[i] + next * (2 * x) - after_next;
+        after_next = next;
+        next = current;
+    }
+    return coefficients[0] + next * x - after_next;
+}
+}  // namespace
+
+EphemerisState GetChainState(const std::vector<Orbit>& chain, second time) {
+    EphemerisState state;
+    for (const Orbit& orbit : chain) {
+        if (orbit.semi_major_axis == 0) {
+            continue;
+        }
+        const double v = GetTrueAnomaly(orbit, time);
+        state.position += toVec3(orbit, v);
+        state.velocity += OrbitVelocityToVec3(orbit, v);
+    }
+    return state;
+}
+
+EphemerisSegment EphemerisSegment::Fit(const std::vector<Orbit>& chain, double start, double end) {
+    constexpr size_t n = coefficient_count;
+    EphemerisSegment segment;
+    segment.start = start;
+    segment.end = end;
+
+    std::array<EphemerisState, n> samples;
+    for (size_t k = 0; k < n; k++) {
+        const double x = std::cos(PI * (k + 0.5) / n);
+        samples[k] = GetChainState(chain, (start + end) / 2 + x * (end - start) / 2);
+    }
+    for (size_t j = 0; j < n; j++) {
+        glm::dvec3 position(0, 0, 0);
+        glm::dvec3 velocity(0, 0, 0);
+        for (size_t k = 0; k < n; k++) {
+            const double weight = std::cos(PI * j * (k + 0.5) / n);
+            position += samples[k].position * weight;
+            velocity += samples[k].velocity * weight;
+        }
+        // The first coefficient is halved, so that evaluating is a plain sum
+        const double scale = (j == 0 ? 1.0 : 2.0) / n;
+        segment.position[j] = position * scale;
+        segment.velocity[j] = velocity * scale;
+    }
+    return segment;
+}
+
+EphemerisState EphemerisSegment::Evaluate(second time) const {
+    const double x = (2 * time - (start + end)) / (end - start);
+    return EphemerisState {EvaluateChebyshev(position, x), EvaluateChebyshev(velocity, x)};
+}
+
+BodyEphemeris::BodyEphemeris(std::vector<Orbit> _chain) : chain(std::move(_chain)) {
+    double shortest_period = std::numeric_limits<double>::infinity();
+    for (const Orbit& orbit : chain) {
+        if (orbit.semi_major_axis == 0) {
+            continue;
+        }
+        if (orbit.eccentricity >= 1 || orbit.semi_major_axis < 0) {
+            // Not periodic, so just compute it every time
+            shortest_period = std::numeric_limits<double>::infinity();
+            break;
+        }
+        shortest_period = std::min(shortest_period, orbit.T());
+    }
+    if (std::isfinite(shortest_period) && shortest_period > 0) {
+        segment_length = shortest_period / 8;
+    }
+}
+
+int64_t BodyEphemeris::SegmentIndex(second time) const {
+    return static_cast<int64_t>(std::floor(time / segment_length));
+}
+
+EphemerisState BodyEphemeris::Get(second time) {
+    if (segment_length == 0) {
+        return GetChainState(chain, time);
+    }
+    const int64_t index = SegmentIndex(time);
+    {
+        // Evaluate while holding the lock, because Keep can drop the segment at any time
+        std::lock_guard lock(mutex);
+        auto it = segments.find(index);
+        if (it != segments.end()) {
+            return it->second.Evaluate(time);
+        }
+    }
+    EphemerisSegment segment = FitSegment(index);
+    std::lock_guard lock(mutex);
+    return segments.try_emplace(index, segment).first->second.Evaluate(time);
+}
+
+void BodyEphemeris::Fit(int64_t index) {
+    if (segment_length == 0 || HasSegment(index)) {
+        return;
+    }
+    // Fit without holding the lock, so that other threads can still read the other segments.
+    // If two threads fit the same segment at once they get the same result, so it doesn't matter which one wins.
+    EphemerisSegment segment = FitSegment(index);
+    std::lock_guard lock(mutex);
+    segments.try_emplace(index, segment);
+}
+
+bool BodyEphemeris::HasSegment(int64_t index) {
+    std::lock_guard lock(mutex);
+    return segments.contains(index);
+}
+
+void BodyEphemeris::Keep(int64_t first, int64_t last) {
+    std::lock_guard lock(mutex);
+    std::erase_if(segments, [first, last](const auto& pair) { return pair.first < first || pair.first > last; });
+}
+
+EphemerisSegment BodyEphemeris::FitSegment(int64_t index) const {
+    return EphemerisSegment::Fit(chain, static_cast<double>(index) * segment_length,
+                                 static_cast<double>(index + 1) * segment_length);
+}
+
+void Ephemeris::SetChain(entt::entity body, const std::vector<Orbit>& chain) {
+    auto it = bodies.find(body);
+    if (it != bodies.end() && SameChain(it->second->GetChain(), chain)) {
+        return;
+    }
+    bodies[body] = std::make_shared<BodyEphemeris>(chain);
+}
+
+EphemerisState Ephemeris::Get(entt::entity body, second time) const { return bodies.at(body)->Get(time); }
+
+void Ephemeris::Refresh(second time, util::ThreadPool* pool) {
+    for (auto& [entity, body] : bodies) {
+        if (body->SegmentLength() == 0) {
+            continue;
+        }
+        const int64_t index = body->SegmentIndex(time);
+        body->Keep(index - 1, index + segments_ahead);
+        if (body->HasSegment(index + 1) || body->refreshing.exchange(true)) {
+            continue;
+        }
+        if (pool == nullptr) {
+            body->Fit(index + 1);
+            body->refreshing = false;
+            continue;
+        }
+        pool->Submit([body = body, index]() {
+            body->Fit(index + 1);
+            body->refreshing = false;
+        });
+    }
+}
+}  // namespace cqsp::core::components::types
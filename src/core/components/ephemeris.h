@@ -0,0 +1,150 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+
+#include "core/components/orbit.h"
+#include "core/components/units.h"
+
+namespace cqsp::core::util {
+class ThreadPool;
+}  // namespace cqsp::core::util
+
+namespace cqsp::core::components::types {
+/// <summary>
+/// Position and velocity relative to the star
+/// </summary>
+struct EphemerisState {
+    glm::dvec3 position {0, 0, 0};
+    glm::dvec3 velocity {0, 0, 0};
+};
+
+/// <summary>
+/// State of a body relative to the star, by adding up the states of every orbit in the chain.
+/// </summary>
+/// <param name="chain">The orbit of the body first, then the orbit of its parent, and so on up to the star</param>
+EphemerisState GetChainState(const std::vector<Orbit>& chain, second time);
+
+/// <summary>
+/// Chebyshev polynomials that approximate a body's state over [start, end]
+/// </summary>
+struct EphemerisSegment {
+    static constexpr size_t coefficient_count = 11;
+
+    double start = 0;
+    double end = 0;
+    std::array<glm::dvec3, coefficient_count> position;
+    std::array<glm::dvec3, coefficient_count> velocity;
+
+    /// <summary>
+    /// Interpolates the chain at the Chebyshev nodes of [start, end]
+    /// </summary>
+    static EphemerisSegment Fit(const std::vector<Orbit>& chain, double start, double end);
+
+    /// Only accurate inside of [start, end]
+    EphemerisState Evaluate(second time) const;
+};
+
+/// <summary>
+/// The fitted segments of one body. Segment i covers [i * SegmentLength(), (i + 1) * SegmentLength()), and
+/// segments are fitted the first time that they are needed, so any time can be asked for.
+/// </summary>
+/// Every function can be called from any thread.
+class BodyEphemeris {
+ public:
+    explicit BodyEphemeris(std::vector<Orbit> chain);
+
+    const std::vector<Orbit>& GetChain() const { return chain; }
+
+    /// <summary>
+    /// An eighth of the shortest period in the chain, so that the polynomials are accurate to well under a meter.
+    /// 0 if the chain can't be fitted, because one of the orbits isn't elliptic.
+    /// </summary>
+    double SegmentLength() const { return segment_length; }
+
+    int64_t SegmentIndex(second time) const;
+
+    EphemerisState Get(second time);
+
+    /// Fits the segment if it isn't there yet
+    void Fit(int64_t index);
+    bool HasSegment(int64_t index);
+
+    /// Drops every segment outside of [first, last]
+    void Keep(int64_t first, int64_t last);
+
+    /// Set while the next segment is being fitted in the background
+    std::atomic<bool> refreshing = false;
+
+ private:
+    EphemerisSegment FitSegment(int64_t index) const;
+
+    std::vector<Orbit> chain;
+    double segment_length = 0;
+
+    std::mutex mutex;
+    std::unordered_map<int64_t, EphemerisSegment> segments;
+};
+
+/// <summary>
+/// Ephemerides of the natural bodies, which follow fixed orbits. Kept in the universe context by SysOrbit, which
+/// keeps the orbits up to date with SetChain and calls Refresh every tick.
+/// </summary>
+/// Getting the state of a body is one polynomial evaluation per body instead of solving Kepler's equation for
+/// the body and every one of its parents.
+class Ephemeris {
+ public:
+    /// <summary>
+    /// Sets the orbits that the body follows. Nothing happens if they are the same as the ones it already had,
+    /// otherwise the old segments are thrown away.
+    /// </summary>
+    void SetChain(entt::entity body, const std::vector<Orbit>& chain);
+
+    bool Contains(entt::entity body) const { return bodies.contains(body); }
+
+    /// <summary>
+    /// State of the body relative to the star. The body has to have a chain.
+    /// </summary>
+    EphemerisState Get(entt::entity body, second time) const;
+    glm::dvec3 GetPosition(entt::entity body, second time) const { return Get(body, time).position; }
+
+    /// <summary>
+    /// Drops the segments that have been passed, and fits the next segment of each body on the pool, so that it
+    /// is ready by the time the date gets there.
+    /// </summary>
+    /// <param name="pool">If it is null, the next segments are fitted straight away</param>
+    void Refresh(second time, util::ThreadPool* pool);
+
+    /// How many segments past the current one are kept around, for things like transfer planning
+    static constexpr int64_t segments_ahead = 64;
+
+ private:
+    // Shared so that the background tasks keep the body alive
+    std::unordered_map<entt::entity, std::shared_ptr<BodyEphemeris>> bodies;
+};
+}  // namespace cqsp::core::components::types
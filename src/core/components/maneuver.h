@@ -16,9 +16,14 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <deque>
+#include <functional>
 #include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
 
 #include "core/components/coordinates.h"
 
@@ -64,4 +69,35 @@ struct CommandQueue {
     bool empty() { return maneuvers.empty(); }
     entt::entity& front() { return commands.front(); }
 };
+
+/// <summary>
+/// Times of the maneuvers in every CommandQueue, soonest first, so that only the ships that have a maneuver due
+/// have to be looked at. Kept in the universe context, use commands::GetManeuverSchedule to get it.
+/// </summary>
+/// Entries aren't removed when the maneuver goes away, so anything that is popped has to be checked against the
+/// CommandQueue again.
+struct ManeuverSchedule {
+    void Push(entt::entity entity, double time) {
+        heap.emplace_back(time, entity);
+        std::push_heap(heap.begin(), heap.end(), std::greater<>());
+    }
+
+    /// <summary>
+    /// Pops every entity that has a maneuver at or before the time
+    /// </summary>
+    void PopDue(double time, std::vector<entt::entity>& due) {
+        while (!heap.empty() && heap.front().first <= time) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+            due.push_back(heap.back().second);
+            heap.pop_back();
+        }
+    }
+
+    size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+    void clear() { heap.clear(); }
+
+ private:
+    std::vector<std::pair<double, entt::entity>> heap;
+};
 }  // namespace cqsp::core::components
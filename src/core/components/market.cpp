@@ -30,15 +30,17 @@ std::pair<double, double> Market::PurchaseFromMarket(const ResourceVector& input
     return std::make_pair(cost, tax_cost);
 }
 
-std::pair<double, double> Market::PurchaseFromMarket(const ResourceConsumption& input) {
+std::pair<double, double> Market::PurchaseFromMarket(const SparseLedger& input) {
     double cost = 0;
 
     double tax_cost = 0;
-    for (auto& [good, amount] : input) {
+    for (size_t i = 0; i < input.size(); i++) {
+        const GoodEntity good = input.GoodAt(i);
+        const double amount = input.ValueAt(i);
         tax_cost += taxation[good] * price[good] * amount;
         cost += price[good] * amount;
+        consumption[good] += amount;
     }
-    consumption += input;
     return std::make_pair(cost, tax_cost);
 }
 }  // namespace cqsp::core::components
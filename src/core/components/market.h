@@ -24,6 +24,7 @@
 #include <entt/entt.hpp>
 
 #include "core/components/resource.h"
+#include "core/components/resourceexpression.h"
 
 namespace cqsp::core::components {
 struct MarketOrder {
@@ -35,11 +36,13 @@ struct MarketOrder {
     double amount;
     double price;
 
+    MarketOrder() = default;
     MarketOrder(entt::entity target, double amount, double price) : target(target), amount(amount), price(price) {}
 };
 
 // A planetary market must have a regular market as well
 struct PlanetaryMarket {
+    PlanetaryMarket() : PlanetaryMarket(0) {}
     explicit PlanetaryMarket(size_t good_count) : supplied_resources(good_count), supply_difference(good_count) {}
     std::map<entt::entity, std::vector<MarketOrder>> demands;
     std::map<entt::entity, std::vector<MarketOrder>> requests;
@@ -49,6 +52,8 @@ struct PlanetaryMarket {
 };
 
 struct Market {
+    // Only for loading saves, the ledgers are resized when they are read
+    Market() : Market(0) {}
     Market(size_t good_count)
         : demand(good_count),
           supply(good_count),
@@ -110,7 +115,23 @@ struct Market {
     double last_trade_deficit = 0;
 
     std::pair<double, double> PurchaseFromMarket(const ResourceVector& input);
-    std::pair<double, double> PurchaseFromMarket(const ResourceConsumption& input);
+    std::pair<double, double> PurchaseFromMarket(const SparseLedger& input);
+
+    /// <summary>
+    /// Same as above, but for lazy expressions (see resourceexpression.h), so the input never has to be
+    /// put into a container.
+    /// </summary>
+    template <expr::SparseExpression Input>
+    std::pair<double, double> PurchaseFromMarket(const Input& input) {
+        double cost = 0;
+        double tax_cost = 0;
+        input.ForEach([&](GoodEntity good, double amount) {
+            tax_cost += taxation[good] * price[good] * amount;
+            cost += price[good] * amount;
+            consumption[good] += amount;
+        });
+        return std::make_pair(cost, tax_cost);
+    }
 };
 
 /// <summary>
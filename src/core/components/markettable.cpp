@@ -0,0 +1,72 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/markettable.h"
+
+#include <spdlog/spdlog.h>
+
+namespace cqsp::core::components {
+MarketTable::MarketTable(size_t good_count, size_t capacity) : good_count(good_count), capacity(capacity) {
+    for (auto& array : values) {
+        array.resize(good_count * capacity, 0.0);
+    }
+}
+
+size_t MarketTable::LedgerIndex(ResourceLedger Market::*ledger) {
+    for (size_t i = 0; i < ledgers.size(); i++) {
+        if (ledgers[i] == ledger) {
+            return i;
+        }
+    }
+    SPDLOG_ERROR("Ledger is not part of the market table");
+    return 0;
+}
+
+size_t MarketTable::Attach(Market& market) {
+    if (row_count == capacity) {
+        SPDLOG_WARN("Market table is full ({} markets), market will keep its own ledgers", capacity);
+        return npos;
+    }
+    for (auto ledger : ledgers) {
+        if ((market.*ledger).size() != good_count) {
+            SPDLOG_WARN("Market has {} goods instead of {}, not adding it to the table", (market.*ledger).size(),
+                        good_count);
+            return npos;
+        }
+    }
+    const size_t row = row_count++;
+    for (size_t i = 0; i < ledgers.size(); i++) {
+        (market.*ledgers[i]).Bind(values[i].data() + row * good_count);
+    }
+    return row;
+}
+
+size_t MarketTable::RowOf(const Market& market) const {
+    // All of the ledgers move together, so checking one is enough
+    const double* begin = values[0].data();
+    const double* position = (market.*ledgers[0]).data();
+    if (good_count == 0 || position < begin || position >= begin + row_count * good_count) {
+        return npos;
+    }
+    return static_cast<size_t>(position - begin) / good_count;
+}
+
+double* MarketTable::Values(ResourceLedger Market::*ledger) { return values[LedgerIndex(ledger)].data(); }
+
+const double* MarketTable::Values(ResourceLedger Market::*ledger) const {
+    return values[LedgerIndex(ledger)].data();
+}
+}  // namespace cqsp::core::components
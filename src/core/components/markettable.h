@@ -0,0 +1,89 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "core/components/market.h"
+#include "core/components/resourceledger.h"
+
+namespace cqsp::core::components {
+/// <summary>
+/// Keeps the ledgers of many markets next to each other.
+/// </summary>
+/// Every ledger of a `Market` (supply, demand, price and so on) gets its own [market x good] array, and each
+/// market that is attached gets a row in all of them. The market's ledgers are bound to the row (see
+/// `ResourceLedger::Bind`), so the market can be used the same way as before, while systems that work on every
+/// market can go through one array instead of jumping between the ledgers of each market.
+///
+/// The rows are allocated up front, so attaching a market never moves the rows that are already there.
+/// The table has to outlive the markets attached to it.
+class MarketTable {
+ public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    MarketTable(size_t good_count, size_t capacity);
+
+    MarketTable(const MarketTable&) = delete;
+    MarketTable(MarketTable&&) noexcept = default;
+    MarketTable& operator=(const MarketTable&) = delete;
+    MarketTable& operator=(MarketTable&&) noexcept = default;
+
+    /// <summary>
+    /// Moves the values of all of the market's ledgers into a new row, and binds them to it.
+    /// </summary>
+    /// <returns>The row, or npos if the table is full or the market doesn't have the same goods</returns>
+    size_t Attach(Market& market);
+
+    /// Row that the market is bound to, or npos if it isn't in this table
+    size_t RowOf(const Market& market) const;
+
+    /// Start of the [market x good] array of that ledger, row r starts at r * GoodCount()
+    double* Values(ResourceLedger Market::*ledger);
+    const double* Values(ResourceLedger Market::*ledger) const;
+
+    double* Row(ResourceLedger Market::*ledger, size_t row) { return Values(ledger) + row * good_count; }
+    const double* Row(ResourceLedger Market::*ledger, size_t row) const { return Values(ledger) + row * good_count; }
+
+    size_t GoodCount() const { return good_count; }
+    size_t RowCount() const { return row_count; }
+    size_t Capacity() const { return capacity; }
+
+ private:
+    static constexpr std::array<ResourceLedger Market::*, 11> ledgers = {
+        &Market::demand,
+        &Market::supply,
+        &Market::sd_ratio,
+        &Market::volume,
+        &Market::price,
+        &Market::chronic_shortages,
+        &Market::trade,
+        &Market::production,
+        &Market::consumption,
+        &Market::market_access,
+        &Market::taxation,
+    };
+
+    static size_t LedgerIndex(ResourceLedger Market::*ledger);
+
+    size_t good_count;
+    size_t capacity;
+    size_t row_count = 0;
+    std::array<std::vector<double>, ledgers.size()> values;
+};
+}  // namespace cqsp::core::components
@@ -17,7 +17,9 @@
 #include "core/components/orbit.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -45,6 +47,34 @@ glm::dvec3 MatrixConvertOrbParams(const double LAN, const double i, const double
                       vec.x * (sin(LAN) * sin(i)) + vec.y * (cos(w) * sin(i)));
 }
 
+OrbitRotation GetOrbitRotation(const radian LAN, const radian i, const radian w) {
+    const double cos_lan = std::cos(LAN);
+    const double sin_lan = std::sin(LAN);
+    const double cos_i = std::cos(i);
+    const double sin_i = std::sin(i);
+    const double cos_w = std::cos(w);
+    const double sin_w = std::sin(w);
+    return OrbitRotation {
+        glm::dvec3(cos_lan * cos_w - sin_lan * cos_i * sin_w, sin_lan * cos_w + cos_lan * cos_i * sin_w, sin_i * sin_w),
+        glm::dvec3(-cos_lan * sin_w - sin_lan * cos_i * cos_w, -sin_lan * sin_w + cos_lan * cos_i * cos_w,
+                   sin_i * cos_w),
+        glm::dvec3(sin_lan * sin_i, -cos_lan * sin_i, cos_i)};
+}
+
+void Orbit::UpdateRotation() {
+    rotation = GetOrbitRotation(LAN, inclination, w);
+    rotation_elements = glm::dvec3(LAN, inclination, w);
+}
+
+OrbitRotation Orbit::GetRotation() const {
+    if (rotation_elements == glm::dvec3(LAN, inclination, w)) {
+        return rotation;
+    }
+    // Something changed the elements without updating the cache. Don't write to it here, because orbits are read
+    // from many threads at once.
+    return GetOrbitRotation(LAN, inclination, w);
+}
+
 glm::dvec3 ConvertOrbParams(const double LAN, const double i, const double w, const glm::dvec3& vec) {
     return glm::dquat {glm::dvec3(0, 0, LAN)} * glm::dquat {glm::dvec3(i, 0, 0)} * glm::dquat {glm::dvec3(0, 0, w)} *
            vec;
@@ -91,7 +121,11 @@ Orbit Vec3ToOrbit(const glm::dvec3& position, const glm::dvec3& velocity, const
     const auto n = glm::dvec3(-h.y, h.x, 0);
 
     // True anomaly
-    double v = glm::angle(glm::normalize(ecc_v), glm::normalize(position));  //acos(std::clamp(m, -1., 1.));
+    // atan2 rather than acos, because acos loses half of the digits close to the periapsis
+    const glm::dvec3 ecc_direction = glm::normalize(ecc_v);
+    const glm::dvec3 position_direction = glm::normalize(position);
+    double v = std::atan2(glm::length(glm::cross(ecc_direction, position_direction)),
+                          glm::dot(ecc_direction, position_direction));
     if (glm::dot(position, velocity) < 0) v = TWOPI - v;
 
     // Inclination
@@ -155,6 +189,7 @@ Orbit Vec3ToOrbit(const glm::dvec3& position, const glm::dvec3& velocity, const
     orb.epoch = time;
     orb.v = normalize_radian(v);
     orb.GM = GM;
+    orb.UpdateRotation();
     return orb;
 }
 
@@ -174,6 +209,17 @@ glm::dvec3 OrbitToVec3(const double& a, const double& e, const radian& i, const
            ConvertToOrbitalVector(LAN, i, w, 0, glm::dvec3(cos(v) / (1 + e * cos(v)), sin(v) / (1 + e * cos(v)), 0));
 }
 
+glm::dvec3 OrbitToVec3(const Orbit& orb, const radian& v) {
+    if (orb.semi_major_axis == 0) {
+        return glm::dvec3(0, 0, 0);
+    }
+    const double e = orb.eccentricity;
+    const double cos_v = std::cos(v);
+    const double radius = orb.semi_major_axis * (1 - e * e) / (1 + e * cos_v);
+    const OrbitRotation rotation = orb.GetRotation();
+    return rotation.p * (radius * cos_v) + rotation.q * (radius * std::sin(v));
+}
+
 double OrbitVelocity(const double v, const double e, const double a, const double GM) {
     double r = GetOrbitingRadius(e, a, v);
     double sma = a;
@@ -190,8 +236,8 @@ glm::dvec3 OrbitVelocityToVec3(const Orbit& orb, double v) {
     // Return
     double semi_param = orb.semi_major_axis * (1 - orb.eccentricity * orb.eccentricity);
 
-    return sqrt(orb.GM / semi_param) *
-           ConvertOrbParams(orb.LAN, orb.inclination, orb.w, glm::dvec3(-sin(v), (orb.eccentricity + cos(v)), 0));
+    const OrbitRotation rotation = orb.GetRotation();
+    return sqrt(orb.GM / semi_param) * (rotation.p * -sin(v) + rotation.q * (orb.eccentricity + cos(v)));
 }
 
 glm::dvec3 OrbitVelocityToVec3(const Orbit& orb) { return OrbitVelocityToVec3(orb, orb.v); }
@@ -236,6 +282,95 @@ double SolveKeplerHyperbolic(const double& mean_anomaly, const double& ecc, cons
     return ea;
 }
 
+namespace {
+std::atomic<KeplerSolver> kepler_solver = KeplerSolver::Fast;
+
+// Stop refining once a step is this small. The steps are fifth order, so the next one would be below machine
+// precision. Markley's starting guess is always closer than this, so elliptic orbits only take one step.
+constexpr double elliptic_stop = 1.0E-3;
+constexpr double hyperbolic_stop = 1.0E-4;
+}  // namespace
+
+// F. Landis Markley, Kepler Equation Solver, Celestial Mechanics and Dynamical Astronomy 63 (1995)
+double SolveKeplerEllipticFast(double mean_anomaly, double ecc) {
+    // Solve for M in [0, pi], then move it back to where it was
+    const double reduced = std::remainder(mean_anomaly, TWOPI);
+    const double offset = mean_anomaly - reduced;
+    const double M = std::abs(reduced);
+    if (M == 0 || ecc < 1.0E-9) {
+        return mean_anomaly;
+    }
+
+    const double alpha = (3 * PI * PI + 1.6 * PI * (PI - M) / (1 + ecc)) / (PI * PI - 6);
+    const double d = 3 * (1 - ecc) + alpha * ecc;
+    const double q = 2 * alpha * d * (1 - ecc) - M * M;
+    const double r = 3 * alpha * d * (d - 1 + ecc) * M + M * M * M;
+    const double w_root = std::cbrt(std::abs(r) + std::sqrt(q * q * q + r * r));
+    const double w = w_root * w_root;
+    double E = (2 * r * w / (w * w + w * q + q * q) + M) / d;
+
+    for (int step = 0; step < 3; step++) {
+        const double e_sin = ecc * std::sin(E);
+        const double e_cos = ecc * std::cos(E);
+        const double f0 = E - e_sin - M;
+        const double f1 = 1 - e_cos;
+        const double d3 = -f0 / (f1 - 0.5 * f0 * e_sin / f1);
+        const double d4 = -f0 / (f1 + 0.5 * d3 * e_sin + d3 * d3 * e_cos / 6);
+        const double d5 = -f0 / (f1 + 0.5 * d4 * e_sin + d4 * d4 * e_cos / 6 - d4 * d4 * d4 * e_sin / 24);
+        E += d5;
+        if (!(std::abs(d5) >= elliptic_stop)) {
+            break;
+        }
+    }
+    return std::copysign(E, reduced) + offset;
+}
+
+double SolveKeplerHyperbolicFast(double mean_anomaly, double ecc) {
+    const double M = std::abs(mean_anomaly);
+    if (M == 0) {
+        return 0;
+    }
+    // For small H, M ~ (e - 1) H + e H^3 / 6, which is a cubic that can be solved directly.
+    // It overshoots for big H, where e sinh(H) ~ e exp(H) / 2 ~ M is closer.
+    const double p = 2 * (ecc - 1) / ecc;
+    const double q = 3 * M / ecc;
+    const double root = std::sqrt(q * q + p * p * p);
+    double H = std::min(std::cbrt(q + root) + std::cbrt(q - root), std::log(2 * M / ecc + 1.8));
+
+    for (int step = 0; step < 3; step++) {
+        const double e_sinh = ecc * std::sinh(H);
+        const double e_cosh = ecc * std::cosh(H);
+        const double f0 = e_sinh - H - M;
+        const double f1 = e_cosh - 1;
+        const double d3 = -f0 / (f1 - 0.5 * f0 * e_sinh / f1);
+        const double d4 = -f0 / (f1 + 0.5 * d3 * e_sinh + d3 * d3 * e_cosh / 6);
+        const double d5 = -f0 / (f1 + 0.5 * d4 * e_sinh + d4 * d4 * e_cosh / 6 + d4 * d4 * d4 * e_sinh / 24);
+        H += d5;
+        if (!(std::abs(d5) >= hyperbolic_stop * std::max(1.0, H))) {
+            break;
+        }
+    }
+    return std::copysign(H, mean_anomaly);
+}
+
+void SetKeplerSolver(KeplerSolver solver) { kepler_solver.store(solver, std::memory_order_relaxed); }
+
+KeplerSolver GetKeplerSolver() { return kepler_solver.load(std::memory_order_relaxed); }
+
+double EccentricAnomalyFromMean(double mean_anomaly, double ecc) {
+    if (GetKeplerSolver() == KeplerSolver::Newton) {
+        return SolveKeplerElliptic(mean_anomaly, ecc);
+    }
+    return SolveKeplerEllipticFast(mean_anomaly, ecc);
+}
+
+double HyperbolicAnomalyFromMean(double mean_anomaly, double ecc) {
+    if (GetKeplerSolver() == KeplerSolver::Newton) {
+        return SolveKeplerHyperbolic(mean_anomaly, ecc);
+    }
+    return SolveKeplerHyperbolicFast(mean_anomaly, ecc);
+}
+
 double EccentricAnomalyToTrueAnomaly(const double& ecc, const double& E) {
     return 2 * atan2(sqrt(1 + ecc) * sin(E / 2), sqrt(1 - ecc) * cos(E / 2));
 }
@@ -259,13 +394,13 @@ double GetMtHyperbolic(const double& M0, const double& nu, const double& time, c
 
 radian TrueAnomalyElliptic(const Orbit& orbit, const second& time) {
     double Mt = GetMtElliptic(orbit.M0, orbit.nu(), time, orbit.epoch);
-    double E = SolveKeplerElliptic(Mt, orbit.eccentricity);
+    double E = EccentricAnomalyFromMean(Mt, orbit.eccentricity);
     return EccentricAnomalyToTrueAnomaly(orbit.eccentricity, E);
 }
 
 radian TrueAnomalyElliptic(const Orbit& orbit, const second& time, double& E_out) {
     double Mt = GetMtElliptic(orbit.M0, orbit.nu(), time, orbit.epoch);
-    double E = SolveKeplerElliptic(Mt, orbit.eccentricity);
+    double E = EccentricAnomalyFromMean(Mt, orbit.eccentricity);
     E_out = E;
     return EccentricAnomalyToTrueAnomaly(orbit.eccentricity, E);
 }
@@ -274,7 +409,7 @@ double GetCircularOrbitingVelocity(const double& GM, const double& radius) { ret
 
 radian TrueAnomalyHyperbolic(const Orbit& orbit, const second& time) {
     double Mt = GetMtHyperbolic(orbit.M0, orbit.nu(), time, orbit.epoch);
-    double H = SolveKeplerHyperbolic(Mt, orbit.eccentricity);
+    double H = HyperbolicAnomalyFromMean(Mt, orbit.eccentricity);
     double v = HyperbolicAnomalyToTrueAnomaly(orbit.eccentricity, H);
 
     assert((-GetHyperbolicAsymptopeAnomaly(orbit.eccentricity) < v &&
@@ -329,6 +464,12 @@ glm::dvec3 CalculateVelocityElliptic(const double& E, const kilometer& r, const
     return ((sqrt(GM * a) / r) * glm::dvec3(-sin(E), sqrt(1 - e * e) * cos(E), 0));
 }
 
+bool SameElements(const Orbit& first, const Orbit& second) {
+    return first.semi_major_axis == second.semi_major_axis && first.eccentricity == second.eccentricity &&
+           first.inclination == second.inclination && first.LAN == second.LAN && first.w == second.w &&
+           first.M0 == second.M0 && first.epoch == second.epoch && first.GM == second.GM;
+}
+
 /*
  * Adds an impulse in the reference frame of the orbit w.r.t. the orbiting body
 */
@@ -336,7 +477,11 @@ Orbit ApplyImpulse(const Orbit& orbit, const glm::dvec3& impulse, double time) {
     // Calculate v at epoch
     // Move the orbit
     const double v = GetTrueAnomaly(orbit, time);
-    const glm::dvec3 norm_impulse = ConvertToOrbitalVector(orbit.LAN, orbit.inclination, orbit.w, v, impulse);
+    // Turn the impulse by the true anomaly in the orbital plane, then into the reference frame
+    const double cos_v = cos(v);
+    const double sin_v = sin(v);
+    const glm::dvec3 norm_impulse = orbit.GetRotation() * glm::dvec3(impulse.x * cos_v - impulse.y * sin_v,
+                                                                     impulse.x * sin_v + impulse.y * cos_v, impulse.z);
     const glm::dvec3 position = toVec3(orbit, v);
     const glm::dvec3 velocity = OrbitVelocityToVec3(orbit, v);
 
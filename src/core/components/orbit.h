@@ -18,6 +18,7 @@
 
 #include <math.h>
 
+#include <limits>
 #include <ostream>
 
 #include <entt/entt.hpp>
@@ -35,6 +36,23 @@ typedef glm::dvec3 Vec3AU;
 
 double GetOrbitingRadius(const double e, const kilometer a, const radian v);
 
+/// <summary>
+/// Rotation from the orbital plane to the reference frame, as the three columns of the matrix. The same rotation
+/// as ConvertOrbParams.
+/// </summary>
+struct OrbitRotation {
+    /// Towards the periapsis
+    glm::dvec3 p {1, 0, 0};
+    /// 90 degrees ahead of the periapsis
+    glm::dvec3 q {0, 1, 0};
+    /// Normal to the orbital plane
+    glm::dvec3 h {0, 0, 1};
+
+    glm::dvec3 operator*(const glm::dvec3& vec) const { return p * vec.x + q * vec.y + h * vec.z; }
+};
+
+OrbitRotation GetOrbitRotation(const radian LAN, const radian i, const radian w);
+
 /**
  * Orbit of a body
  */
@@ -117,7 +135,9 @@ struct Orbit {
           M0(M0),
           v(M0),
           epoch(0),
-          reference_body(entt::null) {}
+          reference_body(entt::null) {
+        UpdateRotation();
+    }
 
     Orbit(kilometer semi_major_axis, double eccentricity, radian inclination, radian LAN, radian w, radian M0,
           entt::entity reference)
@@ -129,7 +149,9 @@ struct Orbit {
           M0(M0),
           v(M0),
           epoch(0),
-          reference_body(reference) {}
+          reference_body(reference) {
+        UpdateRotation();
+    }
 
     Orbit(const Orbit& orbit)
         : eccentricity(orbit.eccentricity),
@@ -141,7 +163,9 @@ struct Orbit {
           v(orbit.M0),
           epoch(orbit.epoch),
           GM(orbit.GM),
-          reference_body(orbit.reference_body) {}
+          reference_body(orbit.reference_body),
+          rotation(orbit.rotation),
+          rotation_elements(orbit.rotation_elements) {}
 
     double GetMtElliptic(double time) const { return normalize_radian(M0 + (time - epoch) * nu()); }
 
@@ -166,6 +190,23 @@ struct Orbit {
     double OrbitalVelocityAtTrueAnomaly(double true_anomaly) const;
 
     std::string ToHumanString() const;
+
+    /// <summary>
+    /// Works out the rotation to the reference frame again. Call this after changing LAN, inclination or w, so
+    /// that positions and velocities don't have to redo the trig for the orientation.
+    /// </summary>
+    void UpdateRotation();
+
+    /// <summary>
+    /// Rotation to the reference frame. This is the cached rotation if the orientation hasn't changed since
+    /// UpdateRotation, and is worked out from the elements if it has, so it is always right.
+    /// </summary>
+    OrbitRotation GetRotation() const;
+
+    /// Use GetRotation instead of reading these
+    OrbitRotation rotation;
+    /// The LAN, inclination and w that rotation was made from
+    glm::dvec3 rotation_elements {std::numeric_limits<double>::quiet_NaN()};
 };
 
 inline std::ostream& operator<<(std::ostream& outs, const Orbit& orb) {
@@ -265,6 +306,12 @@ Orbit Vec3ToOrbit(const glm::dvec3& position, const glm::dvec3& velocity, const
 glm::dvec3 OrbitToVec3(const double& a, const double& e, const radian& i, const radian& LAN, const radian& w,
                        const radian& v);
 
+/// <summary>
+/// Same as above, but with the rotation that the orbit has cached.
+/// </summary>
+/// <param name="v">True anomaly (radians)</param>
+glm::dvec3 OrbitToVec3(const Orbit& orb, const radian& v);
+
 double OrbitVelocity(const double v, const double e, const double a, const double GM);
 double OrbitVelocityAtR(const double GM, const double a, const double r);
 double AvgOrbitalVelocity(const Orbit& orb);
@@ -292,6 +339,51 @@ double SolveKeplerElliptic(const double& mean_anomaly, const double& ecc, const
 /// <returns></returns>
 double SolveKeplerHyperbolic(const double& mean_anomaly, const double& ecc, const int steps = 200);
 
+/// <summary>
+/// Solves Kepler's equation for an elliptic orbit (e < 1) from a close starting guess (Markley's cubic), then
+/// refines it with a fifth order Householder step. It is accurate to about 1e-15 after that one step, for
+/// eccentricities up to 0.999.
+/// </summary>
+/// <param name="mean_anomaly">Any mean anomaly, it doesn't need to be normalized</param>
+/// <param name="ecc"></param>
+/// <returns>Eccentric anomaly (E), in the same revolution as the mean anomaly</returns>
+double SolveKeplerEllipticFast(double mean_anomaly, double ecc);
+
+/// <summary>
+/// Solves Kepler's equation for a hyperbolic orbit (e > 1), starting from the smaller of the cubic and the
+/// logarithmic approximations of the hyperbolic anomaly, then refining it with fifth order Householder steps.
+/// It takes at most three steps for eccentricities up to 10.
+/// </summary>
+/// <returns>Hyperbolic anomaly (H)</returns>
+double SolveKeplerHyperbolicFast(double mean_anomaly, double ecc);
+
+/// <summary>
+/// How Kepler's equation is solved whenever the true anomaly is worked out from the time
+/// </summary>
+enum class KeplerSolver {
+    /// SolveKeplerElliptic and SolveKeplerHyperbolic
+    Newton,
+    /// SolveKeplerEllipticFast and SolveKeplerHyperbolicFast
+    Fast,
+};
+
+/// <summary>
+/// Changes the solver that UpdateOrbit, GetTrueAnomaly, OrbitTimeToVec3 and the other functions that go from
+/// time to true anomaly use. The default is KeplerSolver::Fast.
+/// </summary>
+void SetKeplerSolver(KeplerSolver solver);
+KeplerSolver GetKeplerSolver();
+
+/// <summary>
+/// Eccentric anomaly from the mean anomaly, with the solver that was set with SetKeplerSolver
+/// </summary>
+double EccentricAnomalyFromMean(double mean_anomaly, double ecc);
+
+/// <summary>
+/// Hyperbolic anomaly from the mean anomaly, with the solver that was set with SetKeplerSolver
+/// </summary>
+double HyperbolicAnomalyFromMean(double mean_anomaly, double ecc);
+
 /// <summary>
 /// Calculates true anomaly from eccentricity and eccentric anomaly
 /// </summary>
@@ -342,10 +434,7 @@ radian HyperbolicAnomaly(double v, double e);
 /// <param name="orb">Orbit</param>
 /// <param name="theta">Theta to compute</param>
 /// <returns>Vector 3 in orbit, in AU</returns>
-inline Vec3AU toVec3AU(const Orbit& orb, radian theta) {
-    glm::dvec3 vec = OrbitToVec3(orb.semi_major_axis, orb.eccentricity, orb.inclination, orb.LAN, orb.w, theta);
-    return vec / KmInAu;
-}
+inline Vec3AU toVec3AU(const Orbit& orb, radian theta) { return OrbitToVec3(orb, theta) / KmInAu; }
 
 /// <summary>
 /// Applies impulse based on the vector impulse
@@ -359,15 +448,19 @@ inline Vec3AU toVec3AU(const Orbit& orb, radian theta) {
 /// <returns></returns>
 Orbit ApplyImpulse(const Orbit& orbit, const glm::dvec3& impulse, double time);
 
+/// <summary>
+/// If the two orbits have the same elements, so they follow the same path at the same times.
+/// The true anomaly and the reference body are not compared.
+/// </summary>
+bool SameElements(const Orbit& first, const Orbit& second);
+
 /// <summary>
 /// Converts orbit to theta
 /// </summary>
 /// <param name="orb"></param>
 /// <param name="theta">True anomaly (radians)</param>
 /// <returns></returns>
-inline glm::dvec3 toVec3(const Orbit& orb, radian theta) {
-    return OrbitToVec3(orb.semi_major_axis, orb.eccentricity, orb.inclination, orb.LAN, orb.w, theta);
-}
+inline glm::dvec3 toVec3(const Orbit& orb, radian theta) { return OrbitToVec3(orb, theta); }
 
 glm::dvec3 OrbitTimeToVec3(const Orbit& orb, const second time = 0);
 glm::dvec3 OrbitTimeToVelocityVec3(const Orbit& orb, const second time = 0);
@@ -0,0 +1,229 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/orbitbatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cqsp::core::components::types {
+namespace {
+// Number of elliptic orbits that solve Kepler's equation together. The inner loops work on this many
+// independent values at once, so that the compiler can keep them in vector registers.
+constexpr size_t lanes = 4;
+
+// Same limits as SolveKeplerElliptic
+constexpr int max_steps = 200;
+constexpr double tolerance = 1.0E-10;
+
+// Solves E - e sin(E) = M for every lane, with the solver from SetKeplerSolver. For Newton's method, E is the
+// starting guess, and it runs until all of the lanes have converged. The lanes that converge early just keep
+// getting refined.
+void SolveKeplerLanes(double (&E)[lanes], double (&sin_E)[lanes], double (&cos_E)[lanes], const double (&M)[lanes],
+                      const double (&e)[lanes]) {
+    if (GetKeplerSolver() == KeplerSolver::Fast) {
+        for (size_t lane = 0; lane < lanes; lane++) {
+            E[lane] = SolveKeplerEllipticFast(M[lane], e[lane]);
+            sin_E[lane] = std::sin(E[lane]);
+            cos_E[lane] = std::cos(E[lane]);
+        }
+        return;
+    }
+    for (int step = 0; step < max_steps; step++) {
+        double largest_step = 0;
+        for (size_t lane = 0; lane < lanes; lane++) {
+            sin_E[lane] = std::sin(E[lane]);
+            cos_E[lane] = std::cos(E[lane]);
+            const double delta = (M[lane] - (E[lane] - e[lane] * sin_E[lane])) / (1.0 - e[lane] * cos_E[lane]);
+            E[lane] += delta;
+            largest_step = std::max(largest_step, std::abs(delta));
+        }
+        if (!(largest_step > tolerance)) {
+            break;
+        }
+    }
+    for (size_t lane = 0; lane < lanes; lane++) {
+        sin_E[lane] = std::sin(E[lane]);
+        cos_E[lane] = std::cos(E[lane]);
+    }
+}
+
+void PropagateElliptic(OrbitBatch& batch, const std::vector<size_t>& indices, second time, second future_time) {
+    for (size_t start = 0; start < indices.size(); start += lanes) {
+        const size_t count = std::min(lanes, indices.size() - start);
+        // Unused lanes solve a circular orbit, which converges straight away
+        double e[lanes] = {};
+        double M[lanes] = {};
+        double future_M[lanes] = {};
+        double E[lanes];
+        double sin_E[lanes];
+        double cos_E[lanes];
+        for (size_t lane = 0; lane < count; lane++) {
+            const size_t index = indices[start + lane];
+            const double a = batch.semi_major_axis[index];
+            const double nu = std::sqrt(batch.GM[index] / std::abs(a * a * a));
+            e[lane] = batch.eccentricity[index];
+            M[lane] = GetMtElliptic(batch.M0[index], nu, time, batch.epoch[index]);
+            future_M[lane] = GetMtElliptic(batch.M0[index], nu, future_time, batch.epoch[index]);
+        }
+        // Lanes run until the slowest one has converged, so start closer than M to keep them together
+        for (size_t lane = 0; lane < lanes; lane++) {
+            E[lane] = M[lane] + e[lane] * std::sin(M[lane]);
+        }
+        SolveKeplerLanes(E, sin_E, cos_E, M, e);
+
+        for (size_t lane = 0; lane < count; lane++) {
+            const size_t index = indices[start + lane];
+            const double a = batch.semi_major_axis[index];
+            const double root = std::sqrt(1 - e[lane] * e[lane]);
+            batch.true_anomaly[index] = EccentricAnomalyToTrueAnomaly(e[lane], E[lane]);
+            if (a == 0) {
+                batch.position[index] = glm::dvec3(0, 0, 0);
+                batch.velocity[index] = glm::dvec3(0, 0, 0);
+                continue;
+            }
+            // Perifocal position and velocity straight from the eccentric anomaly, so that the true anomaly
+            // doesn't need any more trig
+            const double denominator = 1 - e[lane] * cos_E[lane];
+            const double cos_v = (cos_E[lane] - e[lane]) / denominator;
+            const double sin_v = root * sin_E[lane] / denominator;
+            const double speed = std::sqrt(batch.GM[index] / (a * root * root));
+            const OrbitRotation& rotation = batch.rotation[index];
+            batch.position[index] = rotation.p * (a * (cos_E[lane] - e[lane])) + rotation.q * (a * root * sin_E[lane]);
+            batch.velocity[index] = rotation.p * (-speed * sin_v) + rotation.q * (speed * (e[lane] + cos_v));
+        }
+
+        // The mean anomaly has moved on by a bit, and E - M changes slowly, so start from there
+        for (size_t lane = 0; lane < lanes; lane++) {
+            E[lane] = future_M[lane] + (E[lane] - M[lane]);
+        }
+        SolveKeplerLanes(E, sin_E, cos_E, future_M, e);
+        for (size_t lane = 0; lane < count; lane++) {
+            const size_t index = indices[start + lane];
+            const double a = batch.semi_major_axis[index];
+            if (a == 0) {
+                batch.future_position[index] = glm::dvec3(0, 0, 0);
+                continue;
+            }
+            const double root = std::sqrt(1 - e[lane] * e[lane]);
+            const OrbitRotation& rotation = batch.rotation[index];
+            batch.future_position[index] =
+                rotation.p * (a * (cos_E[lane] - e[lane])) + rotation.q * (a * root * sin_E[lane]);
+        }
+    }
+}
+
+glm::dvec3 PerifocalToPosition(const OrbitRotation& rotation, double a, double e, double v) {
+    const double cos_v = std::cos(v);
+    const double radius = a * (1 - e * e) / (1 + e * cos_v);
+    return rotation.p * (radius * cos_v) + rotation.q * (radius * std::sin(v));
+}
+
+void PropagateHyperbolic(OrbitBatch& batch, size_t index, second time, second future_time) {
+    const double a = batch.semi_major_axis[index];
+    const double e = batch.eccentricity[index];
+    const double nu = std::sqrt(batch.GM[index] / std::abs(a * a * a));
+
+    const double M = GetMtHyperbolic(batch.M0[index], nu, time, batch.epoch[index]);
+    const double v = HyperbolicAnomalyToTrueAnomaly(e, HyperbolicAnomalyFromMean(M, e));
+    const double future_M = GetMtHyperbolic(batch.M0[index], nu, future_time, batch.epoch[index]);
+    const double future_v = HyperbolicAnomalyToTrueAnomaly(e, HyperbolicAnomalyFromMean(future_M, e));
+
+    batch.true_anomaly[index] = v;
+    if (a == 0) {
+        batch.position[index] = glm::dvec3(0, 0, 0);
+        batch.velocity[index] = glm::dvec3(0, 0, 0);
+        batch.future_position[index] = glm::dvec3(0, 0, 0);
+        return;
+    }
+    const OrbitRotation& rotation = batch.rotation[index];
+    const double speed = std::sqrt(batch.GM[index] / (a * (1 - e * e)));
+    batch.position[index] = PerifocalToPosition(rotation, a, e, v);
+    batch.velocity[index] = rotation.p * (-speed * std::sin(v)) + rotation.q * (speed * (e + std::cos(v)));
+    batch.future_position[index] = PerifocalToPosition(rotation, a, e, future_v);
+}
+}  // namespace
+
+void OrbitBatch::clear() {
+    semi_major_axis.clear();
+    eccentricity.clear();
+    inclination.clear();
+    LAN.clear();
+    w.clear();
+    M0.clear();
+    epoch.clear();
+    GM.clear();
+    rotation.clear();
+    true_anomaly.clear();
+    position.clear();
+    velocity.clear();
+    future_position.clear();
+}
+
+void OrbitBatch::reserve(size_t count) {
+    semi_major_axis.reserve(count);
+    eccentricity.reserve(count);
+    inclination.reserve(count);
+    LAN.reserve(count);
+    w.reserve(count);
+    M0.reserve(count);
+    epoch.reserve(count);
+    GM.reserve(count);
+    rotation.reserve(count);
+    true_anomaly.reserve(count);
+    position.reserve(count);
+    velocity.reserve(count);
+    future_position.reserve(count);
+}
+
+size_t OrbitBatch::push_back(const Orbit& orbit) {
+    semi_major_axis.push_back(orbit.semi_major_axis);
+    eccentricity.push_back(orbit.eccentricity);
+    inclination.push_back(orbit.inclination);
+    LAN.push_back(orbit.LAN);
+    w.push_back(orbit.w);
+    M0.push_back(orbit.M0);
+    epoch.push_back(orbit.epoch);
+    GM.push_back(orbit.GM);
+    rotation.push_back(orbit.GetRotation());
+    return semi_major_axis.size() - 1;
+}
+
+bool OrbitBatch::Matches(size_t index, const Orbit& orbit) const {
+    return semi_major_axis[index] == orbit.semi_major_axis && eccentricity[index] == orbit.eccentricity &&
+           inclination[index] == orbit.inclination && LAN[index] == orbit.LAN && w[index] == orbit.w &&
+           M0[index] == orbit.M0 && epoch[index] == orbit.epoch && GM[index] == orbit.GM;
+}
+
+void PropagateOrbits(OrbitBatch& batch, second time, second future_time) {
+    const size_t count = batch.size();
+    batch.true_anomaly.resize(count);
+    batch.position.resize(count);
+    batch.velocity.resize(count);
+    batch.future_position.resize(count);
+
+    std::vector<size_t> elliptic;
+    elliptic.reserve(count);
+    for (size_t index = 0; index < count; index++) {
+        if (batch.eccentricity[index] < 1) {
+            elliptic.push_back(index);
+        } else {
+            PropagateHyperbolic(batch, index, time, future_time);
+        }
+    }
+    PropagateElliptic(batch, elliptic, time, future_time);
+}
+}  // namespace cqsp::core::components::types
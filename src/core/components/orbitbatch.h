@@ -0,0 +1,78 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "core/components/orbit.h"
+#include "core/components/units.h"
+
+namespace cqsp::core::components::types {
+/// <summary>
+/// Orbits laid out as a structure of arrays, so that they can all be propagated at once with PropagateOrbits.
+/// </summary>
+/// The elements are copied in with push_back, and the results are read out by index, so the batch doesn't keep
+/// any references to the orbits.
+struct OrbitBatch {
+    std::vector<double> semi_major_axis;
+    std::vector<double> eccentricity;
+    std::vector<double> inclination;
+    std::vector<double> LAN;
+    std::vector<double> w;
+    std::vector<double> M0;
+    std::vector<double> epoch;
+    std::vector<double> GM;
+    /// From Orbit::GetRotation, so orbits that keep their orientation don't redo the trig every tick
+    std::vector<OrbitRotation> rotation;
+
+    /// True anomaly at the propagated time
+    std::vector<double> true_anomaly;
+    std::vector<glm::dvec3> position;
+    std::vector<glm::dvec3> velocity;
+    std::vector<glm::dvec3> future_position;
+
+    size_t size() const { return semi_major_axis.size(); }
+    bool empty() const { return semi_major_axis.empty(); }
+
+    void clear();
+    void reserve(size_t count);
+
+    /// <returns>The index of the orbit in the batch</returns>
+    size_t push_back(const Orbit& orbit);
+
+    /// <summary>
+    /// If the orbit has the same elements as the orbit that was put in at index. If it doesn't, then the orbit
+    /// has been changed since it was put in, and the results at the index are out of date.
+    /// </summary>
+    bool Matches(size_t index, const Orbit& orbit) const;
+};
+
+/// <summary>
+/// Does the same as calling UpdateOrbit, toVec3, OrbitVelocityToVec3 and OrbitTimeToVec3 on every orbit in the
+/// batch, and writes the results into the batch.
+/// </summary>
+/// The rotation to the reference frame comes from the orbit's cache, and elliptic orbits solve Kepler's
+/// equation a few at a time, with the solver from SetKeplerSolver. With Newton's method the lanes run in lock
+/// step, and the future position starts from the current eccentric anomaly.
+/// <param name="batch">Orbits to propagate</param>
+/// <param name="time">Time to compute the true anomaly, position and velocity at</param>
+/// <param name="future_time">Time to compute the future position at</param>
+void PropagateOrbits(OrbitBatch& batch, second time, second future_time);
+}  // namespace cqsp::core::components::types
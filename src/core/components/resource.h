@@ -115,8 +115,8 @@ struct RecipeCost {
     ResourceVector scaling;
 };
 
-struct ResourceConsumption : public ResourceMap {};
-struct ResourceProduction : public ResourceMap {};
+struct ResourceConsumption : public SparseLedger {};
+struct ResourceProduction : public SparseLedger {};
 
-struct ResourceStockpile : public ResourceMap {};
+struct ResourceStockpile : public SparseLedger {};
 }  // namespace cqsp::core::components
@@ -0,0 +1,519 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <map>
+#include <type_traits>
+#include <utility>
+
+#include "core/components/resourceledger.h"
+
+/// <summary>
+/// Lazy arithmetic on resource containers.
+/// </summary>
+/// The regular operators on `ResourceVector`, `ResourceMap`, `SparseLedger` and `ResourceLedger` create a new
+/// container for every step. Wrapping one side in `Lazy` builds an expression instead, and nothing is computed
+/// until the expression is summed, added into a ledger or bought from a market. That all happens in one pass
+/// without allocating anything.
+/// ```
+/// using components::expr::Lazy;
+/// auto input = Lazy(recipe.input) * utilization + Lazy(recipe.capitalcost) * size;
+/// market.PurchaseFromMarket(input);
+/// double cost = (Lazy(consumption) * market.price).GetSum();
+/// ```
+/// Expressions only keep references to the containers, so they can't outlive them.
+///
+/// Sparse expressions (built from vectors, maps and sparse ledgers) go through goods in ascending order, so vectors
+/// have to be sorted (see `ResourceVector::Finalize`). Dense expressions (built from ledgers) are indexed by good.
+namespace cqsp::core::components::expr {
+template <typename Derived>
+class Sparse {
+ public:
+    /// Sum of all values, added in ascending good order
+    double GetSum() const {
+        double sum = 0;
+        for (auto cursor = Self().Begin(); !cursor.Done(); cursor.Next()) {
+            sum += cursor.Value();
+        }
+        return sum;
+    }
+
+    /// Calls function(good, value) for every good in the expression
+    template <typename Function>
+    void ForEach(Function&& function) const {
+        for (auto cursor = Self().Begin(); !cursor.Done(); cursor.Next()) {
+            function(cursor.Good(), cursor.Value());
+        }
+    }
+
+ private:
+    const Derived& Self() const { return static_cast<const Derived&>(*this); }
+};
+
+template <typename Derived>
+class Dense {
+ public:
+    double GetSum() const {
+        double sum = 0;
+        for (size_t i = 0; i < Self().Size(); i++) {
+            sum += Self().At(i);
+        }
+        return sum;
+    }
+
+ private:
+    const Derived& Self() const { return static_cast<const Derived&>(*this); }
+};
+
+template <typename T>
+concept SparseExpression = std::derived_from<T, Sparse<T>>;
+
+template <typename T>
+concept DenseExpression = std::derived_from<T, Dense<T>>;
+
+template <typename T>
+concept Expression = SparseExpression<T> || DenseExpression<T>;
+
+template <typename T>
+concept SparseOperand =
+    SparseExpression<T> || std::derived_from<T, ResourceVector> || std::derived_from<T, ResourceMap> ||
+    std::derived_from<T, SparseLedger>;
+
+template <typename T>
+concept DenseOperand = DenseExpression<T> || std::same_as<T, ResourceLedger>;
+
+/// Iterates over anything with sorted (good, value) pairs
+template <typename Iterator>
+class PairCursor {
+ public:
+    PairCursor(Iterator current, Iterator end) : current(current), end(end) {}
+    bool Done() const { return current == end; }
+    GoodEntity Good() const { return current->first; }
+    double Value() const { return current->second; }
+    void Next() { ++current; }
+
+ private:
+    Iterator current;
+    Iterator end;
+};
+
+class VectorLeaf : public Sparse<VectorLeaf> {
+ public:
+    explicit VectorLeaf(const ResourceVector& vector) : vector(vector) {}
+    auto Begin() const { return PairCursor(vector.begin(), vector.end()); }
+
+ private:
+    const ResourceVector& vector;
+};
+
+class MapLeaf : public Sparse<MapLeaf> {
+ public:
+    explicit MapLeaf(const ResourceMap& map) : map(map) {}
+    auto Begin() const { return PairCursor(map.begin(), map.end()); }
+
+ private:
+    const ResourceMap& map;
+};
+
+class SparseLedgerLeaf : public Sparse<SparseLedgerLeaf> {
+ public:
+    explicit SparseLedgerLeaf(const SparseLedger& ledger) : ledger(ledger) {}
+
+    class Cursor {
+     public:
+        explicit Cursor(const SparseLedger& ledger) : ledger(ledger) {}
+        bool Done() const { return index == ledger.size(); }
+        GoodEntity Good() const { return ledger.GoodAt(index); }
+        double Value() const { return ledger.ValueAt(index); }
+        void Next() { index++; }
+
+     private:
+        const SparseLedger& ledger;
+        size_t index = 0;
+    };
+
+    Cursor Begin() const { return Cursor(ledger); }
+
+ private:
+    const SparseLedger& ledger;
+};
+
+class LedgerLeaf : public Dense<LedgerLeaf> {
+ public:
+    explicit LedgerLeaf(const ResourceLedger& ledger) : ledger(ledger) {}
+    double At(size_t index) const { return ledger[ToGoodEntity(static_cast<uint32_t>(index))]; }
+    size_t Size() const { return ledger.size(); }
+
+ private:
+    const ResourceLedger& ledger;
+};
+
+/// Starts an expression from a container, expressions are passed through as they are
+template <typename T>
+auto Lazy(const T& value) {
+    if constexpr (Expression<T>) {
+        return value;
+    } else if constexpr (std::derived_from<T, ResourceVector>) {
+        return VectorLeaf(value);
+    } else if constexpr (std::derived_from<T, ResourceMap>) {
+        return MapLeaf(value);
+    } else if constexpr (std::derived_from<T, SparseLedger>) {
+        return SparseLedgerLeaf(value);
+    } else {
+        static_assert(std::same_as<T, ResourceLedger>, "Not a resource container");
+        return LedgerLeaf(value);
+    }
+}
+
+struct Add {
+    static double Apply(double left, double right) { return left + right; }
+    // Values that are only on one side are passed through untouched, like ResourceVector::operator+
+    static double Left(double left) { return left; }
+    static double Right(double right) { return right; }
+};
+
+struct Subtract {
+    static double Apply(double left, double right) { return left - right; }
+    static double Left(double left) { return left; }
+    static double Right(double right) { return -right; }
+};
+
+struct Multiply {
+    static double Apply(double left, double right) { return left * right; }
+};
+
+struct Divide {
+    static double Apply(double left, double right) { return left / right; }
+};
+
+/// <summary>
+/// Goods that are in either side
+/// </summary>
+/// Both sides are walked together like `ResourceVector::operator+` does. A good that is on both sides comes out
+/// once, as Op::Apply(left, right), so `Lazy(input) * a + Lazy(capital) * b` adds up the same values in the same
+/// order as the eager operators. `ResourceVector::Finalize` only sorts, so a good that is in a vector twice also
+/// comes out twice, and only the first one is combined with the other side, again the same as the eager version.
+template <typename Left, typename Right, typename Op>
+class SparseUnion : public Sparse<SparseUnion<Left, Right, Op>> {
+ public:
+    SparseUnion(const Left& left, const Right& right) : left(left), right(right) {}
+
+    class Cursor {
+     public:
+        Cursor(decltype(std::declval<const Left&>().Begin()) left,
+               decltype(std::declval<const Right&>().Begin()) right)
+            : left(left), right(right) {}
+        bool Done() const { return left.Done() && right.Done(); }
+        GoodEntity Good() const {
+            if (left.Done()) return right.Good();
+            if (right.Done()) return left.Good();
+            return std::min(left.Good(), right.Good());
+        }
+        double Value() const {
+            if (OnlyLeft()) return Op::Left(left.Value());
+            if (OnlyRight()) return Op::Right(right.Value());
+            return Op::Apply(left.Value(), right.Value());
+        }
+        void Next() {
+            const bool only_left = OnlyLeft();
+            const bool only_right = OnlyRight();
+            if (!only_right) left.Next();
+            if (!only_left) right.Next();
+        }
+
+     private:
+        bool OnlyLeft() const { return right.Done() || (!left.Done() && left.Good() < right.Good()); }
+        bool OnlyRight() const { return left.Done() || (!right.Done() && right.Good() < left.Good()); }
+
+        decltype(std::declval<const Left&>().Begin()) left;
+        decltype(std::declval<const Right&>().Begin()) right;
+    };
+
+    Cursor Begin() const { return Cursor(left.Begin(), right.Begin()); }
+
+ private:
+    Left left;
+    Right right;
+};
+
+/// Goods that are in both sides
+template <typename Left, typename Right, typename Op>
+class SparseIntersection : public Sparse<SparseIntersection<Left, Right, Op>> {
+ public:
+    SparseIntersection(const Left& left, const Right& right) : left(left), right(right) {}
+
+    class Cursor {
+     public:
+        Cursor(decltype(std::declval<const Left&>().Begin()) left,
+               decltype(std::declval<const Right&>().Begin()) right)
+            : left(left), right(right) {
+            Align();
+        }
+        bool Done() const { return left.Done() || right.Done(); }
+        GoodEntity Good() const { return left.Good(); }
+        double Value() const { return Op::Apply(left.Value(), right.Value()); }
+        void Next() {
+            left.Next();
+            right.Next();
+            Align();
+        }
+
+     private:
+        // Moves forward until both sides are on the same good
+        void Align() {
+            while (!left.Done() && !right.Done() && left.Good() != right.Good()) {
+                if (left.Good() < right.Good()) {
+                    left.Next();
+                } else {
+                    right.Next();
+                }
+            }
+        }
+
+        decltype(std::declval<const Left&>().Begin()) left;
+        decltype(std::declval<const Right&>().Begin()) right;
+    };
+
+    Cursor Begin() const { return Cursor(left.Begin(), right.Begin()); }
+
+ private:
+    Left left;
+    Right right;
+};
+
+/// Sparse values combined with the same good in a dense expression, keeps the goods of the sparse side
+template <typename Left, typename Right, typename Op, bool sparse_on_left>
+class SparseDense : public Sparse<SparseDense<Left, Right, Op, sparse_on_left>> {
+    using SparseSide = std::conditional_t<sparse_on_left, Left, Right>;
+    using DenseSide = std::conditional_t<sparse_on_left, Right, Left>;
+
+ public:
+    SparseDense(const SparseSide& sparse, const DenseSide& dense) : sparse(sparse), dense(dense) {}
+
+    class Cursor {
+     public:
+        Cursor(decltype(std::declval<const SparseSide&>().Begin()) sparse, const DenseSide& dense)
+            : sparse(sparse), dense(dense) {}
+        bool Done() const { return sparse.Done(); }
+        GoodEntity Good() const { return sparse.Good(); }
+        double Value() const {
+            const double dense_value = dense.At(static_cast<size_t>(sparse.Good()));
+            if constexpr (sparse_on_left) {
+                return Op::Apply(sparse.Value(), dense_value);
+            } else {
+                return Op::Apply(dense_value, sparse.Value());
+            }
+        }
+        void Next() { sparse.Next(); }
+
+     private:
+        decltype(std::declval<const SparseSide&>().Begin()) sparse;
+        const DenseSide& dense;
+    };
+
+    Cursor Begin() const { return Cursor(sparse.Begin(), dense); }
+
+ private:
+    SparseSide sparse;
+    DenseSide dense;
+};
+
+template <typename Inner, typename Op, bool scalar_on_left>
+class SparseScalar : public Sparse<SparseScalar<Inner, Op, scalar_on_left>> {
+ public:
+    SparseScalar(const Inner& inner, double scalar) : inner(inner), scalar(scalar) {}
+
+    class Cursor {
+     public:
+        Cursor(decltype(std::declval<const Inner&>().Begin()) inner, double scalar) : inner(inner), scalar(scalar) {}
+        bool Done() const { return inner.Done(); }
+        GoodEntity Good() const { return inner.Good(); }
+        double Value() const {
+            if constexpr (scalar_on_left) {
+                return Op::Apply(scalar, inner.Value());
+            } else {
+                return Op::Apply(inner.Value(), scalar);
+            }
+        }
+        void Next() { inner.Next(); }
+
+     private:
+        decltype(std::declval<const Inner&>().Begin()) inner;
+        double scalar;
+    };
+
+    Cursor Begin() const { return Cursor(inner.Begin(), scalar); }
+
+ private:
+    Inner inner;
+    double scalar;
+};
+
+template <typename Left, typename Right, typename Op>
+class DenseBinary : public Dense<DenseBinary<Left, Right, Op>> {
+ public:
+    DenseBinary(const Left& left, const Right& right) : left(left), right(right) {}
+    double At(size_t index) const { return Op::Apply(left.At(index), right.At(index)); }
+    size_t Size() const { return left.Size(); }
+
+ private:
+    Left left;
+    Right right;
+};
+
+template <typename Inner, typename Op, bool scalar_on_left>
+class DenseScalar : public Dense<DenseScalar<Inner, Op, scalar_on_left>> {
+ public:
+    DenseScalar(const Inner& inner, double scalar) : inner(inner), scalar(scalar) {}
+    double At(size_t index) const {
+        if constexpr (scalar_on_left) {
+            return Op::Apply(scalar, inner.At(index));
+        } else {
+            return Op::Apply(inner.At(index), scalar);
+        }
+    }
+    size_t Size() const { return inner.Size(); }
+
+ private:
+    Inner inner;
+    double scalar;
+};
+
+// At least one side has to already be an expression, so that the regular eager operators aren't replaced
+template <typename Left, typename Right>
+concept OneSideLazy = Expression<Left> || Expression<Right>;
+
+template <typename T>
+using LazyType = decltype(Lazy(std::declval<const T&>()));
+
+#define CQSP_SPARSE_UNION_OPERATOR(symbol, Op)                                                                  \
+    template <SparseOperand Left, SparseOperand Right>                                                          \
+        requires OneSideLazy<Left, Right>                                                                       \
+    auto operator symbol(const Left& left, const Right& right) {                                                \
+        return SparseUnion<LazyType<Left>, LazyType<Right>, Op>(Lazy(left), Lazy(right));          \
+    }
+
+#define CQSP_DENSE_OPERATOR(symbol, Op)                                                                         \
+    template <DenseOperand Left, DenseOperand Right>                                                            \
+        requires OneSideLazy<Left, Right>                                                                       \
+    auto operator symbol(const Left& left, const Right& right) {                                                \
+        return DenseBinary<LazyType<Left>, LazyType<Right>, Op>(Lazy(left), Lazy(right));          \
+    }                                                                                                           \
+    template <DenseExpression Inner>                                                                            \
+    auto operator symbol(const Inner& inner, double scalar) {                                                   \
+        return DenseScalar<Inner, Op, false>(inner, scalar);                                                    \
+    }                                                                                                           \
+    template <DenseExpression Inner>                                                                            \
+    auto operator symbol(double scalar, const Inner& inner) {                                                   \
+        return DenseScalar<Inner, Op, true>(inner, scalar);                                                     \
+    }
+
+// Operators where the sparse side decides which goods are in the result
+#define CQSP_SPARSE_OPERATOR(symbol, Op)                                                                        \
+    template <SparseOperand Left, DenseOperand Right>                                                           \
+        requires OneSideLazy<Left, Right>                                                                       \
+    auto operator symbol(const Left& left, const Right& right) {                                                \
+        return SparseDense<LazyType<Left>, LazyType<Right>, Op, true>(Lazy(left), Lazy(right));    \
+    }                                                                                                           \
+    template <SparseExpression Inner>                                                                           \
+    auto operator symbol(const Inner& inner, double scalar) {                                                   \
+        return SparseScalar<Inner, Op, false>(inner, scalar);                                                   \
+    }
+
+CQSP_SPARSE_UNION_OPERATOR(+, Add)
+CQSP_SPARSE_UNION_OPERATOR(-, Subtract)
+CQSP_DENSE_OPERATOR(+, Add)
+CQSP_DENSE_OPERATOR(-, Subtract)
+CQSP_DENSE_OPERATOR(*, Multiply)
+CQSP_DENSE_OPERATOR(/, Divide)
+CQSP_SPARSE_OPERATOR(*, Multiply)
+CQSP_SPARSE_OPERATOR(/, Divide)
+
+#undef CQSP_SPARSE_UNION_OPERATOR
+#undef CQSP_DENSE_OPERATOR
+#undef CQSP_SPARSE_OPERATOR
+
+template <SparseOperand Left, SparseOperand Right>
+    requires OneSideLazy<Left, Right>
+auto operator*(const Left& left, const Right& right) {
+    return SparseIntersection<LazyType<Left>, LazyType<Right>, Multiply>(Lazy(left), Lazy(right));
+}
+
+template <DenseOperand Left, SparseOperand Right>
+    requires OneSideLazy<Left, Right>
+auto operator*(const Left& left, const Right& right) {
+    return SparseDense<LazyType<Left>, LazyType<Right>, Multiply, false>(Lazy(right), Lazy(left));
+}
+
+template <SparseExpression Inner>
+auto operator*(double scalar, const Inner& inner) {
+    return SparseScalar<Inner, Multiply, true>(inner, scalar);
+}
+
+template <SparseExpression Inner>
+void operator+=(ResourceLedger& ledger, const Inner& expression) {
+    expression.ForEach([&ledger](GoodEntity good, double value) { ledger[good] += value; });
+}
+
+template <SparseExpression Inner>
+void operator-=(ResourceLedger& ledger, const Inner& expression) {
+    expression.ForEach([&ledger](GoodEntity good, double value) { ledger[good] -= value; });
+}
+
+template <DenseExpression Inner>
+void operator+=(ResourceLedger& ledger, const Inner& expression) {
+    for (size_t i = 0; i < ledger.size(); i++) {
+        ledger[ToGoodEntity(static_cast<uint32_t>(i))] += expression.At(i);
+    }
+}
+
+template <DenseExpression Inner>
+void operator-=(ResourceLedger& ledger, const Inner& expression) {
+    for (size_t i = 0; i < ledger.size(); i++) {
+        ledger[ToGoodEntity(static_cast<uint32_t>(i))] -= expression.At(i);
+    }
+}
+
+template <SparseExpression Inner>
+void operator+=(ResourceMap& map, const Inner& expression) {
+    expression.ForEach([&map](GoodEntity good, double value) { map[good] += value; });
+}
+
+template <SparseExpression Inner>
+void operator+=(SparseLedger& ledger, const Inner& expression) {
+    expression.ForEach([&ledger](GoodEntity good, double value) { ledger[good] += value; });
+}
+
+/// Overwrites the ledger with the expression
+template <DenseExpression Inner>
+void Assign(ResourceLedger& ledger, const Inner& expression) {
+    for (size_t i = 0; i < ledger.size(); i++) {
+        ledger[ToGoodEntity(static_cast<uint32_t>(i))] = expression.At(i);
+    }
+}
+
+/// Replaces the contents of the vector with the expression. Reuses the vector's memory, so keeping the vector
+/// around between calls doesn't allocate.
+template <SparseExpression Inner>
+void Assign(ResourceVector& vector, const Inner& expression) {
+    vector.clear();
+    expression.ForEach([&vector](GoodEntity good, double value) { vector.emplace_back(good, value); });
+}
+}  // namespace cqsp::core::components::expr
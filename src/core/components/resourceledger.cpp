@@ -21,9 +21,11 @@
 #include <ranges>
 #include <utility>
 
+#include "core/components/resourceledgerkernels.h"
+
 #define ITERATE_GOODS(name)                    \
     GoodEntity name = ToGoodEntity(0);         \
-    static_cast<size_t>(name) < ledger.size(); \
+    static_cast<size_t>(name) < good_count; \
     (name) = ToGoodEntity(static_cast<size_t>(name) + 1)
 
 namespace cqsp::core::components {
@@ -442,7 +444,59 @@ ResourceMap CopyVals(const ResourceMap &keys, const ResourceMap &values) {
     return tkeys;
 }
 
-ResourceLedger::ResourceLedger(size_t count) : ledger(count, 0.0) {}
+ResourceLedger::ResourceLedger(size_t count) : owned(count, 0.0), values(owned.data()), good_count(count) {}
+
+ResourceLedger::ResourceLedger(size_t count, std::pmr::memory_resource *resource)
+    : owned(count, 0.0, resource), values(owned.data()), good_count(count) {}
+
+ResourceLedger::ResourceLedger(const ResourceLedger &other)
+    : owned(other.values, other.values + other.good_count), values(owned.data()), good_count(other.good_count) {}
+
+ResourceLedger::ResourceLedger(ResourceLedger &&other) noexcept
+    : owned(std::move(other.owned)), values(other.values), good_count(other.good_count) {
+    other.values = nullptr;
+    other.good_count = 0;
+}
+
+ResourceLedger &ResourceLedger::operator=(const ResourceLedger &other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (IsView() && good_count == other.good_count) {
+        std::copy_n(other.values, good_count, values);
+        return *this;
+    }
+    owned.assign(other.values, other.values + other.good_count);
+    values = owned.data();
+    good_count = other.good_count;
+    return *this;
+}
+
+ResourceLedger &ResourceLedger::operator=(ResourceLedger &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    if (IsView() && !other.IsView() && good_count == other.good_count) {
+        // Keep pointing at the table, this is something like `market.supply = a + b`
+        std::copy_n(other.values, good_count, values);
+        return *this;
+    }
+    const bool other_is_view = other.IsView();
+    // If the memory resources are different, the vector copies instead of taking the other's memory
+    owned = std::move(other.owned);
+    values = other_is_view ? other.values : owned.data();
+    good_count = other.good_count;
+    other.values = nullptr;
+    other.good_count = 0;
+    return *this;
+}
+
+void ResourceLedger::Bind(double *storage) {
+    std::copy_n(values, good_count, storage);
+    owned.clear();
+    owned.shrink_to_fit();
+    values = storage;
+}
 
 ResourceLedger::operator ResourceMap() const {
     ResourceMap map;
@@ -456,27 +510,19 @@ ResourceLedger::operator ResourceMap() const {
 }
 
 void ResourceLedger::operator+=(const ResourceLedger &other) {
-    for (ITERATE_GOODS(i)) {
-        (*this)[i] += other[i];
-    }
+    GetLedgerKernels().add(values, other.values, good_count);
 }
 
 void ResourceLedger::operator-=(const ResourceLedger &other) {
-    for (ITERATE_GOODS(i)) {
-        (*this)[i] -= other[i];
-    }
+    GetLedgerKernels().subtract(values, other.values, good_count);
 }
 
 void ResourceLedger::operator*=(const ResourceLedger &other) {
-    for (ITERATE_GOODS(i)) {
-        (*this)[i] *= other[i];
-    }
+    GetLedgerKernels().multiply(values, other.values, good_count);
 }
 
 void ResourceLedger::operator/=(const ResourceLedger &other) {
-    for (ITERATE_GOODS(i)) {
-        (*this)[i] /= other[i];
-    }
+    GetLedgerKernels().divide(values, other.values, good_count);
 }
 
 void ResourceLedger::operator+=(const double value) {
@@ -503,44 +549,36 @@ void ResourceLedger::operator/=(const double value) {
     }
 }
 
-double ResourceLedger::operator[](const GoodEntity value) const { return ledger[static_cast<int>(value)]; }
+double ResourceLedger::operator[](const GoodEntity value) const { return values[static_cast<int>(value)]; }
 
-double &ResourceLedger::operator[](const GoodEntity value) { return ledger[static_cast<int>(value)]; }
+double &ResourceLedger::operator[](const GoodEntity value) { return values[static_cast<int>(value)]; }
 
 ResourceLedger ResourceLedger::operator-(const ResourceLedger &other) const {
-    ResourceLedger result(ledger.size());
-    for (ITERATE_GOODS(i)) {
-        result[i] = (*this)[i] - other[i];
-    }
+    ResourceLedger result(*this);
+    GetLedgerKernels().subtract(result.values, other.values, good_count);
     return result;
 }
 
 ResourceLedger ResourceLedger::operator+(const ResourceLedger &other) const {
-    ResourceLedger result(ledger.size());
-    for (ITERATE_GOODS(i)) {
-        result[i] = (*this)[i] + other[i];
-    }
+    ResourceLedger result(*this);
+    GetLedgerKernels().add(result.values, other.values, good_count);
     return result;
 }
 
 ResourceLedger ResourceLedger::operator*(const ResourceLedger &other) const {
-    ResourceLedger result(ledger.size());
-    for (ITERATE_GOODS(i)) {
-        result[i] = (*this)[i] * other[i];
-    }
+    ResourceLedger result(*this);
+    GetLedgerKernels().multiply(result.values, other.values, good_count);
     return result;
 }
 
 ResourceLedger ResourceLedger::operator/(const ResourceLedger &other) const {
-    ResourceLedger result(ledger.size());
-    for (ITERATE_GOODS(i)) {
-        result[i] = (*this)[i] / other[i];
-    }
+    ResourceLedger result(*this);
+    GetLedgerKernels().divide(result.values, other.values, good_count);
     return result;
 }
 
 ResourceLedger ResourceLedger::operator-(const double value) const {
-    ResourceLedger result(ledger.size());
+    ResourceLedger result(good_count);
     for (ITERATE_GOODS(i)) {
         result[i] = (*this)[i] - value;
     }
@@ -548,7 +586,7 @@ ResourceLedger ResourceLedger::operator-(const double value) const {
 }
 
 ResourceLedger ResourceLedger::operator+(const double value) const {
-    ResourceLedger result(ledger.size());
+    ResourceLedger result(good_count);
     for (ITERATE_GOODS(i)) {
         result[i] = (*this)[i] + value;
     }
@@ -556,7 +594,7 @@ ResourceLedger ResourceLedger::operator+(const double value) const {
 }
 
 ResourceLedger ResourceLedger::operator*(const double value) const {
-    ResourceLedger result(ledger.size());
+    ResourceLedger result(good_count);
     for (ITERATE_GOODS(i)) {
         result[i] = (*this)[i] * value;
     }
@@ -564,7 +602,7 @@ ResourceLedger ResourceLedger::operator*(const double value) const {
 }
 
 ResourceLedger ResourceLedger::operator/(const double value) const {
-    ResourceLedger result(ledger.size());
+    ResourceLedger result(good_count);
     for (ITERATE_GOODS(i)) {
         result[i] = (*this)[i] / value;
     }
@@ -700,39 +738,27 @@ void ResourceLedger::TransferTo(ResourceLedger &ledger_to, const ResourceLedger
 }
 
 void ResourceLedger::MultiplyAdd(const ResourceLedger &other, double value) {
-    for (ITERATE_GOODS(i)) {
-        (*this)[i] += other[i] * value;
-    }
+    GetLedgerKernels().multiply_add(values, other.values, value, good_count);
 }
 
 // Add all the positive values in the other ledger to this ledger
 // Essentially this += other (if other[idx] > 0)
 void ResourceLedger::ResourceLedger::AddPositive(const ResourceLedger &other) {
-    for (ITERATE_GOODS(i)) {
-        if (other[i] > 0) {
-            (*this)[i] += other[i];
-        }
-    }
+    GetLedgerKernels().add_positive(values, other.values, good_count);
 }
 
 // Add all the negative values in the other ledger to this ledger
 // Essentially this += abs(other) (if other[idx] < 0)
 void ResourceLedger::AddNegative(const ResourceLedger &other) {
-    for (ITERATE_GOODS(i)) {
-        if (other[i] < 0) {
-            (*this)[i] -= other[i];
-        }
-    }
+    GetLedgerKernels().add_negative(values, other.values, good_count);
 }
 
 /// <summary>
 /// Returns a copy of the vector with the values clamped between the min and max indicated
 /// </summary>
 ResourceLedger ResourceLedger::Clamp(const double low, const double high) {
-    ResourceLedger result(ledger.size());
-    for (ITERATE_GOODS(i)) {
-        result[i] = std::clamp(low, high, (*this)[i]);
-    }
+    ResourceLedger result(*this);
+    GetLedgerKernels().clamp(result.values, low, high, good_count);
     return result;
 }
 
@@ -746,31 +772,15 @@ void ResourceLedger::clear() {
 /// Returns a copy of the vector divided by the indicated vector, with division by zero resulting in infiniy
 /// </summary>
 ResourceLedger ResourceLedger::SafeDivision(const ResourceLedger &other) {
-    ResourceLedger return_ledger(ledger.size());
-    return_ledger = *this;
-    for (ITERATE_GOODS(i)) {
-        if (other[i] == 0.0) {
-            return_ledger[i] = std::numeric_limits<double>::infinity();
-        } else {
-            return_ledger[i] = (*this)[i] / other[i];
-        }
-    }
-    return return_ledger;
+    return SafeDivision(other, std::numeric_limits<double>::infinity());
 }
 
 /// <summary>
 /// Returns a copy of the vector divided by the indicated vector, with division by zero resulting in the specified value
 /// </summary>
 ResourceLedger ResourceLedger::SafeDivision(const ResourceLedger &other, double value) {
-    ResourceLedger return_ledger(ledger.size());
-    return_ledger = *this;
-    for (ITERATE_GOODS(i)) {
-        if (other[i] == 0.0) {
-            return_ledger[i] = value;
-        } else {
-            return_ledger[i] = (*this)[i] / other[i];
-        }
-    }
+    ResourceLedger return_ledger(*this);
+    GetLedgerKernels().safe_division(return_ledger.values, other.values, value, good_count);
     return return_ledger;
 }
 
@@ -783,7 +793,7 @@ double ResourceLedger::Average() const {
     for (ITERATE_GOODS(i)) {
         val += (*this)[i];
     }
-    return val / static_cast<double>(ledger.size());
+    return val / static_cast<double>(good_count);
 }
 
 double ResourceLedger::Min() const {
@@ -824,11 +834,21 @@ double ResourceLedger::MultiplyAndGetSum(const ResourceMap &other) const {
 }
 
 double ResourceLedger::MultiplyAndGetSum(const ResourceLedger &other) const {
-    double sum = 0;
-    for (ITERATE_GOODS(i)) {
-        sum += other[i] * (*this)[i];
+    return GetLedgerKernels().multiply_sum(values, other.values, good_count);
+}
+
+double ResourceLedger::MultiplyAndGetSum(const SparseLedger &other) const { return other.MultiplyAndGetSum(*this); }
+
+void ResourceLedger::operator+=(const SparseLedger &other) {
+    for (size_t i = 0; i < other.size(); i++) {
+        values[static_cast<size_t>(other.GoodAt(i))] += other.ValueAt(i);
+    }
+}
+
+void ResourceLedger::operator-=(const SparseLedger &other) {
+    for (size_t i = 0; i < other.size(); i++) {
+        values[static_cast<size_t>(other.GoodAt(i))] -= other.ValueAt(i);
     }
-    return sum;
 }
 
 double ResourceVector::Average() {
@@ -1100,4 +1120,153 @@ void ResourceMap::operator/=(const ResourceVector &other) {
         (*this)[good.first] /= good.second;
     }
 }
+
+SparseLedger::operator ResourceMap() const {
+    ResourceMap map;
+    for (size_t i = 0; i < goods.size(); i++) {
+        map[goods[i]] = values[i];
+    }
+    return map;
+}
+
+size_t SparseLedger::LowerBound(const GoodEntity good) const {
+    return std::ranges::lower_bound(goods, good) - goods.begin();
+}
+
+double SparseLedger::operator[](const GoodEntity good) const {
+    const size_t index = LowerBound(good);
+    if (index == goods.size() || goods[index] != good) {
+        return 0;
+    }
+    return values[index];
+}
+
+double &SparseLedger::operator[](const GoodEntity good) {
+    const size_t index = LowerBound(good);
+    if (index == goods.size() || goods[index] != good) {
+        goods.insert(goods.begin() + index, good);
+        values.insert(values.begin() + index, 0.0);
+    }
+    return values[index];
+}
+
+bool SparseLedger::contains(const GoodEntity good) const {
+    const size_t index = LowerBound(good);
+    return index != goods.size() && goods[index] == good;
+}
+
+template <typename Function>
+void SparseLedger::Merge(const SparseLedger &other, Function function) {
+    // Count the goods that we don't have yet, so that the merge can be done in place from the back
+    size_t missing = 0;
+    size_t i = 0;
+    for (size_t j = 0; j < other.goods.size(); j++) {
+        while (i < goods.size() && goods[i] < other.goods[j]) {
+            i++;
+        }
+        if (i == goods.size() || goods[i] != other.goods[j]) {
+            missing++;
+        }
+    }
+
+    if (missing == 0) {
+        // Usual case, every good in the other ledger is already here
+        i = 0;
+        for (size_t j = 0; j < other.goods.size(); j++) {
+            while (goods[i] != other.goods[j]) {
+                i++;
+            }
+            values[i] = function(values[i], other.values[j]);
+        }
+        return;
+    }
+
+    size_t current = goods.size();
+    size_t incoming = other.goods.size();
+    size_t write = current + missing;
+    goods.resize(write);
+    values.resize(write);
+    while (incoming > 0) {
+        if (current > 0 && goods[current - 1] > other.goods[incoming - 1]) {
+            write--;
+            current--;
+            goods[write] = goods[current];
+            values[write] = values[current];
+        } else if (current > 0 && goods[current - 1] == other.goods[incoming - 1]) {
+            write--;
+            current--;
+            incoming--;
+            goods[write] = goods[current];
+            values[write] = function(values[current], other.values[incoming]);
+        } else {
+            write--;
+            incoming--;
+            goods[write] = other.goods[incoming];
+            values[write] = function(0.0, other.values[incoming]);
+        }
+    }
+    // Everything in front of write is already where it should be
+}
+
+void SparseLedger::operator+=(const SparseLedger &other) {
+    Merge(other, [](double left, double right) { return left + right; });
+}
+
+void SparseLedger::operator-=(const SparseLedger &other) {
+    Merge(other, [](double left, double right) { return left - right; });
+}
+
+void SparseLedger::MultiplyAdd(const SparseLedger &other, double value) {
+    Merge(other, [value](double left, double right) { return left + right * value; });
+}
+
+void SparseLedger::operator*=(const double value) {
+    for (double &amount : values) {
+        amount *= value;
+    }
+}
+
+void SparseLedger::operator/=(const double value) {
+    for (double &amount : values) {
+        amount /= value;
+    }
+}
+
+SparseLedger SparseLedger::operator*(const double value) const {
+    SparseLedger result = *this;
+    result *= value;
+    return result;
+}
+
+SparseLedger SparseLedger::operator/(const double value) const {
+    SparseLedger result = *this;
+    result /= value;
+    return result;
+}
+
+double SparseLedger::GetSum() const {
+    double sum = 0;
+    for (double amount : values) {
+        sum += amount;
+    }
+    return sum;
+}
+
+double SparseLedger::MultiplyAndGetSum(const ResourceLedger &other) const {
+    double sum = 0;
+    for (size_t i = 0; i < goods.size(); i++) {
+        sum += values[i] * other[goods[i]];
+    }
+    return sum;
+}
+
+void SparseLedger::reserve(size_t count) {
+    goods.reserve(count);
+    values.reserve(count);
+}
+
+void SparseLedger::clear() {
+    goods.clear();
+    values.clear();
+}
 }  // namespace cqsp::core::components
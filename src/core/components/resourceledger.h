@@ -16,9 +16,12 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory_resource>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace cqsp::core::components {
@@ -31,6 +34,7 @@ enum class GoodEntity : uint32_t { null = static_cast<uint32_t>(-1) };
 constexpr GoodEntity ToGoodEntity(uint32_t val) { return static_cast<GoodEntity>(val); }
 class ResourceLedger;
 class ResourceVector;
+class SparseLedger;
 
 typedef std::map<GoodEntity, double> LedgerMap;
 
@@ -300,12 +304,40 @@ class ResourceVector : public std::vector<std::pair<GoodEntity, double>> {
     using LedgerVector::size;
 };
 
+/// <summary>
+/// Dense ledger with a value for every good.
+/// </summary>
+/// Usually the ledger owns its values, but it can also be bound to memory somewhere else (see `MarketTable`),
+/// so that the ledgers of many markets sit next to each other. A bound ledger stays bound when something is
+/// assigned to it, the values are just copied over. Copying a bound ledger makes a ledger that owns its values,
+/// and moving it moves the binding.
 class ResourceLedger {
  private:
-    std::vector<double> ledger;
+    // Empty when the ledger is bound
+    std::pmr::vector<double> owned;
+    double* values = nullptr;
+    size_t good_count = 0;
 
  public:
     explicit ResourceLedger(size_t count);
+    /// Ledger that gets its memory from resource, such as a `util::ScratchArena`
+    ResourceLedger(size_t count, std::pmr::memory_resource* resource);
+    ResourceLedger(const ResourceLedger&);
+    ResourceLedger(ResourceLedger&&) noexcept;
+    ResourceLedger& operator=(const ResourceLedger&);
+    ResourceLedger& operator=(ResourceLedger&&) noexcept;
+    ~ResourceLedger() = default;
+
+    /// <summary>
+    /// Copies the values to storage, and uses storage from now on. Storage has to have room for every good,
+    /// and has to outlive the ledger.
+    /// </summary>
+    void Bind(double* storage);
+
+    bool IsView() const { return owned.empty() && values != nullptr; }
+
+    double* data() { return values; }
+    const double* data() const { return values; }
 
     operator ResourceMap() const;
 
@@ -334,6 +366,9 @@ class ResourceLedger {
     void operator*=(const ResourceVector&);
     void operator/=(const ResourceVector&);
 
+    void operator-=(const SparseLedger&);
+    void operator+=(const SparseLedger&);
+
     void operator-=(const double value);
     void operator+=(const double value);
     void operator*=(const double value);
@@ -423,6 +458,7 @@ class ResourceLedger {
 
     double MultiplyAndGetSum(const ResourceMap& other) const;
     double MultiplyAndGetSum(const ResourceLedger& other) const;
+    double MultiplyAndGetSum(const SparseLedger& other) const;
 
     /// <summary>
     /// Returns a copy of the vector divided by the indicated vector, with
@@ -438,13 +474,107 @@ class ResourceLedger {
      */
     double GetSum();
 
-    auto begin() { return ledger.begin(); }
+    double* begin() { return values; }
+
+    double* end() { return values + good_count; }
+
+    size_t size() const { return good_count; }
+
+    void clear();
+};
+
+/// <summary>
+/// Ledger for things that only have a few goods, such as the consumption of a population segment.
+/// </summary>
+/// The goods are kept sorted in one array, and the amounts in another array next to it, so going through the
+/// ledger is a straight walk through memory, and combining it with a `ResourceLedger` only touches the goods
+/// that are actually in here. Assigning one sparse ledger to another reuses the memory that is already there,
+/// so a ledger that is refilled every tick stops allocating once it has seen all of its goods.
+class SparseLedger {
+ public:
+    SparseLedger() = default;
+    /// Ledger that gets its memory from resource, such as a `util::ScratchArena`. Assigning another ledger to
+    /// it keeps using resource, but copies of it use the heap.
+    explicit SparseLedger(std::pmr::memory_resource* resource) : goods(resource), values(resource) {}
+    ~SparseLedger() = default;
+
+    operator ResourceMap() const;
+
+    /// Amount of the good, or zero if it isn't in the ledger
+    double operator[](const GoodEntity good) const;
+    /// Adds the good with zero if it isn't in the ledger yet
+    double& operator[](const GoodEntity good);
+
+    void operator+=(const SparseLedger&);
+    void operator-=(const SparseLedger&);
+
+    void operator*=(const double value);
+    void operator/=(const double value);
+
+    SparseLedger operator*(const double value) const;
+    SparseLedger operator/(const double value) const;
+
+    /// Equivalent to this += other * value
+    void MultiplyAdd(const SparseLedger& other, double value);
+
+    double GetSum() const;
 
-    auto end() { return ledger.end(); }
+    /// <summary>
+    /// Multiplies every good in this ledger with the same good in the other ledger, and adds them all together.
+    /// Usually the other ledger is the price.
+    /// </summary>
+    double MultiplyAndGetSum(const ResourceLedger& other) const;
 
-    size_t size() { return ledger.size(); }
+    bool contains(const GoodEntity good) const;
 
+    GoodEntity GoodAt(size_t index) const { return goods[index]; }
+    double ValueAt(size_t index) const { return values[index]; }
+    double& ValueAt(size_t index) { return values[index]; }
+
+    size_t size() const { return goods.size(); }
+    bool empty() const { return goods.empty(); }
+    void reserve(size_t count);
+    /// Removes all goods, but keeps the memory around
     void clear();
+
+    class const_iterator {
+     public:
+        using value_type = std::pair<GoodEntity, double>;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator() = default;
+        const_iterator(const SparseLedger* ledger, size_t index) : ledger(ledger), index(index) {}
+
+        value_type operator*() const { return {ledger->goods[index], ledger->values[index]}; }
+        const_iterator& operator++() {
+            index++;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            index++;
+            return copy;
+        }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+
+     private:
+        const SparseLedger* ledger = nullptr;
+        size_t index = 0;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, goods.size()); }
+
+ private:
+    /// Index of the first good that isn't smaller than good
+    size_t LowerBound(const GoodEntity good) const;
+
+    /// Merges the other ledger into this one, with values that are in both ledgers combined with function
+    template <typename Function>
+    void Merge(const SparseLedger& other, Function function);
+
+    std::pmr::vector<GoodEntity> goods;
+    std::pmr::vector<double> values;
 };
 
 ResourceMap CopyVals(const ResourceMap& keys, const ResourceMap& values);
@@ -0,0 +1,455 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/resourceledgerkernels.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CQSP_LEDGER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// Every version has to round each multiply and add by itself to give the same results, so the compiler
+// can't fuse them into FMA instructions (which it would do for AVX-512)
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+// MSVC lets intrinsics be used anywhere, so nothing has to be marked
+#define CQSP_TARGET(isa)
+#else
+#define CQSP_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace cqsp::core::components {
+namespace {
+// Leftover elements after the vector loops, and the whole scalar version
+#define SCALAR_ELEMENT_LOOPS(TARGET)                                                                              \
+    TARGET void AddTail(double* out, const double* other, size_t i, size_t count) {                              \
+        for (; i < count; i++) out[i] += other[i];                                                                \
+    }                                                                                                             \
+    TARGET void SubtractTail(double* out, const double* other, size_t i, size_t count) {                         \
+        for (; i < count; i++) out[i] -= other[i];                                                                \
+    }                                                                                                             \
+    TARGET void MultiplyTail(double* out, const double* other, size_t i, size_t count) {                         \
+        for (; i < count; i++) out[i] *= other[i];                                                                \
+    }                                                                                                             \
+    TARGET void DivideTail(double* out, const double* other, size_t i, size_t count) {                           \
+        for (; i < count; i++) out[i] /= other[i];                                                                \
+    }                                                                                                             \
+    TARGET void MultiplyAddTail(double* out, const double* other, double value, size_t i, size_t count) {        \
+        for (; i < count; i++) {                                                                                  \
+            double product = other[i] * value;                                                                    \
+            out[i] += product;                                                                                    \
+        }                                                                                                         \
+    }                                                                                                             \
+    TARGET void AddPositiveTail(double* out, const double* other, size_t i, size_t count) {                      \
+        for (; i < count; i++) {                                                                                  \
+            if (other[i] > 0) out[i] += other[i];                                                                 \
+        }                                                                                                         \
+    }                                                                                                             \
+    TARGET void AddNegativeTail(double* out, const double* other, size_t i, size_t count) {                      \
+        for (; i < count; i++) {                                                                                  \
+            if (other[i] < 0) out[i] -= other[i];                                                                 \
+        }                                                                                                         \
+    }                                                                                                             \
+    TARGET void ClampTail(double* out, double low, double high, size_t i, size_t count) {                        \
+        for (; i < count; i++) out[i] = std::clamp(out[i], low, high);                                           \
+    }                                                                                                             \
+    TARGET void SafeDivisionTail(double* out, const double* other, double fallback, size_t i, size_t count) {    \
+        for (; i < count; i++) out[i] = (other[i] == 0.0) ? fallback : out[i] / other[i];                        \
+    }                                                                                                             \
+    TARGET double MultiplySumTail(double sum, const double* first, const double* second, size_t i, size_t count) { \
+        for (; i < count; i++) sum += first[i] * second[i];                                                       \
+        return sum;                                                                                               \
+    }
+
+// Vector versions of the element wise kernels. VEC, WIDTH, LOAD, STORE, SET1, ADD, SUB, MUL, DIV, LESS, EQUAL
+// and SELECT(mask, if_true, if_false) have to be defined for the instruction set first.
+#define VECTOR_ELEMENT_KERNELS(TARGET)                                                                            \
+    TARGET void Add(double* out, const double* other, size_t count) {                                            \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) STORE(out + i, ADD(LOAD(out + i), LOAD(other + i)));               \
+        AddTail(out, other, i, count);                                                                            \
+    }                                                                                                             \
+    TARGET void Subtract(double* out, const double* other, size_t count) {                                       \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) STORE(out + i, SUB(LOAD(out + i), LOAD(other + i)));               \
+        SubtractTail(out, other, i, count);                                                                       \
+    }                                                                                                             \
+    TARGET void Multiply(double* out, const double* other, size_t count) {                                       \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) STORE(out + i, MUL(LOAD(out + i), LOAD(other + i)));               \
+        MultiplyTail(out, other, i, count);                                                                       \
+    }                                                                                                             \
+    TARGET void Divide(double* out, const double* other, size_t count) {                                         \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) STORE(out + i, DIV(LOAD(out + i), LOAD(other + i)));               \
+        DivideTail(out, other, i, count);                                                                         \
+    }                                                                                                             \
+    TARGET void MultiplyAdd(double* out, const double* other, double value, size_t count) {                      \
+        const VEC factor = SET1(value);                                                                           \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) {                                                                  \
+            STORE(out + i, ADD(LOAD(out + i), MUL(LOAD(other + i), factor)));                                     \
+        }                                                                                                         \
+        MultiplyAddTail(out, other, value, i, count);                                                             \
+    }                                                                                                             \
+    TARGET void AddPositive(double* out, const double* other, size_t count) {                                    \
+        const VEC zero = SET1(0.0);                                                                               \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) {                                                                  \
+            VEC current = LOAD(out + i);                                                                          \
+            VEC value = LOAD(other + i);                                                                          \
+            STORE(out + i, SELECT(LESS(zero, value), ADD(current, value), current));                              \
+        }                                                                                                         \
+        AddPositiveTail(out, other, i, count);                                                                    \
+    }                                                                                                             \
+    TARGET void AddNegative(double* out, const double* other, size_t count) {                                    \
+        const VEC zero = SET1(0.0);                                                                               \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) {                                                                  \
+            VEC current = LOAD(out + i);                                                                          \
+            VEC value = LOAD(other + i);                                                                          \
+            STORE(out + i, SELECT(LESS(value, zero), SUB(current, value), current));                              \
+        }                                                                                                         \
+        AddNegativeTail(out, other, i, count);                                                                    \
+    }                                                                                                             \
+    TARGET void Clamp(double* out, double low, double high, size_t count) {                                      \
+        const VEC low_vec = SET1(low);                                                                            \
+        const VEC high_vec = SET1(high);                                                                          \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) {                                                                  \
+            /* Same order as std::clamp, so the result is the same even if low > high */                         \
+            VEC value = LOAD(out + i);                                                                            \
+            VEC result = SELECT(LESS(high_vec, value), high_vec, value);                                          \
+            STORE(out + i, SELECT(LESS(value, low_vec), low_vec, result));                                        \
+        }                                                                                                         \
+        ClampTail(out, low, high, i, count);                                                                      \
+    }                                                                                                             \
+    TARGET void SafeDivision(double* out, const double* other, double fallback, size_t count) {                  \
+        const VEC zero = SET1(0.0);                                                                               \
+        const VEC fallback_vec = SET1(fallback);                                                                  \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) {                                                                  \
+            VEC value = LOAD(other + i);                                                                          \
+            STORE(out + i, SELECT(EQUAL(value, zero), fallback_vec, DIV(LOAD(out + i), value)));                  \
+        }                                                                                                         \
+        SafeDivisionTail(out, other, fallback, i, count);                                                         \
+    }                                                                                                             \
+    TARGET double MultiplySum(const double* first, const double* second, size_t count) {                         \
+        /* Only the products are done together, they are added up one by one like a plain loop would */          \
+        double products[WIDTH];                                                                                   \
+        double sum = 0;                                                                                           \
+        size_t i = 0;                                                                                             \
+        for (; i + WIDTH <= count; i += WIDTH) {                                                                  \
+            STORE(products, MUL(LOAD(first + i), LOAD(second + i)));                                              \
+            for (size_t lane = 0; lane < WIDTH; lane++) sum += products[lane];                                    \
+        }                                                                                                         \
+        return MultiplySumTail(sum, first, second, i, count);                                                     \
+    }
+
+namespace scalar {
+SCALAR_ELEMENT_LOOPS()
+
+void Add(double* out, const double* other, size_t count) { AddTail(out, other, 0, count); }
+void Subtract(double* out, const double* other, size_t count) { SubtractTail(out, other, 0, count); }
+void Multiply(double* out, const double* other, size_t count) { MultiplyTail(out, other, 0, count); }
+void Divide(double* out, const double* other, size_t count) { DivideTail(out, other, 0, count); }
+void MultiplyAdd(double* out, const double* other, double value, size_t count) {
+    MultiplyAddTail(out, other, value, 0, count);
+}
+void AddPositive(double* out, const double* other, size_t count) { AddPositiveTail(out, other, 0, count); }
+void AddNegative(double* out, const double* other, size_t count) { AddNegativeTail(out, other, 0, count); }
+void Clamp(double* out, double low, double high, size_t count) { ClampTail(out, low, high, 0, count); }
+void SafeDivision(double* out, const double* other, double fallback, size_t count) {
+    SafeDivisionTail(out, other, fallback, 0, count);
+}
+
+double MultiplySum(const double* first, const double* second, size_t count) {
+    return MultiplySumTail(0, first, second, 0, count);
+}
+
+double MultiplySumInterleaved(const double* first, const double* second, size_t count) {
+    double sums[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (size_t lane = 0; lane < 4; lane++) {
+            sums[lane] += first[i + lane] * second[i + lane];
+        }
+    }
+    return MultiplySumTail((sums[0] + sums[1]) + (sums[2] + sums[3]), first, second, i, count);
+}
+}  // namespace scalar
+
+#ifdef CQSP_LEDGER_X86
+namespace sse2 {
+SCALAR_ELEMENT_LOOPS(CQSP_TARGET("sse2"))
+
+#define VEC __m128d
+#define WIDTH 2
+#define LOAD _mm_loadu_pd
+#define STORE _mm_storeu_pd
+#define SET1 _mm_set1_pd
+#define ADD _mm_add_pd
+#define SUB _mm_sub_pd
+#define MUL _mm_mul_pd
+#define DIV _mm_div_pd
+#define LESS _mm_cmplt_pd
+#define EQUAL _mm_cmpeq_pd
+#define SELECT(mask, if_true, if_false) _mm_or_pd(_mm_and_pd(mask, if_true), _mm_andnot_pd(mask, if_false))
+VECTOR_ELEMENT_KERNELS(CQSP_TARGET("sse2"))
+#undef VEC
+#undef WIDTH
+#undef LOAD
+#undef STORE
+#undef SET1
+#undef ADD
+#undef SUB
+#undef MUL
+#undef DIV
+#undef LESS
+#undef EQUAL
+#undef SELECT
+
+CQSP_TARGET("sse2") double MultiplySumInterleaved(const double* first, const double* second, size_t count) {
+    __m128d low = _mm_setzero_pd();
+    __m128d high = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        low = _mm_add_pd(low, _mm_mul_pd(_mm_loadu_pd(first + i), _mm_loadu_pd(second + i)));
+        high = _mm_add_pd(high, _mm_mul_pd(_mm_loadu_pd(first + i + 2), _mm_loadu_pd(second + i + 2)));
+    }
+    double sums[4];
+    _mm_storeu_pd(sums, low);
+    _mm_storeu_pd(sums + 2, high);
+    return MultiplySumTail((sums[0] + sums[1]) + (sums[2] + sums[3]), first, second, i, count);
+}
+}  // namespace sse2
+
+namespace avx2 {
+SCALAR_ELEMENT_LOOPS(CQSP_TARGET("avx2"))
+
+#define VEC __m256d
+#define WIDTH 4
+#define LOAD _mm256_loadu_pd
+#define STORE _mm256_storeu_pd
+#define SET1 _mm256_set1_pd
+#define ADD _mm256_add_pd
+#define SUB _mm256_sub_pd
+#define MUL _mm256_mul_pd
+#define DIV _mm256_div_pd
+#define LESS(a, b) _mm256_cmp_pd(a, b, _CMP_LT_OQ)
+#define EQUAL(a, b) _mm256_cmp_pd(a, b, _CMP_EQ_OQ)
+#define SELECT(mask, if_true, if_false) _mm256_blendv_pd(if_false, if_true, mask)
+VECTOR_ELEMENT_KERNELS(CQSP_TARGET("avx2"))
+#undef VEC
+#undef WIDTH
+#undef LOAD
+#undef STORE
+#undef SET1
+#undef ADD
+#undef SUB
+#undef MUL
+#undef DIV
+#undef LESS
+#undef EQUAL
+#undef SELECT
+
+CQSP_TARGET("avx2") double MultiplySumInterleaved(const double* first, const double* second, size_t count) {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(first + i), _mm256_loadu_pd(second + i)));
+    }
+    double sums[4];
+    _mm256_storeu_pd(sums, sum);
+    return MultiplySumTail((sums[0] + sums[1]) + (sums[2] + sums[3]), first, second, i, count);
+}
+}  // namespace avx2
+
+namespace avx512 {
+SCALAR_ELEMENT_LOOPS(CQSP_TARGET("avx512f"))
+
+#define VEC __m512d
+#define WIDTH 8
+#define LOAD _mm512_loadu_pd
+#define STORE _mm512_storeu_pd
+#define SET1 _mm512_set1_pd
+#define ADD _mm512_add_pd
+#define SUB _mm512_sub_pd
+#define MUL _mm512_mul_pd
+#define DIV _mm512_div_pd
+#define LESS(a, b) _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ)
+#define EQUAL(a, b) _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ)
+#define SELECT(mask, if_true, if_false) _mm512_mask_blend_pd(mask, if_false, if_true)
+VECTOR_ELEMENT_KERNELS(CQSP_TARGET("avx512f"))
+#undef VEC
+#undef WIDTH
+#undef LOAD
+#undef STORE
+#undef SET1
+#undef ADD
+#undef SUB
+#undef MUL
+#undef DIV
+#undef LESS
+#undef EQUAL
+#undef SELECT
+
+// The sum has to be split into the same four lanes as everywhere else, so this stays at 256 bits
+CQSP_TARGET("avx512f") double MultiplySumInterleaved(const double* first, const double* second, size_t count) {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(first + i), _mm256_loadu_pd(second + i)));
+    }
+    double sums[4];
+    _mm256_storeu_pd(sums, sum);
+    return MultiplySumTail((sums[0] + sums[1]) + (sums[2] + sums[3]), first, second, i, count);
+}
+}  // namespace avx512
+
+bool CpuSupports(SimdLevel level) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    // The OS has to save the ymm (and zmm) registers on context switches
+    const bool ymm_enabled = (xcr0 & 0x6) == 0x6;
+    const bool zmm_enabled = (xcr0 & 0xe6) == 0xe6;
+    bool avx2 = false;
+    bool avx512f = false;
+    if (max_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+        case SimdLevel::SSE2:
+            return sse2;
+        case SimdLevel::AVX2:
+            return avx && avx2 && ymm_enabled;
+        case SimdLevel::AVX512:
+            return avx && avx2 && avx512f && ymm_enabled && zmm_enabled;
+    }
+    return false;
+#else
+    __builtin_cpu_init();
+    switch (level) {
+        case SimdLevel::Scalar:
+            return true;
+        case SimdLevel::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#endif
+}
+#else
+bool CpuSupports(SimdLevel level) { return level == SimdLevel::Scalar; }
+#endif  // CQSP_LEDGER_X86
+
+#undef SCALAR_ELEMENT_LOOPS
+#undef VECTOR_ELEMENT_KERNELS
+
+#define KERNEL_TABLE(level, isa)                                                                                \
+    LedgerKernels {                                                                                             \
+        level, isa::Add, isa::Subtract, isa::Multiply, isa::Divide, isa::MultiplyAdd, isa::AddPositive,         \
+            isa::AddNegative, isa::Clamp, isa::SafeDivision, isa::MultiplySum, isa::MultiplySumInterleaved      \
+    }
+
+const LedgerKernels scalar_kernels = KERNEL_TABLE(SimdLevel::Scalar, scalar);
+#ifdef CQSP_LEDGER_X86
+const LedgerKernels sse2_kernels = KERNEL_TABLE(SimdLevel::SSE2, sse2);
+const LedgerKernels avx2_kernels = KERNEL_TABLE(SimdLevel::AVX2, avx2);
+const LedgerKernels avx512_kernels = KERNEL_TABLE(SimdLevel::AVX512, avx512);
+#endif
+
+#undef KERNEL_TABLE
+}  // namespace
+
+const char* ToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return "Scalar";
+        case SimdLevel::SSE2:
+            return "SSE2";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::AVX512:
+            return "AVX-512";
+    }
+    return "Unknown";
+}
+
+bool IsSimdLevelSupported(SimdLevel level) {
+    static const bool supported[] = {CpuSupports(SimdLevel::Scalar), CpuSupports(SimdLevel::SSE2),
+                                     CpuSupports(SimdLevel::AVX2), CpuSupports(SimdLevel::AVX512)};
+    return supported[static_cast<int>(level)];
+}
+
+SimdLevel GetBestSimdLevel() {
+    for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE2}) {
+        if (IsSimdLevelSupported(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::Scalar;
+}
+
+const LedgerKernels& GetLedgerKernels(SimdLevel level) {
+    if (!IsSimdLevelSupported(level)) {
+        return scalar_kernels;
+    }
+    switch (level) {
+#ifdef CQSP_LEDGER_X86
+        case SimdLevel::SSE2:
+            return sse2_kernels;
+        case SimdLevel::AVX2:
+            return avx2_kernels;
+        case SimdLevel::AVX512:
+            return avx512_kernels;
+#endif
+        default:
+            return scalar_kernels;
+    }
+}
+
+const LedgerKernels& GetLedgerKernels() {
+    static const LedgerKernels& kernels = GetLedgerKernels(GetBestSimdLevel());
+    return kernels;
+}
+}  // namespace cqsp::core::components
@@ -0,0 +1,68 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace cqsp::core::components {
+enum class SimdLevel { Scalar, SSE2, AVX2, AVX512 };
+
+const char* ToString(SimdLevel level);
+
+/// <summary>
+/// The loops behind the dense `ResourceLedger` operations, in one version per instruction set.
+/// </summary>
+/// Every version gives exactly the same results as the others, down to the bit. The kernels do the same
+/// operations in the same order as a plain loop would, except for `multiply_sum_interleaved`, which adds up
+/// four interleaved partial sums, (0 + 1) + (2 + 3), then the leftover elements one by one.
+struct LedgerKernels {
+    SimdLevel level;
+    // out[i] += other[i]
+    void (*add)(double* out, const double* other, size_t count);
+    // out[i] -= other[i]
+    void (*subtract)(double* out, const double* other, size_t count);
+    // out[i] *= other[i]
+    void (*multiply)(double* out, const double* other, size_t count);
+    // out[i] /= other[i]
+    void (*divide)(double* out, const double* other, size_t count);
+    // out[i] += other[i] * value, without fusing the multiply and add
+    void (*multiply_add)(double* out, const double* other, double value, size_t count);
+    // out[i] += other[i] if other[i] > 0
+    void (*add_positive)(double* out, const double* other, size_t count);
+    // out[i] -= other[i] if other[i] < 0
+    void (*add_negative)(double* out, const double* other, size_t count);
+    // out[i] = std::clamp(out[i], low, high)
+    void (*clamp)(double* out, double low, double high, size_t count);
+    // out[i] = other[i] == 0 ? fallback : out[i] / other[i]
+    void (*safe_division)(double* out, const double* other, double fallback, size_t count);
+    // Sum of first[i] * second[i], added up in order
+    double (*multiply_sum)(const double* first, const double* second, size_t count);
+    // Same sum in four interleaved lanes, which is faster but rounds differently than adding up in order
+    double (*multiply_sum_interleaved)(const double* first, const double* second, size_t count);
+};
+
+/// The best instruction set that this CPU and OS supports
+SimdLevel GetBestSimdLevel();
+
+bool IsSimdLevelSupported(SimdLevel level);
+
+/// Kernels for the best supported instruction set, this is what `ResourceLedger` uses.
+const LedgerKernels& GetLedgerKernels();
+
+/// Kernels for a specific instruction set, or the scalar ones if it isn't supported.
+const LedgerKernels& GetLedgerKernels(SimdLevel level);
+}  // namespace cqsp::core::components
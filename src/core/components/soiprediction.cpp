@@ -0,0 +1,74 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/soiprediction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace cqsp::core::components::types {
+namespace {
+// Positions come from different solvers and fits, so leave a bit of room around every boundary
+constexpr kilometer margin = 1;
+}  // namespace
+
+SOIBounds GetSOIBounds(const Orbit& orbit, const glm::dvec3& position, kilometer SOI) {
+    SOIBounds bounds;
+    bounds.position = position;
+    bounds.min_radius = orbit.GetPeriapsis();
+    bounds.max_radius = (orbit.eccentricity < 1) ? orbit.GetApoapsis() : std::numeric_limits<double>::infinity();
+    bounds.max_speed = MaxOrbitSpeed(orbit);
+    bounds.SOI = SOI;
+    return bounds;
+}
+
+double MaxOrbitSpeed(const Orbit& orbit) {
+    // Vis-viva, works for hyperbolic orbits as well because the semi major axis is negative
+    return std::sqrt(orbit.GM * (2 / orbit.GetPeriapsis() - 1 / orbit.semi_major_axis));
+}
+
+second SOISafeDuration(const Orbit& orbit, const glm::dvec3& position, kilometer parent_radius, kilometer parent_SOI,
+                       std::span<const SOIBounds> bodies) {
+    const kilometer periapsis = orbit.GetPeriapsis();
+    const kilometer apoapsis =
+        (orbit.eccentricity < 1) ? orbit.GetApoapsis() : std::numeric_limits<double>::infinity();
+    const double max_speed = MaxOrbitSpeed(orbit);
+    const kilometer radius = glm::length(position);
+
+    second duration = std::numeric_limits<double>::infinity();
+    if (periapsis <= parent_radius + margin) {
+        duration = std::min(duration, (radius - parent_radius - margin) / max_speed);
+    }
+    if (apoapsis >= parent_SOI - margin) {
+        duration = std::min(duration, (parent_SOI - radius - margin) / max_speed);
+    }
+    for (const SOIBounds& body : bodies) {
+        if (apoapsis < body.min_radius - body.SOI - margin || periapsis > body.max_radius + body.SOI + margin) {
+            continue;
+        }
+        const kilometer distance = glm::distance(position, body.position) - body.SOI - margin;
+        duration = std::min(duration, distance / (max_speed + body.max_speed));
+    }
+    // Already past one of them, or the speeds are broken
+    if (!(duration > 0)) {
+        return 0;
+    }
+    return duration;
+}
+}  // namespace cqsp::core::components::types
@@ -0,0 +1,77 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <span>
+
+#include <glm/vec3.hpp>
+
+#include "core/components/orbit.h"
+#include "core/components/units.h"
+
+namespace cqsp::core::components::types {
+/// <summary>
+/// Until when a ship can't leave the SOI it's in, crash, or enter the SOI of another body. SysOrbit skips the SOI
+/// and crash checks of the ship until then, as long as the orbit stays the same.
+/// </summary>
+struct SOIPrediction {
+    /// The orbit that the prediction was made for
+    Orbit orbit;
+    second next_check = 0;
+
+    /// <summary>
+    /// If the checks can still be skipped, because it isn't next_check yet and the orbit hasn't changed
+    /// </summary>
+    bool Holds(const Orbit& current, second time) const {
+        return time < next_check && orbit.reference_body == current.reference_body && SameElements(orbit, current);
+    }
+};
+
+/// <summary>
+/// A body that a ship could run into, in the frame of the body they are both orbiting
+/// </summary>
+struct SOIBounds {
+    glm::dvec3 position {0, 0, 0};
+    /// Closest and furthest that the body gets from the parent
+    kilometer min_radius = 0;
+    kilometer max_radius = 0;
+    /// Fastest that the body moves relative to the parent, at periapsis
+    double max_speed = 0;
+    kilometer SOI = 0;
+};
+
+SOIBounds GetSOIBounds(const Orbit& orbit, const glm::dvec3& position, kilometer SOI);
+
+/// <summary>
+/// Fastest that something on the orbit moves, which is at periapsis
+/// </summary>
+double MaxOrbitSpeed(const Orbit& orbit);
+
+/// <summary>
+/// How long a ship is guaranteed to not leave the SOI of its parent, crash into it, or enter the SOI of one of
+/// the bodies orbiting it. This is conservative, so the ship could still be fine long after this.
+/// </summary>
+/// If the range of distances that the ship can be from the parent doesn't overlap with where something can be,
+/// it can never run into it. Otherwise the distance to it can't shrink faster than the fastest that they can
+/// both move at.
+/// <param name="orbit">Orbit of the ship</param>
+/// <param name="position">Position of the ship relative to the parent</param>
+/// <param name="bodies">Bodies that are orbiting the parent</param>
+/// <returns>Seconds from now, can be infinity</returns>
+second SOISafeDuration(const Orbit& orbit, const glm::dvec3& position, kilometer parent_radius, kilometer parent_SOI,
+                       std::span<const SOIBounds> bodies);
+}  // namespace cqsp::core::components::types
@@ -31,6 +31,11 @@ struct TransportedGood {
     double amount;
     double fulfilled;
     double priority;
+    /// When a good that goes to another planet leaves, and how long it takes to get there. They are picked from the
+    /// cheapest transfer window when the space port first gets to the good, and it waits in the queue until then.
+    /// Negative until it is picked.
+    double departure = -1;
+    double flight_time = 0;
 
     TransportedGood() : good(entt::null), amount(0.0), fulfilled(0.0), priority(0) {}
     explicit TransportedGood(const MarketOrder& order, entt::entity _good)
@@ -46,6 +51,7 @@ struct TransportedGood {
  * But for now, we'll support a limited amount of space launch systems
  */
 struct SpacePort {
+    SpacePort() : SpacePort(0) {}
     explicit SpacePort(size_t goods)
         : demanded_resources(goods),
           demanded_resources_rate(goods),
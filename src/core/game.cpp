@@ -17,4 +17,11 @@
 #include "core/game.h"
 namespace cqsp::core {
 Game::Game() { script_interface.Init(); }
+
+util::ThreadPool& Game::GetThreadPool() {
+    if (thread_pool == nullptr) {
+        thread_pool = std::make_unique<util::ThreadPool>(thread_count);
+    }
+    return *thread_pool;
+}
 }  // namespace cqsp::core
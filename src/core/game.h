@@ -16,8 +16,11 @@
  */
 #pragma once
 
+#include <memory>
+
 #include "core/scripting/scripting.h"
 #include "core/universe.h"
+#include "core/util/threadpool.h"
 
 namespace cqsp::core {
 /// <summary>
@@ -33,8 +36,22 @@ class Game {
 
     scripting::ScriptInterface& GetScriptInterface() { return script_interface; }
 
+    /// <summary>
+    /// Worker threads shared by everything that runs in parallel. The threads are only started the
+    /// first time this is called.
+    /// </summary>
+    util::ThreadPool& GetThreadPool();
+
+    /// <summary>
+    /// Sets the number of worker threads, 0 is one per hardware thread. Has to be called before the
+    /// thread pool is first used.
+    /// </summary>
+    void SetThreadCount(size_t count) { thread_count = count; }
+
  private:
     Universe universe;
     scripting::ScriptInterface script_interface;
+    std::unique_ptr<util::ThreadPool> thread_pool;
+    size_t thread_count = 0;
 };
 }  // namespace cqsp::core
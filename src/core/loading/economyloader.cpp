@@ -29,6 +29,7 @@ static const char* default_config_string = R"(
         base_price_deviation: 0.75
         shortage_level: 0.8
         default_market_access: 0.8
+        market_table: true
     }
     production_config: {
         profit_multiplier: 0.001
@@ -48,6 +49,7 @@ void LoadEconomyConfig(Universe& universe, const Hjson::Value& hjson) {
     SET_ECONOMY_CONFIG(market_config, market_config, base_price_deviation);
     SET_ECONOMY_CONFIG(market_config, market_config, shortage_level);
     SET_ECONOMY_CONFIG(market_config, market_config, default_market_access);
+    universe.economy_config.market_config.market_table = static_cast<bool>(market_config["market_table"]);
     const Hjson::Value& prod_config = conf["production_config"];
     SET_ECONOMY_CONFIG(production_config, prod_config, profit_multiplier);
     SET_ECONOMY_CONFIG(production_config, prod_config, max_factory_delta);
@@ -67,6 +67,7 @@ std::optional<Orbit> LoadOrbit(const Hjson::Value& values) {
     if (!M0_correct) {
         return std::nullopt;
     }
+    orbit.UpdateRotation();
     return std::optional<Orbit>(orbit);
 }
 }  // namespace cqsp::core::loading
@@ -88,6 +88,7 @@ Orbit GetOrbit(const std::string& line_one, const std::string& line_two, const d
     orbit.GM = GM;
     orbit.M0 = m0;
     orbit.epoch = epoch;
+    orbit.UpdateRotation();
 
     return orbit;
 }
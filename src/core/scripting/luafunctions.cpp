@@ -114,6 +114,7 @@ void FunctionUniverseBodyGen(Universe& universe, sol::state_view& script_engine)
         orb.LAN = LAN;
         orb.w = w;
         orb.M0 = M0;
+        orb.UpdateRotation();
         auto& kinematics = universe.emplace<types::Kinematics>(orbital_entity);
         types::UpdatePos(kinematics, orb);
     });
@@ -16,6 +16,10 @@
  */
 #include "core/scripting/orbitfunctions.h"
 
+#include <vector>
+
+#include "core/actions/maneuver/lambert/porkchop.h"
+#include "core/components/conjunction.h"
 #include "core/components/orbit.h"
 #include "core/scripting/functionreg.h"
 
@@ -44,5 +48,44 @@ void LoadOrbitFunctions(Universe& universe, sol::state_view& script_engine) {
         SOL_PROPERTY(types::Orbit, entt::entity, reference_body));
     REGISTER_FUNCTION("get_orbit",
                       [&](entt::entity entity) -> types::Orbit& { return universe.get<types::Orbit>(entity); });
+
+    // Delta-v of every transfer, row by row for each departure time
+    REGISTER_FUNCTION("porkchop", [](const types::Orbit& departure, const types::Orbit& arrival,
+                                     const std::vector<double>& departure_times,
+                                     const std::vector<double>& flight_times) {
+        std::vector<double> delta_v(departure_times.size() * flight_times.size());
+        systems::lambert::ComputePorkchop(departure, arrival, departure_times, flight_times, delta_v);
+        return sol::as_table(delta_v);
+    });
+    REGISTER_FUNCTION("best_transfer", [](const types::Orbit& departure, const types::Orbit& arrival,
+                                          const std::vector<double>& departure_times,
+                                          const std::vector<double>& flight_times, sol::this_state state) {
+        std::vector<double> delta_v(departure_times.size() * flight_times.size());
+        systems::lambert::ComputePorkchop(departure, arrival, departure_times, flight_times, delta_v);
+        auto window = systems::lambert::BestTransfer(departure_times, flight_times, delta_v);
+        return sol::state_view(state).create_table_with("departure", window.departure, "flight_time",
+                                                        window.flight_time, "delta_v", window.delta_v);
+    });
+
+    REGISTER_FUNCTION("set_conjunction_distance", [&](double miss_distance) {
+        auto* conjunctions = universe.ctx().find<types::Conjunctions>();
+        if (conjunctions == nullptr) {
+            conjunctions = &universe.ctx().emplace<types::Conjunctions>();
+        }
+        conjunctions->miss_distance = miss_distance;
+    });
+    REGISTER_FUNCTION("get_conjunctions", [&](sol::this_state state) {
+        sol::state_view lua(state);
+        sol::table list = lua.create_table();
+        auto* conjunctions = universe.ctx().find<types::Conjunctions>();
+        if (conjunctions == nullptr) {
+            return list;
+        }
+        for (const auto& conjunction : conjunctions->conjunctions) {
+            list.add(lua.create_table_with("object", conjunction.object, "other", conjunction.other, "distance",
+                                           conjunction.distance, "start", conjunction.start));
+        }
+        return list;
+    });
 }
 }  // namespace cqsp::core::scripting
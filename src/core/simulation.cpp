@@ -47,6 +47,7 @@
 #include "core/systems/economy/sysspaceport.h"
 #include "core/systems/history/sysmarketcsvlogger.h"
 #include "core/systems/history/sysmarkethistory.h"
+#include "core/systems/movement/sysconjunction.h"
 #include "core/systems/movement/sysorbit.h"
 #include "core/systems/scriptrunner.h"
 
@@ -82,6 +83,7 @@ void Simulation::CreateSystems() {
 
     // Movement
     AddSystem<SysOrbit>();
+    AddSystem<SysConjunction>();
 }
 
 void Simulation::Init() {
@@ -89,6 +91,7 @@ void Simulation::Init() {
     for (auto& sys : system_list) {
         sys->Init();
     }
+    scheduler.Build(system_list, m_universe);
 }
 
 void Simulation::tick() {
@@ -99,10 +102,14 @@ void Simulation::tick() {
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    for (auto& sys : system_list) {
-        if (m_universe.date.GetDate() % sys->Interval() == 0) {
-            sys->DoSystem();
-        }
+    to_run.resize(system_list.size());
+    for (size_t i = 0; i < system_list.size(); i++) {
+        to_run[i] = (m_universe.date.GetDate() % system_list[i]->Interval() == 0);
+        system_list[i]->GetScratch().Reset();
+    }
+    scheduler.Run(to_run, parallel ? &m_game.GetThreadPool() : nullptr);
+    for (size_t i = 0; i < system_list.size(); i++) {
+        TracyPlot(system_names[i].c_str(), static_cast<int64_t>(system_list[i]->GetScratch().BytesUsed()));
     }
     auto end = std::chrono::high_resolution_clock::now();
     int len = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -111,4 +118,13 @@ void Simulation::tick() {
         SPDLOG_WARN("Tick has taken more than {} ms at {} ms", expected_len, len);
     }
 }
+
+std::vector<Simulation::ScratchUsage> Simulation::GetScratchUsage() const {
+    std::vector<ScratchUsage> usage;
+    for (size_t i = 0; i < system_list.size(); i++) {
+        usage.push_back({system_names[i], system_list[i]->GetScratch().BytesUsed(),
+                         system_list[i]->GetScratch().PeakBytes()});
+    }
+    return usage;
+}
 }  // namespace cqsp::core::systems::simulation
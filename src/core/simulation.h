@@ -17,10 +17,14 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include <entt/entt.hpp>
+
 #include "core/game.h"
 #include "core/systems/isimulationsystem.h"
+#include "core/systems/systemscheduler.h"
 
 namespace cqsp::core::systems::simulation {
 /// <summary>
@@ -32,6 +36,8 @@ namespace cqsp::core::systems::simulation {
 /// AddSystem<SimSystemName>();
 /// ```
 ///
+/// Systems that declare their component access with `DeclareAccess` can run at the same time as
+/// other systems, see `SystemScheduler`.
 class Simulation {
  public:
     explicit Simulation(Game &game);
@@ -42,10 +48,29 @@ class Simulation {
     void tick();
     void Init();
 
+    /// <summary>
+    /// Runs systems that don't conflict with each other on the game's thread pool. The result of a tick
+    /// is the same either way. This is on by default.
+    /// </summary>
+    void SetParallel(bool parallel) { this->parallel = parallel; }
+
+    struct ScratchUsage {
+        std::string system;
+        // Bytes of scratch memory used in the last tick, and the most used in any tick
+        size_t used;
+        size_t peak;
+    };
+
+    /// <summary>
+    /// How much of their scratch arena each system used, in the order that the systems were added.
+    /// </summary>
+    std::vector<ScratchUsage> GetScratchUsage() const;
+
     template <class T>
     void AddSystem() {
         static_assert(std::is_base_of<ISimulationSystem, T>::value);
         system_list.push_back(std::make_unique<T>(m_game));
+        system_names.emplace_back(entt::type_id<T>().name());
     }
 
  protected:
@@ -57,6 +82,13 @@ class Simulation {
     /// Holds all the systems.
     /// </summary>
     std::vector<std::unique_ptr<ISimulationSystem>> system_list;
+    // Also used as the names of the Tracy plots, so they can't change after Init
+    std::vector<std::string> system_names;
     Universe &m_universe;
+
+    SystemScheduler scheduler;
+    // Systems that are due this tick
+    std::vector<bool> to_run;
+    bool parallel = true;
 };
 }  // namespace cqsp::core::systems::simulation
@@ -39,6 +39,12 @@ struct EconomyConfig {
          * What to initialize our market access with.
          */
         double default_market_access = 0.8;
+
+        /**
+         * Keep the ledgers of all markets together in a MarketTable, so that
+         * prices and shortages can be worked out for every market in one go.
+         */
+        bool market_table = true;
     } market_config;
 
     struct ProductionConfig {
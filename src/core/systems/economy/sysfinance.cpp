@@ -19,6 +19,7 @@
 #include <tracy/Tracy.hpp>
 
 #include "core/components/market.h"
+#include "core/systems/systemaccess.h"
 
 namespace cqsp::core::systems {
 void SysWalletReset::DoSystem() {
@@ -27,4 +28,6 @@ void SysWalletReset::DoSystem() {
         wallet.Reset();
     }
 }
+
+void SysWalletReset::DeclareAccess(SystemAccess& access) { access.Write<components::Wallet>(); }
 }  // namespace cqsp::core::systems
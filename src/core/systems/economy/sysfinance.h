@@ -23,5 +23,6 @@ class SysWalletReset : public ISimulationSystem {
  public:
     explicit SysWalletReset(Game& game) : ISimulationSystem(game) {}
     void DoSystem();
+    void DeclareAccess(SystemAccess& access) override;
 };
 }  // namespace cqsp::core::systems
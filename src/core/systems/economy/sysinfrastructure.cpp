@@ -21,6 +21,8 @@
 #include "core/components/area.h"
 #include "core/components/infrastructure.h"
 #include "core/components/labor.h"
+#include "core/components/market.h"
+#include "core/systems/systemaccess.h"
 
 namespace cqsp::core::systems {
 
@@ -42,12 +44,15 @@ void InfrastructureSim::DoSystem() {
         if (construction_sector.construction_capacity == 0) {
             continue;
         }
-        components::ResourceVector vec;
-        vec.emplace_back(labor.good,
-                         static_cast<double>(construction_sector.construction_capacity) * tick_hours * 1000);
-        auto [cost, tax] = market.PurchaseFromMarket(vec);
+        components::SparseLedger labor_cost(&GetScratch());
+        labor_cost[labor.good] = static_cast<double>(construction_sector.construction_capacity) * tick_hours * 1000;
+        auto [cost, tax] = market.PurchaseFromMarket(labor_cost);
         // Then if it's zeroo we just ignore it?
         construction_sector.construction_cost = (cost + tax) / construction_sector.construction_capacity;
     }
 }
+
+void InfrastructureSim::DeclareAccess(SystemAccess& access) {
+    access.Read<components::Labor>().Write<infrastructure::ConstructionSector, components::Market>();
+}
 }  // namespace cqsp::core::systems
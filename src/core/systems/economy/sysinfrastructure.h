@@ -24,6 +24,7 @@ class InfrastructureSim : public ISimulationSystem {
  public:
     explicit InfrastructureSim(Game& game) : ISimulationSystem(game) {}
     void DoSystem();
+    void DeclareAccess(SystemAccess& access) override;
     int Interval() const override { return ECONOMIC_TICK; }
 };
 }  // namespace cqsp::core::systems
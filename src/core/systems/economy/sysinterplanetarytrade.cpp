@@ -34,7 +34,8 @@ void SysInterplanetaryTrade::DoSystem() {
         auto& habitation = market_node.get<components::Settlements>();
         // Their parent market should probably have a planetary market
         auto& planetary_market = market_node.get<components::PlanetaryMarket>();
-        planetary_market.supply_difference = (market_component.consumption - market_component.production);
+        components::expr::Assign(planetary_market.supply_difference,
+                                 components::expr::Lazy(market_component.consumption) - market_component.production);
     }
 
     ResolveTrades();
@@ -65,41 +66,23 @@ void SysInterplanetaryTrade::DoSystem() {
 }
 
 void SysInterplanetaryTrade::ResolveTrades() {
-    auto planetary_markets =
-        GetUniverse().nodes<components::Market, components::PlanetaryMarket, components::Settlements>();
-
-    for (Node seller_node : planetary_markets) {
-        // Market we are going to ship from
-        auto& seller_planetary_market = seller_node.get<components::PlanetaryMarket>();
-        auto& seller_market = seller_node.get<components::Market>();
-        for (Node buyer_node : planetary_markets) {
-            if (seller_node == buyer_node) {
-                continue;
-            }
-            // Market we are going to ship to
-            auto& buyer_planetary_market = buyer_node.get<components::PlanetaryMarket>();
-            auto& buyer_market = buyer_node.get<components::Market>();
-            // Check for any goods, check if the price is worth it, then buy it
-            // Check if the seller market needs stuff
-            for (auto good : GetUniverse().GoodIterator()) {
-                if (buyer_planetary_market.supply_difference[good] <= 0) {
-                    // Let's not process anything where supply is greater than demand for now
-                    // TODO(EhWhoAmI): Leave a way to indicate if you want a great surplus
-                    // versus a low surplus
-                    continue;
-                }
-                // Now see if the price is acceptable
-                // TODO(EhWhoAmI): Estimate the cost of the good
-                if (buyer_market.price[good] > seller_market.price[good] &&
-                    seller_market.chronic_shortages[good] <= 0) {
-                    // We should add a market order to the buyer market and then figure out
-                    // Now dump it to the market
-                    components::MarketOrder order(buyer_node, buyer_planetary_market.supply_difference[good],
-                                                  buyer_market.price[good]);
-                    seller_planetary_market.demands[GetUniverse().GetGood(good)].push_back(order);
-                }
-            }
-        }
+    ZoneScoped;
+    trading_markets.clear();
+    for (auto&& [entity, market, planetary_market, settlements] :
+         GetUniverse().view<components::Market, components::PlanetaryMarket, components::Settlements>().each()) {
+        trading_markets.push_back({entity, &market, &planetary_market});
     }
+
+    // Check if the buyer needs a good, and if the price is worth it, then put a market order in the seller
+    // TODO(EhWhoAmI): Leave a way to indicate if you want a great surplus versus a low surplus
+    // TODO(EhWhoAmI): Estimate the cost of the good
+    MatchArbitrage(trading_markets, GetUniverse().GoodCount(), &GetScratch(),
+                   [&](uint32_t seller, uint32_t buyer, components::GoodEntity good) {
+                       const TradingMarket& buyer_market = trading_markets[buyer];
+                       components::MarketOrder order(buyer_market.entity,
+                                                     buyer_market.planetary_market->supply_difference[good],
+                                                     buyer_market.market->price[good]);
+                       trading_markets[seller].planetary_market->demands[GetUniverse().GetGood(good)].push_back(order);
+                   });
 }
 }  // namespace cqsp::core::systems
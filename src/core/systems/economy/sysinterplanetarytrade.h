@@ -16,7 +16,10 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "core/systems/economy/economyconfig.h"
+#include "core/systems/economy/tradematching.h"
 #include "core/systems/isimulationsystem.h"
 #include "core/universe.h"
 
@@ -29,5 +32,8 @@ class SysInterplanetaryTrade : public ISimulationSystem {
 
  private:
     void ResolveTrades();
+
+    // Planetary markets in view order
+    std::vector<TradingMarket> trading_markets;
 };
 }  // namespace cqsp::core::systems
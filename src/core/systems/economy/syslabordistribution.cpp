@@ -17,6 +17,7 @@
 #include "core/systems/economy/syslabordistribution.h"
 
 #include <map>
+#include <memory_resource>
 
 #include <tracy/Tracy.hpp>
 
@@ -49,7 +50,7 @@ void SysLaborDistribution::HandleJob(components::PopulationSegment& segment, com
     double employment_rate_sum = 0;
     // Compute education level as well and then compute how much contribution we should provide with that
 
-    std::map<entt::entity, int> job_drift;
+    std::pmr::map<entt::entity, int> job_drift(&GetScratch());
     // Compute job drift
     for (auto& [labor, workers] : segment.labor.labor_distribution) {
         // Now sort through
@@ -21,6 +21,7 @@
 #include "core/components/labor.h"
 #include "core/components/market.h"
 #include "core/components/surface.h"
+#include "core/systems/systemaccess.h"
 
 namespace cqsp::core::systems {
 using components::Market;
@@ -45,6 +46,10 @@ void SysLaborMarket::DoSystem() {
     }
 }
 
+void SysLaborMarket::DeclareAccess(SystemAccess& access) {
+    access.Read<Market, components::PlanetaryMarket>().Write<components::Settlement>();
+}
+
 void SysLaborMarket::Init() {
     auto labor_view = GetUniverse().view<components::LaborGood>();
     for (entt::entity entity : labor_view) {
@@ -31,6 +31,7 @@ class SysLaborMarket : public ISimulationSystem {
     explicit SysLaborMarket(Game& game) : ISimulationSystem(game) {}
     void DoSystem() override;
     void Init() override;
+    void DeclareAccess(SystemAccess& access) override;
     int Interval() const override { return ECONOMIC_TICK; }
 
  private:
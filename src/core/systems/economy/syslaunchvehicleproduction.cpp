@@ -16,6 +16,9 @@
  */
 #include "core/systems/economy/syslaunchvehicleproduction.h"
 
+#include <memory_resource>
+#include <vector>
+
 #include <tracy/Tracy.hpp>
 
 #include "core/components/projects.h"
@@ -36,7 +39,7 @@ void SysLaunchVehicleProduction::DoSystem() {
             continue;
         }
         // We add the different projects together and process
-        std::vector<entt::entity> completed_projects;
+        std::pmr::vector<entt::entity> completed_projects(&GetScratch());
         for (entt::entity project : space_port_comp.projects) {
             // Then we process the project...
             auto& project_comp = GetUniverse().get<components::Project>(project);
@@ -24,20 +24,48 @@
 #include <tracy/Tracy.hpp>
 
 #include "core/components/market.h"
+#include "core/components/markettable.h"
 #include "core/components/name.h"
 #include "core/components/spaceport.h"
+#include "core/systems/systemaccess.h"
 
 namespace cqsp::core::systems {
 using components::Market;
 
+namespace {
+// Rows kept free in the market table for markets that are made while the game is running, on top of a quarter
+// of the markets that there are at the start
+const size_t SPARE_TABLE_ROWS = 16;
+}  // namespace
+
 void SysMarket::DoSystem() {
     ZoneScoped;
+    auto* table = GetUniverse().ctx().find<components::MarketTable>();
+    table_markets.clear();
+    table_rows.clear();
     auto marketview = GetUniverse().view<Market>(entt::exclude<components::PlanetaryMarket>);
     for (auto&& [entity, market] : marketview.each()) {
-        ProcessMarket(GetUniverse()(entity), market);
+        // Markets that were made after Init go in the spare rows. Once those run out, they keep their own
+        // ledgers and are worked out one at a time.
+        if (table != nullptr && table->RowCount() < table->Capacity() &&
+            table->RowOf(market) == components::MarketTable::npos) {
+            table->Attach(market);
+        }
+        ProcessMarket(GetUniverse()(entity), market, table);
+    }
+    if (table != nullptr) {
+        DeterminePrices(*table);
+        DetermineShortages(*table);
     }
 }
 
+void SysMarket::DeclareAccess(SystemAccess& access) {
+    // The prices and shortages are worked out in the market table, so it is written, not only read
+    access.Read<components::PlanetaryMarket>()
+        .Write<Market, components::infrastructure::SpacePort>()
+        .WriteResource<components::MarketTable>();
+}
+
 void SysMarket::DetermineShortages(components::Market& market) {
     ZoneScoped;
     components::ResourceLedger& market_supply = market.supply;
@@ -68,7 +96,36 @@ void SysMarket::DetermineShortages(components::Market& market) {
     market.deficit += deficit;
 }
 
-void SysMarket::ProcessMarket(Node market_node, components::Market& market) {
+void SysMarket::DetermineShortages(components::MarketTable& table) {
+    ZoneScoped;
+    const size_t goods = table.GoodCount();
+    const double shortage_limit = GetUniverse().economy_config.market_config.shortage_level;
+    const double* supply = table.Values(&Market::supply);
+    const double* demand = table.Values(&Market::demand);
+    const double* price = table.Values(&Market::price);
+    double* chronic_shortages = table.Values(&Market::chronic_shortages);
+    for (size_t i = 0; i < table_rows.size(); i++) {
+        const size_t offset = table_rows[i] * goods;
+        double deficit = 0;
+        for (size_t index = offset; index < offset + goods; index++) {
+            deficit += (demand[index] - supply[index]) * price[index];
+
+            double shortage_level = (demand[index] - supply[index]) / demand[index];
+            if (demand[index] == 0) {
+                shortage_level = 0;
+            }
+            if (shortage_level > shortage_limit) {
+                chronic_shortages[index] += shortage_level;
+            } else if (shortage_level < 0) {
+                chronic_shortages[index] -= std::max(chronic_shortages[index] - (1 - shortage_level), 0.);
+            }
+        }
+        table_markets[i]->last_deficit = deficit;
+        table_markets[i]->deficit += deficit;
+    }
+}
+
+void SysMarket::ProcessMarket(Node market_node, components::Market& market, const components::MarketTable* table) {
     ZoneScoped;
     // Add a supply if there is a space port
     if (market_node.any_of<components::infrastructure::SpacePort>()) {
@@ -94,6 +151,14 @@ void SysMarket::ProcessMarket(Node market_node, components::Market& market) {
     // Calculate Supply and demand
     // Add combined supply and demand to compute S/D ratio
     DetermineSupplyDemand(market);
+
+    // Markets in the table get their prices and shortages done all together after this
+    const size_t row = (table != nullptr) ? table->RowOf(market) : components::MarketTable::npos;
+    if (row != components::MarketTable::npos) {
+        table_markets.push_back(&market);
+        table_rows.push_back(row);
+        return;
+    }
     DeterminePrices(market);
     DetermineShortages(market);
 }
@@ -118,6 +183,27 @@ void SysMarket::DeterminePrices(components::Market& market) {
     }
 }
 
+void SysMarket::DeterminePrices(components::MarketTable& table) {
+    ZoneScoped;
+    const size_t goods = table.GoodCount();
+    const double deviation = GetUniverse().economy_config.market_config.base_price_deviation;
+    const double* base = base_prices.data();
+    const double* supply = table.Values(&Market::supply);
+    const double* demand = table.Values(&Market::demand);
+    double* price = table.Values(&Market::price);
+    for (size_t row : table_rows) {
+        const size_t offset = row * goods;
+        // Same formula as DeterminePrice, written so that the compiler can vectorize it
+        for (size_t good = 0; good < goods; good++) {
+            const double market_supply = supply[offset + good];
+            const double market_demand = demand[offset + good];
+            const double ratio =
+                (market_demand - market_supply) / (std::max(0.001, std::min(market_demand, market_supply)));
+            price[offset + good] = base[good] * (1. + deviation * std::clamp(ratio, -1., 1.));
+        }
+    }
+}
+
 void SysMarket::DetermineSupplyDemand(components::Market& market) {
     ZoneScoped;
     market.supply = market.production;
@@ -154,5 +240,16 @@ void SysMarket::Init() {
     for (auto good_node : GetUniverse().GoodIterator()) {
         base_prices[good_node] = GetUniverse().get<components::Price>(good_node);
     }
+
+    if (GetUniverse().economy_config.market_config.market_table &&
+        !GetUniverse().ctx().contains<components::MarketTable>()) {
+        // Only the markets that are processed here go in the table
+        auto marketview = GetUniverse().view<Market>(entt::exclude<components::PlanetaryMarket>);
+        const size_t capacity = marketview.size_hint() + marketview.size_hint() / 4 + SPARE_TABLE_ROWS;
+        auto& table = GetUniverse().ctx().emplace<components::MarketTable>(GetUniverse().GoodCount(), capacity);
+        for (auto&& [entity, market] : marketview.each()) {
+            table.Attach(market);
+        }
+    }
 }
 }  // namespace cqsp::core::systems
@@ -16,7 +16,10 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "core/components/market.h"
+#include "core/components/markettable.h"
 #include "core/components/resource.h"
 #include "core/systems/economy/economyconfig.h"
 #include "core/systems/isimulationsystem.h"
@@ -29,13 +32,23 @@ class SysMarket : public ISimulationSystem {
     int Interval() const override { return ECONOMIC_TICK; }
 
     void Init() override;
+    void DeclareAccess(SystemAccess& access) override;
 
  private:
     void DeterminePrice(components::Market& market, components::GoodEntity good_entity);
     void DeterminePrices(components::Market& market);
     void DetermineSupplyDemand(components::Market& market);
     void DetermineShortages(components::Market& market);
-    void ProcessMarket(Node market_node, components::Market& market);
+
+    // Same as above, but for all of the markets in the table at once
+    void DeterminePrices(components::MarketTable& table);
+    void DetermineShortages(components::MarketTable& table);
+
+    void ProcessMarket(Node market_node, components::Market& market, const components::MarketTable* table);
     components::ResourceLedger base_prices;
+
+    // Markets in the market table that were processed this tick, and their rows
+    std::vector<components::Market*> table_markets;
+    std::vector<size_t> table_rows;
 };
 }  // namespace cqsp::core::systems
@@ -19,10 +19,13 @@
 #include <tracy/Tracy.hpp>
 
 #include "core/components/market.h"
+#include "core/systems/systemaccess.h"
 
 namespace cqsp::core::systems {
 void SysMarketReset::DoSystem() {
     ZoneScoped;
     GetUniverse().view<components::Market>().each([](components::Market& market) { market.ResetLedgers(); });
 }
+
+void SysMarketReset::DeclareAccess(SystemAccess& access) { access.Write<components::Market>(); }
 }  // namespace cqsp::core::systems
@@ -29,6 +29,7 @@ class SysMarketReset : public ISimulationSystem {
  public:
     explicit SysMarketReset(Game& game) : ISimulationSystem(game) {}
     void DoSystem() override;
+    void DeclareAccess(SystemAccess& access) override;
     int Interval() const override { return ECONOMIC_TICK; }
 };
 }  // namespace cqsp::core::systems
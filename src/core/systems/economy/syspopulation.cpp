@@ -68,19 +68,21 @@ void SysPopulationConsumption::ProcessSettlement(Node& settlement, const Resourc
         consumption *= population;
 
         components::Wallet& wallet = node_segment.get_or_emplace<components::Wallet>();
-        double cost = (consumption * market.price).GetSum();
+        double cost = (components::expr::Lazy(consumption) * market.price).GetSum();
 
         if (wallet > 0) {  // If the pop has cash left over spend it
             // Add to the cost of price of transport
             const ResourceConsumption& extraconsumption = marginal_propensity_base;
 
-            double extra_cost = (extraconsumption * market.price).GetSum();  // Distribute wallet amongst goods
+            // Distribute wallet amongst goods
+            double extra_cost = (components::expr::Lazy(extraconsumption) * market.price).GetSum();
 
             extra_cost *= segment.standard_of_living;
 
             // Now we should change the value that we do
             // Also see if we have extra money and then we can adjust SOL or something like that
-            consumption += extraconsumption * segment.standard_of_living;  // Remove purchased goods from the market
+            // Remove purchased goods from the market
+            consumption += components::expr::Lazy(extraconsumption) * segment.standard_of_living;
 
             // Consumption
             // Check if there's enough on the market
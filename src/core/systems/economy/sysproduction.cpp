@@ -19,6 +19,7 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <vector>
 
 #include <tracy/Tracy.hpp>
 
@@ -30,8 +31,15 @@
 #include "core/components/organizations.h"
 #include "core/components/population.h"
 #include "core/components/surface.h"
+#include "core/game.h"
+#include "core/util/random/counterrandom.h"
 
 namespace cqsp::core::systems {
+namespace {
+// Random stream for the industry state machine, every industry only goes through one state per tick
+const uint32_t INDUSTRY_FSM_STREAM = 1;
+}  // namespace
+
 // Entry point: resets construction counters, advances the industry FSM, then runs production for every settlement.
 void SysProduction::DoSystem() {
     ZoneScoped;
@@ -42,11 +50,59 @@ void SysProduction::DoSystem() {
     }
 
     IndustryFsm();
-    for (Node entity : universe.nodes<components::IndustrialZone, components::Market>()) {
-        ProcessIndustries(entity);
+
+    settlements.clear();
+    for (entt::entity entity : universe.view<components::IndustrialZone, components::Market>()) {
+        settlements.push_back(entity);
+    }
+    settlement_taxes.assign(settlements.size(), 0.);
+
+    if (parallel) {
+        ProcessSettlementsParallel();
+    } else {
+        for (size_t i = 0; i < settlements.size(); i++) {
+            Node node(universe, settlements[i]);
+            settlement_taxes[i] = ProcessIndustries(node);
+        }
+    }
+
+    // Taxes are credited in the same order no matter how the settlements were split up, so the
+    // country totals come out the same down to the last bit.
+    for (size_t i = 0; i < settlements.size(); i++) {
+        if (settlement_taxes[i] == 0) {
+            continue;
+        }
+        auto& province = universe.get<components::Province>(settlements[i]);
+        universe.get<components::OrganizationIncome>(province.country).income_taxes += settlement_taxes[i];
     }
 }
 
+// Splits the settlements between the worker threads. Every settlement only touches its own market, its own
+// industries and its own construction sector, so the only shared state are the taxes, which are kept per
+// settlement and added up afterwards.
+void SysProduction::ProcessSettlementsParallel() {
+    ZoneScoped;
+    Universe& universe = GetUniverse();
+    // Looking up a component type for the first time creates its pool, which can't happen from several threads
+    universe.storage<components::ProductionUnit>();
+    universe.storage<components::Employer>();
+    universe.storage<components::Wallet>();
+    universe.storage<components::Recipe>();
+    universe.storage<components::Construction>();
+    universe.storage<components::ConstructionCost>();
+    universe.storage<components::Labor>();
+    universe.storage<components::Settlement>();
+    universe.storage<components::infrastructure::CityInfrastructure>();
+    universe.storage<components::infrastructure::ConstructionSector>();
+
+    GetGame().GetThreadPool().ParallelFor(0, settlements.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Node node(universe, settlements[i]);
+            settlement_taxes[i] = ProcessIndustries(node);
+        }
+    });
+}
+
 // Advances each industry's state machine by one tick. State transitions drive capacity expansion/contraction.
 void SysProduction::IndustryFsm() {
     for (auto&& [industry, production] : GetUniverse().view<components::ProductionUnit>().each()) {
@@ -105,6 +161,12 @@ void SysProduction::ProductionPreprocessing(entt::entity industry, components::P
     }
 }
 
+// Random numbers for one industry on this tick, so the draws don't depend on the order industries are visited in.
+util::CounterRandom SysProduction::IndustryRandom(entt::entity industry) {
+    return util::CounterRandom(GetUniverse().random->GetSeed(), entt::to_integral(industry),
+                               GetUniverse().date.GetDate(), INDUSTRY_FSM_STREAM);
+}
+
 // Steady operation: adds small random noise to utilization; transitions to Shrinking or Expanding on sustained losses/gains.
 components::IndustryState SysProduction::SteadyState(entt::entity industry, components::ProductionUnit& production) {
     if (production.continuous_gains < -30 * components::StarDate::DAY) {
@@ -115,7 +177,7 @@ components::IndustryState SysProduction::SteadyState(entt::entity industry, comp
         return components::IndustryState::Expanding;
     }
 
-    production.diff = 1 + GetUniverse().random->GetRandomNormal(0, 0.0005);
+    production.diff = 1 + IndustryRandom(industry).GetRandomNormal(0, 0.0005);
     production.utilization = std::clamp(production.utilization * production.diff,
                                         production_config.factory_min_utilization * production.size, production.size);
     production.utilization = std::max(1., production.utilization);
@@ -193,7 +255,7 @@ components::IndustryState SysProduction::Shrinking(entt::entity industry, compon
     }
 
     double diff = production_config.GetFactoryUtilizationDiff(production.profit);
-    diff += GetUniverse().random->GetRandomNormal(0, 0.0005);
+    diff += IndustryRandom(industry).GetRandomNormal(0, 0.0005);
     diff = std::min(diff, 1.);
 
     production.diff = diff;
@@ -218,7 +280,7 @@ components::IndustryState SysProduction::Expanding(entt::entity industry, compon
     }
 
     double diff = production_config.GetFactoryUtilizationDiff(production.profit);
-    diff += GetUniverse().random->GetRandomNormal(0, 0.0005);
+    diff += IndustryRandom(industry).GetRandomNormal(0, 0.0005);
     diff = std::max(diff, 1.);
     production.diff = diff;
     production.utilization = std::clamp(production.utilization * production.diff,
@@ -231,7 +293,7 @@ components::IndustryState SysProduction::Shortage(entt::entity industry, compone
     if (!production.shortage) {
         return components::IndustryState::SteadyState;
     }
-    production.diff = std::max(GetUniverse().random->GetRandomNormal(0.1, 0.1), 0.02);
+    production.diff = std::max(IndustryRandom(industry).GetRandomNormal(0.1, 0.1), 0.02);
     production.utilization = std::clamp(production.utilization * production.diff, 1., production.size);
     return components::IndustryState::Shortage;
 }
@@ -253,12 +315,12 @@ double SysProduction::StateToExpertiseGain(components::IndustryState state) {
     }
 }
 
-// Iterates all industries in a settlement, accumulates their tax contributions, and credits them to the province's country.
-void SysProduction::ProcessIndustries(Node& node) {
+// Iterates all industries in a settlement, and returns their tax contributions to the province's country.
+double SysProduction::ProcessIndustries(Node& node) {
     ZoneScoped;
     auto& settlement = node.get<components::Settlement>();
     if (settlement.population.empty()) {
-        return;
+        return 0;
     }
     auto& market = node.get<components::Market>();
     market.GDP = 0;
@@ -271,10 +333,7 @@ void SysProduction::ProcessIndustries(Node& node) {
     for (Node industry_node : node.Convert(industries.industries)) {
         total_taxes += ProcessIndustry(industry_node, node, market, infra_cost);
     }
-
-    auto& province = node.get<components::Province>();
-    auto& income = GetUniverse().get<components::OrganizationIncome>(province.country);
-    income.income_taxes += total_taxes;
+    return total_taxes;
 }
 
 // Runs one production tick for a single industry: handles construction spending, consumes inputs, produces outputs,
@@ -299,18 +358,17 @@ double SysProduction::ProcessIndustry(Node& industry_node, Node& market_node, co
     }
 
     // Input vectors: capital upkeep scales with physical size, operational inputs scale with utilization.
-    components::ResourceVector capitalinput = recipe.capitalcost * (size.size);
-    components::ResourceVector input = (recipe.input * size.utilization) + capitalinput;
+    // This is only evaluated when it's bought from the market, so it doesn't allocate anything.
+    auto input = components::expr::Lazy(recipe.input) * size.utilization +
+                 components::expr::Lazy(recipe.capitalcost) * size.size;
 
     // Expertise tick: working industries gain mastery over time, boosting output per unit of utilization.
     size.expertise_gain = StateToExpertiseGain(size.state);
     size.expertise += size.expertise_gain;
     size.expertise = std::clamp(size.expertise, 0., static_cast<double>(size.max_expertise));
 
-    // Output vector: single good, scaled by utilization and expertise multiplier.
-    components::ResourceVector output;
+    // Output: single good, scaled by utilization and expertise multiplier.
     size.amount_sold = recipe.output.amount * size.utilization * size.expertise;
-    output.push_back(std::pair(recipe.output.entity, size.amount_sold));
 
     // Shortage detection: flag if any material input or required labor type is chronically undersupplied.
     bool shortage = false;
@@ -333,7 +391,7 @@ double SysProduction::ProcessIndustry(Node& industry_node, Node& market_node, co
     size.shortage = shortage;
 
     // Register this industry's production and labor demand with the market for this tick.
-    market.production += output;
+    market.production[recipe.output.entity] += size.amount_sold;
 
     // Purchase inputs and labor from the market; taxes are collected on both transactions.
     auto [material_costs, taxes] = market.PurchaseFromMarket(input);
@@ -345,7 +403,7 @@ double SysProduction::ProcessIndustry(Node& industry_node, Node& market_node, co
     size.transport = 0;
 
     // Profit = revenue minus all costs. A negative profit signals the FSM to eventually shrink.
-    size.revenue = output.MultiplyAndGetSum(market.price);
+    size.revenue = size.amount_sold * market.price[recipe.output.entity];
     size.profit =
         size.revenue - size.maintenance - size.material_costs - size.wage_cost - size.transport - size.tax_cost;
 
@@ -382,10 +440,10 @@ double SysProduction::ProcessConstruction(Node& industry_node, Node& market_node
     auto& construction_cost = recipenode.get<components::ConstructionCost>();
 
     double construction_amount = construction.levels * Interval();
-    components::ResourceVector cost_vector = construction_cost.cost * construction.levels;
+    auto cost_vector = components::expr::Lazy(construction_cost.cost) * construction.levels;
 
     bool shortage = false;
-    for (auto& [good, amount] : cost_vector) {
+    for (auto& [good, amount] : construction_cost.cost) {
         if (market.chronic_shortages[good] > 5) {
             shortage = true;
             break;
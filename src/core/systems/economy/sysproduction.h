@@ -16,8 +16,11 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "core/systems/economy/economyconfig.h"
 #include "core/systems/isimulationsystem.h"
+#include "core/util/random/counterrandom.h"
 
 namespace cqsp::core::systems {
 class SysProduction : public ISimulationSystem {
@@ -27,9 +30,16 @@ class SysProduction : public ISimulationSystem {
     void DoSystem() override;
     int Interval() const override { return ECONOMIC_TICK; }
 
+    /// <summary>
+    /// Splits the settlements between the game's worker threads. The industry state machine always runs
+    /// on one thread. On by default, the results are the same either way.
+    /// </summary>
+    void SetParallel(bool parallel) { this->parallel = parallel; }
+
  private:
     // Settlement-level processing
-    void ProcessIndustries(Node& node);
+    void ProcessSettlementsParallel();
+    double ProcessIndustries(Node& node);
     double ProcessIndustry(Node& industry_node, Node& market_node, components::Market& market, double infra_cost);
     double ProcessConstruction(Node& industry_node, Node& market_node, components::Market& market);
     void ScaleConstruction(Node& industry_node, double pl_ratio);
@@ -46,7 +56,13 @@ class SysProduction : public ISimulationSystem {
     components::IndustryState Expanding(entt::entity industry, components::ProductionUnit& production);
     components::IndustryState Shortage(entt::entity industry, components::ProductionUnit& production);
     double StateToExpertiseGain(components::IndustryState state);
+    util::CounterRandom IndustryRandom(entt::entity industry);
 
     const EconomyConfig::ProductionConfig& production_config;
+
+    // Settlements processed this tick, and the taxes that each of them owes to their country
+    std::vector<entt::entity> settlements;
+    std::vector<double> settlement_taxes;
+    bool parallel = true;
 };
 }  // namespace cqsp::core::systems
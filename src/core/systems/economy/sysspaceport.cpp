@@ -16,10 +16,14 @@
  */
 #include "core/systems/economy/sysspaceport.h"
 
+#include <cmath>
+#include <limits>
+
 #include <tracy/Tracy.hpp>
 
 #include "client/components/clientctx.h"
 #include "core/actions/maneuver/commands.h"
+#include "core/actions/maneuver/lambert/izzo.h"
 #include "core/actions/maneuver/transfers.h"
 #include "core/actions/shiplaunchaction.h"
 #include "core/components/bodies.h"
@@ -34,6 +38,7 @@
 #include "core/components/spaceport.h"
 #include "core/components/surface.h"
 #include "core/util/nameutil.h"
+#include "core/util/threadpool.h"
 
 namespace cqsp::core::systems {
 void SysSpacePort::DoSystem() {
@@ -47,12 +52,12 @@ void SysSpacePort::DoSystem() {
             // Let's ignore the moon for now
             // Let's try to figure out the target
             entt::entity common_soi = commands::GetCommonSOI(GetUniverse(), port_component.reference_body, target);
-            while (!delivery_queue.empty()) {
-                components::infrastructure::TransportedGood& element = delivery_queue.back();
-                // So this disables moons or something
-                ProcessShippedGood(delivery_queue.back(), target, common_soi, port_component);
+            // Goods that wait for their transfer window stay in the queue
+            for (size_t i = delivery_queue.size(); i-- > 0;) {
                 // But we should also have non good stuff...
-                delivery_queue.pop_back();
+                if (ProcessShippedGood(delivery_queue[i], target, common_soi, port_component)) {
+                    delivery_queue.erase(delivery_queue.begin() + i);
+                }
             }
         }
     }
@@ -213,6 +218,52 @@ entt::entity SysSpacePort::ReturnFromMoonManeuver(const components::infrastructu
     GetUniverse().emplace<components::OrbitScalar>(reenter, target_body.radius * 0.9);
     command_queue.commands.push_back(reenter);
 
+    LandOnCrash(element, ship, target);
+    return ship;
+}
+
+entt::entity SysSpacePort::InterplanetaryManeuver(const components::infrastructure::TransportedGood& element,
+                                                  entt::entity reference_body, entt::entity target,
+                                                  entt::entity common_soi) {
+    entt::entity source_body = GetOrbiting(reference_body, common_soi);
+    const auto& source_orbit = GetUniverse().get<components::types::Orbit>(source_body);
+    const auto& target_orbit = GetUniverse().get<components::types::Orbit>(target);
+    // Leave now, which is up to a day after the window as space ports are only looked at once a day, but still arrive
+    // when the window does
+    const double now = GetUniverse().date.ToSecond();
+    const double arrival = element.departure + element.flight_time;
+    const double flight_time = arrival - now;
+    glm::dvec3 r1 = components::types::OrbitTimeToVec3(source_orbit, now);
+    const glm::dvec3 source_velocity = components::types::OrbitTimeToVelocityVec3(source_orbit, now);
+    // Aim for the middle of the target, so that the ship hits it and lands
+    const glm::dvec3 r2 = components::types::OrbitTimeToVec3(target_orbit, arrival);
+    glm::dvec3 v1;
+    glm::dvec3 v2;
+    if (!lambert::SolveZeroRevolution(r1, r2, flight_time, source_orbit.GM, false, v1, v2)) {
+        SPDLOG_WARN("Could not solve the transfer to {}", util::GetName(GetUniverse(), target));
+        return entt::null;
+    }
+    // Start just outside of the SOI of the body that it leaves, on the way out, so that it doesn't fall back in
+    const double source_soi = GetUniverse().get<components::bodies::Body>(source_body).SOI;
+    if (std::isfinite(source_soi)) {
+        r1 += glm::normalize(v1 - source_velocity) * source_soi * 1.01;
+        if (!lambert::SolveZeroRevolution(r1, r2, flight_time, source_orbit.GM, false, v1, v2)) {
+            SPDLOG_WARN("Could not solve the transfer to {}", util::GetName(GetUniverse(), target));
+            return entt::null;
+        }
+    }
+    components::types::Orbit transfer_orbit = components::types::Vec3ToOrbit(r1, v1, source_orbit.GM, now);
+    transfer_orbit.reference_body = common_soi;
+    entt::entity ship = core::actions::LaunchShip(GetUniverse(), transfer_orbit);
+    GetUniverse().emplace<components::Name>(
+        ship, fmt::format("{} Transport Vehicle", util::GetName(GetUniverse(), element.good)));
+    LandOnCrash(element, ship, target);
+    return ship;
+}
+
+void SysSpacePort::LandOnCrash(const components::infrastructure::TransportedGood& element, entt::entity ship,
+                               entt::entity target) {
+    auto& command_queue = GetUniverse().get_or_emplace<components::CommandQueue>(ship);
     entt::entity dock_city = GetUniverse().create();
     if (element.target_province == entt::null) {
         auto& cities = GetUniverse().get<components::Settlements>(target);
@@ -223,11 +274,9 @@ entt::entity SysSpacePort::ReturnFromMoonManeuver(const components::infrastructu
     GetUniverse().emplace<components::Trigger>(dock_city, components::Trigger::OnCrash);
     GetUniverse().emplace<components::Command>(dock_city, components::Command::LandOnBody);
     command_queue.commands.push_back(dock_city);
-
-    return ship;
 }
 
-void SysSpacePort::ProcessShippedGood(const components::infrastructure::TransportedGood& element, entt::entity target,
+bool SysSpacePort::ProcessShippedGood(components::infrastructure::TransportedGood& element, entt::entity target,
                                       entt::entity common_soi, components::infrastructure::SpacePort& port_component) {
     ZoneScoped;
     entt::entity ship = entt::null;
@@ -237,8 +286,23 @@ void SysSpacePort::ProcessShippedGood(const components::infrastructure::Transpor
     } else if (common_soi == port_component.reference_body) {
         // Target moon
         ship = TargetMoonManeuver(element, port_component.reference_body, target);
+    } else if (GetOrbiting(target, common_soi) != target) {
+        SPDLOG_ERROR("Transfers to the moons of other planets are not supported yet");
     } else {
-        SPDLOG_ERROR("Interplanetary transfers not supported yet");
+        // Goods to other planets wait for a transfer window, which is picked once, when the good is first seen
+        if (element.departure < 0) {
+            auto window = SelectTransferWindow(port_component.reference_body, target, common_soi);
+            if (!std::isfinite(window.delta_v)) {
+                SPDLOG_ERROR("No transfer to {} was found", util::GetName(GetUniverse(), target));
+                return true;
+            }
+            element.departure = window.departure;
+            element.flight_time = window.flight_time;
+        }
+        if (GetUniverse().date.ToSecond() < element.departure) {
+            return false;
+        }
+        ship = InterplanetaryManeuver(element, port_component.reference_body, target, common_soi);
     }
 
     if (ship != entt::null) {
@@ -252,6 +316,57 @@ void SysSpacePort::ProcessShippedGood(const components::infrastructure::Transpor
         }
         GetUniverse().emplace<client::ctx::VisibleOrbit>(ship);
     }
+    return true;
+}
+
+entt::entity SysSpacePort::GetOrbiting(entt::entity body, entt::entity common_soi) {
+    while (body != entt::null && GetUniverse().get<components::types::Orbit>(body).reference_body != common_soi) {
+        body = GetUniverse().get<components::types::Orbit>(body).reference_body;
+    }
+    return body;
+}
+
+lambert::TransferWindow SysSpacePort::SelectTransferWindow(entt::entity source, entt::entity target,
+                                                          entt::entity common_soi) {
+    ZoneScoped;
+    const double now = GetUniverse().date.ToSecond();
+    auto cached = transfer_windows.find(std::make_pair(source, target));
+    if (cached != transfer_windows.end() && cached->second.departure >= now) {
+        return cached->second;
+    }
+    // Transfer between the bodies that orbit the common SOI, and leave the moons for the departure and capture burns
+    entt::entity source_body = GetOrbiting(source, common_soi);
+    entt::entity target_body = GetOrbiting(target, common_soi);
+    if (source_body == entt::null || target_body == entt::null) {
+        return lambert::TransferWindow {.delta_v = std::numeric_limits<double>::infinity()};
+    }
+    const auto& source_orbit = GetUniverse().get<components::types::Orbit>(source_body);
+    const auto& target_orbit = GetUniverse().get<components::types::Orbit>(target_body);
+
+    // Departures over a synodic period, and flight times around the Hohmann transfer time
+    constexpr size_t departure_count = 64;
+    constexpr size_t flight_time_count = 32;
+    double synodic_period = 1 / std::abs(1 / source_orbit.T() - 1 / target_orbit.T());
+    if (!std::isfinite(synodic_period)) {
+        synodic_period = source_orbit.T();
+    }
+    // CalculateTransferTime only goes outwards, so get the half period of the transfer orbit directly
+    const double transfer_sma = (source_orbit.semi_major_axis + target_orbit.semi_major_axis) / 2;
+    const double hohmann_time = components::types::PI * std::sqrt(std::pow(transfer_sma, 3) / source_orbit.GM);
+    departure_times.resize(departure_count);
+    for (size_t i = 0; i < departure_count; i++) {
+        departure_times[i] = now + synodic_period * static_cast<double>(i) / departure_count;
+    }
+    flight_times.resize(flight_time_count);
+    for (size_t i = 0; i < flight_time_count; i++) {
+        flight_times[i] = hohmann_time * (0.5 + static_cast<double>(i) / (flight_time_count - 1));
+    }
+    transfer_delta_v.resize(departure_count * flight_time_count);
+    lambert::ComputePorkchop(source_orbit, target_orbit, departure_times, flight_times, transfer_delta_v, porkchop,
+                             &GetGame().GetThreadPool());
+    auto window = lambert::BestTransfer(departure_times, flight_times, transfer_delta_v);
+    transfer_windows[std::make_pair(source, target)] = window;
+    return window;
 }
 
 void SysSpacePort::ProcessLandedCargo(entt::entity space_port, entt::entity ship) {
@@ -16,6 +16,11 @@
  */
 #pragma once
 
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "core/actions/maneuver/lambert/porkchop.h"
 #include "core/components/spaceport.h"
 #include "core/systems/isimulationsystem.h"
 
@@ -32,9 +37,29 @@ class SysSpacePort : public ISimulationSystem {
                                     entt::entity reference_body, entt::entity target);
     entt::entity ReturnFromMoonManeuver(const components::infrastructure::TransportedGood& element,
                                         entt::entity reference_body, entt::entity target);
-    void ProcessShippedGood(const components::infrastructure::TransportedGood& element, entt::entity target,
+    entt::entity InterplanetaryManeuver(const components::infrastructure::TransportedGood& element,
+                                        entt::entity reference_body, entt::entity target, entt::entity common_soi);
+    void LandOnCrash(const components::infrastructure::TransportedGood& element, entt::entity ship,
+                     entt::entity target);
+    /// Returns false if the good is waiting for its transfer window, and has to stay in the queue
+    bool ProcessShippedGood(components::infrastructure::TransportedGood& element, entt::entity target,
                             entt::entity common_soi, components::infrastructure::SpacePort& port_component);
     void ProcessLandedCargo(entt::entity space_port, entt::entity ship);
     void AutoMissionQueue();
+    /// The body that body is, or is a moon of, that orbits common_soi
+    entt::entity GetOrbiting(entt::entity body, entt::entity common_soi);
+    /// <summary>
+    /// Searches the porkchop plot of the transfer from source to target, which are somewhere inside common_soi,
+    /// over the next synodic period
+    /// </summary>
+    lambert::TransferWindow SelectTransferWindow(entt::entity source, entt::entity target, entt::entity common_soi);
+
+    // Windows that haven't departed yet, so that goods going the same way don't search again
+    std::map<std::pair<entt::entity, entt::entity>, lambert::TransferWindow> transfer_windows;
+    // Porkchop buffers, kept so that they don't get reallocated every search
+    std::vector<double> departure_times;
+    std::vector<double> flight_times;
+    std::vector<double> transfer_delta_v;
+    lambert::PorkchopBuffers porkchop;
 };
 }  // namespace cqsp::core::systems
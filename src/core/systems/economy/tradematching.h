@@ -0,0 +1,79 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "core/components/market.h"
+
+namespace cqsp::core::systems {
+struct TradingMarket {
+    entt::entity entity;
+    const components::Market* market;
+    // Orders are added to this
+    components::PlanetaryMarket* planetary_market;
+};
+
+/// <summary>
+/// Finds every pair of planetary markets where the buyer wants a good (positive supply difference), the
+/// seller doesn't have a shortage of it, and the seller's price is lower than the buyer's.
+/// </summary>
+/// Calls match(seller, buyer, good) with the indices of the markets for each pair. For any seller and good,
+/// the buyers come in the same order as they are in markets.
+///
+/// Sellers are sorted by price once for each good, so each buyer only looks at the sellers that are cheaper
+/// than it, which makes this O(G * P log P) plus the number of matches, instead of checking all P^2 pairs.
+template <typename Match>
+void MatchArbitrage(const std::vector<TradingMarket>& markets, size_t good_count, std::pmr::memory_resource* memory,
+                    Match&& match) {
+    std::pmr::vector<uint32_t> sellers(memory);
+    sellers.reserve(markets.size());
+    for (size_t g = 0; g < good_count; g++) {
+        const components::GoodEntity good = components::ToGoodEntity(static_cast<uint32_t>(g));
+        sellers.clear();
+        for (uint32_t i = 0; i < markets.size(); i++) {
+            // A NaN price never compares as cheaper, so it can't sell anything
+            if (markets[i].market->chronic_shortages[good] <= 0 && !std::isnan(markets[i].market->price[good])) {
+                sellers.push_back(i);
+            }
+        }
+        std::ranges::sort(sellers, [&markets, good](uint32_t first, uint32_t second) {
+            return markets[first].market->price[good] < markets[second].market->price[good];
+        });
+        for (uint32_t buyer = 0; buyer < markets.size(); buyer++) {
+            if (markets[buyer].planetary_market->supply_difference[good] <= 0) {
+                continue;
+            }
+            const double buyer_price = markets[buyer].market->price[good];
+            for (uint32_t seller : sellers) {
+                if (!(markets[seller].market->price[good] < buyer_price)) {
+                    break;
+                }
+                if (seller != buyer) {
+                    match(seller, buyer, good);
+                }
+            }
+        }
+    }
+}
+}  // namespace cqsp::core::systems
@@ -24,10 +24,15 @@
 #include "core/components/history.h"
 #include "core/components/market.h"
 #include "core/components/name.h"
+#include "core/systems/systemaccess.h"
 
 namespace cqsp::core::systems::history {
 void SysMarketCsvHistory::Init() {}
 
+void SysMarketCsvHistory::DeclareAccess(SystemAccess& access) {
+    access.Read<components::LogMarket, components::Market, components::Identifier>();
+}
+
 void SysMarketCsvHistory::DoSystem() {
     ZoneScoped;
     // Now log every system
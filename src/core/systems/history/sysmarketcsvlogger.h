@@ -30,6 +30,7 @@ class SysMarketCsvHistory : public ISimulationSystem {
     explicit SysMarketCsvHistory(Game& game) : ISimulationSystem(game) {}
     void DoSystem();
     void Init();
+    void DeclareAccess(SystemAccess& access) override;
     ~SysMarketCsvHistory() = default;
 
     void WriteCsvHeader(const entt::entity entity);
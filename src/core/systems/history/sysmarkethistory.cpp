@@ -17,6 +17,8 @@
 #include "core/systems/history/sysmarkethistory.h"
 
 #include "core/components/history.h"
+#include "core/components/market.h"
+#include "core/systems/systemaccess.h"
 
 namespace cqsp::core::systems::history {
 void SysMarketHistory::DoSystem() {
@@ -36,4 +38,8 @@ void SysMarketHistory::DoSystem() {
     }
 }
 void SysMarketHistory::Init() {}
+
+void SysMarketHistory::DeclareAccess(SystemAccess& access) {
+    access.Read<components::Market, components::PlanetaryMarket>().Write<components::MarketHistory>();
+}
 }  // namespace cqsp::core::systems::history
@@ -24,6 +24,7 @@ class SysMarketHistory : public ISimulationSystem {
     explicit SysMarketHistory(Game& game) : ISimulationSystem(game) {}
     void DoSystem();
     void Init();
+    void DeclareAccess(SystemAccess& access) override;
     SysMarketHistory() = default;
 
     int Interval() const override { return ECONOMIC_TICK; }
@@ -20,8 +20,11 @@
 
 #include "core/game.h"
 #include "core/universe.h"
+#include "core/util/scratcharena.h"
 
 namespace cqsp::core::systems {
+class SystemAccess;
+
 class ISimulationSystem {
  public:
     explicit ISimulationSystem(Game& game) : game(game) {}
@@ -34,11 +37,21 @@ class ISimulationSystem {
     /// The default is 24
     virtual int Interval() const { return components::StarDate::DAY; }
 
+    /// Declares the components that `DoSystem` reads and writes, so that systems that don't touch
+    /// the same data can run at the same time. See `SystemAccess`.
+    /// If nothing is declared, the system runs by itself.
+    virtual void DeclareAccess(SystemAccess& access) {}
+
+    /// Memory for temporaries that only have to last until the end of `DoSystem`. The simulation resets it
+    /// at the start of every tick.
+    util::ScratchArena& GetScratch() { return scratch; }
+
  protected:
     Game& GetGame() { return game; }
     Universe& GetUniverse() { return game.GetUniverse(); }
 
  private:
     Game& game;
+    util::ScratchArena scratch;
 };
 }  // namespace cqsp::core::systems
@@ -0,0 +1,88 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/movement/sysconjunction.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include <tracy/Tracy.hpp>
+
+#include "core/components/bodies.h"
+#include "core/components/coordinates.h"
+#include "core/components/orbit.h"
+#include "core/components/ships.h"
+#include "core/systems/systemaccess.h"
+#include "core/util/threadpool.h"
+
+namespace cqsp::core::systems {
+namespace types = components::types;
+
+namespace {
+bool ConjunctionLess(const types::Conjunction& first, const types::Conjunction& second) {
+    return std::tie(first.object, first.other) < std::tie(second.object, second.other);
+}
+
+types::Conjunctions& GetConjunctions(Universe& universe) {
+    auto* conjunctions = universe.ctx().find<types::Conjunctions>();
+    if (conjunctions == nullptr) {
+        return universe.ctx().emplace<types::Conjunctions>();
+    }
+    return *conjunctions;
+}
+}  // namespace
+
+void SysConjunction::Init() { GetConjunctions(GetUniverse()); }
+
+void SysConjunction::DoSystem() {
+    ZoneScoped;
+    auto& conjunctions = GetConjunctions(GetUniverse());
+    objects.clear();
+    positions.clear();
+    groups.clear();
+    // Positions are relative to the body that they orbit, so only objects around the same body can be compared.
+    // Crashed ships all sit at the center of the body they hit, so they are left out like in SysOrbit.
+    auto view = GetUniverse().view<types::Orbit, types::Kinematics>(
+        entt::exclude<components::bodies::Body, components::ships::Crash>);
+    for (auto&& [entity, orbit, kinematics] : view.each()) {
+        objects.push_back(entity);
+        positions.push_back(kinematics.position);
+        groups.push_back(entt::to_integral(orbit.reference_body));
+    }
+    screen.Screen(positions, groups, conjunctions.miss_distance, approaches, &GetGame().GetThreadPool());
+
+    const double now = GetUniverse().date.ToSecond();
+    previous.swap(conjunctions.conjunctions);
+    conjunctions.conjunctions.clear();
+    for (const auto& approach : approaches) {
+        auto pair = std::minmax(objects[approach.first], objects[approach.second]);
+        conjunctions.conjunctions.push_back(types::Conjunction {pair.first, pair.second, approach.distance, now});
+    }
+    std::sort(conjunctions.conjunctions.begin(), conjunctions.conjunctions.end(), ConjunctionLess);
+    for (auto& conjunction : conjunctions.conjunctions) {
+        auto last = std::lower_bound(previous.begin(), previous.end(), conjunction, ConjunctionLess);
+        if (last != previous.end() && last->object == conjunction.object && last->other == conjunction.other) {
+            conjunction.start = last->start;
+        }
+    }
+}
+
+void SysConjunction::DeclareAccess(SystemAccess& access) {
+    access.Read<types::Orbit, types::Kinematics, components::bodies::Body, components::ships::Crash>()
+        .WriteResource<types::Conjunctions>();
+}
+}  // namespace cqsp::core::systems
@@ -0,0 +1,51 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "core/components/conjunction.h"
+#include "core/systems/isimulationsystem.h"
+
+namespace cqsp::core::systems {
+/// <summary>
+/// Looks for orbiting objects that are closer than types::Conjunctions::miss_distance every tick, and lists them
+/// in types::Conjunctions.
+/// </summary>
+/// Objects are only compared against objects that orbit the same body, and natural bodies and crashed ships are
+/// left out.
+class SysConjunction : public ISimulationSystem {
+ public:
+    explicit SysConjunction(Game& game) : ISimulationSystem(game) {}
+    void Init() override;
+    void DoSystem() override;
+    void DeclareAccess(SystemAccess& access) override;
+    int Interval() const override { return 1; }
+
+ private:
+    components::types::ConjunctionScreen screen;
+    std::vector<entt::entity> objects;
+    std::vector<glm::dvec3> positions;
+    std::vector<uint32_t> groups;
+    std::vector<components::types::CloseApproach> approaches;
+    // Last tick's conjunctions, to carry over when they started
+    std::vector<components::types::Conjunction> previous;
+};
+}  // namespace cqsp::core::systems
@@ -16,6 +16,7 @@
  */
 #include "core/systems/movement/sysorbit.h"
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -25,11 +26,17 @@
 
 #include "core/actions/maneuver/commands.h"
 #include "core/components/coordinates.h"
+#include "core/components/ephemeris.h"
 #include "core/components/maneuver.h"
 #include "core/components/orbit.h"
 #include "core/components/ships.h"
+#include "core/components/soiprediction.h"
+#include "core/components/orders.h"
+#include "core/components/surface.h"
 #include "core/components/units.h"
+#include "core/systems/systemaccess.h"
 #include "core/util/nameutil.h"
+#include "core/util/threadpool.h"
 
 namespace cqsp::core::systems {
 namespace ships = components::ships;
@@ -44,68 +51,211 @@ using types::Orbit;
 void SysOrbit::DoSystem() {
     ZoneScoped;
     Universe& universe = GetGame().GetUniverse();
-    // Let's parse the bodies
-    for (auto&& [entity, orbit, body, kinematics, future_pos] :
-         universe.view<Orbit, Body, Kinematics, types::FuturePosition>().each()) {
-        types::UpdateOrbit(orbit, GetUniverse().date.ToSecond());
-        kinematics.position = types::toVec3(orbit);
-        kinematics.velocity = types::OrbitVelocityToVec3(orbit, orbit.v);
-        future_pos.position =
-            types::OrbitTimeToVec3(orbit, GetUniverse().date.ToSecond() + components::StarDate::TIME_INCREMENT);
-        auto& cache = body_cache[entity];
-        cache.position = kinematics.position;
-        cache.radius = body.radius;
-        cache.SOI = body.SOI;
-        cache.future_position = future_pos.position;
+    const double time = GetUniverse().date.ToSecond();
+    const double future_time = time + components::StarDate::TIME_INCREMENT;
+
+    // The bodies follow fixed orbits, so their states come from the ephemeris instead of solving Kepler's
+    // equation every tick
+    auto& ephemeris = universe.ctx().at<types::Ephemeris>();
+    if (HierarchyChanged()) {
+        BuildHierarchy();
+    }
+    auto body_view = universe.view<Orbit, Body, Kinematics, types::FuturePosition>();
+    for (entt::entity entity : body_view) {
+        BuildChain(entity, body_chain);
+        ephemeris.SetChain(entity, body_chain);
+    }
+    util::ThreadPool* pool = parallel ? &GetGame().GetThreadPool() : nullptr;
+    ephemeris.Refresh(time, pool);
+    for (auto&& [entity, orbit, body, kinematics, future_pos] : body_view.each()) {
+        types::EphemerisState state = ephemeris.Get(entity, time);
+        glm::dvec3 future_position = ephemeris.GetPosition(entity, future_time);
+        if (ephemeris.Contains(orbit.reference_body)) {
+            // Relative to the parent
+            const types::EphemerisState parent_state = ephemeris.Get(orbit.reference_body, time);
+            state.position -= parent_state.position;
+            state.velocity -= parent_state.velocity;
+            future_position -= ephemeris.GetPosition(orbit.reference_body, future_time);
+        }
+        if (orbit.semi_major_axis != 0) {
+            orbit.v = types::TrueAnomalyFromVector(orbit, state.position);
+        }
+        kinematics.position = state.position;
+        kinematics.velocity = state.velocity;
+        future_pos.position = future_position;
+        const uint32_t h = hierarchy.IndexOf(entity);
+        if (h == bodies::BodyHierarchy::npos) {
+            continue;
+        }
+        hierarchy.position[h] = kinematics.position;
+        hierarchy.future_position[h] = future_pos.position;
+        hierarchy.radius[h] = body.radius;
+        hierarchy.SOI[h] = body.SOI;
     }
 
     // now compute our hierachy
-    ComputeCenters(GetUniverse().sun, glm::dvec3(0, 0, 0), glm::dvec3(0, 0, 0));
+    ComputeCenters();
+
+    // Propagate all the ships together first
+    orbit_batch.clear();
+    batch_entities.clear();
+    auto ship_view = universe.view<Orbit, Kinematics, types::FuturePosition>(entt::exclude<Body, ships::Crash>);
+    for (entt::entity entity : ship_view) {
+        orbit_batch.push_back(ship_view.get<Orbit>(entity));
+        batch_entities.push_back(entity);
+    }
+    types::PropagateOrbits(orbit_batch, time, future_time);
+
+    // Only the ships with a maneuver due have to look at their command queue
+    auto& schedule = commands::GetManeuverSchedule(universe);
+    due_maneuvers.clear();
+    schedule.PopDue(time, due_maneuvers);
+    std::sort(due_maneuvers.begin(), due_maneuvers.end());
+    due_maneuvers.erase(std::unique(due_maneuvers.begin(), due_maneuvers.end()), due_maneuvers.end());
+
+    // Most ships just move along their orbits, which only touches their own components, so that can be done in
+    // parallel. Maneuvers, SOI changes and crashes change the registry and run commands, so the ships that have
+    // one are put in the deferred buffer, and done one at a time afterwards, in the same order as before.
+    deferred.assign(batch_entities.size(), 0);
+    // Looking up a component makes its storage if it doesn't exist yet, which can't happen on the workers
+    universe.storage<types::SOIPrediction>();
+    auto propagate = [&](size_t begin, size_t end) {
+        std::vector<types::SOIBounds> bounds;
+        for (size_t i = begin; i < end; i++) {
+            deferred[i] = !PropagateShip(i, bounds);
+        }
+    };
+    if (pool != nullptr) {
+        pool->ParallelFor(0, batch_entities.size(), propagate, 256);
+    } else {
+        propagate(0, batch_entities.size());
+    }
 
     // ParseChildren(GetUniverse().sun);
-    for (auto&& [entity, orbit, kinematics, future_pos] :
-         universe.view<Orbit, Kinematics, types::FuturePosition>(entt::exclude<Body, ships::Crash>).each()) {
-        CalculatePosition(entity, orbit, kinematics, future_pos);
+    for (size_t i = 0; i < batch_entities.size(); i++) {
+        if (!deferred[i]) {
+            continue;
+        }
+        const entt::entity entity = batch_entities[i];
+        // Commands run for the ships before this one can change it, so check again
+        if (!universe.valid(entity) || !universe.all_of<Orbit, Kinematics, types::FuturePosition>(entity) ||
+            universe.any_of<ships::Crash>(entity)) {
+            continue;
+        }
+        auto [orbit, kinematics, future_pos] = universe.get<Orbit, Kinematics, types::FuturePosition>(entity);
+        CalculatePosition(entity, orbit, kinematics, future_pos, i);
+    }
+
+    // Only one maneuver is done per tick, so put the next one back, along with the ones that couldn't be done
+    for (entt::entity entity : due_maneuvers) {
+        if (!universe.valid(entity) || !universe.all_of<components::CommandQueue>(entity)) {
+            continue;
+        }
+        auto& queue = universe.get<components::CommandQueue>(entity);
+        if (!queue.maneuvers.empty()) {
+            schedule.Push(entity, queue.maneuvers.front().time);
+        }
     }
 }
 
+bool SysOrbit::PropagateShip(size_t index, std::vector<types::SOIBounds>& bounds) {
+    const entt::entity entity = batch_entities[index];
+    if (std::binary_search(due_maneuvers.begin(), due_maneuvers.end(), entity)) {
+        return false;
+    }
+    const auto& position = orbit_batch.position[index];
+    auto [orbit, kinematics, future_pos] = GetUniverse().get<Orbit, Kinematics, types::FuturePosition>(entity);
+
+    glm::dvec3 future_center = glm::dvec3(0, 0, 0);
+    const uint32_t parent_index = hierarchy.IndexOf(orbit.reference_body);
+    if (parent_index != bodies::BodyHierarchy::npos) {
+        // Making the prediction would change the registry structure
+        auto* prediction = GetUniverse().try_get<types::SOIPrediction>(entity);
+        if (prediction == nullptr) {
+            return false;
+        }
+        if (!prediction->Holds(orbit, GetUniverse().date.ToSecond())) {
+            const double radius = glm::length(position);
+            if (radius > hierarchy.SOI[parent_index] || radius <= hierarchy.radius[parent_index] ||
+                FindEnteredSOI(orbit.reference_body, entity, position) != entt::null) {
+                return false;
+            }
+            PredictSOIEvents(entity, orbit, position, *prediction, bounds);
+        }
+        kinematics.center = hierarchy.center[parent_index];
+        future_center = hierarchy.future_center[parent_index];
+    }
+    orbit.v = orbit_batch.true_anomaly[index];
+    kinematics.position = position;
+    kinematics.velocity = orbit_batch.velocity[index];
+    future_pos.position = orbit_batch.future_position[index];
+    future_pos.center = future_center;
+    return true;
+}
+
 void SysOrbit::CalculatePosition(entt::entity entity, components::types::Orbit& orbit,
                                  components::types::Kinematics& kinematics,
-                                 components::types::FuturePosition& future_pos) {
+                                 components::types::FuturePosition& future_pos, size_t index) {
     ZoneScoped;
     // Now let's compute all our updates
     entt::entity parent = orbit.reference_body;
-    types::UpdateOrbit(orbit, GetUniverse().date.ToSecond());
-    UpdateCommandQueue(orbit, entity, parent);
+    if (orbit_batch.Matches(index, orbit)) {
+        orbit.v = orbit_batch.true_anomaly[index];
+    } else {
+        types::UpdateOrbit(orbit, GetUniverse().date.ToSecond());
+    }
+    if (std::binary_search(due_maneuvers.begin(), due_maneuvers.end(), entity)) {
+        UpdateCommandQueue(orbit, entity, parent);
+    }
 
-    kinematics.position = types::toVec3(orbit);
-    kinematics.velocity = types::OrbitVelocityToVec3(orbit, orbit.v);
+    if (orbit_batch.Matches(index, orbit)) {
+        kinematics.position = orbit_batch.position[index];
+        kinematics.velocity = orbit_batch.velocity[index];
+    } else {
+        // A maneuver was done, so the batch is out of date
+        kinematics.position = types::toVec3(orbit);
+        kinematics.velocity = types::OrbitVelocityToVec3(orbit, orbit.v);
+    }
 
     glm::dvec3 future_center = glm::dvec3(0, 0, 0);
-    if (parent != entt::null) {
+    const uint32_t parent_index = hierarchy.IndexOf(parent);
+    if (parent_index != bodies::BodyHierarchy::npos) {
         ZoneScopedN("Future Position computation");
-        // If distance is above SOI, then be annoyed
-        auto& parent_data = body_cache[parent];
-        double SOI = parent_data.SOI;
-        if (glm::length(kinematics.position) > SOI) {
-            auto& p_bod = GetUniverse().get<components::bodies::Body>(parent);
-            auto& p_pos = GetUniverse().get_or_emplace<types::Kinematics>(parent);
-            LeaveSOI(entity, parent, orbit, kinematics, p_pos);
-        }
-
-        if (CrashObject(orbit, entity, kinematics, parent_data.radius)) {
-            return;
-        }
-
-        kinematics.center = parent_data.center;
-        future_center = parent_data.future_center;
-
-        if (CheckEnterSOI(parent, entity, kinematics)) {
-            SPDLOG_INFO("Entered SOI");
+        const double time = GetUniverse().date.ToSecond();
+        const auto* prediction = GetUniverse().try_get<types::SOIPrediction>(entity);
+        if (prediction != nullptr && prediction->Holds(orbit, time)) {
+            // Can't have left, crashed or entered anything yet
+            kinematics.center = hierarchy.center[parent_index];
+            future_center = hierarchy.future_center[parent_index];
+        } else {
+            // If distance is above SOI, then be annoyed
+            double SOI = hierarchy.SOI[parent_index];
+            if (glm::length(kinematics.position) > SOI) {
+                auto& p_bod = GetUniverse().get<components::bodies::Body>(parent);
+                auto& p_pos = GetUniverse().get_or_emplace<types::Kinematics>(parent);
+                LeaveSOI(entity, parent, orbit, kinematics, p_pos);
+            }
+
+            if (CrashObject(orbit, entity, kinematics, hierarchy.radius[parent_index])) {
+                return;
+            }
+
+            kinematics.center = hierarchy.center[parent_index];
+            future_center = hierarchy.future_center[parent_index];
+
+            if (CheckEnterSOI(parent, entity, kinematics)) {
+                SPDLOG_INFO("Entered SOI");
+            }
+            PredictSOIEvents(entity, orbit, kinematics.position,
+                             GetUniverse().get_or_emplace<types::SOIPrediction>(entity), soi_bounds);
         }
     }
-    future_pos.position =
-        types::OrbitTimeToVec3(orbit, GetUniverse().date.ToSecond() + components::StarDate::TIME_INCREMENT);
+    if (orbit_batch.Matches(index, orbit)) {
+        future_pos.position = orbit_batch.future_position[index];
+    } else {
+        future_pos.position =
+            types::OrbitTimeToVec3(orbit, GetUniverse().date.ToSecond() + components::StarDate::TIME_INCREMENT);
+    }
     future_pos.center = future_center;
 }
 
@@ -289,23 +439,23 @@ void SysOrbit::ComputePosition(entt::entity parent, entt::entity body) {
     }
     glm::dvec3 future_center = glm::dvec3(0, 0, 0);
     CalculateImpulse(orb, body);
-    if (parent != entt::null) {
+    const uint32_t parent_index = hierarchy.IndexOf(parent);
+    if (parent_index != bodies::BodyHierarchy::npos) {
         ZoneScopedN("Future Position computation");
         // If distance is above SOI, then be annoyed
-        auto& parent_data = body_cache[parent];
-        double SOI = parent_data.SOI;
+        double SOI = hierarchy.SOI[parent_index];
         if (glm::length(pos.position) > SOI) {
             auto& p_bod = GetUniverse().get<components::bodies::Body>(parent);
             auto& p_pos = GetUniverse().get_or_emplace<types::Kinematics>(parent);
             LeaveSOI(body, parent, orb, pos, p_pos);
         }
 
-        if (CrashObject(orb, body, pos, parent_data.radius)) {
+        if (CrashObject(orb, body, pos, hierarchy.radius[parent_index])) {
             return;
         }
 
-        pos.center = parent_data.center;
-        future_center = parent_data.future_center;
+        pos.center = hierarchy.center[parent_index];
+        future_center = hierarchy.future_center[parent_index];
 
         if (CheckEnterSOI(parent, body, pos)) {
             SPDLOG_INFO("Entered SOI");
@@ -324,28 +474,36 @@ bool SysOrbit::CheckEnterSOI(const entt::entity& parent, const entt::entity& bod
                  util::GetName(universe, parent));
 
     // Check parents for SOI if we're intersecting with anything
-    auto& o_system = GetUniverse().get<OrbitalSystem>(parent);
+    const entt::entity entity = FindEnteredSOI(parent, body, pos.position);
+    if (entity == entt::null) {
+        return false;
+    }
+    auto& orb = GetUniverse().get<Orbit>(body);
+    const auto& body_comp = GetUniverse().get<Body>(entity);
+    const auto& target_position = GetUniverse().get<Kinematics>(entity);
+    EnterSOI(entity, body, parent, orb, pos, body_comp, target_position);
+
+    // I have a bad feeling about this
+    commands::ProcessCommandQueue(GetUniverse(), body, components::Trigger::OnEnterSOI);
+    return true;
+}
 
+entt::entity SysOrbit::FindEnteredSOI(entt::entity parent, entt::entity body, const glm::dvec3& position) {
+    const auto& o_system = GetUniverse().get<OrbitalSystem>(parent);
     for (entt::entity entity : o_system.bodies) {
         // Get the stuff
         if (entity == body) {
             continue;
         }
 
-        auto& child_cache = body_cache[entity];
-        if (glm::distance(child_cache.position, pos.position) > child_cache.SOI) {
+        const uint32_t index = hierarchy.IndexOf(entity);
+        if (index == bodies::BodyHierarchy::npos ||
+            glm::distance(hierarchy.position[index], position) > hierarchy.SOI[index]) {
             continue;
         }
-        auto& orb = GetUniverse().get<Orbit>(body);
-        const auto& body_comp = GetUniverse().get<Body>(entity);
-        const auto& target_position = GetUniverse().get<Kinematics>(entity);
-        EnterSOI(entity, body, parent, orb, pos, body_comp, target_position);
-
-        // I have a bad feeling about this
-        commands::ProcessCommandQueue(GetUniverse(), body, components::Trigger::OnEnterSOI);
-        return true;
+        return entity;
     }
-    return false;
+    return entt::null;
 }
 
 void SysOrbit::EnterSOI(entt::entity entity, entt::entity body, entt::entity parent, Orbit& orb,
@@ -382,21 +540,126 @@ void SysOrbit::EnterSOI(entt::entity entity, entt::entity body, entt::entity par
     GetUniverse().emplace_or_replace<bodies::DirtyOrbit>(body);
 }
 
-void SysOrbit::ComputeCenters(entt::entity entity, glm::dvec3 parent_pos, glm::dvec3 future_parent_pos) {
-    auto& system = GetUniverse().get<OrbitalSystem>(entity);
-    for (const entt::entity child : system.bodies) {
-        auto& cache = body_cache[child];
-        glm::dvec3 pos = cache.position + parent_pos;
-        glm::dvec3 future_pos = cache.future_position + future_parent_pos;
+void SysOrbit::PredictSOIEvents(entt::entity entity, const Orbit& orbit, const glm::dvec3& position,
+                                types::SOIPrediction& prediction, std::vector<types::SOIBounds>& bounds) {
+    ZoneScoped;
+    prediction.orbit = orbit;
+    const entt::entity parent = orbit.reference_body;
+    const double time = GetUniverse().date.ToSecond();
+    const uint32_t parent_index = hierarchy.IndexOf(parent);
+    if (parent_index == bodies::BodyHierarchy::npos || !GetUniverse().all_of<OrbitalSystem>(parent)) {
+        prediction.next_check = time;
+        return;
+    }
+    bounds.clear();
+    for (entt::entity body : GetUniverse().get<OrbitalSystem>(parent).bodies) {
+        if (body == entity) {
+            continue;
+        }
+        const uint32_t index = hierarchy.IndexOf(body);
+        if (index == bodies::BodyHierarchy::npos) {
+            continue;
+        }
+        bounds.push_back(
+            types::GetSOIBounds(GetUniverse().get<Orbit>(body), hierarchy.position[index], hierarchy.SOI[index]));
+    }
+    prediction.next_check = time + types::SOISafeDuration(orbit, position, hierarchy.radius[parent_index],
+                                                          hierarchy.SOI[parent_index], bounds);
+}
 
-        cache.center = pos;
-        cache.future_center = future_pos;
+void SysOrbit::ComputeCenters() {
+    ZoneScoped;
+    hierarchy.ComputeCenters();
+    // The root is the star, which stays where it is
+    for (uint32_t i = 0; i < hierarchy.size(); i++) {
+        if (hierarchy.parents[i] == bodies::BodyHierarchy::npos) {
+            continue;
+        }
+        GetUniverse().get<Kinematics>(hierarchy.entities[i]).center = hierarchy.ParentCenter(i);
+        GetUniverse().get<types::FuturePosition>(hierarchy.entities[i]).center = hierarchy.FutureParentCenter(i);
+    }
+}
+
+bool SysOrbit::HierarchyChanged() {
+    return hierarchy_dirty || hierarchy.empty() || hierarchy.entities.front() != GetUniverse().sun ||
+           hierarchy_body_count != GetUniverse().view<Body>().size();
+}
 
-        ComputeCenters(child, pos, future_pos);
-        GetUniverse().get<Kinematics>(child).center = parent_pos;
-        GetUniverse().get<types::FuturePosition>(child).center = future_parent_pos;
+void SysOrbit::OnHierarchyChanged(entt::registry&, entt::entity) { hierarchy_dirty = true; }
+
+void SysOrbit::OnOrbitDirty(entt::registry& registry, entt::entity entity) {
+    // Ships get marked every time they change SOI, which doesn't matter here
+    if (registry.all_of<Body>(entity)) {
+        hierarchy_dirty = true;
     }
 }
 
-void SysOrbit::Init() {}
+void SysOrbit::ConnectHierarchySignals(bool connect) {
+    Universe& universe = GetUniverse();
+    if (connect) {
+        universe.on_construct<Body>().connect<&SysOrbit::OnHierarchyChanged>(*this);
+        universe.on_destroy<Body>().connect<&SysOrbit::OnHierarchyChanged>(*this);
+        universe.on_construct<OrbitalSystem>().connect<&SysOrbit::OnHierarchyChanged>(*this);
+        universe.on_update<OrbitalSystem>().connect<&SysOrbit::OnHierarchyChanged>(*this);
+        universe.on_destroy<OrbitalSystem>().connect<&SysOrbit::OnHierarchyChanged>(*this);
+        universe.on_construct<bodies::DirtyOrbit>().connect<&SysOrbit::OnOrbitDirty>(*this);
+        universe.on_update<bodies::DirtyOrbit>().connect<&SysOrbit::OnOrbitDirty>(*this);
+    } else {
+        universe.on_construct<Body>().disconnect(*this);
+        universe.on_destroy<Body>().disconnect(*this);
+        universe.on_construct<OrbitalSystem>().disconnect(*this);
+        universe.on_update<OrbitalSystem>().disconnect(*this);
+        universe.on_destroy<OrbitalSystem>().disconnect(*this);
+        universe.on_construct<bodies::DirtyOrbit>().disconnect(*this);
+        universe.on_update<bodies::DirtyOrbit>().disconnect(*this);
+    }
+}
+
+void SysOrbit::BuildHierarchy() {
+    ZoneScoped;
+    hierarchy.clear();
+    hierarchy_dirty = false;
+    hierarchy_body_count = GetUniverse().view<Body>().size();
+    if (!GetUniverse().valid(GetUniverse().sun)) {
+        return;
+    }
+    hierarchy.push_back(GetUniverse().sun, bodies::BodyHierarchy::npos);
+    // Everything before the cursor has had its children added already, so parents always come first
+    for (uint32_t cursor = 0; cursor < hierarchy.size(); cursor++) {
+        const entt::entity entity = hierarchy.entities[cursor];
+        if (!GetUniverse().all_of<OrbitalSystem>(entity)) {
+            continue;
+        }
+        for (const entt::entity child : GetUniverse().get<OrbitalSystem>(entity).bodies) {
+            hierarchy.push_back(child, cursor);
+        }
+    }
+}
+
+void SysOrbit::BuildChain(entt::entity body, std::vector<Orbit>& chain) {
+    chain.clear();
+    while (body != entt::null && GetUniverse().all_of<Orbit>(body)) {
+        const Orbit& orbit = GetUniverse().get<Orbit>(body);
+        chain.push_back(orbit);
+        body = orbit.reference_body;
+    }
+}
+
+SysOrbit::~SysOrbit() { ConnectHierarchySignals(false); }
+
+void SysOrbit::Init() {
+    GetUniverse().ctx().emplace<types::Ephemeris>();
+    GetUniverse().ctx().emplace<components::ManeuverSchedule>();
+    ConnectHierarchySignals(true);
+}
+
+void SysOrbit::DeclareAccess(SystemAccess& access) {
+    // Ship commands are executed from here, so this also has to cover everything that they can touch
+    access.Read<Body, components::Trigger, components::Command, components::OrbitTarget, components::OrbitScalar,
+                components::OrbitEntityTarget, components::Name, components::Identifier>()
+        .Structure<Orbit, Kinematics, types::FuturePosition, types::Impulse, types::SOIPrediction, OrbitalSystem,
+                   bodies::DirtyOrbit, ships::Crash, components::CommandQueue, components::DockedShips>()
+        .WriteResource<types::Ephemeris, components::ManeuverSchedule>()
+        .Entities();
+}
 }  // namespace cqsp::core::systems
@@ -16,30 +16,31 @@
  */
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
+#include "core/components/bodyhierarchy.h"
 #include "core/components/orbit.h"
+#include "core/components/orbitbatch.h"
+#include "core/components/soiprediction.h"
 #include "core/systems/isimulationsystem.h"
 
 namespace cqsp::core::systems {
 class SysOrbit : public ISimulationSystem {
  public:
     explicit SysOrbit(Game& game) : ISimulationSystem(game) {}
+    ~SysOrbit() override;
     void DoSystem() override;
     int Interval() const override { return 1; }
     void Init() override;
+    void DeclareAccess(SystemAccess& access) override;
 
- private:
-    struct BodyCache {
-        glm::dvec3 position;
-        glm::dvec3 center;
-        glm::dvec3 future_position;
-        glm::dvec3 future_center;
-        double SOI;
-        double radius;
-    };
+    /// <summary>
+    /// Propagates the ships on the game's worker threads. On by default, the results are the same either way.
+    /// </summary>
+    void SetParallel(bool parallel) { this->parallel = parallel; }
 
+ private:
     void ParseOrbitTree(entt::entity parent, entt::entity body);
     void ComputePosition(entt::entity parent, entt::entity body);
 
@@ -80,12 +81,77 @@ class SysOrbit : public ISimulationSystem {
     void EnterSOI(entt::entity entity, entt::entity body, entt::entity parent, components::types::Orbit& orb,
                   components::types::Kinematics& vehicle_position, const components::bodies::Body& body_comp,
                   const components::types::Kinematics& target_position);
-    void ComputeCenters(entt::entity entity, glm::dvec3 parent_pos, glm::dvec3 future_parent_pos);
+    /// <summary>
+    /// Works out the centers of the bodies from the hierarchy, and sets them in their kinematics
+    /// </summary>
+    void ComputeCenters();
+
+    /// <summary>
+    /// If bodies have been added or removed, an OrbitalSystem has been added, patched or removed, a body has been
+    /// marked with DirtyOrbit, or the star has changed, since the hierarchy was built
+    /// </summary>
+    /// Anything that moves a body to another parent has to patch the OrbitalSystem or mark the body as dirty.
+    bool HierarchyChanged();
+    void BuildHierarchy();
+
+    /// Connected to the Body and OrbitalSystem signals
+    void OnHierarchyChanged(entt::registry& registry, entt::entity entity);
+    /// Connected to the DirtyOrbit signals, only bodies change the hierarchy
+    void OnOrbitDirty(entt::registry& registry, entt::entity entity);
+    /// Connects or disconnects the signals above
+    void ConnectHierarchySignals(bool connect);
+
+    /// <summary>
+    /// Works out until when the ship can skip its SOI and crash checks
+    /// </summary>
+    /// Doesn't change the registry, so it can be called from any thread.
+    /// <param name="bounds">Scratch space</param>
+    void PredictSOIEvents(entt::entity entity, const components::types::Orbit& orbit, const glm::dvec3& position,
+                          components::types::SOIPrediction& prediction,
+                          std::vector<components::types::SOIBounds>& bounds);
+
+    /// <summary>
+    /// The body orbiting the parent whose SOI the position is in, or null if there isn't one
+    /// </summary>
+    entt::entity FindEnteredSOI(entt::entity parent, entt::entity body, const glm::dvec3& position);
+
+    /// <summary>
+    /// Moves the ship to the propagated position in orbit_batch, if nothing happens to it this tick.
+    /// </summary>
+    /// Only changes the components of the ship, so it can be called from any thread.
+    /// <param name="bounds">Scratch space</param>
+    /// <returns>false if the ship has a maneuver, SOI change or crash, and has to go through CalculatePosition
+    /// instead. Nothing is changed then.</returns>
+    bool PropagateShip(size_t index, std::vector<components::types::SOIBounds>& bounds);
+
+    /// <summary>
+    /// Gets the orbit of the body, then the orbit of its parent, and so on up to the star
+    /// </summary>
+    void BuildChain(entt::entity body, std::vector<components::types::Orbit>& chain);
+
+    /// <summary>
+    /// Moves the ship along its orbit, and handles maneuvers, SOI changes and crashes.
+    /// </summary>
+    /// <param name="index">Index of the ship in orbit_batch, which has to be propagated already</param>
     void CalculatePosition(entt::entity entity, components::types::Orbit& orbit,
-                           components::types::Kinematics& kinematics, components::types::FuturePosition& future_pos);
+                           components::types::Kinematics& kinematics, components::types::FuturePosition& future_pos,
+                           size_t index);
 
     const bool debug_prints = false;
 
-    std::unordered_map<entt::entity, BodyCache> body_cache;
+    components::bodies::BodyHierarchy hierarchy;
+    size_t hierarchy_body_count = 0;
+    bool hierarchy_dirty = true;
+
+    // Kept between ticks so that the arrays don't have to be allocated again
+    components::types::OrbitBatch orbit_batch;
+    std::vector<entt::entity> batch_entities;
+    std::vector<components::types::Orbit> body_chain;
+    std::vector<components::types::SOIBounds> soi_bounds;
+    // Sorted ships that have a maneuver due this tick
+    std::vector<entt::entity> due_maneuvers;
+    // Set for the ships in batch_entities that have to go through CalculatePosition this tick
+    std::vector<uint8_t> deferred;
+    bool parallel = true;
 };
 }  // namespace cqsp::core::systems
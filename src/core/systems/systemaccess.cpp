@@ -0,0 +1,40 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/systemaccess.h"
+
+#include <algorithm>
+
+namespace cqsp::core::systems {
+namespace {
+bool Overlaps(const std::vector<entt::id_type>& first, const std::vector<entt::id_type>& second) {
+    return std::ranges::any_of(first,
+                               [&second](entt::id_type id) { return std::ranges::find(second, id) != second.end(); });
+}
+}  // namespace
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const {
+    if (IsExclusive() || other.IsExclusive()) {
+        return true;
+    }
+    // Creating or destroying entities touches every pool that the entity is in, so it can't
+    // overlap with anything else that changes the shape of the registry.
+    if ((entities && (other.entities || other.structural)) || (other.entities && structural)) {
+        return true;
+    }
+    return Overlaps(writes, other.writes) || Overlaps(writes, other.reads) || Overlaps(reads, other.writes);
+}
+}  // namespace cqsp::core::systems
@@ -0,0 +1,117 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "core/universe.h"
+
+namespace cqsp::core::systems {
+/// <summary>
+/// Everything a simulation system touches while running `DoSystem`.
+/// </summary>
+/// The simulation uses this to decide which systems can run at the same time. Two systems are ordered
+/// (in `AddSystem` order) if one of them writes something the other one reads or writes.
+///
+/// A system that never declares anything is exclusive, and runs by itself on the simulation thread.
+/// ```
+/// void DeclareAccess(SystemAccess& access) override {
+///     access.Read<components::Market>().Write<components::Settlement>();
+/// }
+/// ```
+class SystemAccess {
+ public:
+    explicit SystemAccess(Universe& universe) : universe(universe) {}
+
+    /// Components that are only read
+    template <typename... Component>
+    SystemAccess& Read() {
+        (AddComponent<Component>(reads), ...);
+        declared = true;
+        return *this;
+    }
+
+    /// Components that are modified, but never emplaced or removed
+    template <typename... Component>
+    SystemAccess& Write() {
+        (AddComponent<Component>(writes), ...);
+        declared = true;
+        return *this;
+    }
+
+    /// Components that are emplaced or removed from entities
+    template <typename... Component>
+    SystemAccess& Structure() {
+        (AddComponent<Component>(writes), ...);
+        structural = true;
+        declared = true;
+        return *this;
+    }
+
+    /// Shared state that lives outside of the registry (such as `Universe::random`) and is only read
+    template <typename... Resource>
+    SystemAccess& ReadResource() {
+        (reads.push_back(entt::type_hash<Resource>::value()), ...);
+        declared = true;
+        return *this;
+    }
+
+    /// Shared state that lives outside of the registry (such as `Universe::random`) and is modified
+    template <typename... Resource>
+    SystemAccess& WriteResource() {
+        (writes.push_back(entt::type_hash<Resource>::value()), ...);
+        declared = true;
+        return *this;
+    }
+
+    /// The system creates or destroys entities, or checks if entities are valid
+    SystemAccess& Entities() {
+        entities = true;
+        declared = true;
+        return *this;
+    }
+
+    /// The system has to run by itself, after everything before it and before everything after it
+    SystemAccess& Exclusive() {
+        exclusive = true;
+        declared = true;
+        return *this;
+    }
+
+    bool IsExclusive() const { return exclusive || !declared; }
+
+    bool ConflictsWith(const SystemAccess& other) const;
+
+ private:
+    template <typename Component>
+    void AddComponent(std::vector<entt::id_type>& list) {
+        // Create the pool now, so that it isn't created while other systems are looking at the registry
+        universe.storage<Component>();
+        list.push_back(entt::type_hash<Component>::value());
+    }
+
+    Universe& universe;
+    std::vector<entt::id_type> reads;
+    std::vector<entt::id_type> writes;
+    bool structural = false;
+    bool entities = false;
+    bool exclusive = false;
+    bool declared = false;
+};
+}  // namespace cqsp::core::systems
@@ -0,0 +1,160 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/systemscheduler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include <tracy/Tracy.hpp>
+
+namespace cqsp::core::systems {
+void SystemScheduler::Build(const std::vector<std::unique_ptr<ISimulationSystem>>& systems, Universe& universe) {
+    nodes.clear();
+    std::vector<SystemAccess> access;
+    access.reserve(systems.size());
+    for (auto& system : systems) {
+        SystemAccess& system_access = access.emplace_back(universe);
+        system->DeclareAccess(system_access);
+        nodes.push_back({system.get(), system_access.IsExclusive(), {}});
+    }
+
+    int exclusive_count = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        exclusive_count += nodes[i].exclusive ? 1 : 0;
+        for (size_t j = i + 1; j < nodes.size(); j++) {
+            if (access[i].ConflictsWith(access[j])) {
+                nodes[i].successors.push_back(j);
+            }
+        }
+    }
+    SPDLOG_INFO("Scheduled {} simulation systems, {} of which are exclusive", nodes.size(), exclusive_count);
+}
+
+void SystemScheduler::RunSerial(const std::vector<bool>& to_run) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (to_run[i]) {
+            nodes[i].system->DoSystem();
+        }
+    }
+}
+
+void SystemScheduler::Run(const std::vector<bool>& to_run, util::ThreadPool* pool) {
+    ZoneScoped;
+    if (pool == nullptr || pool->ThreadCount() <= 1) {
+        RunSerial(to_run);
+        return;
+    }
+
+    // Number of unfinished systems each system is still waiting on
+    std::vector<size_t> pending(nodes.size(), 0);
+    size_t active = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (!to_run[i]) {
+            continue;
+        }
+        active++;
+        for (size_t successor : nodes[i].successors) {
+            if (to_run[successor]) {
+                pending[successor]++;
+            }
+        }
+    }
+
+    std::deque<size_t> ready;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (to_run[i] && pending[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    // Workers only report back which system they finished, all of the bookkeeping stays on this thread
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<size_t> completed;
+    std::exception_ptr exception;
+
+    size_t finished = 0;
+    size_t in_flight = 0;
+    bool failed = false;
+    auto complete = [&](size_t index) {
+        finished++;
+        for (size_t successor : nodes[index].successors) {
+            if (to_run[successor] && --pending[successor] == 0) {
+                ready.push_back(successor);
+            }
+        }
+    };
+
+    while (finished < active) {
+        while (!ready.empty() && !failed) {
+            size_t index = ready.front();
+            ready.pop_front();
+            if (nodes[index].exclusive) {
+                // Exclusive systems conflict with everything, so nothing else can be running right now
+                try {
+                    nodes[index].system->DoSystem();
+                } catch (...) {
+                    std::lock_guard lock(mutex);
+                    exception = std::current_exception();
+                    failed = true;
+                }
+                complete(index);
+                continue;
+            }
+            in_flight++;
+            pool->Submit([&, index]() {
+                std::exception_ptr system_exception;
+                try {
+                    nodes[index].system->DoSystem();
+                } catch (...) {
+                    system_exception = std::current_exception();
+                }
+                std::lock_guard lock(mutex);
+                if (system_exception && !exception) {
+                    exception = system_exception;
+                }
+                completed.push_back(index);
+                condition.notify_one();
+            });
+        }
+        if (in_flight == 0) {
+            // Only happens if something threw and we stopped launching systems
+            break;
+        }
+
+        std::vector<size_t> done;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&completed]() { return !completed.empty(); });
+            done.swap(completed);
+            failed = failed || exception != nullptr;
+        }
+        for (size_t index : done) {
+            in_flight--;
+            complete(index);
+        }
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+}  // namespace cqsp::core::systems
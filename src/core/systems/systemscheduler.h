@@ -0,0 +1,59 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/systems/isimulationsystem.h"
+#include "core/systems/systemaccess.h"
+#include "core/util/threadpool.h"
+
+namespace cqsp::core::systems {
+/// <summary>
+/// Runs simulation systems in parallel while keeping the results the same as running them one by one.
+/// </summary>
+/// Every system gets an edge to every later system (in `AddSystem` order) that it conflicts with, according
+/// to their `SystemAccess`. A system only starts once all of the earlier systems it conflicts with are done,
+/// so any two systems that touch the same data still see each other in the original order.
+class SystemScheduler {
+ public:
+    /// <summary>
+    /// Collects the access of every system, and builds the dependency graph.
+    /// </summary>
+    void Build(const std::vector<std::unique_ptr<ISimulationSystem>>& systems, Universe& universe);
+
+    /// <summary>
+    /// Runs all systems where to_run is true, and blocks until they are done.
+    /// </summary>
+    /// If pool is null, the systems are run in order on this thread.
+    /// Exclusive systems are always run on this thread.
+    void Run(const std::vector<bool>& to_run, util::ThreadPool* pool);
+
+ private:
+    struct SystemNode {
+        ISimulationSystem* system;
+        bool exclusive;
+        // Later systems that have to wait for this one
+        std::vector<size_t> successors;
+    };
+
+    void RunSerial(const std::vector<bool>& to_run);
+
+    std::vector<SystemNode> nodes;
+};
+}  // namespace cqsp::core::systems
@@ -0,0 +1,33 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace cqsp::core::util {
+inline constexpr uint64_t fnv_offset = 0xcbf29ce484222325;
+
+/// 64 bit FNV-1a of some bytes, mixed into `hash`. Unlike std::hash, it is the same on every platform and standard
+/// library, so it can be written to files.
+constexpr uint64_t HashBytes(std::string_view bytes, uint64_t hash = fnv_offset) {
+    for (const char c : bytes) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+    }
+    return hash;
+}
+}  // namespace cqsp::core::util
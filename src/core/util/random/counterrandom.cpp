@@ -0,0 +1,60 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/random/counterrandom.h"
+
+#include <cmath>
+#include <numbers>
+
+namespace cqsp::core::util {
+namespace {
+// 53 random bits, the most a double can hold, mapped to [0, 1)
+double ToUniform(uint32_t high, uint32_t low) {
+    const uint64_t bits = ((static_cast<uint64_t>(high) << 32) | low) >> 11;
+    return static_cast<double>(bits) * 0x1.0p-53;
+}
+}  // namespace
+
+Philox4x32::Counter CounterRandom::NextBlock() {
+    return Philox4x32::Generate({draws++, stream, tick_low, tick_high}, key);
+}
+
+double CounterRandom::GetRandomUniform() {
+    auto block = NextBlock();
+    return ToUniform(block[0], block[1]);
+}
+
+int CounterRandom::GetRandomInt(int min, int max) {
+    if (max <= min) {
+        return min;
+    }
+    auto block = NextBlock();
+    const double range = static_cast<double>(max) - static_cast<double>(min) + 1.;
+    return min + static_cast<int>(std::floor(ToUniform(block[0], block[1]) * range));
+}
+
+int CounterRandom::GetRandomNormalInt(double mean, double sd) {
+    return static_cast<int>(std::round(GetRandomNormal(mean, sd)));
+}
+
+double CounterRandom::GetRandomNormal(double mean, double sd) {
+    // Box-Muller, one block is enough for both uniforms. 1 - u keeps the log away from 0.
+    auto block = NextBlock();
+    const double u1 = 1. - ToUniform(block[0], block[1]);
+    const double u2 = ToUniform(block[2], block[3]);
+    return mean + sd * std::sqrt(-2. * std::log(u1)) * std::cos(2. * std::numbers::pi * u2);
+}
+}  // namespace cqsp::core::util
@@ -0,0 +1,60 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "core/util/random/philox.h"
+#include "core/util/random/random.h"
+
+namespace cqsp::core::util {
+/// <summary>
+/// Random numbers that only depend on (seed, entity, tick, stream), and how many numbers have been drawn
+/// from this object so far.
+/// </summary>
+/// Two objects made with the same key give out the same numbers, no matter which thread they are on
+/// or what else was drawn before them. Make one where the random numbers are needed:
+/// ```
+/// CounterRandom random(universe.random->GetSeed(), entity, universe.date.GetDate(), MY_STREAM);
+/// double noise = random.GetRandomNormal(0, 0.0005);
+/// ```
+class CounterRandom : public IRandom {
+ public:
+    CounterRandom(int _seed, uint32_t entity, uint64_t tick, uint32_t stream)
+        : IRandom(_seed),
+          key {static_cast<uint32_t>(_seed), entity},
+          tick_low(static_cast<uint32_t>(tick)),
+          tick_high(static_cast<uint32_t>(tick >> 32)),
+          stream(stream) {}
+
+    int GetRandomInt(int min, int max) override;
+    int GetRandomNormalInt(double mean, double sd) override;
+    double GetRandomNormal(double mean, double sd) override;
+
+    /// Uniform value in [0, 1)
+    double GetRandomUniform();
+
+ private:
+    Philox4x32::Counter NextBlock();
+
+    Philox4x32::Key key;
+    uint32_t tick_low;
+    uint32_t tick_high;
+    uint32_t stream;
+    uint32_t draws = 0;
+};
+}  // namespace cqsp::core::util
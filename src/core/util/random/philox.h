@@ -0,0 +1,60 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace cqsp::core::util {
+/// <summary>
+/// Philox4x32-10 counter based generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3").
+/// </summary>
+/// There's no state, every block of random bits only depends on the counter and the key, so any
+/// draw can be reproduced from anywhere without having to run through the draws before it.
+class Philox4x32 {
+ public:
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static constexpr Counter Generate(Counter counter, Key key) {
+        counter = Round(counter, key);
+        for (int i = 1; i < ROUNDS; i++) {
+            key[0] += WEYL_0;
+            key[1] += WEYL_1;
+            counter = Round(counter, key);
+        }
+        return counter;
+    }
+
+ private:
+    static constexpr int ROUNDS = 10;
+    static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53;
+    static constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+    static constexpr uint32_t WEYL_0 = 0x9E3779B9;
+    static constexpr uint32_t WEYL_1 = 0xBB67AE85;
+
+    static constexpr Counter Round(const Counter& counter, const Key& key) {
+        const uint64_t product_0 = static_cast<uint64_t>(MULTIPLIER_0) * counter[0];
+        const uint64_t product_1 = static_cast<uint64_t>(MULTIPLIER_1) * counter[2];
+        const auto hi_0 = static_cast<uint32_t>(product_0 >> 32);
+        const auto lo_0 = static_cast<uint32_t>(product_0);
+        const auto hi_1 = static_cast<uint32_t>(product_1 >> 32);
+        const auto lo_1 = static_cast<uint32_t>(product_1);
+        return {hi_1 ^ counter[1] ^ key[0], lo_1, hi_0 ^ counter[3] ^ key[1], lo_0};
+    }
+};
+}  // namespace cqsp::core::util
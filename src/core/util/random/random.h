@@ -28,6 +28,8 @@ class IRandom {
     // Random normal value with mean, and standard deviation
     virtual double GetRandomNormal(double mean, double sd) = 0;
 
+    int GetSeed() const { return seed; }
+
  protected:
     int seed;
 };
@@ -0,0 +1,100 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/autosave.h"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include <tracy/Tracy.hpp>
+
+#include "core/util/save/save.h"
+
+namespace cqsp::core::save {
+Autosave::Autosave(util::ThreadPool& pool, std::string folder, int interval)
+    : pool(pool), folder(std::move(folder)), interval(interval) {}
+
+Autosave::~Autosave() { Wait(); }
+
+bool Autosave::Tick(Universe& universe) {
+    if (interval <= 0) {
+        return false;
+    }
+    if (++ticks < interval) {
+        return false;
+    }
+    ticks = 0;
+    return Save(universe);
+}
+
+bool Autosave::Save(Universe& universe) {
+    ZoneScoped;
+    if (writing) {
+        skipped++;
+        SPDLOG_WARN("Skipping autosave, the last one is still being written");
+        return false;
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    metadata = Hjson::Marshal(save::Save(universe).GetMetadata());
+    WriteSnapshot(universe, snapshot, pool);
+    last_stall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    SPDLOG_INFO("Autosave held up the simulation for {} ms", last_stall);
+
+    writing = true;
+    writer = std::thread(&Autosave::Write, this);
+    return true;
+}
+
+void Autosave::Wait() {
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+void Autosave::Write() {
+    ZoneScoped;
+    auto start = std::chrono::steady_clock::now();
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+
+    // Written next to the old save and then moved over it, so that a crash while writing still leaves the last
+    // save in one piece
+    const std::string snapshot_path = GetSnapshotPath(folder);
+    const std::string temporary_path = snapshot_path + ".tmp";
+    bool saved = SaveSnapshot(snapshot, temporary_path);
+    if (saved) {
+        std::filesystem::rename(temporary_path, snapshot_path, error);
+        saved = !error;
+    }
+    if (saved) {
+        std::ofstream(GetMetaPath(folder)) << metadata;
+        SPDLOG_INFO("Autosaved {} KiB to {} in {} ms", snapshot.size() / 1024, folder,
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    } else {
+        SPDLOG_ERROR("Could not autosave to {}", folder);
+    }
+    writing = false;
+}
+}  // namespace cqsp::core::save
@@ -0,0 +1,63 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/binaryarchive.h"
+
+#include <cstring>
+
+namespace cqsp::core::save {
+void OutputArchive::Write(const void* data, size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    const char* begin = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), begin, begin + bytes);
+}
+
+void OutputArchive::Align() { buffer.resize((buffer.size() + archive_alignment - 1) & ~(archive_alignment - 1)); }
+
+size_t InputArchive::Size() {
+    uint64_t size = 0;
+    Value(size);
+    if (size > Remaining()) {
+        failed = true;
+        return 0;
+    }
+    return static_cast<size_t>(size);
+}
+
+void InputArchive::Read(void* value, size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    if (failed || bytes > Remaining()) {
+        failed = true;
+        std::memset(value, 0, bytes);
+        return;
+    }
+    std::memcpy(value, data + offset, bytes);
+    offset += bytes;
+}
+
+void InputArchive::Align() {
+    const size_t aligned = (offset + archive_alignment - 1) & ~(archive_alignment - 1);
+    if (aligned > length) {
+        failed = true;
+        return;
+    }
+    offset = aligned;
+}
+}  // namespace cqsp::core::save
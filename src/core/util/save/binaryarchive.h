@@ -0,0 +1,267 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+namespace cqsp::core::save {
+namespace detail {
+template <typename T>
+struct IsVector : std::false_type {};
+template <typename T, typename Allocator>
+struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+template <typename T>
+struct IsDeque : std::false_type {};
+template <typename T, typename Allocator>
+struct IsDeque<std::deque<T, Allocator>> : std::true_type {};
+
+template <typename T>
+struct IsMap : std::false_type {};
+template <typename K, typename V, typename Compare, typename Allocator>
+struct IsMap<std::map<K, V, Compare, Allocator>> : std::true_type {};
+template <typename K, typename V, typename Hash, typename Equal, typename Allocator>
+struct IsMap<std::unordered_map<K, V, Hash, Equal, Allocator>> : std::true_type {};
+
+template <typename T>
+struct IsSet : std::false_type {};
+template <typename K, typename Compare, typename Allocator>
+struct IsSet<std::set<K, Compare, Allocator>> : std::true_type {};
+template <typename K, typename Hash, typename Equal, typename Allocator>
+struct IsSet<std::unordered_set<K, Hash, Equal, Allocator>> : std::true_type {};
+
+template <typename T>
+struct IsPair : std::false_type {};
+template <typename A, typename B>
+struct IsPair<std::pair<A, B>> : std::true_type {};
+
+/// Values that are written as the bytes they have in memory
+template <typename T>
+constexpr bool is_raw = std::is_trivially_copyable_v<T> && !std::is_empty_v<T>;
+}  // namespace detail
+
+/// Arrays are aligned to this in the archive, so that they can be copied straight out of a mapped file
+inline constexpr size_t archive_alignment = 8;
+
+/// <summary>
+/// Writes the registry and the rest of a save into a byte buffer, in the format that `InputArchive` reads.
+/// </summary>
+/// Works as the archive of entt::snapshot. Values that are trivially copyable are written as the bytes they have
+/// in memory, and arrays of them (ledgers, vectors of entities) are written in one block. Standard containers are
+/// written as their size and then their elements. Anything else needs a `Serialize(archive, value)` function in
+/// this namespace, which lists its members with `archive.Fields(...)`, see componentserialization.h.
+class OutputArchive {
+ public:
+    static constexpr bool is_loading = false;
+
+    explicit OutputArchive(std::vector<char>& buffer) : buffer(buffer) {}
+
+    // These are what entt::snapshot calls
+    void operator()(std::underlying_type_t<entt::entity> count) { Value(count); }
+    void operator()(entt::entity entity) { Value(entity); }
+    template <typename Component>
+    void operator()(entt::entity entity, const Component& component) {
+        Value(entity);
+        Value(component);
+    }
+
+    template <typename... T>
+    void Fields(const T&... values) {
+        (Value(values), ...);
+    }
+
+    template <typename T>
+    void Value(const T& value) {
+        if constexpr (std::is_empty_v<T>) {
+            return;
+        } else if constexpr (detail::is_raw<T>) {
+            Write(&value, sizeof(T));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            Size(value.size());
+            Write(value.data(), value.size());
+        } else if constexpr (detail::IsVector<T>::value) {
+            Size(value.size());
+            if constexpr (detail::is_raw<typename T::value_type>) {
+                Array(value.data(), value.size());
+            } else {
+                for (const auto& element : value) {
+                    Value(element);
+                }
+            }
+        } else if constexpr (detail::IsDeque<T>::value || detail::IsSet<T>::value) {
+            Size(value.size());
+            for (const auto& element : value) {
+                Value(element);
+            }
+        } else if constexpr (detail::IsMap<T>::value) {
+            Size(value.size());
+            for (const auto& [key, mapped] : value) {
+                Value(key);
+                Value(mapped);
+            }
+        } else if constexpr (detail::IsPair<T>::value) {
+            Fields(value.first, value.second);
+        } else {
+            Serialize(*this, const_cast<T&>(value));
+        }
+    }
+
+    /// Writes count values as one aligned block
+    template <typename T>
+    void Array(const T* values, size_t count) {
+        static_assert(detail::is_raw<T>);
+        Align();
+        Write(values, sizeof(T) * count);
+    }
+
+    void Size(size_t size) { Value(static_cast<uint64_t>(size)); }
+
+    /// Pads the buffer to `archive_alignment`
+    void Align();
+
+    /// Bytes written so far
+    size_t size() const { return buffer.size(); }
+
+ private:
+    void Write(const void* data, size_t bytes);
+
+    std::vector<char>& buffer;
+};
+
+/// <summary>
+/// Reads what `OutputArchive` wrote, usually out of a `MappedFile`.
+/// </summary>
+/// The archive doesn't own the memory, it has to stay around until the archive is done. Reading past the end, or
+/// a size that can't fit in what is left, marks the archive as failed, and everything read after that is zero.
+/// Check `Failed` once everything is read.
+class InputArchive {
+ public:
+    static constexpr bool is_loading = true;
+
+    InputArchive(const char* data, size_t size) : data(data), length(size) {}
+
+    // These are what entt::snapshot_loader calls
+    void operator()(std::underlying_type_t<entt::entity>& count) {
+        Value(count);
+        // Every entity takes some bytes, see `Size`
+        if (count > Remaining()) {
+            failed = true;
+            count = 0;
+        }
+    }
+    void operator()(entt::entity& entity) { Value(entity); }
+    template <typename Component>
+    void operator()(entt::entity& entity, Component& component) {
+        Value(entity);
+        Value(component);
+    }
+
+    template <typename... T>
+    void Fields(T&... values) {
+        (Value(values), ...);
+    }
+
+    template <typename T>
+    void Value(T& value) {
+        if constexpr (std::is_empty_v<T>) {
+            return;
+        } else if constexpr (detail::is_raw<T>) {
+            Read(&value, sizeof(T));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            const size_t count = Size();
+            if (!failed) {
+                value.assign(data + offset, count);
+                offset += count;
+            }
+        } else if constexpr (detail::IsVector<T>::value) {
+            value.resize(Size());
+            if constexpr (detail::is_raw<typename T::value_type>) {
+                Array(value.data(), value.size());
+            } else {
+                for (auto& element : value) {
+                    Value(element);
+                }
+            }
+        } else if constexpr (detail::IsDeque<T>::value) {
+            value.resize(Size());
+            for (auto& element : value) {
+                Value(element);
+            }
+        } else if constexpr (detail::IsSet<T>::value) {
+            value.clear();
+            for (size_t count = Size(); count > 0; count--) {
+                typename T::value_type element {};
+                Value(element);
+                value.emplace_hint(value.end(), std::move(element));
+            }
+        } else if constexpr (detail::IsMap<T>::value) {
+            value.clear();
+            for (size_t count = Size(); count > 0; count--) {
+                typename T::key_type key {};
+                typename T::mapped_type mapped {};
+                Value(key);
+                Value(mapped);
+                value.emplace_hint(value.end(), std::move(key), std::move(mapped));
+            }
+        } else if constexpr (detail::IsPair<T>::value) {
+            Fields(value.first, value.second);
+        } else {
+            Serialize(*this, value);
+        }
+    }
+
+    /// Reads count values that were written with `OutputArchive::Array`
+    template <typename T>
+    void Array(T* values, size_t count) {
+        static_assert(detail::is_raw<T>);
+        Align();
+        Read(values, sizeof(T) * count);
+    }
+
+    /// <summary>
+    /// Reads the size of a container. Every element takes at least a byte, so a size that is bigger than what
+    /// is left can only come from a broken file, and reads as zero.
+    /// </summary>
+    size_t Size();
+
+    /// Skips the padding of `OutputArchive::Align`
+    void Align();
+
+    bool Failed() const { return failed; }
+    size_t Remaining() const { return length - offset; }
+
+ private:
+    void Read(void* value, size_t bytes);
+
+    const char* data;
+    size_t length;
+    size_t offset = 0;
+    bool failed = false;
+};
+}  // namespace cqsp::core::save
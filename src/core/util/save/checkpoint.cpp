@@ -0,0 +1,502 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/checkpoint.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <tracy/Tracy.hpp>
+
+#include "core/util/save/binaryarchive.h"
+#include "core/util/save/componentserialization.h"
+#include "core/util/save/mappedfile.h"
+
+namespace cqsp::core::save {
+namespace {
+constexpr std::array<char, 8> checkpoint_magic = {'C', 'Q', 'S', 'P', 'C', 'H', 'K', 'P'};
+constexpr const char* checkpoint_extension = ".checkpoint";
+
+// A full checkpoint is followed by a snapshot, any other checkpoint by what changed since the one before it:
+// the universe's state, the tables if they changed, the entities that were destroyed and made, and then for
+// each pool that changed, its index, the entities that lost the component, and the components that changed.
+// The pools end with `end_of_pools`.
+struct CheckpointHeader {
+    std::array<char, 8> magic = checkpoint_magic;
+    uint32_t version = checkpoint_version;
+    uint32_t snapshot = snapshot_version;
+    uint32_t sequence = 0;
+    uint32_t full = 0;
+};
+
+constexpr uint32_t end_of_pools = ~uint32_t {0};
+
+uint64_t HashBytes(const std::vector<char>& bytes) {
+    uint64_t hash = bytes.size();
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        hash = (hash ^ word) * 0x9e3779b97f4a7c15;
+        hash ^= hash >> 29;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+    hash = (hash ^ tail) * 0x9e3779b97f4a7c15;
+    return hash ^ (hash >> 29);
+}
+
+uint64_t HashTables(const Universe& universe) {
+    std::vector<char> buffer;
+    OutputArchive archive(buffer);
+    UniverseTables(archive, universe);
+    return HashBytes(buffer);
+}
+
+// Sorted
+std::vector<entt::entity> AliveEntities(const Universe& universe) {
+    std::vector<entt::entity> entities;
+    entities.reserve(universe.alive());
+    universe.each([&](entt::entity entity) { entities.push_back(entity); });
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+// Records are aligned, so that a component is the same bytes wherever it is written, and can be hashed on its own
+template <typename Component>
+void WriteRecord(OutputArchive& archive, const Universe& universe, entt::entity entity) {
+    archive.Align();
+    if constexpr (std::is_empty_v<Component>) {
+        archive(entity);
+    } else {
+        archive(entity, universe.get<Component>(entity));
+    }
+}
+
+// Puts the components of the pool that changed since the last checkpoint into `pool.delta`. For the base of a
+// chain, the hashes are only remembered, because the snapshot has every component already.
+template <typename Component>
+void WritePoolDelta(const Universe& universe, uint32_t index, CheckpointPool& pool, bool base) {
+    std::sort(pool.touched.begin(), pool.touched.end());
+    pool.touched.erase(std::unique(pool.touched.begin(), pool.touched.end()), pool.touched.end());
+
+    // Entities that were destroyed are in the list of destroyed entities instead
+    std::vector<entt::entity> removed;
+    for (entt::entity entity : pool.touched) {
+        const bool valid = universe.valid(entity);
+        if (valid && universe.all_of<Component>(entity)) {
+            continue;
+        }
+        if (pool.hashes.erase(entity) != 0 && valid) {
+            removed.push_back(entity);
+        }
+    }
+
+    std::vector<entt::entity> changed;
+    std::vector<char> record;
+    for (entt::entity entity : universe.view<const Component>()) {
+        record.clear();
+        OutputArchive archive(record);
+        WriteRecord<Component>(archive, universe, entity);
+        const uint64_t hash = HashBytes(record);
+        auto [it, inserted] = pool.hashes.try_emplace(entity, hash);
+        if (inserted || it->second != hash ||
+            std::binary_search(pool.touched.begin(), pool.touched.end(), entity)) {
+            it->second = hash;
+            changed.push_back(entity);
+        }
+    }
+    pool.touched.clear();
+    pool.delta.clear();
+    pool.records = changed.size() + removed.size();
+    if (base || pool.records == 0) {
+        return;
+    }
+
+    OutputArchive archive(pool.delta);
+    archive.Value(index);
+    archive.Value(removed);
+    archive.Size(changed.size());
+    for (entt::entity entity : changed) {
+        WriteRecord<Component>(archive, universe, entity);
+    }
+    archive.Align();
+}
+
+// The entt snapshot loader can only fill an empty registry, so the changes are put in one by one
+template <typename Component>
+bool ApplyPoolDelta(Universe& universe, InputArchive& archive) {
+    std::vector<entt::entity> removed;
+    archive.Value(removed);
+    for (entt::entity entity : removed) {
+        if (universe.valid(entity)) {
+            universe.remove<Component>(entity);
+        }
+    }
+    for (size_t count = archive.Size(); count > 0; count--) {
+        archive.Align();
+        entt::entity entity;
+        if constexpr (std::is_empty_v<Component>) {
+            archive(entity);
+            if (archive.Failed() || !universe.valid(entity)) {
+                return false;
+            }
+            universe.emplace_or_replace<Component>(entity);
+        } else {
+            Component component {};
+            archive(entity, component);
+            if (archive.Failed() || !universe.valid(entity)) {
+                return false;
+            }
+            universe.emplace_or_replace<Component>(entity, std::move(component));
+        }
+    }
+    archive.Align();
+    return !archive.Failed();
+}
+
+using PoolDeltaWriter = void (*)(const Universe&, uint32_t, CheckpointPool&, bool);
+using PoolDeltaReader = bool (*)(Universe&, InputArchive&);
+
+template <typename... Component>
+constexpr std::array<PoolDeltaWriter, sizeof...(Component)> PoolDeltaWriters(entt::type_list<Component...>) {
+    return {&WritePoolDelta<Component>...};
+}
+
+template <typename... Component>
+constexpr std::array<PoolDeltaReader, sizeof...(Component)> PoolDeltaReaders(entt::type_list<Component...>) {
+    return {&ApplyPoolDelta<Component>...};
+}
+
+constexpr auto pool_delta_writers = PoolDeltaWriters(SnapshotComponents {});
+constexpr auto pool_delta_readers = PoolDeltaReaders(SnapshotComponents {});
+
+std::string CheckpointPath(const std::string& folder, uint32_t sequence) {
+    return (std::filesystem::path(folder) / fmt::format("{:08}{}", sequence, checkpoint_extension)).string();
+}
+
+// Sequence numbers and paths of the checkpoints in the folder, in order
+std::map<uint32_t, std::string> ListCheckpoints(const std::string& folder) {
+    std::map<uint32_t, std::string> checkpoints;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(folder, error)) {
+        if (entry.path().extension() != checkpoint_extension) {
+            continue;
+        }
+        const std::string stem = entry.path().stem().string();
+        if (stem.empty() || !std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        checkpoints[static_cast<uint32_t>(std::stoul(stem))] = entry.path().string();
+    }
+    return checkpoints;
+}
+
+// Returns the size of the file, or 0 if it couldn't be written
+size_t WriteCheckpoint(const std::string& path, const CheckpointHeader& header,
+                       const std::vector<const std::vector<char>*>& blocks) {
+    {
+        std::unique_ptr<FILE, decltype(&std::fclose)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+        if (file == nullptr || std::fwrite(&header, sizeof(header), 1, file.get()) != 1) {
+            return 0;
+        }
+        for (const std::vector<char>* block : blocks) {
+            if (std::fwrite(block->data(), 1, block->size(), file.get()) != block->size()) {
+                return 0;
+            }
+        }
+    }
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    return error ? 0 : static_cast<size_t>(size);
+}
+
+// A mapped checkpoint file, with its header checked
+struct CheckpointFile {
+    std::unique_ptr<MappedFile> file;
+    CheckpointHeader header;
+
+    bool Open(const std::string& path) {
+        file = std::make_unique<MappedFile>(path);
+        if (!file->IsOpen() || file->size() < sizeof(header)) {
+            SPDLOG_ERROR("Could not read checkpoint {}", path);
+            return false;
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.magic != checkpoint_magic || header.version != checkpoint_version ||
+            header.snapshot != snapshot_version) {
+            SPDLOG_ERROR("Checkpoint {} is from another version", path);
+            return false;
+        }
+        return true;
+    }
+
+    const char* data() const { return file->data() + sizeof(header); }
+    size_t size() const { return file->size() - sizeof(header); }
+};
+
+bool ApplyDelta(Universe& universe, const CheckpointFile& checkpoint) {
+    InputArchive archive(checkpoint.data(), checkpoint.size());
+    UniverseState(archive, universe);
+    uint8_t tables_changed = 0;
+    archive.Value(tables_changed);
+    if (tables_changed != 0) {
+        UniverseTables(archive, universe);
+    }
+    std::vector<entt::entity> destroyed;
+    std::vector<entt::entity> created;
+    archive.Fields(destroyed, created);
+    archive.Align();
+    if (archive.Failed()) {
+        return false;
+    }
+    for (entt::entity entity : destroyed) {
+        if (universe.valid(entity)) {
+            universe.destroy(entity);
+        }
+    }
+    for (entt::entity entity : created) {
+        if (universe.valid(entity) || universe.create(entity) != entity) {
+            return false;
+        }
+    }
+
+    while (true) {
+        uint32_t index = end_of_pools;
+        archive.Value(index);
+        if (archive.Failed()) {
+            return false;
+        }
+        if (index == end_of_pools) {
+            break;
+        }
+        if (index >= pool_delta_readers.size() || !pool_delta_readers[index](universe, archive)) {
+            return false;
+        }
+    }
+    return archive.Remaining() == 0;
+}
+
+// Loads the last full checkpoint in the folder, and every checkpoint after it, and returns the sequence of the
+// newest one
+bool LoadChain(Universe& universe, const std::string& folder, uint32_t& sequence) {
+    const auto checkpoints = ListCheckpoints(folder);
+    if (checkpoints.empty()) {
+        SPDLOG_ERROR("No checkpoints in {}", folder);
+        return false;
+    }
+    // Go back from the newest checkpoint until a full one, with no gaps in between
+    std::vector<CheckpointFile> chain;
+    uint32_t expected = checkpoints.rbegin()->first;
+    for (auto it = checkpoints.rbegin(); it != checkpoints.rend() && it->first == expected; ++it, --expected) {
+        if (!chain.emplace_back().Open(it->second)) {
+            return false;
+        }
+        if (chain.back().header.full != 0) {
+            break;
+        }
+    }
+    if (chain.back().header.full == 0) {
+        SPDLOG_ERROR("Checkpoints in {} don't go back to a full checkpoint", folder);
+        return false;
+    }
+    std::reverse(chain.begin(), chain.end());
+
+    if (!ReadSnapshot(universe, chain.front().data(), chain.front().size())) {
+        return false;
+    }
+    for (size_t i = 1; i < chain.size(); i++) {
+        if (!ApplyDelta(universe, chain[i])) {
+            SPDLOG_ERROR("Checkpoint {} in {} is broken", chain[i].header.sequence, folder);
+            universe.clear();
+            return false;
+        }
+    }
+    if (chain.size() > 1) {
+        RebuildDerived(universe);
+    }
+    sequence = chain.back().header.sequence;
+    return true;
+}
+}  // namespace
+
+CheckpointWriter::CheckpointWriter(Universe& universe, util::ThreadPool& pool, std::string folder)
+    : universe(universe), pool(pool), folder(std::move(folder)), pools(SnapshotComponents::size) {
+    std::error_code error;
+    std::filesystem::create_directories(this->folder, error);
+    const auto checkpoints = ListCheckpoints(this->folder);
+    sequence = checkpoints.empty() ? 0 : checkpoints.rbegin()->first + 1;
+
+    [this]<size_t... Index>(std::index_sequence<Index...>) {
+        (ConnectPool<Index>(true), ...);
+    }(std::make_index_sequence<SnapshotComponents::size> {});
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    [this]<size_t... Index>(std::index_sequence<Index...>) {
+        (ConnectPool<Index>(false), ...);
+    }(std::make_index_sequence<SnapshotComponents::size> {});
+}
+
+template <size_t Index>
+void CheckpointWriter::Touch(entt::registry&, entt::entity entity) {
+    pools[Index].touched.push_back(entity);
+}
+
+template <size_t Index>
+void CheckpointWriter::ConnectPool(bool connect) {
+    using Component = entt::type_list_element_t<Index, SnapshotComponents>;
+    if (connect) {
+        universe.on_construct<Component>().template connect<&CheckpointWriter::Touch<Index>>(*this);
+        universe.on_update<Component>().template connect<&CheckpointWriter::Touch<Index>>(*this);
+        universe.on_destroy<Component>().template connect<&CheckpointWriter::Touch<Index>>(*this);
+    } else {
+        universe.on_construct<Component>().disconnect(*this);
+        universe.on_update<Component>().disconnect(*this);
+        universe.on_destroy<Component>().disconnect(*this);
+    }
+}
+
+size_t CheckpointWriter::Checkpoint() {
+    ZoneScoped;
+    const std::string path = CheckpointPath(folder, sequence);
+    const size_t size = has_base ? WriteDelta(path) : WriteBase(path);
+    // The hashes already moved on, so if it wasn't written the next checkpoint has to start a new chain
+    has_base = size != 0;
+    if (size == 0) {
+        SPDLOG_ERROR("Could not write checkpoint {}", path);
+        return 0;
+    }
+    sequence++;
+    return size;
+}
+
+void CheckpointWriter::WritePools(bool base) {
+    pool.ParallelFor(0, pools.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            pool_delta_writers[i](universe, static_cast<uint32_t>(i), pools[i], base);
+        }
+    });
+    changed_records = 0;
+    for (const CheckpointPool& component_pool : pools) {
+        changed_records += component_pool.records;
+    }
+}
+
+size_t CheckpointWriter::WriteBase(const std::string& path) {
+    WriteSnapshot(universe, snapshot, pool);
+    WritePools(true);
+    entities = AliveEntities(universe);
+    tables_hash = HashTables(universe);
+
+    CheckpointHeader header;
+    header.sequence = sequence;
+    header.full = 1;
+    std::vector<const std::vector<char>*> blocks;
+    for (const auto& part : snapshot.parts) {
+        blocks.push_back(&part);
+    }
+    return WriteCheckpoint(path, header, blocks);
+}
+
+size_t CheckpointWriter::WriteDelta(const std::string& path) {
+    std::vector<entt::entity> alive = AliveEntities(universe);
+    std::vector<entt::entity> destroyed;
+    std::vector<entt::entity> created;
+    std::set_difference(entities.begin(), entities.end(), alive.begin(), alive.end(), std::back_inserter(destroyed));
+    std::set_difference(alive.begin(), alive.end(), entities.begin(), entities.end(), std::back_inserter(created));
+    entities = std::move(alive);
+
+    const uint64_t new_tables_hash = HashTables(universe);
+    const uint8_t tables_changed = new_tables_hash != tables_hash;
+    tables_hash = new_tables_hash;
+
+    head.clear();
+    OutputArchive archive(head);
+    UniverseState(archive, universe);
+    archive.Value(tables_changed);
+    if (tables_changed != 0) {
+        UniverseTables(archive, universe);
+    }
+    archive.Fields(destroyed, created);
+    archive.Align();
+
+    WritePools(false);
+
+    std::vector<char> tail;
+    OutputArchive(tail).Value(end_of_pools);
+
+    CheckpointHeader header;
+    header.sequence = sequence;
+    std::vector<const std::vector<char>*> blocks {&head};
+    for (const CheckpointPool& component_pool : pools) {
+        if (!component_pool.delta.empty()) {
+            blocks.push_back(&component_pool.delta);
+        }
+    }
+    blocks.push_back(&tail);
+    return WriteCheckpoint(path, header, blocks);
+}
+
+bool LoadCheckpoints(Universe& universe, const std::string& folder) {
+    ZoneScoped;
+    uint32_t sequence;
+    return LoadChain(universe, folder, sequence);
+}
+
+bool CompactCheckpoints(const std::string& folder) {
+    ZoneScoped;
+    Universe universe;
+    CheckpointHeader header;
+    header.full = 1;
+    if (!LoadChain(universe, folder, header.sequence)) {
+        return false;
+    }
+    std::vector<char> buffer;
+    WriteSnapshot(universe, buffer);
+
+    // Written next to the chain and then moved over the newest checkpoint, so that a crash leaves the chain as
+    // it was
+    const std::string path = CheckpointPath(folder, header.sequence);
+    const std::string temporary_path = path + ".tmp";
+    if (WriteCheckpoint(temporary_path, header, {&buffer}) == 0) {
+        SPDLOG_ERROR("Could not write checkpoint {}", temporary_path);
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        SPDLOG_ERROR("Could not replace checkpoint {}: {}", path, error.message());
+        return false;
+    }
+    for (const auto& [older, older_path] : ListCheckpoints(folder)) {
+        if (older < header.sequence) {
+            std::filesystem::remove(older_path, error);
+        }
+    }
+    return true;
+}
+}  // namespace cqsp::core::save
@@ -0,0 +1,114 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/universe.h"
+#include "core/util/save/snapshot.h"
+#include "core/util/threadpool.h"
+
+namespace cqsp::core::save {
+/// Bumped whenever the layout of a checkpoint file changes
+inline constexpr uint32_t checkpoint_version = 2;
+
+/// <summary>
+/// What a `CheckpointWriter` remembers about one component pool between checkpoints.
+/// </summary>
+struct CheckpointPool {
+    /// Hash of each component as it was last written
+    std::unordered_map<entt::entity, uint64_t> hashes;
+    /// Entities whose component was emplaced, patched or removed since the last checkpoint
+    std::vector<entt::entity> touched;
+    /// The components that go in the next checkpoint, and the ones that were removed
+    std::vector<char> delta;
+    size_t records = 0;
+};
+
+/// <summary>
+/// Saves a long running game as a chain of small files, each with only the components that changed since the
+/// one before.
+/// </summary>
+/// The first checkpoint is a whole snapshot, and is the base of the chain. After that, a checkpoint has the
+/// date, the entities that were made and destroyed, and for each component pool, the components that changed
+/// and the entities that it was removed from. Emplaced, patched and removed components are caught with the
+/// registry's signals. Most systems change components in place, which the registry never hears about, so every
+/// component is also hashed and compared with the hash it had when it was last written.
+///
+/// Goods, recipes, names and the other things that never change after the universe is loaded are only written
+/// once, and a market or an orbit that changes only costs its own bytes, not the rest of its pool.
+class CheckpointWriter {
+ public:
+    /// Starts a new chain in the folder, after any checkpoints that are already there
+    CheckpointWriter(Universe& universe, util::ThreadPool& pool, std::string folder);
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /// <summary>
+    /// Writes the next checkpoint. Returns the size of the file, or 0 if it couldn't be written.
+    /// </summary>
+    size_t Checkpoint();
+
+    /// Number of components that were written or removed in the last checkpoint
+    size_t GetChangedRecords() const { return changed_records; }
+
+ private:
+    // Index is the component's place in `SnapshotComponents`
+    template <size_t Index>
+    void Touch(entt::registry&, entt::entity entity);
+    template <size_t Index>
+    void ConnectPool(bool connect);
+
+    // Runs the pools through the hashes, and puts what changed in their deltas unless it is the base
+    void WritePools(bool base);
+    size_t WriteBase(const std::string& path);
+    size_t WriteDelta(const std::string& path);
+
+    Universe& universe;
+    util::ThreadPool& pool;
+    std::string folder;
+    uint32_t sequence;
+    bool has_base = false;
+
+    SnapshotParts snapshot;
+    std::vector<CheckpointPool> pools;
+    // Sorted, as they were at the last checkpoint
+    std::vector<entt::entity> entities;
+    uint64_t tables_hash = 0;
+    std::vector<char> head;
+    size_t changed_records = 0;
+};
+
+/// <summary>
+/// Replaces the universe with the last checkpoint in the folder: the last full checkpoint, with every checkpoint
+/// after it applied on top. See `ReadSnapshot`.
+/// </summary>
+bool LoadCheckpoints(Universe& universe, const std::string& folder);
+
+/// <summary>
+/// Merges the last chain of checkpoints in the folder into one full checkpoint, and removes the rest.
+/// The merged checkpoint takes the place of the last one, so a `CheckpointWriter` can keep adding to it.
+/// </summary>
+bool CompactCheckpoints(const std::string& folder);
+}  // namespace cqsp::core::save
@@ -0,0 +1,435 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "core/components/area.h"
+#include "core/components/bodies.h"
+#include "core/components/colony.h"
+#include "core/components/coordinates.h"
+#include "core/components/discovery.h"
+#include "core/components/history.h"
+#include "core/components/infrastructure.h"
+#include "core/components/labor.h"
+#include "core/components/launchvehicle.h"
+#include "core/components/maneuver.h"
+#include "core/components/market.h"
+#include "core/components/model.h"
+#include "core/components/modifier.h"
+#include "core/components/name.h"
+#include "core/components/orbit.h"
+#include "core/components/orders.h"
+#include "core/components/organizations.h"
+#include "core/components/player.h"
+#include "core/components/population.h"
+#include "core/components/projects.h"
+#include "core/components/resource.h"
+#include "core/components/resourceledger.h"
+#include "core/components/science.h"
+#include "core/components/ships.h"
+#include "core/components/spaceport.h"
+#include "core/components/surface.h"
+#include "core/components/tags.h"
+
+namespace cqsp::core::save {
+namespace components = core::components;
+
+/// <summary>
+/// Every component that goes in a save.
+/// </summary>
+/// Anything that isn't here is gone after a load, which is fine for caches that the systems make again (such as
+/// `SOIPrediction`) and for components that only live while the universe is being loaded. Adding, removing or
+/// reordering a component changes the format, so bump `snapshot_version` when this list changes.
+using SnapshotComponents = entt::type_list<
+    // Names
+    components::Name, components::Identifier, components::Description, components::Tags, components::WorldModel,
+    // Goods and recipes
+    components::Good, components::Unit, components::Energy, components::ConsumerGood, components::Mineral,
+    components::RawGood, components::LaborGood, components::FluidGood, components::IntermediateGood,
+    components::CapitalGood, components::Price, components::Recipe, components::RecipeCost,
+    components::ConstructionCost, components::Labor, components::Modifier,
+    // Economy
+    components::Market, components::PlanetaryMarket, components::MarketHistory, components::LogMarket,
+    components::Wallet, components::Currency, components::CostTable, components::MarketAgent,
+    components::InternationalPort, components::Commercial, components::Employer, components::LaborInformation,
+    components::FactoryProducing, components::Owned, components::TradePartners, components::ResourceMap,
+    components::ResourceConsumption, components::ResourceProduction, components::ResourceStockpile,
+    components::IndustrialZone, components::ProductionUnit, components::Construction, components::Factory,
+    components::Mine, components::Service, components::Farm, components::RawResourceGen, components::ZoningType,
+    components::PopulationSegment, components::Hunger,
+    // Countries and the surface
+    components::Player, components::Organization, components::Country, components::Governed,
+    components::OrganizationIncome, components::CountryCityList, components::MissionQueue, components::Subsidies,
+    components::Settlements, components::Settlement, components::City, components::ProvincedPlanet,
+    components::Province, components::ProvinceColor, components::CapitalCity, components::TimeZone,
+    components::CityTimeZone, components::DockedShips, components::ResourceAmenability,
+    components::infrastructure::CityInfrastructure, components::infrastructure::PowerPlant,
+    components::infrastructure::PowerConsumption, components::infrastructure::CityPower,
+    components::infrastructure::BrownOut, components::infrastructure::Highway,
+    components::infrastructure::ConstructionSector, components::infrastructure::SpacePort,
+    // Science and projects
+    components::science::Field, components::science::Science, components::science::ScienceProject,
+    components::science::ScientificResearch, components::science::Technology, components::Project,
+    components::ProjectTemplate, components::Mission, components::MissionInProgress,
+    components::ColonizationTarget, components::Colony, components::HabitationModule,
+    components::CommunicationsModule, components::ColonyCoreModule, components::Survey,
+    components::DiscoveryStatus, components::LaunchVehicle, components::SpaceCapability,
+    // Bodies, orbits and ships
+    components::bodies::Body, components::bodies::TexturedTerrain, components::bodies::NautralObject,
+    components::bodies::OrbitalSystem, components::bodies::DirtyOrbit, components::bodies::Star,
+    components::bodies::Planet, components::bodies::LightEmitter, components::bodies::Atmosphere,
+    components::types::Orbit, components::types::Kinematics, components::types::FuturePosition,
+    components::types::Impulse, components::types::GalacticCoordinate, components::types::SurfaceCoordinate,
+    components::ships::Ship, components::ships::Propulsion, components::ships::SensorSuite,
+    components::ships::CommunicationsSuite, components::ships::PowerSuite, components::ships::Crash,
+    components::ships::CargoHold, components::CommandQueue, components::Command, components::Trigger,
+    components::OrbitTarget, components::OrbitScalar, components::OrbitEntityTarget>;
+
+// What changes from tick to tick, kept apart from the tables so that checkpoints don't have to write them again
+template <typename Archive, typename UniverseType>
+void UniverseState(Archive& archive, UniverseType& universe) {
+    archive.Fields(universe.date, universe.uuid, universe.sun, universe.default_job);
+}
+
+// The goods, recipes and other lookups of the universe, which only change while it is being loaded
+template <typename Archive, typename UniverseType>
+void UniverseTables(Archive& archive, UniverseType& universe) {
+    archive.Fields(universe.goods, universe.good_vector, universe.good_map, universe.good_prices,
+                   universe.consumergoods);
+    archive.Fields(universe.recipes, universe.terrain_data, universe.fields, universe.technologies,
+                   universe.planets, universe.time_zones, universe.countries, universe.provinces, universe.cities,
+                   universe.jobs, universe.zoning, universe.modifiers);
+    archive.Fields(universe.province_colors);
+}
+
+// Ledgers are written as their values, so that a dense ledger is one block that is copied straight back in
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ResourceLedger& ledger) {
+    if constexpr (Archive::is_loading) {
+        const size_t count = archive.Size();
+        if (ledger.size() != count) {
+            ledger = components::ResourceLedger(count);
+        }
+        archive.Array(ledger.data(), count);
+    } else {
+        archive.Size(ledger.size());
+        archive.Array(ledger.data(), ledger.size());
+    }
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::SparseLedger& ledger) {
+    if constexpr (Archive::is_loading) {
+        const size_t count = archive.Size();
+        ledger.clear();
+        ledger.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            components::GoodEntity good;
+            double value;
+            archive.Fields(good, value);
+            // Goods were written in order, so this always adds to the end
+            ledger[good] = value;
+        }
+    } else {
+        archive.Size(ledger.size());
+        for (size_t i = 0; i < ledger.size(); i++) {
+            archive.Fields(ledger.GoodAt(i), ledger.ValueAt(i));
+        }
+    }
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ResourceMap& map) {
+    if constexpr (Archive::is_loading) {
+        map.clear();
+        for (size_t count = archive.Size(); count > 0; count--) {
+            components::GoodEntity good;
+            double value;
+            archive.Fields(good, value);
+            map.emplace(good, value);
+        }
+    } else {
+        archive.Size(map.size());
+        for (const auto& [good, value] : map) {
+            archive.Fields(good, value);
+        }
+    }
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ResourceVector& vector) {
+    archive.Value(static_cast<std::vector<std::pair<components::GoodEntity, double>>&>(vector));
+}
+
+template <typename Archive, components::ModifierOp Op>
+void Serialize(Archive& archive, components::ModifiableValue<Op>& value) {
+    archive.Fields(value.base, value.sum, value.value, value.modifiers);
+}
+
+// Names
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Name& name) {
+    archive.Fields(name.name);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Identifier& identifier) {
+    archive.Fields(identifier.identifier);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Description& description) {
+    archive.Fields(description.description);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Tags& tags) {
+    archive.Fields(tags.tags);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::WorldModel& model) {
+    archive.Fields(model.name);
+}
+
+// Goods and recipes
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Unit& unit) {
+    archive.Fields(unit.unit_name);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::RecipeWorkers& workers) {
+    archive.Fields(workers.workers);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Recipe& recipe) {
+    archive.Fields(recipe.input, recipe.output, recipe.type, recipe.workers, recipe.capitalcost);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::RecipeCost& cost) {
+    archive.Fields(cost.fixed, cost.scaling);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ConstructionCost& cost) {
+    archive.Fields(cost.cost, cost.time, cost.zoning);
+}
+
+// Economy
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Market& market) {
+    archive.Fields(market.demand, market.supply, market.sd_ratio, market.volume, market.price,
+                   market.chronic_shortages, market.trade, market.production, market.consumption,
+                   market.market_access, market.taxation, market.connected_markets, market.parent_market,
+                   market.GDP, market.deficit, market.last_deficit, market.trade_deficit, market.last_trade_deficit);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::PlanetaryMarket& market) {
+    archive.Fields(market.demands, market.requests, market.supplied_resources, market.supply_difference);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::MarketHistory& history) {
+    archive.Fields(history.price_history, history.sd_ratio, history.supply, history.demand, history.gdp);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::TradePartners& partners) {
+    archive.Value(static_cast<std::vector<entt::entity>&>(partners));
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::IndustrialZone& zone) {
+    archive.Fields(zone.industries);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ProductionUnit& unit) {
+    archive.Fields(unit.size, unit.utilization, unit.diff, unit.workers, unit.shortage, unit.cumulative_pr,
+                   unit.continuous_gains, unit.stability, unit.expertise, unit.expertise_gain, unit.max_expertise,
+                   unit.throughput, unit.consumption, unit.type, unit.recipe, unit.state, unit.revenue,
+                   unit.material_costs, unit.maintenance, unit.wage_cost, unit.tax_cost, unit.construction_cost,
+                   unit.profit, unit.transport, unit.output_subsidy, unit.output_subsidy_amount, unit.amount_sold);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::PopulationLabor& labor) {
+    archive.Fields(labor.labor_distribution, labor.labor_hours);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::PopulationSegment& segment) {
+    archive.Fields(segment.population, segment.labor_force, segment.employed_amount, segment.unemployment_rate,
+                   segment.standard_of_living, segment.consumer_confidence, segment.education, segment.sol_pid,
+                   segment.labor, segment.spending, segment.income, segment.saving_ratio, segment.average_wage);
+}
+
+// Countries and the surface
+
+template <typename Archive>
+void Serialize(Archive& archive, components::CountryCityList& list) {
+    archive.Fields(list.city_list, list.province_list, list.space_port_list);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::MissionQueue& queue) {
+    archive.Fields(queue.list);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Subsidies& subsidies) {
+    archive.Fields(subsidies.global_subsidy);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Settlements& settlements) {
+    archive.Fields(settlements.settlements, settlements.provinces);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Settlement& settlement) {
+    archive.Fields(settlement.population, settlement.job_demands);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ProvincedPlanet& planet) {
+    archive.Fields(planet.province_map, planet.province_definitions, planet.adjacencies);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Province& province) {
+    archive.Fields(province.country, province.planet, province.cities, province.neighbors, province.zoning);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::DockedShips& docked) {
+    archive.Fields(docked.docked_ships);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::infrastructure::SpacePort& port) {
+    archive.Fields(port.deliveries, port.launch_cadence, port.launchpads, port.reference_body,
+                   port.demanded_resources, port.demanded_resources_rate, port.output_resources,
+                   port.output_resources_rate, port.resource_stockpile, port.projects, port.stored_launch_vehicles);
+}
+
+// Science and projects
+
+template <typename Archive>
+void Serialize(Archive& archive, components::science::Field& field) {
+    archive.Fields(field.parents, field.adjacent);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::science::Science& science) {
+    archive.Fields(science.difficulty, science.fields);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::science::Technology& technology) {
+    archive.Fields(technology.fields, technology.actions, technology.difficulty);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ProjectTemplate& project) {
+    archive.Fields(project.cost, project.max_progress);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::Colony& colony) {
+    archive.Fields(colony.population, colony.max_population, colony.power, colony.comms_power, colony.components);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::DiscoveryStatus& status) {
+    archive.Fields(status.flyby, status.orbit, status.atmospheric_flight, status.landed, status.returned,
+                   status.survey_state);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::SpaceCapability& capability) {
+    archive.Fields(capability.launch_vehicle_list);
+}
+
+// Bodies, orbits and ships
+
+template <typename Archive>
+void Serialize(Archive& archive, components::bodies::TexturedTerrain& terrain) {
+    archive.Fields(terrain.terrain_name, terrain.normal_name, terrain.roughness_name);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::bodies::OrbitalSystem& system) {
+    archive.Fields(system.children, system.bodies);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::types::Orbit& orbit) {
+    archive.Fields(orbit.eccentricity, orbit.semi_major_axis, orbit.inclination, orbit.LAN, orbit.w, orbit.M0,
+                   orbit.epoch, orbit.v, orbit.GM, orbit.reference_body);
+    if constexpr (Archive::is_loading) {
+        orbit.UpdateRotation();
+    }
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::OrbitTarget& target) {
+    archive.Fields(target.orbit);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ships::Ship& ship) {
+    archive.Fields(ship.components);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::ships::CargoHold& hold) {
+    archive.Fields(hold.cargo);
+}
+
+template <typename Archive>
+void Serialize(Archive& archive, components::CommandQueue& queue) {
+    // Maneuvers can't be changed once they are made, so they are made again from their values
+    if constexpr (Archive::is_loading) {
+        queue.maneuvers.clear();
+        for (size_t count = archive.Size(); count > 0; count--) {
+            std::pair<glm::dvec3, double> maneuver;
+            archive.Fields(maneuver.first, maneuver.second);
+            queue.maneuvers.emplace_back(maneuver);
+        }
+    } else {
+        archive.Size(queue.maneuvers.size());
+        for (const auto& maneuver : queue.maneuvers) {
+            archive.Fields(maneuver.delta_v, maneuver.time);
+        }
+    }
+    archive.Fields(queue.commands);
+}
+}  // namespace cqsp::core::save
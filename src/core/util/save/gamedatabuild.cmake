@@ -0,0 +1,38 @@
+# Conquer Space
+# Copyright (C) 2021 Conquer Space
+
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Writes OUTPUT, a header with a hash of SOURCES (separated by |), which are the files that decide what the game
+# data turns into. The game data cache is keyed on it, so a build that changes how the game data is loaded doesn't
+# read a cache written by an older one. Run with cmake -P at build time.
+string(REPLACE "|" ";" _sources "${SOURCES}")
+list(SORT _sources)
+
+set(_hashes "")
+foreach(_source IN LISTS _sources)
+    file(SHA256 "${_source}" _hash)
+    file(RELATIVE_PATH _name "${SOURCE_ROOT}" "${_source}")
+    string(APPEND _hashes "${_name}:${_hash}\n")
+endforeach()
+string(SHA256 _build_id "${_hashes}")
+string(SUBSTRING "${_build_id}" 0 16 _build_id)
+
+# Only touch the header when the hash changes, so that nothing rebuilds for no reason
+file(WRITE "${OUTPUT}.tmp"
+    "// Generated by gamedatabuild.cmake, do not edit\n"
+    "#pragma once\n"
+    "#define CQSP_GAME_DATA_BUILD_ID 0x${_build_id}ull\n")
+configure_file("${OUTPUT}.tmp" "${OUTPUT}" COPYONLY)
+file(REMOVE "${OUTPUT}.tmp")
@@ -0,0 +1,140 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/gamedatacache.h"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <tracy/Tracy.hpp>
+
+#include "core/actions/names/namegenerator.h"
+#include "core/util/paths.h"
+#include "core/util/save/binaryarchive.h"
+#include "core/util/save/gamedatabuild.h"
+#include "core/util/save/mappedfile.h"
+#include "core/util/save/snapshot.h"
+
+namespace cqsp::core::save {
+namespace {
+constexpr std::array<char, 8> cache_magic = {'C', 'Q', 'S', 'P', 'D', 'A', 'T', 'A'};
+
+// Followed by the parts of the universe that aren't in a snapshot, and then the snapshot
+struct CacheHeader {
+    std::array<char, 8> magic = cache_magic;
+    uint32_t version = game_data_cache_version;
+    uint32_t snapshot = snapshot_version;
+    // Hash of the loader sources, made by the build, so that a cache isn't read by a build that loads differently
+    uint64_t build = CQSP_GAME_DATA_BUILD_ID;
+    uint64_t key = 0;
+    // Where the snapshot starts
+    uint64_t snapshot_offset = 0;
+};
+
+template <typename Archive, typename UniverseType>
+void UniverseExtras(Archive& archive, UniverseType& universe) {
+    archive.Fields(universe.economy_config, universe.name_generators);
+}
+}  // namespace
+
+bool SaveGameDataCache(const Universe& universe, uint64_t key, const std::string& path) {
+    ZoneScoped;
+    std::vector<char> buffer;
+    OutputArchive archive(buffer);
+    CacheHeader header;
+    header.key = key;
+    archive.Value(header);
+    UniverseExtras(archive, universe);
+    archive.Align();
+    header.snapshot_offset = buffer.size();
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    std::vector<char> snapshot;
+    WriteSnapshot(universe, snapshot);
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    std::unique_ptr<FILE, decltype(&std::fclose)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if (file == nullptr || std::fwrite(buffer.data(), 1, buffer.size(), file.get()) != buffer.size() ||
+        std::fwrite(snapshot.data(), 1, snapshot.size(), file.get()) != snapshot.size()) {
+        SPDLOG_WARN("Could not write game data cache to {}", path);
+        return false;
+    }
+    return true;
+}
+
+bool LoadGameDataCache(Universe& universe, uint64_t key, const std::string& path) {
+    ZoneScoped;
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+    MappedFile file(path);
+    CacheHeader header;
+    if (!file.IsOpen() || file.size() < sizeof(header)) {
+        SPDLOG_WARN("Could not read game data cache {}", path);
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != cache_magic || header.version != game_data_cache_version ||
+        header.snapshot != snapshot_version || header.build != CQSP_GAME_DATA_BUILD_ID ||
+        header.snapshot_offset > file.size()) {
+        SPDLOG_INFO("Game data cache {} is from another version", path);
+        return false;
+    }
+    if (header.key != key) {
+        SPDLOG_INFO("Game data changed since it was cached");
+        return false;
+    }
+
+    // Read the extras first, so that a broken cache doesn't leave the universe half loaded
+    InputArchive archive(file.data(), header.snapshot_offset);
+    archive.Value(header);
+    Universe extras;
+    UniverseExtras(archive, extras);
+    if (archive.Failed()) {
+        SPDLOG_WARN("Game data cache {} is broken", path);
+        return false;
+    }
+
+    std::string uuid = std::move(universe.uuid);
+    const components::StarDate date = universe.date;
+    const bool loaded =
+        ReadSnapshot(universe, file.data() + header.snapshot_offset, file.size() - header.snapshot_offset);
+    universe.uuid = std::move(uuid);
+    universe.date = date;
+    if (!loaded) {
+        return false;
+    }
+
+    universe.economy_config = extras.economy_config;
+    universe.name_generators = std::move(extras.name_generators);
+    for (auto& [name, generator] : universe.name_generators) {
+        generator.SetRandom(universe.random.get());
+    }
+    return true;
+}
+
+std::string GetGameDataCachePath() {
+    return (std::filesystem::path(util::GetCqspAppDataPath()) / "cache" / "gamedata.cache").string();
+}
+}  // namespace cqsp::core::save
@@ -0,0 +1,46 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "core/universe.h"
+
+namespace cqsp::core::save {
+/// Bumped whenever the layout of the cache changes. Changes to the loaders make old caches stale on their own, as
+/// the cache also holds a hash of their sources from the build.
+inline constexpr uint32_t game_data_cache_version = 2;
+
+/// <summary>
+/// Writes the universe, as it is right after the game data (goods, recipes, provinces, cities and so on) is
+/// loaded, to a file. The key should change whenever the game data does, see `LoadGameDataCache`.
+/// </summary>
+bool SaveGameDataCache(const Universe& universe, uint64_t key, const std::string& path);
+
+/// <summary>
+/// Replaces the universe with the game data in a cache made by `SaveGameDataCache`, instead of loading the game
+/// data again. Returns false, and leaves the universe alone, if there is no cache or it was made with another key,
+/// version or build.
+/// </summary>
+/// The universe keeps its own id and date. A cache that turns out to be broken part way through is refused like any
+/// other, so the game data can be loaded into the same universe instead, see `ReadSnapshot`.
+bool LoadGameDataCache(Universe& universe, uint64_t key, const std::string& path);
+
+/// Where the game data cache goes
+std::string GetGameDataCachePath();
+}  // namespace cqsp::core::save
@@ -0,0 +1,88 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cqsp::core::save {
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    file = handle;
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(handle, &file_size) || file_size.QuadPart == 0) {
+        return;
+    }
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        return;
+    }
+    bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (bytes != nullptr) {
+        length = static_cast<size_t>(file_size.QuadPart);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) {
+        UnmapViewOfFile(bytes);
+    }
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+    }
+    if (file != nullptr) {
+        CloseHandle(file);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        void* address = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            // The whole file is read front to back
+            madvise(address, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(address);
+            length = static_cast<size_t>(file_stat.st_size);
+        }
+    }
+    // The mapping keeps the file alive
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+}
+#endif
+}  // namespace cqsp::core::save
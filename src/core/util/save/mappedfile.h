@@ -0,0 +1,51 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace cqsp::core::save {
+/// <summary>
+/// Read only view of a whole file, mapped into memory.
+/// </summary>
+/// Pages are only read in when they are touched, so reading a save is a walk through memory instead of a chain
+/// of small reads. The data is gone once the file is destroyed, anything that is needed after that has to be
+/// copied out.
+class MappedFile {
+ public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// If the file could be opened and mapped. An empty file is never open.
+    bool IsOpen() const { return bytes != nullptr; }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+ private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+}  // namespace cqsp::core::save
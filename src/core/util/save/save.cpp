@@ -33,11 +33,6 @@ Hjson::Value Save::GetMetadata() {
     return value;
 }
 
-Hjson::Value Save::SaveGame() {
-    // Save all the game information
-    return Hjson::Value();
-}
-
 void Load::LoadMetadata(Hjson::Value& data) {
     universe.date.SetDate((int)data["date"]);
     // Verify version, but screw that
@@ -45,4 +40,8 @@ void Load::LoadMetadata(Hjson::Value& data) {
 }
 
 std::string GetMetaPath(std::string_view folder) { return (std::filesystem::path(folder) / "meta.hjson").string(); }
+
+std::string GetSnapshotPath(std::string_view folder) {
+    return (std::filesystem::path(folder) / "universe.snapshot").string();
+}
 }  // namespace cqsp::core::save
\ No newline at end of file
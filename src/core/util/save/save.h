@@ -30,7 +30,6 @@ class Save {
     Universe& universe;
 
     Hjson::Value GetMetadata();
-    Hjson::Value SaveGame();
 };
 
 class Load {
@@ -43,4 +42,6 @@ class Load {
 };
 
 std::string GetMetaPath(std::string_view folder);
+/// Everything else in the save, see snapshot.h
+std::string GetSnapshotPath(std::string_view folder);
 }  // namespace cqsp::core::save
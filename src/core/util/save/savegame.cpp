@@ -16,6 +16,9 @@
  */
 #include "core/util/save/savegame.h"
 
+#include <spdlog/spdlog.h>
+
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -24,8 +27,16 @@
 #include "core/components/player.h"
 #include "core/util/paths.h"
 #include "core/util/save/save.h"
+#include "core/util/save/snapshot.h"
+
 namespace cqsp::core::save {
 
+std::string GetSaveFolder(Universe& universe) {
+    entt::entity player = universe.GetPlayer();
+    auto& name = universe.get<components::Identifier>(player);
+    return (std::filesystem::path(util::GetCqspSavePath()) / (name.identifier + "_" + universe.uuid)).string();
+}
+
 void save_game(Universe& universe) {
     std::string save_dir_path = util::GetCqspSavePath();
     if (!std::filesystem::exists(save_dir_path)) std::filesystem::create_directories(save_dir_path);
@@ -33,23 +44,39 @@ void save_game(Universe& universe) {
     // Generate basic information
     Save save(universe);
     Hjson::Value metadata = save.GetMetadata();
-    // Write to a file
-    entt::entity player = universe.GetPlayer();
-    auto& name = universe.get<components::Identifier>(player);
     // Generate the folder
-    std::filesystem::path path = std::filesystem::path(save_dir_path) / (name.identifier + "_" + universe.uuid);
+    std::filesystem::path path = GetSaveFolder(universe);
     std::filesystem::create_directories(path);
 
     // Generate the file
     Hjson::MarshalToFile(save.GetMetadata(), GetMetaPath(path.string()));
 
-    // Then write other game information, however we do that.
+    // Then write the rest of the game
+    auto start = std::chrono::steady_clock::now();
+    if (SaveSnapshot(universe, GetSnapshotPath(path.string()))) {
+        SPDLOG_INFO("Saved game to {} in {} ms", path.string(),
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
 }
 
-void load_game(Universe& universe, std::string_view directory) {
-    Load load(universe);
-    // Load meta file
-    Hjson::Value metadata = Hjson::UnmarshalFromFile(GetMetaPath(directory));
-    load.LoadMetadata(metadata);
+bool load_game(Universe& universe, std::string_view directory) {
+    // Saves from before snapshots only have the metadata
+    const std::string snapshot_path = GetSnapshotPath(directory);
+    if (!std::filesystem::exists(snapshot_path)) {
+        Load load(universe);
+        Hjson::Value metadata = Hjson::UnmarshalFromFile(GetMetaPath(directory));
+        load.LoadMetadata(metadata);
+        SPDLOG_WARN("Save {} has no snapshot, only the date was loaded", directory);
+        return true;
+    }
+    // The snapshot has the date and id too, so the metadata isn't needed
+    auto start = std::chrono::steady_clock::now();
+    if (!LoadSnapshot(universe, snapshot_path)) {
+        SPDLOG_ERROR("Could not load save {}", directory);
+        return false;
+    }
+    SPDLOG_INFO("Loaded {} entities in {} ms", universe.alive(),
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return true;
 }
 }  // namespace cqsp::core::save
@@ -16,11 +16,18 @@
  */
 #pragma once
 
+#include <string>
 #include <string_view>
 
 #include "core/universe.h"
 
 namespace cqsp::core::save {
+/// Folder in the save directory that the player's game is saved to
+std::string GetSaveFolder(Universe& universe);
 void save_game(Universe& universe);
-void load_game(Universe& universe, std::string_view directory);
+/// <summary>
+/// Loads the save in the directory into the universe. Returns false, and leaves the universe as it was, if the
+/// save can't be read.
+/// </summary>
+bool load_game(Universe& universe, std::string_view directory);
 }  // namespace cqsp::core::save
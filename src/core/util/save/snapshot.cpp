@@ -0,0 +1,271 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/snapshot.h"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <tracy/Tracy.hpp>
+
+#include "core/components/ephemeris.h"
+#include "core/components/maneuver.h"
+#include "core/components/markettable.h"
+#include "core/util/save/binaryarchive.h"
+#include "core/util/save/componentserialization.h"
+#include "core/util/save/mappedfile.h"
+
+namespace cqsp::core::save {
+namespace {
+constexpr std::array<char, 8> snapshot_magic = {'C', 'Q', 'S', 'P', 'S', 'N', 'A', 'P'};
+
+struct SnapshotHeader {
+    std::array<char, 8> magic = snapshot_magic;
+    uint32_t version = snapshot_version;
+    uint32_t good_count = 0;
+    // Size of the whole snapshot, including the header
+    uint64_t size = 0;
+};
+
+// Every component is padded to the alignment, so that they can be written into separate buffers and still be
+// read as one
+using ComponentWriter = void (*)(const entt::snapshot&, OutputArchive&);
+
+template <typename... Component>
+constexpr std::array<ComponentWriter, sizeof...(Component)> ComponentWriters(entt::type_list<Component...>) {
+    return {[](const entt::snapshot& snapshot, OutputArchive& archive) {
+        snapshot.component<Component>(archive);
+        archive.Align();
+    }...};
+}
+
+constexpr auto component_writers = ComponentWriters(SnapshotComponents {});
+
+template <typename... Component>
+void ReadComponents(const entt::snapshot_loader& loader, InputArchive& archive, entt::type_list<Component...>) {
+    ((loader.component<Component>(archive), archive.Align()), ...);
+}
+
+// Writes the header, with the size left empty
+void WriteHeader(const Universe& universe, OutputArchive& archive) {
+    SnapshotHeader header;
+    header.good_count = static_cast<uint32_t>(universe.GoodCount());
+    archive.Value(header);
+    UniverseState(archive, universe);
+    archive.Align();
+}
+
+void WriteTables(const Universe& universe, OutputArchive& archive) {
+    UniverseTables(archive, universe);
+    entt::snapshot {universe}.entities(archive);
+    archive.Align();
+}
+
+void SetSize(std::vector<char>& head, uint64_t size) {
+    std::memcpy(head.data() + offsetof(SnapshotHeader, size), &size, sizeof(size));
+}
+
+// Goes through the fields of the universe that a snapshot has, in the same order as they are saved, so that they
+// can be moved from one universe to another without listing them again
+class FieldCollector {
+ public:
+    template <typename... Field>
+    void Fields(Field&... fields) {
+        (pointers.push_back(&fields), ...);
+    }
+
+    std::vector<void*> pointers;
+};
+
+class FieldMover {
+ public:
+    explicit FieldMover(const std::vector<void*>& pointers) : pointers(pointers) {}
+
+    template <typename... Field>
+    void Fields(Field&... fields) {
+        ((fields = std::move(*static_cast<Field*>(pointers[next++]))), ...);
+    }
+
+ private:
+    const std::vector<void*>& pointers;
+    size_t next = 0;
+};
+
+// Moves the entities and saved fields of a universe that was read into another one. The context of the universe
+// that is moved into is kept, it can have things in it that aren't part of the game.
+void MoveUniverse(Universe& from, Universe& to) {
+    FieldCollector collector;
+    UniverseState(collector, from);
+    UniverseTables(collector, from);
+    FieldMover mover(collector.pointers);
+    UniverseState(mover, to);
+    UniverseTables(mover, to);
+
+    auto context = std::move(to.ctx());
+    static_cast<entt::registry&>(to) = std::move(static_cast<entt::registry&>(from));
+    to.ctx() = std::move(context);
+}
+}  // namespace
+
+void RebuildDerived(Universe& universe) {
+    universe.colors_province.clear();
+    for (const auto& [planet, colors] : universe.province_colors) {
+        auto& provinces = universe.colors_province[planet];
+        for (const auto& [color, province] : colors) {
+            provinces[province] = color;
+        }
+    }
+
+    // Markets own their ledgers again, the market system makes a new table when it starts
+    universe.ctx().erase<components::MarketTable>();
+    universe.ctx().erase<components::types::Ephemeris>();
+
+    auto& schedule = universe.ctx().emplace<components::ManeuverSchedule>();
+    schedule.clear();
+    for (auto&& [entity, queue] : universe.view<components::CommandQueue>().each()) {
+        for (const auto& maneuver : queue.maneuvers) {
+            schedule.Push(entity, maneuver.time);
+        }
+    }
+}
+
+void WriteSnapshot(const Universe& universe, std::vector<char>& buffer) {
+    ZoneScoped;
+    buffer.clear();
+    OutputArchive archive(buffer);
+    WriteHeader(universe, archive);
+    WriteTables(universe, archive);
+    const entt::snapshot snapshot {universe};
+    for (ComponentWriter writer : component_writers) {
+        writer(snapshot, archive);
+    }
+    SetSize(buffer, buffer.size());
+}
+
+size_t SnapshotPartCount() { return snapshot_head_parts + component_writers.size(); }
+
+size_t SnapshotParts::size() const {
+    size_t size = 0;
+    for (const auto& part : parts) {
+        size += part.size();
+    }
+    return size;
+}
+
+void WriteSnapshot(const Universe& universe, SnapshotParts& snapshot, util::ThreadPool& pool) {
+    ZoneScoped;
+    snapshot.parts.resize(SnapshotPartCount());
+    // Nothing is written to the universe, so every part can read it at the same time
+    pool.ParallelFor(0, snapshot.parts.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            std::vector<char>& part = snapshot.parts[i];
+            part.clear();
+            OutputArchive archive(part);
+            if (i == 0) {
+                WriteHeader(universe, archive);
+            } else if (i == 1) {
+                WriteTables(universe, archive);
+            } else {
+                component_writers[i - snapshot_head_parts](entt::snapshot {universe}, archive);
+            }
+        }
+    });
+    SetSize(snapshot.parts.front(), snapshot.size());
+}
+
+bool ReadSnapshot(Universe& universe, const char* data, size_t size) {
+    ZoneScoped;
+    InputArchive archive(data, size);
+    SnapshotHeader header;
+    archive.Value(header);
+    if (archive.Failed() || header.magic != snapshot_magic) {
+        SPDLOG_ERROR("Not a snapshot");
+        return false;
+    }
+    if (header.version != snapshot_version) {
+        SPDLOG_ERROR("Snapshot is version {}, but only version {} can be read", header.version, snapshot_version);
+        return false;
+    }
+    if (header.size != size) {
+        SPDLOG_ERROR("Snapshot should be {} bytes, but is {} bytes", header.size, size);
+        return false;
+    }
+
+    // Read into another universe first, so that a snapshot that is broken part way through doesn't leave the game
+    // half replaced
+    Universe loaded(universe.uuid);
+    UniverseState(archive, loaded);
+    archive.Align();
+    UniverseTables(archive, loaded);
+    entt::snapshot_loader loader {loaded};
+    loader.entities(archive);
+    archive.Align();
+    ReadComponents(loader, archive, SnapshotComponents {});
+    if (archive.Failed() || archive.Remaining() != 0 || loaded.GoodCount() != header.good_count) {
+        SPDLOG_ERROR("Snapshot is broken, {} bytes were not read", archive.Remaining());
+        return false;
+    }
+
+    MoveUniverse(loaded, universe);
+    RebuildDerived(universe);
+    return true;
+}
+
+bool SaveSnapshot(const Universe& universe, const std::string& path) {
+    std::vector<char> buffer;
+    WriteSnapshot(universe, buffer);
+
+    ZoneScopedN("Write snapshot file");
+    std::unique_ptr<FILE, decltype(&std::fclose)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if (file == nullptr || std::fwrite(buffer.data(), 1, buffer.size(), file.get()) != buffer.size()) {
+        SPDLOG_ERROR("Could not write snapshot to {}", path);
+        return false;
+    }
+    return true;
+}
+
+bool SaveSnapshot(const SnapshotParts& snapshot, const std::string& path) {
+    ZoneScoped;
+    std::unique_ptr<FILE, decltype(&std::fclose)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+    if (file == nullptr) {
+        SPDLOG_ERROR("Could not write snapshot to {}", path);
+        return false;
+    }
+    for (const auto& part : snapshot.parts) {
+        if (std::fwrite(part.data(), 1, part.size(), file.get()) != part.size()) {
+            SPDLOG_ERROR("Could not write snapshot to {}", path);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LoadSnapshot(Universe& universe, const std::string& path) {
+    MappedFile file(path);
+    if (!file.IsOpen()) {
+        SPDLOG_ERROR("Could not open snapshot {}", path);
+        return false;
+    }
+    return ReadSnapshot(universe, file.data(), file.size());
+}
+}  // namespace cqsp::core::save
@@ -0,0 +1,86 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/universe.h"
+#include "core/util/threadpool.h"
+
+namespace cqsp::core::save {
+/// Bumped whenever the layout of the snapshot, or of a component in it, changes. Older snapshots are refused.
+inline constexpr uint32_t snapshot_version = 4;
+
+/// <summary>
+/// Writes every entity and saved component (see componentserialization.h), and the tables of the universe that
+/// point to entities, into the buffer. Anything that was in the buffer is replaced.
+/// </summary>
+void WriteSnapshot(const Universe& universe, std::vector<char>& buffer);
+
+/// Parts of a snapshot that come before the components: the header with the date, and then the universe's tables
+/// with the entities.
+inline constexpr size_t snapshot_head_parts = 2;
+
+/// <summary>
+/// A snapshot that is split into `snapshot_head_parts`, and then one part for each component in the order of
+/// `SnapshotComponents`. Put together in order, the parts are the same bytes as `WriteSnapshot` writes.
+/// </summary>
+struct SnapshotParts {
+    std::vector<std::vector<char>> parts;
+
+    size_t size() const;
+};
+
+/// Number of parts that a snapshot is split into
+size_t SnapshotPartCount();
+
+/// <summary>
+/// Same as above, but the components are written at the same time on the thread pool, so that the
+/// simulation is held up for as short as possible. Keep the parts around between snapshots, the buffers are
+/// reused.
+/// </summary>
+/// The universe can't change until this returns, but after that the parts are a copy that can be written out on
+/// another thread.
+void WriteSnapshot(const Universe& universe, SnapshotParts& snapshot, util::ThreadPool& pool);
+
+/// <summary>
+/// Replaces every entity in the universe with the ones in a snapshot made by `WriteSnapshot`.
+/// </summary>
+/// Things that the systems work out from the components, such as the market table or the maneuver schedule,
+/// are thrown away or made again, so this has to be done before the simulation is initialized.
+/// Returns false, and leaves the universe as it was, if it isn't a snapshot of this version or it is broken.
+/// The context of the universe is kept, but the component pools are replaced along with anything connected to
+/// their signals, so connect to them after loading.
+bool ReadSnapshot(Universe& universe, const char* data, size_t size);
+
+/// <summary>
+/// Makes the parts of the universe that are worked out from the components again, and throws away the caches
+/// that the systems make for themselves. `ReadSnapshot` does this already, anything else that changes the
+/// components of a loaded universe has to do it too.
+/// </summary>
+void RebuildDerived(Universe& universe);
+
+/// Writes a snapshot to a file, returns false if the file couldn't be written
+bool SaveSnapshot(const Universe& universe, const std::string& path);
+/// Writes the parts of a snapshot to a file, returns false if the file couldn't be written
+bool SaveSnapshot(const SnapshotParts& snapshot, const std::string& path);
+/// Maps the file and reads the snapshot in it, see `ReadSnapshot`
+bool LoadSnapshot(Universe& universe, const std::string& path);
+}  // namespace cqsp::core::save
@@ -0,0 +1,68 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/scratcharena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace cqsp::core::util {
+ScratchArena::ScratchArena(size_t block_size) : block_size(block_size) {}
+
+void ScratchArena::AddBlock(size_t size) {
+    blocks.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});
+    current = blocks.size() - 1;
+    offset = 0;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    while (current < blocks.size()) {
+        const Block& block = blocks[current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+        const uintptr_t start = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        if (start + bytes <= base + block.size) {
+            offset = start + bytes - base;
+            used += bytes;
+            peak = std::max(peak, used);
+            return reinterpret_cast<void*>(start);
+        }
+        // Blocks after this one are left over from a tick that needed more memory
+        current++;
+        offset = 0;
+    }
+    AddBlock(std::max(block_size, bytes + alignment));
+    return do_allocate(bytes, alignment);
+}
+
+void ScratchArena::Reset() {
+    if (blocks.size() > 1) {
+        const size_t total = BytesReserved();
+        blocks.clear();
+        AddBlock(total);
+    }
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+size_t ScratchArena::BytesReserved() const {
+    size_t total = 0;
+    for (const Block& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+}  // namespace cqsp::core::util
@@ -0,0 +1,80 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace cqsp::core::util {
+/// <summary>
+/// Memory for temporary containers that don't have to live past the end of the tick.
+/// </summary>
+/// Allocating only moves a pointer forward, and deallocating does nothing. `Reset` makes all of the memory
+/// usable again without giving it back, so once the arena has seen a full tick it stops touching the heap.
+/// It works with any std::pmr container, and with the ledgers that take a memory resource:
+/// ```
+/// std::pmr::map<entt::entity, int> job_drift(&GetScratch());
+/// components::SparseLedger cost(&GetScratch());
+/// ```
+/// Anything that was allocated from the arena must be gone by the time it is reset.
+/// This is not thread safe, every simulation system has its own arena (see `ISimulationSystem::GetScratch`).
+class ScratchArena : public std::pmr::memory_resource {
+ public:
+    explicit ScratchArena(size_t block_size = 64 * 1024);
+    ~ScratchArena() override = default;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /// <summary>
+    /// Frees everything that was allocated from the arena. If more than one block was needed since the last
+    /// reset, they are replaced with one block that fits all of it.
+    /// </summary>
+    void Reset();
+
+    /// Bytes allocated since the last reset
+    size_t BytesUsed() const { return used; }
+    /// Highest BytesUsed has been since the arena was made
+    size_t PeakBytes() const { return peak; }
+    /// Bytes the arena is holding on to
+    size_t BytesReserved() const;
+
+ protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+ private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    void AddBlock(size_t size);
+
+    size_t block_size;
+    std::vector<Block> blocks;
+    // Block that is being allocated from, and how far into it we are
+    size_t current = 0;
+    size_t offset = 0;
+
+    size_t used = 0;
+    size_t peak = 0;
+};
+}  // namespace cqsp::core::util
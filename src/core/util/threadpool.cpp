@@ -0,0 +1,147 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <utility>
+
+namespace cqsp::core::util {
+namespace {
+/// Shared between the caller of ParallelFor and the helper tasks, because helpers can still be
+/// sitting in the queue after the caller has already returned.
+struct ParallelForState {
+    std::function<void(size_t, size_t)> function;
+    size_t begin;
+    size_t end;
+    size_t chunk_size;
+    size_t chunk_count;
+    std::atomic_size_t next_chunk = 0;
+    std::atomic_size_t finished_chunks = 0;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::exception_ptr exception;
+
+    // Claims and runs chunks until there are none left
+    void Work() {
+        while (true) {
+            size_t chunk = next_chunk.fetch_add(1);
+            if (chunk >= chunk_count) {
+                return;
+            }
+            size_t chunk_begin = begin + chunk * chunk_size;
+            size_t chunk_end = std::min(end, chunk_begin + chunk_size);
+            try {
+                function(chunk_begin, chunk_end);
+            } catch (...) {
+                std::lock_guard lock(mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+            if (finished_chunks.fetch_add(1) + 1 == chunk_count) {
+                std::lock_guard lock(mutex);
+                condition.notify_all();
+            }
+        }
+    }
+};
+}  // namespace
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex);
+        tasks.push(std::move(task));
+    }
+    condition.notify_one();
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& function,
+                             size_t grain) {
+    if (end <= begin) {
+        return;
+    }
+    const size_t count = end - begin;
+    grain = std::max<size_t>(grain, 1);
+    // Aim for a few chunks per thread so that uneven chunks still balance out
+    size_t chunk_size = std::max(grain, count / (ThreadCount() * 4 + 1) + 1);
+    size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    if (chunk_count == 1) {
+        function(begin, end);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->function = function;
+    state->begin = begin;
+    state->end = end;
+    state->chunk_size = chunk_size;
+    state->chunk_count = chunk_count;
+
+    size_t helpers = std::min(ThreadCount(), chunk_count - 1);
+    for (size_t i = 0; i < helpers; i++) {
+        Submit([state]() { state->Work(); });
+    }
+    state->Work();
+
+    std::unique_lock lock(state->mutex);
+    state->condition.wait(lock, [&state]() { return state->finished_chunks.load() == state->chunk_count; });
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+}  // namespace cqsp::core::util
@@ -0,0 +1,68 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace cqsp::core::util {
+/// <summary>
+/// Fixed size pool of worker threads.
+/// </summary>
+/// Tasks are run in the order that they are submitted, but there is no guarantee on which thread they run on
+/// or when they finish, so anything that needs a deterministic result has to merge its output itself.
+class ThreadPool {
+ public:
+    /// <param name="thread_count">Number of workers. 0 means one worker per hardware thread.</param>
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// <summary>
+    /// Queues a task to be run on one of the workers.
+    /// </summary>
+    void Submit(std::function<void()> task);
+
+    /// <summary>
+    /// Splits [begin, end) into chunks of at least `grain` elements and calls function(chunk_begin, chunk_end)
+    /// on each of them across the pool. Blocks until every chunk is done.
+    /// </summary>
+    /// The calling thread works on chunks as well, so it is safe to call this from inside a task that is
+    /// already running on the pool.
+    /// If a chunk throws, the first exception is rethrown on the calling thread after all chunks are done.
+    void ParallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& function,
+                     size_t grain = 1);
+
+    size_t ThreadCount() const { return workers.size(); }
+
+ private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+};
+}  // namespace cqsp::core::util
@@ -23,10 +23,13 @@
 #include <stb_image.h>
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <regex>
 #include <string>
 #include <utility>
@@ -35,7 +38,9 @@
 #include <assimp/Importer.hpp>
 #include <tracy/Tracy.hpp>
 
+#include "core/util/hash.h"
 #include "core/util/paths.h"
+#include "core/util/threadpool.h"
 #include "engine/asset/assetmanager.h"
 #include "engine/asset/assetprototypedefs.h"
 #include "engine/asset/modelloader.h"
@@ -50,6 +55,15 @@
     };
 
 namespace cqsp::asset {
+namespace {
+// Asset types that don't touch anything but the file system, so they can be loaded off the main thread
+constexpr std::array<AssetType, 2> pre_parsed_types = {AssetType::HJSON, AssetType::TEXT};
+
+bool IsPreParsed(AssetType type) {
+    return std::find(pre_parsed_types.begin(), pre_parsed_types.end(), type) != pre_parsed_types.end();
+}
+}  // namespace
+
 AssetLoader::AssetLoader(AssetOptions asset_options) : asset_options(asset_options) {
     loading_functions[AssetType::TEXT] = CREATE_ASSET_LAMBDA(LoadText);
     loading_functions[AssetType::TEXTURE] = CREATE_ASSET_LAMBDA(LoadTexture);
@@ -417,12 +431,21 @@ std::unique_ptr<Asset> AssetLoader::LoadHjson(VirtualMounter* mount, const std::
     if (mount->IsDirectory(path)) {
         // Load and append to assets.
         auto dir = mount->OpenDirectory(path);
-        for (int i = 0; i < dir->GetSize(); i++) {
+        // Go through the files by name, because the listing order depends on the filesystem, and both the order of
+        // the values and the content hash should be the same everywhere
+        std::vector<int> files(dir->GetSize());
+        std::iota(files.begin(), files.end(), 0);
+        std::sort(files.begin(), files.end(), [&](int a, int b) { return dir->GetFilename(a) < dir->GetFilename(b); });
+        asset->content_hash = core::util::fnv_offset;
+        for (int i : files) {
             auto file = dir->GetFile(i);
             Hjson::Value result;
+            const std::string text = ReadAllFromVFileToString(file.get());
+            asset->content_hash = core::util::HashBytes(dir->GetFilename(i), asset->content_hash);
+            asset->content_hash = core::util::HashBytes(text, asset->content_hash);
             // Since it's a directory, we will assume it's an array, and push back the values.
             try {
-                result = Hjson::Unmarshal(ReadAllFromVFileToString(file.get()), dec_opt);
+                result = Hjson::Unmarshal(text, dec_opt);
                 if (result.type() == Hjson::Type::Vector) {
                     // Append all the values in place
                     for (int k = 0; k < result.size(); k++) {
@@ -438,8 +461,10 @@ std::unique_ptr<Asset> AssetLoader::LoadHjson(VirtualMounter* mount, const std::
     } else {
         auto file = mount->Open(path);
         // Read the file
+        const std::string text = ReadAllFromVFileToString(file.get());
+        asset->content_hash = core::util::HashBytes(text);
         try {
-            asset->data = Hjson::Unmarshal(ReadAllFromVFileToString(file.get()), dec_opt);
+            asset->data = Hjson::Unmarshal(text, dec_opt);
         } catch (Hjson::syntax_error& ex) {
             ENGINE_LOG_ERROR("Failed to load hjson {}: {}", path, ex.what());
         }
@@ -732,6 +757,7 @@ void AssetLoader::LoadResources(Package& package, const std::string& package_mou
     // Open the root directory
     auto directory = mounter.OpenDirectory(package_mount_path + "/");
     ENGINE_LOG_INFO("Loading {}", package_mount_path);
+    std::vector<PendingAsset> pending;
     for (int i = 0; i < directory->GetSize(); i++) {
         auto resource_file = directory->GetFile(i);
         // Get the path
@@ -761,12 +787,62 @@ void AssetLoader::LoadResources(Package& package, const std::string& package_mou
         }
 
         max_loading += asset_value.size();
-        LoadResourceHjsonFile(package, package_mount_path, resource_file->Path(), asset_value);
+        LoadResourceHjsonFile(package_mount_path, resource_file->Path(), asset_value, pending);
     }
+    PlaceAssets(package, pending);
 }
 
-void AssetLoader::LoadResourceHjsonFile(Package& package, const std::string& package_mount_path,
-                                        const std::string& resource_file_path, const Hjson::Value& asset_value) {
+void AssetLoader::PlaceAssets(Package& package, std::vector<PendingAsset>& pending) {
+    ZoneScoped;
+    for (AssetType type : pre_parsed_types) {
+        std::vector<PendingAsset*> batch;
+        for (PendingAsset& asset : pending) {
+            if (asset.type != type) {
+                continue;
+            }
+            // Logged here so that the log stays in the order that the assets were listed
+            ENGINE_LOG_INFO("Loading asset {} from path {}", asset.key, asset.path);
+            if (!mounter.Exists(asset.path)) {
+                ENGINE_LOG_WARN("{} at {} does not exist, errors may ensue", asset.key, asset.path);
+            }
+            batch.push_back(&asset);
+        }
+        if (batch.empty()) {
+            continue;
+        }
+        const LoaderFunction& function = loading_functions.at(type);
+        auto start = std::chrono::system_clock::now();
+        GetThreadPool().ParallelFor(0, batch.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                batch[i]->asset = function(&mounter, batch[i]->path, batch[i]->key, batch[i]->hints);
+            }
+        });
+        auto end = std::chrono::system_clock::now();
+        loading_times[type] += std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    }
+
+    for (PendingAsset& asset : pending) {
+        if (!IsPreParsed(asset.type)) {
+            PlaceAsset(package, asset.type, asset.path, asset.key, asset.hints);
+        } else if (asset.asset == nullptr) {
+            ENGINE_LOG_WARN("Asset {} was not loaded properly", asset.key);
+        } else {
+            asset.asset->path = asset.path;
+            package.assets[asset.key] = std::move(asset.asset);
+        }
+        currentloading++;
+    }
+}
+
+core::util::ThreadPool& AssetLoader::GetThreadPool() {
+    if (thread_pool == nullptr) {
+        thread_pool = std::make_unique<core::util::ThreadPool>();
+    }
+    return *thread_pool;
+}
+
+void AssetLoader::LoadResourceHjsonFile(const std::string& package_mount_path, const std::string& resource_file_path,
+                                        const Hjson::Value& asset_value, std::vector<PendingAsset>& pending) {
     ZoneScoped;
     for (const auto& [key, val] : asset_value) {
         ENGINE_LOG_TRACE("Loading asset {}", key);
@@ -802,8 +878,7 @@ void AssetLoader::LoadResourceHjsonFile(Package& package, const std::string& pac
         if (!asset_options.load_visual && AssetIsVisual(asset_type)) {
             continue;
         }
-        PlaceAsset(package, asset_type, path, std::string(key), hints);
-        currentloading++;
+        pending.push_back({asset_type, path, std::string(key), hints, nullptr});
     }
 }
 bool AssetLoader::HjsonPrototypeDirectory(Package& package, const std::string& path, const std::string& name) {
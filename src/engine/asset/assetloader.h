@@ -21,8 +21,10 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "core/util/threadpool.h"
 #include "engine/asset/assetoptions.h"
 #include "engine/asset/assetprototype.h"
 #include "engine/asset/package.h"
@@ -41,6 +43,18 @@ class QueueHolder {
     AssetPrototype* prototype;
 };
 
+/// <summary>
+/// An asset listed in a `resource.hjson` file that hasn't been put into its package yet.
+/// </summary>
+struct PendingAsset {
+    AssetType type;
+    std::string path;
+    std::string key;
+    Hjson::Value hints;
+    /// Set if the asset was loaded ahead of time, see @ref AssetLoader::PlaceAssets
+    std::unique_ptr<Asset> asset;
+};
+
 class AssetLoader {
  public:
     AssetLoader(AssetOptions options = AssetOptions());
@@ -301,16 +315,31 @@ class AssetLoader {
     /// </summary>
     void LoadResources(Package& package, const std::string& path);
 
+    /// <summary>
+    /// Loads the assets that were listed in the resource files, and puts them into the package in the order that they
+    /// were listed.
+    /// <br>
+    /// Hjson and text assets only need to be read and decoded, so all of them are loaded at once on a thread pool
+    /// first, one asset type at a time. The rest are loaded one after another.
+    /// </summary>
+    void PlaceAssets(Package& package, std::vector<PendingAsset>& pending);
+
+    /// <summary>
+    /// Workers that PlaceAssets loads with, shared by every package. The threads are only started the first time
+    /// this is called.
+    /// </summary>
+    core::util::ThreadPool& GetThreadPool();
+
     /// <summary>
     /// Loads all the resources defined in the hjson `asset_value` in the hjson resource
     /// loading format.
     /// </summary>
-    /// <param name="package">Package to load into</param>
     /// <param name="resource_mount_path">root path of the package</param>
     /// <param name="resource_file_path">Resource file path</param>
     /// <param name="asset_value">Hjson value to read from</param>
-    void LoadResourceHjsonFile(Package& package, const std::string& package_mount_path,
-                               const std::string& resource_file_path, const Hjson::Value& asset_value);
+    /// <param name="pending">Where the assets to load are added to</param>
+    void LoadResourceHjsonFile(const std::string& package_mount_path, const std::string& resource_file_path,
+                               const Hjson::Value& asset_value, std::vector<PendingAsset>& pending);
     /// <summary>
     /// Defines a directory that contains hjson asset data.
     /// </summary>
@@ -348,8 +377,12 @@ class AssetLoader {
     /// </summary>
     /// \see @ref LoadScriptDirectory LoadCubemap LoadAudio LoadText LoadTexture LoadHjson LoadShader LoadFont
     std::map<AssetType, LoaderFunction> loading_functions;
+    /// <summary>
+    /// Wall time in milliseconds that each asset type took to load
+    /// </summary>
     std::map<AssetType, uint64_t> loading_times;
     VirtualMounter mounter;
+    std::unique_ptr<core::util::ThreadPool> thread_pool;
 
     AssetOptions asset_options;
 };
@@ -18,6 +18,7 @@
 
 #include <hjson.h>
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -56,6 +57,8 @@ class TextDirectoryAsset : public Asset {
 class HjsonAsset : public Asset {
  public:
     Hjson::Value data;
+    // Hash of the text of the files that the data was read from, so that things made out of the data can be cached
+    uint64_t content_hash = 0;
     AssetType GetAssetType() override { return AssetType::HJSON; }
 };
 
@@ -48,6 +48,8 @@ Hjson::Value ClientOptions::GetDefaultOptions() {
     default_options["audio"]["ui"] = 0.80f;
     default_options["splashscreens"] = "../data/core/gui/splashscreens";
     default_options["samples"] = 4;
+    // Ticks between autosaves, 0 turns them off
+    default_options["autosave"]["interval"] = 1000;
     return default_options;
 }
 
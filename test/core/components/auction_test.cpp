@@ -20,20 +20,22 @@
 
 #include <algorithm>
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include "core/actions/economy/auctionhandler.h"
 
-using cqsp::core::components::AscendingSortedOrderList;
 using cqsp::core::components::AuctionHouse;
-using cqsp::core::components::DescendingSortedOrderList;
+using cqsp::core::components::BuyOrderBook;
 using cqsp::core::components::Order;
+using cqsp::core::components::SellOrderBook;
 
 cqsp::core::Universe universe;
 cqsp::core::Node test_good(universe);
 cqsp::core::Node test_agent(universe);
 
-TEST(AuctionTest, DescendingSortedOrderListTest) {
-    DescendingSortedOrderList sorted_list;
+TEST(AuctionTest, BuyOrderBookTest) {
+    BuyOrderBook sorted_list;
     // Add random elements, and sort
     // quantity should not matter
     sorted_list.put(Order(40, 5, test_agent));
@@ -48,15 +50,17 @@ TEST(AuctionTest, DescendingSortedOrderListTest) {
     sorted_list.put(Order(157, 5, test_agent));
     sorted_list.put(Order(45, 5, test_agent));
 
-    double previous = sorted_list[0].price;
-    for (auto &i : sorted_list) {
+    double previous = sorted_list.front().price;
+    EXPECT_EQ(previous, 157);
+    EXPECT_EQ(sorted_list.size(), 11);
+    sorted_list.ForEach([&previous](const Order &i) {
         EXPECT_LE(i.price, previous);
         previous = i.price;
-    }
+    });
 }
 
-TEST(AuctionTest, AscendingSortedOrderListTest) {
-    AscendingSortedOrderList sorted_list;
+TEST(AuctionTest, SellOrderBookTest) {
+    SellOrderBook sorted_list;
     // Add random elements, and sort
     // quantity should not matter
     sorted_list.put(Order(40, 5, test_agent));
@@ -71,11 +75,13 @@ TEST(AuctionTest, AscendingSortedOrderListTest) {
     sorted_list.put(Order(157, 5, test_agent));
     sorted_list.put(Order(45, 5, test_agent));
 
-    double previous = sorted_list[0].price;
-    for (auto &i : sorted_list) {
+    double previous = sorted_list.front().price;
+    EXPECT_EQ(previous, 10);
+    EXPECT_EQ(sorted_list.size(), 11);
+    sorted_list.ForEach([&previous](const Order &i) {
         EXPECT_GE(i.price, previous);
         previous = i.price;
-    }
+    });
 }
 
 TEST(AuctionTest, DemandTest) {
@@ -249,3 +255,179 @@ TEST(AuctionTest, OverpricedSellOrderTest) {
     EXPECT_EQ(100, auction_house.GetDemand(test_good));
     EXPECT_EQ(100, auction_house.GetSupply(test_good));
 }
+
+// Buyers should take the cheapest sell order first, no matter which order they were put in
+TEST(AuctionTest, BestPriceFirstTest) {
+    AuctionHouse auction_house;
+    cqsp::core::Node first_agent(universe);
+    cqsp::core::Node second_agent(universe);
+    auction_house.AddSellOrder(test_good, Order(30, 10, first_agent));
+    auction_house.AddSellOrder(test_good, Order(20, 10, second_agent));
+    auction_house.AddSellOrder(test_good, Order(40, 10, first_agent));
+
+    EXPECT_EQ(auction_house.sell_orders[test_good].front().price, 20);
+    EXPECT_TRUE(cqsp::core::actions::BuyGood(auction_house, test_agent, test_good, 35, 15));
+
+    // The order at 20 is gone, and half of the order at 30 is left
+    EXPECT_EQ(auction_house.sell_orders[test_good].size(), 2);
+    EXPECT_EQ(auction_house.sell_orders[test_good].front().price, 30);
+    EXPECT_EQ(auction_house.GetSupply(test_good), 15);
+}
+
+// Orders at the same price are filled in the order they came in
+TEST(AuctionTest, FifoWithinPriceTest) {
+    SellOrderBook book;
+    cqsp::core::Node agents[4] = {cqsp::core::Node(universe), cqsp::core::Node(universe),
+                                  cqsp::core::Node(universe), cqsp::core::Node(universe)};
+    for (auto &agent : agents) {
+        book.put(Order(10, 5, agent));
+    }
+    book.put(Order(15, 5, test_agent));
+    EXPECT_EQ(book.LevelCount(), 2);
+    for (auto &agent : agents) {
+        ASSERT_FALSE(book.empty());
+        EXPECT_EQ(book.front().agent, static_cast<entt::entity>(agent));
+        book.pop_front();
+    }
+    EXPECT_EQ(book.LevelCount(), 1);
+    EXPECT_EQ(book.front().price, 15);
+    book.pop_front();
+    EXPECT_TRUE(book.empty());
+    EXPECT_EQ(book.size(), 0);
+}
+
+namespace {
+// Every order in the order it came in, filled by scanning the whole list for the best price.
+// This is what the book should do, without any of the price levels.
+struct ReferenceBook {
+    std::vector<Order> sell_orders;
+    std::vector<Order> buy_orders;
+
+    static size_t Best(const std::vector<Order> &orders, bool lowest) {
+        size_t best = 0;
+        for (size_t i = 1; i < orders.size(); i++) {
+            if (lowest ? orders[i].price < orders[best].price : orders[i].price > orders[best].price) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    bool Fill(std::vector<Order> &opposite, std::vector<Order> &own, Order order, bool buying) {
+        if (opposite.empty()) {
+            own.push_back(order);
+            return false;
+        }
+        while (!opposite.empty()) {
+            size_t best = Best(opposite, buying);
+            Order &first = opposite[best];
+            if (buying ? first.price > order.price : first.price < order.price) {
+                break;
+            }
+            if (first.quantity > order.quantity) {
+                first.quantity -= order.quantity;
+                return true;
+            }
+            order.quantity -= first.quantity;
+            opposite.erase(opposite.begin() + best);
+            if (order.quantity == 0) {
+                break;
+            }
+        }
+        if (order.quantity <= 0) {
+            return true;
+        }
+        own.push_back(order);
+        return false;
+    }
+};
+
+template <typename Book>
+std::vector<Order> Drain(Book book) {
+    std::vector<Order> orders;
+    book.ForEach([&orders](const Order &order) { orders.push_back(order); });
+    return orders;
+}
+}  // namespace
+
+TEST(AuctionTest, ReferenceEquivalenceTest) {
+    AuctionHouse auction_house;
+    ReferenceBook reference;
+    std::mt19937 gen(42);
+    // Few prices, so that there are many orders on each level
+    std::uniform_int_distribution<int> price_dist(90, 110);
+    std::uniform_int_distribution<int> quantity_dist(1, 20);
+    std::vector<cqsp::core::Node> agents;
+    for (int i = 0; i < 8; i++) {
+        agents.emplace_back(universe);
+    }
+
+    for (int i = 0; i < 5000; i++) {
+        cqsp::core::Node &agent = agents[i % agents.size()];
+        double price = price_dist(gen);
+        double quantity = quantity_dist(gen);
+        if (gen() % 2 == 0) {
+            bool filled = cqsp::core::actions::BuyGood(auction_house, agent, test_good, price, quantity);
+            EXPECT_EQ(filled, reference.Fill(reference.sell_orders, reference.buy_orders,
+                                             Order(price, quantity, agent), true));
+        } else {
+            bool filled = cqsp::core::actions::SellGood(auction_house, agent, test_good, price, quantity);
+            EXPECT_EQ(filled, reference.Fill(reference.buy_orders, reference.sell_orders,
+                                             Order(price, quantity, agent), false));
+        }
+    }
+
+    // Walk both books in fill order
+    auto sells = Drain(auction_house.sell_orders[test_good]);
+    std::stable_sort(reference.sell_orders.begin(), reference.sell_orders.end(),
+                     [](const Order &a, const Order &b) { return a.price < b.price; });
+    ASSERT_EQ(sells.size(), reference.sell_orders.size());
+    for (size_t i = 0; i < sells.size(); i++) {
+        EXPECT_EQ(sells[i].price, reference.sell_orders[i].price);
+        EXPECT_EQ(sells[i].quantity, reference.sell_orders[i].quantity);
+        EXPECT_EQ(sells[i].agent, reference.sell_orders[i].agent);
+    }
+
+    auto buys = Drain(auction_house.buy_orders[test_good]);
+    std::stable_sort(reference.buy_orders.begin(), reference.buy_orders.end(),
+                     [](const Order &a, const Order &b) { return a.price > b.price; });
+    ASSERT_EQ(buys.size(), reference.buy_orders.size());
+    for (size_t i = 0; i < buys.size(); i++) {
+        EXPECT_EQ(buys[i].price, reference.buy_orders[i].price);
+        EXPECT_EQ(buys[i].quantity, reference.buy_orders[i].quantity);
+        EXPECT_EQ(buys[i].agent, reference.buy_orders[i].agent);
+    }
+}
+
+TEST(AuctionTest, BatchedMatchingTest) {
+    AuctionHouse batched;
+    AuctionHouse one_by_one;
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> price_dist(50, 150);
+    std::uniform_int_distribution<int> quantity_dist(1, 100);
+    std::vector<Order> sells;
+    std::vector<Order> buys;
+    for (int i = 0; i < 1000; i++) {
+        sells.emplace_back(price_dist(gen), quantity_dist(gen), test_agent);
+        buys.emplace_back(price_dist(gen), quantity_dist(gen), test_agent);
+    }
+
+    size_t filled = cqsp::core::actions::SellGoods(batched, test_good, sells);
+    filled += cqsp::core::actions::BuyGoods(batched, test_good, buys);
+
+    size_t expected_filled = 0;
+    for (const Order &order : sells) {
+        expected_filled +=
+            cqsp::core::actions::SellGood(one_by_one, test_agent, test_good, order.price, order.quantity) ? 1 : 0;
+    }
+    for (const Order &order : buys) {
+        expected_filled +=
+            cqsp::core::actions::BuyGood(one_by_one, test_agent, test_good, order.price, order.quantity) ? 1 : 0;
+    }
+
+    EXPECT_EQ(filled, expected_filled);
+    EXPECT_EQ(batched.GetSupply(test_good), one_by_one.GetSupply(test_good));
+    EXPECT_EQ(batched.GetDemand(test_good), one_by_one.GetDemand(test_good));
+    EXPECT_EQ(batched.sell_orders[test_good].size(), one_by_one.sell_orders[test_good].size());
+    EXPECT_EQ(batched.buy_orders[test_good].size(), one_by_one.buy_orders[test_good].size());
+}
@@ -0,0 +1,61 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/bodyhierarchy.h"
+
+#include <gtest/gtest.h>
+
+#include <glm/glm.hpp>
+
+namespace bodies = cqsp::core::components::bodies;
+
+TEST(BodyHierarchyTest, ComputeCenters) {
+    bodies::BodyHierarchy hierarchy;
+    const uint32_t sun = hierarchy.push_back(static_cast<entt::entity>(10), bodies::BodyHierarchy::npos);
+    const uint32_t earth = hierarchy.push_back(static_cast<entt::entity>(3), sun);
+    const uint32_t mars = hierarchy.push_back(static_cast<entt::entity>(7), sun);
+    const uint32_t moon = hierarchy.push_back(static_cast<entt::entity>(1), earth);
+    hierarchy.position[earth] = glm::dvec3(100, 0, 0);
+    hierarchy.position[mars] = glm::dvec3(0, 200, 0);
+    hierarchy.position[moon] = glm::dvec3(1, 2, 3);
+    hierarchy.future_position[earth] = glm::dvec3(90, 10, 0);
+    hierarchy.future_position[moon] = glm::dvec3(2, 2, 3);
+
+    hierarchy.ComputeCenters();
+    EXPECT_EQ(hierarchy.center[sun], glm::dvec3(0, 0, 0));
+    EXPECT_EQ(hierarchy.center[earth], glm::dvec3(100, 0, 0));
+    EXPECT_EQ(hierarchy.center[mars], glm::dvec3(0, 200, 0));
+    EXPECT_EQ(hierarchy.center[moon], glm::dvec3(101, 2, 3));
+    EXPECT_EQ(hierarchy.future_center[moon], glm::dvec3(92, 12, 3));
+    EXPECT_EQ(hierarchy.ParentCenter(moon), glm::dvec3(100, 0, 0));
+    EXPECT_EQ(hierarchy.FutureParentCenter(moon), glm::dvec3(90, 10, 0));
+    EXPECT_EQ(hierarchy.ParentCenter(sun), glm::dvec3(0, 0, 0));
+}
+
+TEST(BodyHierarchyTest, IndexOf) {
+    bodies::BodyHierarchy hierarchy;
+    const uint32_t sun = hierarchy.push_back(static_cast<entt::entity>(10), bodies::BodyHierarchy::npos);
+    const uint32_t earth = hierarchy.push_back(static_cast<entt::entity>(3), sun);
+    EXPECT_EQ(hierarchy.IndexOf(static_cast<entt::entity>(10)), sun);
+    EXPECT_EQ(hierarchy.IndexOf(static_cast<entt::entity>(3)), earth);
+    EXPECT_FALSE(hierarchy.Contains(static_cast<entt::entity>(4)));
+    EXPECT_FALSE(hierarchy.Contains(static_cast<entt::entity>(100)));
+    EXPECT_FALSE(hierarchy.Contains(entt::null));
+
+    hierarchy.clear();
+    EXPECT_TRUE(hierarchy.empty());
+    EXPECT_FALSE(hierarchy.Contains(static_cast<entt::entity>(3)));
+}
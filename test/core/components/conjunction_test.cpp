@@ -0,0 +1,96 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/conjunction.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/util/threadpool.h"
+
+namespace cqspt = cqsp::core::components::types;
+
+namespace {
+std::vector<cqspt::CloseApproach> BruteForce(const std::vector<glm::dvec3>& positions,
+                                             const std::vector<uint32_t>& groups, double miss_distance) {
+    std::vector<cqspt::CloseApproach> approaches;
+    for (uint32_t i = 0; i < positions.size(); i++) {
+        for (uint32_t j = i + 1; j < positions.size(); j++) {
+            double distance = glm::length(positions[i] - positions[j]);
+            if ((groups.empty() || groups[i] == groups[j]) && distance <= miss_distance) {
+                approaches.push_back(cqspt::CloseApproach {i, j, distance});
+            }
+        }
+    }
+    return approaches;
+}
+
+void ExpectSame(const std::vector<cqspt::CloseApproach>& result, const std::vector<cqspt::CloseApproach>& expected) {
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t i = 0; i < result.size(); i++) {
+        EXPECT_EQ(result[i].first, expected[i].first);
+        EXPECT_EQ(result[i].second, expected[i].second);
+        EXPECT_NEAR(result[i].distance, expected[i].distance, 1e-9);
+    }
+}
+}  // namespace
+
+TEST(ConjunctionTest, MatchesBruteForce) {
+    std::mt19937 gen(7);
+    // Dense enough that there are plenty of pairs across cube edges
+    std::uniform_real_distribution<> coordinate(-200, 200);
+    std::uniform_int_distribution<uint32_t> group(0, 2);
+    std::vector<glm::dvec3> positions(3000);
+    std::vector<uint32_t> groups(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        positions[i] = glm::dvec3(coordinate(gen), coordinate(gen), coordinate(gen));
+        groups[i] = group(gen);
+    }
+
+    cqspt::ConjunctionScreen screen;
+    std::vector<cqspt::CloseApproach> approaches;
+    screen.Screen(positions, {}, 10, approaches);
+    auto expected = BruteForce(positions, {}, 10);
+    EXPECT_FALSE(expected.empty());
+    ExpectSame(approaches, expected);
+
+    // Same positions, but only pairs in the same group count
+    screen.Screen(positions, groups, 10, approaches);
+    auto grouped = BruteForce(positions, groups, 10);
+    EXPECT_LT(grouped.size(), expected.size());
+    ExpectSame(approaches, grouped);
+
+    cqsp::core::util::ThreadPool pool(4);
+    std::vector<cqspt::CloseApproach> parallel;
+    screen.Screen(positions, groups, 10, parallel, &pool);
+    ExpectSame(parallel, grouped);
+}
+
+TEST(ConjunctionTest, SkipsBrokenPositions) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<glm::dvec3> positions = {{0, 0, 0}, {nan, 0, 0}, {0, 0, 9.5}, {-0.5, 0, 0}, {0, 0, 1e30}};
+    cqspt::ConjunctionScreen screen;
+    std::vector<cqspt::CloseApproach> approaches;
+    screen.Screen(positions, {}, 10, approaches);
+    std::vector<cqspt::CloseApproach> expected = {
+        {0, 2, 9.5}, {0, 3, 0.5}, {2, 3, glm::length(glm::dvec3(0.5, 0, 9.5))}};
+    ExpectSame(approaches, expected);
+}
@@ -0,0 +1,96 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/ephemeris.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "core/components/orbit.h"
+#include "core/util/threadpool.h"
+
+namespace cqspt = cqsp::core::components::types;
+
+namespace {
+// Something like the moon going around something like the earth
+std::vector<cqspt::Orbit> MoonChain() {
+    cqspt::Orbit moon(384400, 0.0549, 0.09, 2.18, 5.55, 2.35);
+    moon.GM = 398600;
+    cqspt::Orbit earth(149598023, 0.0167, 0.00005, 6.08, 1.99, 6.25);
+    earth.GM = cqspt::SunMu;
+    return {moon, earth};
+}
+}  // namespace
+
+TEST(EphemerisTest, MatchesChain) {
+    std::vector<cqspt::Orbit> chain = MoonChain();
+    cqspt::BodyEphemeris ephemeris(chain);
+    ASSERT_GT(ephemeris.SegmentLength(), 0);
+    // A little over a month, at a bit less than 10 minute steps so that it doesn't line up with the segments
+    for (double time = -1e5; time < 3e6; time += 597) {
+        cqspt::EphemerisState expected = cqspt::GetChainState(chain, time);
+        cqspt::EphemerisState state = ephemeris.Get(time);
+        EXPECT_LT(glm::length(expected.position - state.position), 1e-3) << time;
+        EXPECT_LT(glm::length(expected.velocity - state.velocity), 1e-9) << time;
+    }
+}
+
+TEST(EphemerisTest, RefreshFitsAhead) {
+    cqspt::Ephemeris ephemeris;
+    const entt::entity moon = static_cast<entt::entity>(1);
+    ephemeris.SetChain(moon, MoonChain());
+    ASSERT_TRUE(ephemeris.Contains(moon));
+
+    cqspt::BodyEphemeris reference(MoonChain());
+    const double time = 1e6;
+    const int64_t index = reference.SegmentIndex(time);
+    {
+        cqsp::core::util::ThreadPool pool(2);
+        ephemeris.Refresh(time, &pool);
+    }
+    // Same fit no matter which thread it was done on
+    const double next = (index + 1.5) * reference.SegmentLength();
+    cqspt::EphemerisState state = ephemeris.Get(moon, next);
+    cqspt::EphemerisState expected = reference.Get(next);
+    EXPECT_EQ(state.position, expected.position);
+    EXPECT_EQ(state.velocity, expected.velocity);
+
+    ephemeris.Refresh(time, nullptr);
+    EXPECT_EQ(ephemeris.GetPosition(moon, time), reference.Get(time).position);
+}
+
+TEST(EphemerisTest, ChangedChain) {
+    cqspt::Ephemeris ephemeris;
+    const entt::entity moon = static_cast<entt::entity>(1);
+    std::vector<cqspt::Orbit> chain = MoonChain();
+    ephemeris.SetChain(moon, chain);
+    const glm::dvec3 before = ephemeris.GetPosition(moon, 1000);
+
+    chain[0] = cqspt::ApplyImpulse(chain[0], glm::dvec3(0, 0.1, 0), 0);
+    ephemeris.SetChain(moon, chain);
+    const glm::dvec3 after = ephemeris.GetPosition(moon, 1000);
+    EXPECT_NE(before, after);
+    EXPECT_LT(glm::length(cqspt::GetChainState(chain, 1000).position - after), 1e-3);
+}
+
+TEST(EphemerisTest, HyperbolicIsNotFitted) {
+    cqspt::Orbit orbit(-50000, 1.5, 0.1, 0.2, 0.3, 0.1);
+    orbit.GM = 398600;
+    cqspt::BodyEphemeris ephemeris({orbit});
+    EXPECT_EQ(ephemeris.SegmentLength(), 0);
+    EXPECT_EQ(ephemeris.Get(100).position, cqspt::GetChainState({orbit}, 100).position);
+}
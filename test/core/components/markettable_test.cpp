@@ -0,0 +1,90 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/markettable.h"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+using cqsp::core::components::Market;
+using cqsp::core::components::MarketTable;
+using cqsp::core::components::ResourceLedger;
+using cqsp::core::components::ToGoodEntity;
+
+TEST(Core_MarketTable, AttachKeepsValues) {
+    Market market(4);
+    market.price[ToGoodEntity(2)] = 12;
+    market.supply[ToGoodEntity(0)] = 3;
+
+    MarketTable table(4, 2);
+    ASSERT_EQ(table.Attach(market), 0);
+    EXPECT_TRUE(market.price.IsView());
+    EXPECT_EQ(table.RowOf(market), 0);
+    EXPECT_DOUBLE_EQ(market.price[ToGoodEntity(2)], 12);
+    EXPECT_DOUBLE_EQ(table.Row(&Market::price, 0)[2], 12);
+    EXPECT_DOUBLE_EQ(table.Row(&Market::supply, 0)[0], 3);
+
+    // Writing through the market writes into the table
+    market.demand[ToGoodEntity(1)] = 7;
+    EXPECT_DOUBLE_EQ(table.Row(&Market::demand, 0)[1], 7);
+}
+
+TEST(Core_MarketTable, AssignmentStaysInTable) {
+    MarketTable table(3, 1);
+    Market market(3);
+    table.Attach(market);
+
+    ResourceLedger production(3);
+    production[ToGoodEntity(1)] = 5;
+    market.supply = production;
+    market.sd_ratio = market.supply.SafeDivision(market.demand);
+    market.production += production;
+
+    EXPECT_EQ(table.RowOf(market), 0);
+    EXPECT_DOUBLE_EQ(table.Row(&Market::supply, 0)[1], 5);
+    EXPECT_DOUBLE_EQ(table.Row(&Market::production, 0)[1], 5);
+    EXPECT_EQ(market.sd_ratio.data(), table.Row(&Market::sd_ratio, 0));
+
+    // A copy gets its own values
+    Market copy = market;
+    EXPECT_FALSE(copy.supply.IsView());
+    EXPECT_EQ(table.RowOf(copy), MarketTable::npos);
+    copy.supply[ToGoodEntity(1)] = 100;
+    EXPECT_DOUBLE_EQ(market.supply[ToGoodEntity(1)], 5);
+}
+
+TEST(Core_MarketTable, MovedMarketsKeepTheirRows) {
+    MarketTable table(2, 3);
+    std::vector<Market> markets;
+    for (int i = 0; i < 3; i++) {
+        markets.emplace_back(2);
+        markets.back().price[ToGoodEntity(0)] = i;
+    }
+    for (auto& market : markets) {
+        table.Attach(market);
+    }
+    // Swapping markets around (like entt does when sorting or removing) moves the rows with them
+    std::swap(markets[0], markets[2]);
+    EXPECT_EQ(table.RowOf(markets[0]), 2);
+    EXPECT_DOUBLE_EQ(markets[0].price[ToGoodEntity(0)], 2);
+    EXPECT_EQ(table.RowOf(markets[2]), 0);
+
+    Market extra(2);
+    EXPECT_EQ(table.Attach(extra), MarketTable::npos);
+    EXPECT_FALSE(extra.price.IsView());
+}
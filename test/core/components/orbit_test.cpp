@@ -20,6 +20,8 @@
 #include <gtest/gtest.h>
 #include <hjson.h>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <numbers>
 
@@ -394,3 +396,93 @@ INSTANTIATE_TEST_SUITE_P(EllipticalOrbitTest, EllipticalOrbitTest,
                                          Orbit(57.91e7, 0.9, 3.14, 0.29, 0.68, 2.8), Orbit(57.91e7, 0, 1, 0, 0, 0),
                                          Orbit(57.91e7, 0.6, 0, 0, 0, 0.8), Orbit(57.91e7, 0.6, 0, 0, 0, 0),
                                          Orbit(57.91e7, 0, 0, 0, 0, 0)));
+
+namespace {
+// Newton's method in long double from a safe starting point, as a reference
+long double ReferenceEllipticAnomaly(long double M, long double e) {
+    long double E = e > 0.8 ? std::copysign(cqspt::PI, static_cast<double>(M)) : M;
+    for (int i = 0; i < 500; i++) {
+        long double step = (E - e * std::sin(E) - M) / (1 - e * std::cos(E));
+        E -= step;
+        if (std::abs(step) < 1e-19L) {
+            break;
+        }
+    }
+    return E;
+}
+
+long double ReferenceHyperbolicAnomaly(long double M, long double e) {
+    long double H = std::copysign(std::log(2 * std::abs(M) / e + 2) + 1, static_cast<double>(M));
+    for (int i = 0; i < 500; i++) {
+        long double step = (e * std::sinh(H) - H - M) / (e * std::cosh(H) - 1);
+        H -= step;
+        if (std::abs(step) < 1e-19L * std::max(1.0L, std::abs(H))) {
+            break;
+        }
+    }
+    return H;
+}
+}  // namespace
+
+TEST(OrbitTest, FastKeplerEllipticSweep) {
+    for (double e : {0.0, 0.001, 0.1, 0.5, 0.9, 0.99, 0.999}) {
+        for (int i = -1000; i <= 1000; i++) {
+            const double M = i * cqspt::PI / 1000 * 0.9999;
+            const double E = cqspt::SolveKeplerEllipticFast(M, e);
+            EXPECT_NEAR(E, static_cast<double>(ReferenceEllipticAnomaly(M, e)), 1e-14) << "e=" << e << " M=" << M;
+        }
+    }
+    // Mean anomalies outside of [-pi, pi] stay in their own revolution
+    EXPECT_NEAR(cqspt::SolveKeplerEllipticFast(cqspt::TWOPI + 1, 0.3),
+                cqspt::TWOPI + cqspt::SolveKeplerEllipticFast(1, 0.3), 1e-12);
+}
+
+TEST(OrbitTest, FastKeplerHyperbolicSweep) {
+    for (double e : {1.001, 1.01, 1.1, 1.5, 2.0, 5.0, 10.0}) {
+        for (int i = -600; i <= 600; i++) {
+            // 1e-6 to 1e6
+            const double M = std::copysign(std::pow(10.0, std::abs(i) / 50.0 - 6), static_cast<double>(i));
+            const double H = cqspt::SolveKeplerHyperbolicFast(M, e);
+            const double expected = static_cast<double>(ReferenceHyperbolicAnomaly(M, e));
+            EXPECT_NEAR(H, expected, 1e-13 * std::max(1.0, std::abs(expected))) << "e=" << e << " M=" << M;
+        }
+    }
+    EXPECT_EQ(cqspt::SolveKeplerHyperbolicFast(0, 2), 0);
+}
+
+TEST(OrbitTest, KeplerSolverSelection) {
+    Orbit orbit(57.91e7, 0.6, 1.45, 0.29, 0.68, 2);
+    EXPECT_EQ(cqspt::GetKeplerSolver(), cqspt::KeplerSolver::Fast);
+    const double fast = cqspt::GetTrueAnomaly(orbit, 1e6);
+    cqspt::SetKeplerSolver(cqspt::KeplerSolver::Newton);
+    const double newton = cqspt::GetTrueAnomaly(orbit, 1e6);
+    cqspt::SetKeplerSolver(cqspt::KeplerSolver::Fast);
+    EXPECT_NEAR(fast, newton, 1e-9);
+}
+
+TEST(OrbitTest, CachedRotationTest) {
+    Orbit orbit(57.91e7, 0.3, 1.1, 0.29, 0.68, 2);
+    const glm::dvec3 vec(0.3, -1.2, 0.7);
+    const glm::dvec3 rotated = cqspt::ConvertOrbParams(orbit.LAN, orbit.inclination, orbit.w, vec);
+    EXPECT_LT(glm::length(orbit.GetRotation() * vec - rotated), 1e-12);
+    for (double v = 0; v < cqspt::TWOPI; v += 0.1) {
+        const glm::dvec3 expected = cqspt::OrbitToVec3(orbit.semi_major_axis, orbit.eccentricity, orbit.inclination,
+                                                       orbit.LAN, orbit.w, v);
+        EXPECT_LT(glm::length(cqspt::toVec3(orbit, v) - expected), 1e-6 * orbit.semi_major_axis);
+    }
+
+    // Changing the elements without updating the cache still gives the right answer
+    orbit.LAN = 2.5;
+    auto expected = cqspt::OrbitToVec3(orbit.semi_major_axis, orbit.eccentricity, orbit.inclination, orbit.LAN,
+                                       orbit.w, 1.);
+    EXPECT_LT(glm::length(cqspt::toVec3(orbit, 1.) - expected), 1e-6 * orbit.semi_major_axis);
+    orbit.UpdateRotation();
+    EXPECT_EQ(orbit.rotation_elements, glm::dvec3(orbit.LAN, orbit.inclination, orbit.w));
+    EXPECT_LT(glm::length(cqspt::toVec3(orbit, 1.) - expected), 1e-6 * orbit.semi_major_axis);
+
+    // New orbits from state vectors come with the cache filled in
+    Orbit moved = cqspt::ApplyImpulse(orbit, glm::dvec3(0, 1, 0.5), 100);
+    EXPECT_EQ(moved.rotation_elements, glm::dvec3(moved.LAN, moved.inclination, moved.w));
+    Orbit copy = moved;
+    EXPECT_EQ(copy.rotation_elements, moved.rotation_elements);
+}
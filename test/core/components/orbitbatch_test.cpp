@@ -0,0 +1,109 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/orbitbatch.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "core/components/orbit.h"
+
+namespace cqspt = cqsp::core::components::types;
+
+namespace {
+void ExpectNearVector(const glm::dvec3& expected, const glm::dvec3& actual, double tolerance) {
+    const double scale = std::max(glm::length(expected), 1.);
+    EXPECT_LE(glm::length(expected - actual) / scale, tolerance)
+        << glm::to_string(expected) << " vs " << glm::to_string(actual);
+}
+
+std::vector<cqspt::Orbit> RandomOrbits(size_t count, double min_e, double max_e) {
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<> e_dist(min_e, max_e);
+    std::uniform_real_distribution<> a_dist(7000, 400000);
+    std::uniform_real_distribution<> angle_dist(0, cqspt::TWOPI);
+    std::uniform_real_distribution<> i_dist(0, cqspt::PI);
+    std::uniform_real_distribution<> epoch_dist(-100000, 100000);
+    std::vector<cqspt::Orbit> orbits;
+    for (size_t i = 0; i < count; i++) {
+        const double e = e_dist(gen);
+        // Hyperbolic orbits have a negative semi major axis
+        const double a = e < 1 ? a_dist(gen) : -a_dist(gen);
+        cqspt::Orbit orbit(a, e, i_dist(gen), angle_dist(gen), angle_dist(gen), 0);
+        orbit.GM = 398600;
+        orbit.epoch = epoch_dist(gen);
+        // Keep hyperbolic orbits near periapsis, so that they are well away from the asymptotes
+        orbit.M0 = e < 1 ? angle_dist(gen) : e_dist(gen) - 1;
+        orbits.push_back(orbit);
+    }
+    return orbits;
+}
+
+void ExpectSameAsScalar(std::vector<cqspt::Orbit>& orbits, double time, double future_time) {
+    cqspt::OrbitBatch batch;
+    for (const cqspt::Orbit& orbit : orbits) {
+        batch.push_back(orbit);
+    }
+    cqspt::PropagateOrbits(batch, time, future_time);
+    ASSERT_EQ(batch.size(), orbits.size());
+
+    for (size_t i = 0; i < orbits.size(); i++) {
+        cqspt::Orbit& orbit = orbits[i];
+        EXPECT_TRUE(batch.Matches(i, orbit));
+        cqspt::UpdateOrbit(orbit, time);
+        EXPECT_NEAR(cqspt::normalize_radian(orbit.v), cqspt::normalize_radian(batch.true_anomaly[i]), 1e-9)
+            << orbit;
+        ExpectNearVector(cqspt::toVec3(orbit), batch.position[i], 1e-9);
+        ExpectNearVector(cqspt::OrbitVelocityToVec3(orbit, orbit.v), batch.velocity[i], 1e-9);
+        ExpectNearVector(cqspt::OrbitTimeToVec3(orbit, future_time), batch.future_position[i], 1e-9);
+    }
+}
+}  // namespace
+
+TEST(OrbitBatchTest, EllipticMatchesScalar) {
+    std::vector<cqspt::Orbit> orbits = RandomOrbits(1001, 0, 0.95);
+    ExpectSameAsScalar(orbits, 3600, 3600 + 60);
+}
+
+TEST(OrbitBatchTest, NewtonMatchesScalar) {
+    cqspt::SetKeplerSolver(cqspt::KeplerSolver::Newton);
+    std::vector<cqspt::Orbit> orbits = RandomOrbits(1001, 0, 0.95);
+    ExpectSameAsScalar(orbits, 3600, 3600 + 60);
+    cqspt::SetKeplerSolver(cqspt::KeplerSolver::Fast);
+}
+
+TEST(OrbitBatchTest, CircularMatchesScalar) {
+    std::vector<cqspt::Orbit> orbits = RandomOrbits(13, 0, 0);
+    ExpectSameAsScalar(orbits, 0, 60);
+}
+
+TEST(OrbitBatchTest, HyperbolicMatchesScalar) {
+    std::vector<cqspt::Orbit> orbits = RandomOrbits(101, 1.1, 3);
+    ExpectSameAsScalar(orbits, 0, 1);
+}
+
+TEST(OrbitBatchTest, MatchesChangedOrbit) {
+    cqspt::Orbit orbit(10000, 0.1, 0.2, 0.3, 0.4, 0.5);
+    cqspt::OrbitBatch batch;
+    size_t index = batch.push_back(orbit);
+    EXPECT_TRUE(batch.Matches(index, orbit));
+    orbit = cqspt::ApplyImpulse(orbit, glm::dvec3(0, 1, 0), 100);
+    EXPECT_FALSE(batch.Matches(index, orbit));
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+}
@@ -0,0 +1,123 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/resourceexpression.h"
+
+#include <gtest/gtest.h>
+
+#include "core/components/market.h"
+
+using cqsp::core::components::GoodEntity;
+using cqsp::core::components::Market;
+using cqsp::core::components::ResourceLedger;
+using cqsp::core::components::ResourceMap;
+using cqsp::core::components::ResourceVector;
+using cqsp::core::components::ToGoodEntity;
+using cqsp::core::components::expr::Lazy;
+
+namespace {
+ResourceVector MakeVector(std::initializer_list<std::pair<uint32_t, double>> values) {
+    ResourceVector vector;
+    for (auto [good, value] : values) {
+        vector.emplace_back(ToGoodEntity(good), value);
+    }
+    vector.Finalize();
+    return vector;
+}
+}  // namespace
+
+TEST(Core_ResourceExpression, VectorSumMatchesEager) {
+    ResourceVector input = MakeVector({{1, 2.5}, {3, 4}, {7, 0.1}});
+    ResourceVector capital = MakeVector({{0, 1}, {3, 2}, {8, 5}});
+    const double utilization = 13.7;
+    const double size = 3.3;
+
+    ResourceVector expected = (input * utilization) + (capital * size);
+    ResourceVector result;
+    Assign(result, Lazy(input) * utilization + Lazy(capital) * size);
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(result.begin()[i].first, expected.begin()[i].first);
+        EXPECT_EQ(result.begin()[i].second, expected.begin()[i].second);
+    }
+}
+
+// Goods that are both inputs and capital costs, and one that is in the inputs twice, have to be bought the same
+// way as SysProduction did before with the eager operators
+TEST(Core_ResourceExpression, OverlappingGoodsMatchEagerPurchase) {
+    ResourceVector input = MakeVector({{1, 2.5}, {3, 4}, {3, 0.7}, {5, 1.1}, {7, 0.1}});
+    ResourceVector capital = MakeVector({{0, 1}, {1, 0.3}, {3, 2}, {7, 5}});
+    const double utilization = 13.7;
+    const double size = 3.3;
+
+    Market eager(8);
+    Market lazy(8);
+    for (uint32_t good = 0; good < 8; good++) {
+        eager.price[ToGoodEntity(good)] = lazy.price[ToGoodEntity(good)] = 1.3 + 0.7 * good;
+        eager.taxation[ToGoodEntity(good)] = lazy.taxation[ToGoodEntity(good)] = 0.01 * good;
+    }
+    ResourceVector combined = (input * utilization) + (capital * size);
+    auto expression = Lazy(input) * utilization + Lazy(capital) * size;
+    EXPECT_EQ(expression.GetSum(), combined.GetSum());
+
+    auto [eager_cost, eager_tax] = eager.PurchaseFromMarket(combined);
+    auto [lazy_cost, lazy_tax] = lazy.PurchaseFromMarket(expression);
+    EXPECT_EQ(lazy_cost, eager_cost);
+    EXPECT_EQ(lazy_tax, eager_tax);
+    for (uint32_t good = 0; good < 8; good++) {
+        EXPECT_EQ(lazy.consumption[ToGoodEntity(good)], eager.consumption[ToGoodEntity(good)]) << "good " << good;
+    }
+}
+
+TEST(Core_ResourceExpression, MapTimesLedger) {
+    ResourceMap consumption;
+    consumption[ToGoodEntity(1)] = 10;
+    consumption[ToGoodEntity(4)] = 3;
+    ResourceLedger price(6);
+    price[ToGoodEntity(1)] = 2;
+    price[ToGoodEntity(4)] = 0.5;
+    price[ToGoodEntity(5)] = 100;
+
+    EXPECT_DOUBLE_EQ((Lazy(consumption) * price).GetSum(), 21.5);
+    EXPECT_DOUBLE_EQ((price * Lazy(consumption)).GetSum(), 21.5);
+    EXPECT_DOUBLE_EQ((Lazy(consumption) * price * 2.).GetSum(), 43);
+}
+
+TEST(Core_ResourceExpression, AddIntoLedger) {
+    ResourceVector input = MakeVector({{0, 1}, {2, 2}});
+    ResourceVector other = MakeVector({{2, 3}, {3, 4}});
+    ResourceLedger ledger(4);
+    ledger += Lazy(input) - other;
+    EXPECT_EQ(ledger[ToGoodEntity(0)], 1);
+    EXPECT_EQ(ledger[ToGoodEntity(1)], 0);
+    EXPECT_EQ(ledger[ToGoodEntity(2)], -1);
+    EXPECT_EQ(ledger[ToGoodEntity(3)], -4);
+
+    ResourceLedger doubled(4);
+    Assign(doubled, Lazy(ledger) * 2. + ledger);
+    EXPECT_EQ(doubled[ToGoodEntity(3)], -12);
+    EXPECT_EQ((Lazy(ledger) * ledger).GetSum(), 1 + 1 + 16);
+}
+
+TEST(Core_ResourceExpression, SparseProductOnlyKeepsSharedGoods) {
+    ResourceVector first = MakeVector({{0, 2}, {2, 3}, {5, 4}});
+    ResourceVector second = MakeVector({{1, 10}, {2, 10}, {5, 10}, {6, 10}});
+    ResourceVector result;
+    Assign(result, Lazy(first) * second);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[ToGoodEntity(2)], 30);
+    EXPECT_EQ(result[ToGoodEntity(5)], 40);
+}
@@ -0,0 +1,243 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/resourceledgerkernels.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "core/components/resourceledger.h"
+
+using cqsp::core::components::GetLedgerKernels;
+using cqsp::core::components::IsSimdLevelSupported;
+using cqsp::core::components::LedgerKernels;
+using cqsp::core::components::SimdLevel;
+
+namespace {
+const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+
+// Mix of ordinary values and the ones that usually break vector code
+std::vector<double> MakeValues(size_t count, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> dist(-1000, 1000);
+    std::uniform_int_distribution<> special(0, 11);
+    std::vector<double> values(count);
+    for (double& value : values) {
+        switch (special(gen)) {
+            case 0:
+                value = 0.0;
+                break;
+            case 1:
+                value = -0.0;
+                break;
+            case 2:
+                value = std::numeric_limits<double>::infinity();
+                break;
+            case 3:
+                value = std::numeric_limits<double>::quiet_NaN();
+                break;
+            case 4:
+                value = std::numeric_limits<double>::denorm_min();
+                break;
+            default:
+                value = dist(gen);
+        }
+    }
+    return values;
+}
+
+bool BitEqual(const std::vector<double>& first, const std::vector<double>& second) {
+    return first.size() == second.size() &&
+           std::memcmp(first.data(), second.data(), first.size() * sizeof(double)) == 0;
+}
+
+bool BitEqual(double first, double second) { return std::memcmp(&first, &second, sizeof(double)) == 0; }
+
+// Checks every supported kernel against the plain loop that ResourceLedger used before
+template <typename Reference, typename Kernel>
+void ExpectSameAsLoop(Reference reference, Kernel kernel) {
+    for (size_t count = 0; count < 40; count++) {
+        std::vector<double> first = MakeValues(count, static_cast<unsigned int>(count));
+        std::vector<double> second = MakeValues(count, static_cast<unsigned int>(count + 1000));
+        std::vector<double> expected = first;
+        reference(expected, second);
+        for (SimdLevel level : levels) {
+            if (!IsSimdLevelSupported(level)) {
+                continue;
+            }
+            std::vector<double> result = first;
+            kernel(GetLedgerKernels(level), result, second);
+            EXPECT_TRUE(BitEqual(result, expected)) << ToString(level) << " with " << count << " goods";
+        }
+    }
+}
+}  // namespace
+
+TEST(Core_LedgerKernels, ScalarAlwaysSupported) {
+    EXPECT_TRUE(IsSimdLevelSupported(SimdLevel::Scalar));
+    EXPECT_TRUE(IsSimdLevelSupported(cqsp::core::components::GetBestSimdLevel()));
+    EXPECT_EQ(GetLedgerKernels().level, cqsp::core::components::GetBestSimdLevel());
+}
+
+TEST(Core_LedgerKernels, Arithmetic) {
+    using Vec = std::vector<double>;
+    ExpectSameAsLoop([](Vec& a, const Vec& b) { for (size_t i = 0; i < a.size(); i++) a[i] += b[i]; },
+                     [](const LedgerKernels& k, Vec& a, const Vec& b) { k.add(a.data(), b.data(), a.size()); });
+    ExpectSameAsLoop([](Vec& a, const Vec& b) { for (size_t i = 0; i < a.size(); i++) a[i] -= b[i]; },
+                     [](const LedgerKernels& k, Vec& a, const Vec& b) { k.subtract(a.data(), b.data(), a.size()); });
+    ExpectSameAsLoop([](Vec& a, const Vec& b) { for (size_t i = 0; i < a.size(); i++) a[i] *= b[i]; },
+                     [](const LedgerKernels& k, Vec& a, const Vec& b) { k.multiply(a.data(), b.data(), a.size()); });
+    ExpectSameAsLoop([](Vec& a, const Vec& b) { for (size_t i = 0; i < a.size(); i++) a[i] /= b[i]; },
+                     [](const LedgerKernels& k, Vec& a, const Vec& b) { k.divide(a.data(), b.data(), a.size()); });
+}
+
+TEST(Core_LedgerKernels, MultiplyAdd) {
+    using Vec = std::vector<double>;
+    for (double factor : {0.0, -0.0, 0.3, -17.5, std::numeric_limits<double>::infinity()}) {
+        ExpectSameAsLoop(
+            [factor](Vec& a, const Vec& b) {
+                for (size_t i = 0; i < a.size(); i++) {
+                    double product = b[i] * factor;
+                    a[i] += product;
+                }
+            },
+            [factor](const LedgerKernels& k, Vec& a, const Vec& b) {
+                k.multiply_add(a.data(), b.data(), factor, a.size());
+            });
+    }
+}
+
+TEST(Core_LedgerKernels, AddPositiveNegative) {
+    using Vec = std::vector<double>;
+    ExpectSameAsLoop(
+        [](Vec& a, const Vec& b) {
+            for (size_t i = 0; i < a.size(); i++) {
+                if (b[i] > 0) a[i] += b[i];
+            }
+        },
+        [](const LedgerKernels& k, Vec& a, const Vec& b) { k.add_positive(a.data(), b.data(), a.size()); });
+    ExpectSameAsLoop(
+        [](Vec& a, const Vec& b) {
+            for (size_t i = 0; i < a.size(); i++) {
+                if (b[i] < 0) a[i] -= b[i];
+            }
+        },
+        [](const LedgerKernels& k, Vec& a, const Vec& b) { k.add_negative(a.data(), b.data(), a.size()); });
+}
+
+TEST(Core_LedgerKernels, ClampAndSafeDivision) {
+    using Vec = std::vector<double>;
+    ExpectSameAsLoop(
+        [](Vec& a, const Vec&) {
+            for (double& value : a) value = std::clamp(value, -10.0, 250.0);
+        },
+        [](const LedgerKernels& k, Vec& a, const Vec&) { k.clamp(a.data(), -10.0, 250.0, a.size()); });
+    for (double fallback : {0.0, std::numeric_limits<double>::infinity()}) {
+        ExpectSameAsLoop(
+            [fallback](Vec& a, const Vec& b) {
+                for (size_t i = 0; i < a.size(); i++) a[i] = (b[i] == 0.0) ? fallback : a[i] / b[i];
+            },
+            [fallback](const LedgerKernels& k, Vec& a, const Vec& b) {
+                k.safe_division(a.data(), b.data(), fallback, a.size());
+            });
+    }
+}
+
+TEST(Core_LedgerKernels, MultiplySumInOrder) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> dist(-1000, 1000);
+    for (size_t count = 0; count < 70; count++) {
+        std::vector<double> first(count);
+        std::vector<double> second(count);
+        double sequential = 0;
+        for (size_t i = 0; i < count; i++) {
+            first[i] = dist(gen);
+            second[i] = dist(gen);
+            sequential += first[i] * second[i];
+        }
+        for (SimdLevel level : levels) {
+            if (!IsSimdLevelSupported(level)) {
+                continue;
+            }
+            double result = GetLedgerKernels(level).multiply_sum(first.data(), second.data(), count);
+            EXPECT_EQ(result, sequential) << ToString(level) << " with " << count << " goods";
+            EXPECT_TRUE(BitEqual(result, sequential)) << ToString(level) << " with " << count << " goods";
+        }
+    }
+}
+
+TEST(Core_LedgerKernels, ResourceLedgerSumInOrder) {
+    using cqsp::core::components::ResourceLedger;
+    using cqsp::core::components::ToGoodEntity;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<> dist(-1000, 1000);
+    const size_t count = 37;
+    ResourceLedger price(count);
+    ResourceLedger amount(count);
+    double sequential = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        price[ToGoodEntity(i)] = dist(gen);
+        amount[ToGoodEntity(i)] = dist(gen);
+        sequential += amount[ToGoodEntity(i)] * price[ToGoodEntity(i)];
+    }
+    EXPECT_EQ(price.MultiplyAndGetSum(amount), sequential);
+}
+
+// Adding up in lanes rounds differently, so it is only close to the sum in order, but still the same on every level
+TEST(Core_LedgerKernels, InterleavedSumSameOnEveryLevel) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> dist(-1000, 1000);
+    for (size_t count = 0; count < 70; count++) {
+        std::vector<double> first(count);
+        std::vector<double> second(count);
+        double sequential = 0;
+        for (size_t i = 0; i < count; i++) {
+            first[i] = dist(gen);
+            second[i] = dist(gen);
+            sequential += first[i] * second[i];
+        }
+        const double expected =
+            GetLedgerKernels(SimdLevel::Scalar).multiply_sum_interleaved(first.data(), second.data(), count);
+        EXPECT_NEAR(expected, sequential, 1e-6 * (1 + std::abs(sequential)));
+        for (SimdLevel level : levels) {
+            if (!IsSimdLevelSupported(level)) {
+                continue;
+            }
+            double result = GetLedgerKernels(level).multiply_sum_interleaved(first.data(), second.data(), count);
+            EXPECT_TRUE(BitEqual(result, expected)) << ToString(level) << " with " << count << " goods";
+        }
+    }
+}
+
+TEST(Core_LedgerKernels, ResourceLedgerClamp) {
+    using cqsp::core::components::ResourceLedger;
+    using cqsp::core::components::ToGoodEntity;
+    ResourceLedger ledger(5);
+    ledger[ToGoodEntity(0)] = -5;
+    ledger[ToGoodEntity(1)] = 0.5;
+    ledger[ToGoodEntity(2)] = 20;
+    ResourceLedger clamped = ledger.Clamp(0, 10);
+    EXPECT_EQ(clamped[ToGoodEntity(0)], 0);
+    EXPECT_EQ(clamped[ToGoodEntity(1)], 0.5);
+    EXPECT_EQ(clamped[ToGoodEntity(2)], 10);
+    EXPECT_EQ(clamped[ToGoodEntity(3)], 0);
+}
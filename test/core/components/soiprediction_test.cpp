@@ -0,0 +1,102 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/components/soiprediction.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "core/components/orbit.h"
+
+namespace cqspt = cqsp::core::components::types;
+
+namespace {
+constexpr double earth_radius = 6371;
+constexpr double earth_soi = 924000;
+constexpr double earth_mu = 398600;
+constexpr double moon_soi = 66100;
+
+cqspt::Orbit MoonOrbit() {
+    cqspt::Orbit moon(384400, 0.0549, 0.09, 2.18, 5.55, 2.35);
+    moon.GM = earth_mu;
+    return moon;
+}
+
+cqspt::Orbit ShipOrbit(double a, double e) {
+    cqspt::Orbit ship(a, e, 0.1, 0.2, 0.3, 0.4);
+    ship.GM = earth_mu;
+    return ship;
+}
+
+// Steps through the duration, and checks that nothing was crossed
+void ExpectNothingHappens(const cqspt::Orbit& ship, const cqspt::Orbit& moon, double time, double duration) {
+    for (double t = time; t < time + duration; t += duration / 1000) {
+        const glm::dvec3 position = cqspt::OrbitTimeToVec3(ship, t);
+        EXPECT_GT(glm::length(position), earth_radius) << t;
+        EXPECT_LT(glm::length(position), earth_soi) << t;
+        EXPECT_GT(glm::distance(position, cqspt::OrbitTimeToVec3(moon, t)), moon_soi) << t;
+    }
+}
+}  // namespace
+
+TEST(SOIPredictionTest, ParkedOrbitNeverChecks) {
+    cqspt::Orbit ship = ShipOrbit(earth_radius + 500, 0.01);
+    std::vector<cqspt::SOIBounds> bounds {
+        cqspt::GetSOIBounds(MoonOrbit(), cqspt::OrbitTimeToVec3(MoonOrbit(), 0), moon_soi)};
+    const double duration =
+        cqspt::SOISafeDuration(ship, cqspt::OrbitTimeToVec3(ship, 0), earth_radius, earth_soi, bounds);
+    EXPECT_TRUE(std::isinf(duration));
+}
+
+TEST(SOIPredictionTest, TransferOrbitIsConservative) {
+    // Reaches out to the moon
+    const double periapsis = earth_radius + 300;
+    const double apoapsis = 390000;
+    cqspt::Orbit ship = ShipOrbit((periapsis + apoapsis) / 2, (apoapsis - periapsis) / (apoapsis + periapsis));
+    const cqspt::Orbit moon = MoonOrbit();
+    for (double time = 0; time < ship.T(); time += ship.T() / 16) {
+        std::vector<cqspt::SOIBounds> bounds {cqspt::GetSOIBounds(moon, cqspt::OrbitTimeToVec3(moon, time), moon_soi)};
+        const double duration =
+            cqspt::SOISafeDuration(ship, cqspt::OrbitTimeToVec3(ship, time), earth_radius, earth_soi, bounds);
+        ASSERT_TRUE(std::isfinite(duration));
+        EXPECT_GT(duration, 0);
+        ExpectNothingHappens(ship, moon, time, duration);
+    }
+}
+
+TEST(SOIPredictionTest, CrashingOrbit) {
+    // Periapsis is under the surface
+    cqspt::Orbit ship = ShipOrbit(earth_radius + 200, 0.1);
+    const glm::dvec3 position = cqspt::toVec3(ship, cqspt::apoapsis);
+    const double duration = cqspt::SOISafeDuration(ship, position, earth_radius, earth_soi, {});
+    ASSERT_TRUE(std::isfinite(duration));
+    EXPECT_LE(duration, (glm::length(position) - earth_radius) / cqspt::MaxOrbitSpeed(ship));
+    EXPECT_EQ(cqspt::SOISafeDuration(ship, glm::normalize(position) * (earth_radius - 1), earth_radius, earth_soi, {}),
+              0);
+}
+
+TEST(SOIPredictionTest, EscapingOrbit) {
+    cqspt::Orbit ship = ShipOrbit(-50000, 1.2);
+    const glm::dvec3 position = cqspt::toVec3(ship, 0.5);
+    const double duration = cqspt::SOISafeDuration(ship, position, earth_radius, earth_soi, {});
+    ASSERT_TRUE(std::isfinite(duration));
+    EXPECT_GT(duration, 0);
+    EXPECT_LE(duration, (earth_soi - glm::length(position)) / cqspt::MaxOrbitSpeed(ship));
+}
@@ -0,0 +1,123 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "core/components/resourceexpression.h"
+#include "core/components/resourceledger.h"
+
+using cqsp::core::components::GoodEntity;
+using cqsp::core::components::ResourceLedger;
+using cqsp::core::components::ResourceMap;
+using cqsp::core::components::SparseLedger;
+using cqsp::core::components::ToGoodEntity;
+using cqsp::core::components::expr::Lazy;
+
+TEST(Core_SparseLedger, InsertKeepsGoodsSorted) {
+    SparseLedger ledger;
+    ledger[ToGoodEntity(5)] = 1;
+    ledger[ToGoodEntity(1)] = 2;
+    ledger[ToGoodEntity(3)] += 3;
+    ledger[ToGoodEntity(5)] += 4;
+
+    ASSERT_EQ(ledger.size(), 3);
+    EXPECT_EQ(ledger.GoodAt(0), ToGoodEntity(1));
+    EXPECT_EQ(ledger.GoodAt(1), ToGoodEntity(3));
+    EXPECT_EQ(ledger.GoodAt(2), ToGoodEntity(5));
+    EXPECT_DOUBLE_EQ(ledger[ToGoodEntity(5)], 5);
+
+    const SparseLedger& const_ledger = ledger;
+    EXPECT_DOUBLE_EQ(const_ledger[ToGoodEntity(2)], 0);
+    EXPECT_FALSE(const_ledger.contains(ToGoodEntity(2)));
+    EXPECT_EQ(ledger.size(), 3);
+}
+
+TEST(Core_SparseLedger, MergeMatchesResourceMap) {
+    SparseLedger first;
+    SparseLedger second;
+    ResourceMap first_map;
+    ResourceMap second_map;
+    for (uint32_t good : {0, 2, 4, 6, 9}) {
+        first[ToGoodEntity(good)] = good * 1.5;
+        first_map[ToGoodEntity(good)] = good * 1.5;
+    }
+    for (uint32_t good : {1, 2, 3, 9, 12}) {
+        second[ToGoodEntity(good)] = good + 0.25;
+        second_map[ToGoodEntity(good)] = good + 0.25;
+    }
+
+    SparseLedger sum = first;
+    sum += second;
+    ResourceMap expected = first_map + second_map;
+    EXPECT_TRUE(expected.LedgerEquals(sum));
+
+    SparseLedger difference = first;
+    difference -= second;
+    expected = first_map - second_map;
+    EXPECT_TRUE(expected.LedgerEquals(difference));
+
+    SparseLedger scaled = first;
+    scaled.MultiplyAdd(second, 2);
+    expected = first_map;
+    expected.MultiplyAdd(second_map, 2);
+    EXPECT_TRUE(expected.LedgerEquals(scaled));
+    for (size_t i = 1; i < scaled.size(); i++) {
+        EXPECT_LT(scaled.GoodAt(i - 1), scaled.GoodAt(i));
+    }
+}
+
+TEST(Core_SparseLedger, MergeWithDenseLedger) {
+    SparseLedger consumption;
+    consumption[ToGoodEntity(1)] = 10;
+    consumption[ToGoodEntity(4)] = 3;
+    ResourceLedger price(6);
+    price[ToGoodEntity(1)] = 2;
+    price[ToGoodEntity(4)] = 0.5;
+    price[ToGoodEntity(5)] = 100;
+
+    EXPECT_DOUBLE_EQ(consumption.MultiplyAndGetSum(price), 21.5);
+    EXPECT_DOUBLE_EQ(price.MultiplyAndGetSum(consumption), 21.5);
+    EXPECT_DOUBLE_EQ((Lazy(consumption) * price).GetSum(), 21.5);
+
+    ResourceLedger total(6);
+    total += consumption;
+    total += consumption;
+    total -= consumption * 0.5;
+    EXPECT_DOUBLE_EQ(total[ToGoodEntity(1)], 15);
+    EXPECT_DOUBLE_EQ(total[ToGoodEntity(4)], 4.5);
+    EXPECT_DOUBLE_EQ(total[ToGoodEntity(5)], 0);
+}
+
+TEST(Core_SparseLedger, AssignReusesGoods) {
+    SparseLedger base;
+    base[ToGoodEntity(2)] = 1;
+    base[ToGoodEntity(3)] = 2;
+
+    SparseLedger consumption;
+    consumption = base;
+    consumption *= 100;
+    consumption += Lazy(base) * 0.5;
+    EXPECT_DOUBLE_EQ(consumption[ToGoodEntity(2)], 100.5);
+    EXPECT_DOUBLE_EQ(consumption[ToGoodEntity(3)], 201);
+
+    ResourceMap map = consumption;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_DOUBLE_EQ(map[ToGoodEntity(3)], 201);
+
+    consumption.clear();
+    EXPECT_TRUE(consumption.empty());
+    EXPECT_DOUBLE_EQ(consumption.GetSum(), 0);
+}
@@ -16,14 +16,20 @@
  */
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <numbers>
 #include <random>
+#include <span>
+#include <vector>
 
 #include "core/actions/maneuver/basicmaneuver.h"
 #include "core/actions/maneuver/lambert/izzo.h"
+#include "core/actions/maneuver/lambert/porkchop.h"
 #include "core/actions/maneuver/rendezvous.h"
 #include "core/components/orbit.h"
 #include "core/components/units.h"
 #include "core/util/orbit/randomorbit.h"
+#include "core/util/threadpool.h"
 
 namespace cqsps = cqsp::core::systems;
 namespace cqspt = cqsp::core::components::types;
@@ -61,3 +67,89 @@ TEST(IzzoTest, DISABLED_Lambert) {
         } while (true);
     }
 }
+
+TEST(IzzoTest, BatchMatchesSolver) {
+    std::mt19937 gen(31);
+    std::uniform_real_distribution<> position(-2, 2);
+    std::uniform_real_distribution<> flight_time(0.5, 4);
+    const size_t count = 500;
+    std::vector<glm::dvec3> r1(count);
+    std::vector<glm::dvec3> r2(count);
+    std::vector<double> tof(count);
+    for (size_t i = 0; i < count; i++) {
+        r1[i] = glm::dvec3(position(gen), position(gen), position(gen) / 4);
+        r2[i] = glm::dvec3(position(gen), position(gen), position(gen) / 4);
+        tof[i] = flight_time(gen);
+    }
+
+    std::vector<glm::dvec3> v1(count);
+    std::vector<glm::dvec3> v2(count);
+    cqsps::lambert::SolveBatch(r1, r2, tof, 1, v1, v2);
+
+    cqsp::core::util::ThreadPool pool(4);
+    std::vector<glm::dvec3> pool_v1(count);
+    std::vector<glm::dvec3> pool_v2(count);
+    cqsps::lambert::SolveBatch(r1, r2, tof, 1, pool_v1, pool_v2, &pool);
+
+    for (size_t i = 0; i < count; i++) {
+        cqsps::lambert::Izzo lp(r1[i], r2[i], tof[i], 1, false, 0);
+        lp.solve();
+        EXPECT_EQ(v1[i], lp.get_v1()[0]);
+        EXPECT_EQ(v2[i], lp.get_v2()[0]);
+        EXPECT_EQ(v1[i], pool_v1[i]);
+        EXPECT_EQ(v2[i], pool_v2[i]);
+    }
+}
+
+TEST(IzzoTest, PorkchopFindsHohmann) {
+    cqspt::Orbit inner(1, 0, 0, 0, 0, 0);
+    inner.GM = 1;
+    cqspt::Orbit outer(1.5, 0, 0, 0, 0, 1);
+    outer.GM = 1;
+
+    const double hohmann = std::sqrt(1 / 1.) * (std::sqrt(2 * 1.5 / 2.5) - 1) +
+                           std::sqrt(1 / 1.5) * (1 - std::sqrt(2 * 1. / 2.5));
+    const double hohmann_time = std::numbers::pi * std::sqrt(std::pow(1.25, 3));
+    const double synodic = 1 / (1 / inner.T() - 1 / outer.T());
+
+    std::vector<double> departures(200);
+    for (size_t i = 0; i < departures.size(); i++) {
+        departures[i] = synodic * i / departures.size();
+    }
+    std::vector<double> flight_times(101);
+    for (size_t i = 0; i < flight_times.size(); i++) {
+        flight_times[i] = hohmann_time * (0.7 + 0.6 * i / (flight_times.size() - 1));
+    }
+
+    std::vector<double> delta_v(departures.size() * flight_times.size());
+    cqsp::core::util::ThreadPool pool(4);
+    cqsps::lambert::ComputePorkchop(inner, outer, departures, flight_times, delta_v, &pool);
+    auto best = cqsps::lambert::BestTransfer(departures, flight_times, delta_v);
+
+    // Hohmann is the cheapest two burn transfer between these orbits, so the plot can only get close to it
+    EXPECT_GE(best.delta_v, hohmann * (1 - 1e-6));
+    EXPECT_LT(best.delta_v, hohmann * 1.05);
+    EXPECT_NEAR(best.flight_time, hohmann_time, hohmann_time * 0.1);
+
+    std::vector<double> serial(delta_v.size());
+    cqsps::lambert::ComputePorkchop(inner, outer, departures, flight_times, serial);
+    for (size_t i = 0; i < serial.size(); i++) {
+        if (std::isfinite(serial[i])) {
+            EXPECT_EQ(serial[i], delta_v[i]);
+        }
+    }
+
+    // Buffers that were used for a plot of another size give the same plot
+    cqsps::lambert::PorkchopBuffers buffers;
+    std::vector<double> small(10 * flight_times.size());
+    cqsps::lambert::ComputePorkchop(inner, outer, std::span(departures).first(10), flight_times, small, buffers);
+    std::vector<double> reused(delta_v.size());
+    cqsps::lambert::ComputePorkchop(inner, outer, departures, flight_times, reused, buffers, &pool);
+    for (size_t i = 0; i < reused.size(); i++) {
+        if (std::isfinite(serial[i])) {
+            EXPECT_EQ(reused[i], serial[i]);
+        } else {
+            EXPECT_FALSE(std::isfinite(reused[i]));
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/movement/sysconjunction.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "core/components/bodies.h"
+#include "core/components/coordinates.h"
+#include "core/components/orbit.h"
+#include "core/components/ships.h"
+#include "core/game.h"
+
+namespace components = cqsp::core::components;
+namespace cqspt = cqsp::core::components::types;
+
+class SysConjunctionTest : public ::testing::Test {
+ protected:
+    SysConjunctionTest() : universe(game.GetUniverse()), system(game) {
+        planet = universe.create();
+        universe.emplace<components::bodies::Body>(planet);
+        system.Init();
+    }
+
+    entt::entity MakeShip(const glm::dvec3& position) {
+        entt::entity ship = universe.create();
+        auto& orbit = universe.emplace<cqspt::Orbit>(ship);
+        orbit.reference_body = planet;
+        universe.emplace<cqspt::Kinematics>(ship).position = position;
+        return ship;
+    }
+
+    const cqspt::Conjunctions& Conjunctions() { return universe.ctx().at<cqspt::Conjunctions>(); }
+
+    cqsp::core::Game game;
+    cqsp::core::Universe& universe;
+    cqsp::core::systems::SysConjunction system;
+    entt::entity planet;
+};
+
+TEST_F(SysConjunctionTest, FindsCloseShips) {
+    entt::entity first = MakeShip(glm::dvec3(7000, 0, 0));
+    entt::entity second = MakeShip(glm::dvec3(7001, 0, 0));
+    MakeShip(glm::dvec3(-7000, 0, 0));
+    system.DoSystem();
+
+    ASSERT_EQ(Conjunctions().conjunctions.size(), 1);
+    EXPECT_EQ(Conjunctions().conjunctions[0].object, std::min(first, second));
+    EXPECT_EQ(Conjunctions().conjunctions[0].other, std::max(first, second));
+    EXPECT_DOUBLE_EQ(Conjunctions().conjunctions[0].distance, 1);
+}
+
+// SysOrbit puts crashed ships at the center of the body, so they would all be on top of each other
+TEST_F(SysConjunctionTest, IgnoresCrashedShips) {
+    for (int i = 0; i < 2; i++) {
+        universe.emplace<components::ships::Crash>(MakeShip(glm::dvec3(0)));
+    }
+    MakeShip(glm::dvec3(7000, 0, 0));
+    system.DoSystem();
+    EXPECT_TRUE(Conjunctions().conjunctions.empty());
+
+    system.DoSystem();
+    EXPECT_TRUE(Conjunctions().conjunctions.empty());
+}
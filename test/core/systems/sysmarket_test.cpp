@@ -0,0 +1,163 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/economy/sysmarket.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/components/market.h"
+#include "core/components/markettable.h"
+#include "core/components/resource.h"
+#include "core/game.h"
+
+namespace components = cqsp::core::components;
+using components::Market;
+using components::MarketTable;
+using components::ToGoodEntity;
+
+namespace {
+const size_t good_count = 10;
+
+// The same markets, worked out with or without the market table
+class MarketWorld {
+ public:
+    explicit MarketWorld(bool market_table) : universe(game.GetUniverse()) {
+        universe.economy_config.market_config.market_table = market_table;
+        for (size_t i = 0; i < good_count; i++) {
+            entt::entity good = universe.create();
+            universe.emplace<components::Price>(good, 5.0 + i);
+            universe.goods["good_" + std::to_string(i)] = good;
+            universe.good_map[good] = ToGoodEntity(i);
+            universe.good_vector.push_back(good);
+        }
+        universe.emplace<components::LaborGood>(universe.good_vector.back());
+        for (int i = 0; i < 30; i++) {
+            AddMarket();
+        }
+        system = std::make_unique<cqsp::core::systems::SysMarket>(game);
+        system->Init();
+    }
+
+    void AddMarket() {
+        markets.push_back(universe.create());
+        universe.emplace<Market>(markets.back(), good_count);
+    }
+
+    // Random production and consumption, the same for every world on the same tick
+    void Tick(int tick) {
+        std::mt19937 gen(tick);
+        std::uniform_real_distribution<> dist(0, 10);
+        for (entt::entity entity : markets) {
+            auto& market = universe.get<Market>(entity);
+            for (size_t g = 0; g < good_count; g++) {
+                // Some goods aren't bought at all
+                market.production[ToGoodEntity(g)] = dist(gen);
+                market.consumption[ToGoodEntity(g)] = (g % 4 == 0) ? 0 : dist(gen);
+            }
+        }
+        system->DoSystem();
+    }
+
+    cqsp::core::Game game;
+    cqsp::core::Universe& universe;
+    std::unique_ptr<cqsp::core::systems::SysMarket> system;
+    std::vector<entt::entity> markets;
+};
+
+void ExpectSameLedger(const components::ResourceLedger& expected, const components::ResourceLedger& actual,
+                      const char* name) {
+    for (size_t g = 0; g < good_count; g++) {
+        EXPECT_EQ(expected[ToGoodEntity(g)], actual[ToGoodEntity(g)]) << name << " of good " << g;
+    }
+}
+
+void ExpectSameMarkets(MarketWorld& expected, MarketWorld& actual) {
+    ASSERT_EQ(expected.markets.size(), actual.markets.size());
+    for (size_t i = 0; i < expected.markets.size(); i++) {
+        SCOPED_TRACE(i);
+        const auto& expected_market = expected.universe.get<Market>(expected.markets[i]);
+        const auto& actual_market = actual.universe.get<Market>(actual.markets[i]);
+        ExpectSameLedger(expected_market.price, actual_market.price, "price");
+        ExpectSameLedger(expected_market.sd_ratio, actual_market.sd_ratio, "sd_ratio");
+        ExpectSameLedger(expected_market.chronic_shortages, actual_market.chronic_shortages, "chronic_shortages");
+        EXPECT_EQ(expected_market.last_deficit, actual_market.last_deficit);
+        EXPECT_EQ(expected_market.deficit, actual_market.deficit);
+    }
+}
+
+bool InTable(MarketWorld& world, entt::entity entity) {
+    const auto& table = world.universe.ctx().at<MarketTable>();
+    return table.RowOf(world.universe.get<Market>(entity)) != MarketTable::npos;
+}
+}  // namespace
+
+TEST(SysMarketTest, TableMatchesPerMarket) {
+    MarketWorld per_market(false);
+    MarketWorld table(true);
+    ASSERT_FALSE(per_market.universe.ctx().contains<MarketTable>());
+    ASSERT_TRUE(table.universe.ctx().contains<MarketTable>());
+    for (entt::entity market : table.markets) {
+        ASSERT_TRUE(InTable(table, market));
+    }
+
+    for (int tick = 0; tick < 10; tick++) {
+        per_market.Tick(tick);
+        table.Tick(tick);
+        ExpectSameMarkets(per_market, table);
+    }
+}
+
+TEST(SysMarketTest, NewMarketsGoInTheTable) {
+    MarketWorld per_market(false);
+    MarketWorld table(true);
+    per_market.Tick(0);
+    table.Tick(0);
+
+    for (int i = 0; i < 3; i++) {
+        per_market.AddMarket();
+        table.AddMarket();
+    }
+    for (int tick = 1; tick < 10; tick++) {
+        per_market.Tick(tick);
+        table.Tick(tick);
+        ExpectSameMarkets(per_market, table);
+    }
+    for (entt::entity market : table.markets) {
+        EXPECT_TRUE(InTable(table, market));
+    }
+}
+
+// Once the spare rows are used up, new markets are still worked out, just on their own
+TEST(SysMarketTest, MarketsPastTheTableKeepTheirLedgers) {
+    MarketWorld per_market(false);
+    MarketWorld table(true);
+    const size_t spare = table.universe.ctx().at<MarketTable>().Capacity() - table.markets.size();
+    for (size_t i = 0; i < spare + 5; i++) {
+        per_market.AddMarket();
+        table.AddMarket();
+    }
+    for (int tick = 0; tick < 10; tick++) {
+        per_market.Tick(tick);
+        table.Tick(tick);
+        ExpectSameMarkets(per_market, table);
+    }
+    EXPECT_FALSE(InTable(table, table.markets.back()));
+}
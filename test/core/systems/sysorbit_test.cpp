@@ -18,9 +18,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <memory>
 #include <numbers>
+#include <utility>
+#include <vector>
 
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtx/vector_angle.hpp>
@@ -28,7 +32,9 @@
 #include "core/actions/maneuver/basicmaneuver.h"
 #include "core/actions/maneuver/commands.h"
 #include "core/actions/shiplaunchaction.h"
+#include "core/components/ephemeris.h"
 #include "core/components/ships.h"
+#include "core/components/soiprediction.h"
 #include "core/game.h"
 #include "core/loading/hjsonloader.h"
 #include "core/loading/planetloader.h"
@@ -476,3 +482,310 @@ TEST_F(SysOrbitTest, ManeuverTest) {
 
     SPDLOG_INFO("Final vector difference: {}", glm::to_string(orbital_vector - new_orbital_vector));
 }
+
+// Ships are propagated together, so check them against propagating each of them on its own
+TEST_F(SysOrbitTest, BatchedPropagationTest) {
+    namespace cqspt = cqsp::core::components::types;
+    auto& body_component = universe.get<cqsp::core::components::bodies::Body>(earth);
+    std::vector<entt::entity> ships;
+    for (int i = 0; i < 37; i++) {
+        cqspt::Orbit orbit(body_component.radius + 500. + i * 1000., 0.01 * i, 0.05 * i, 0.1 * i, 0.2 * i, 0.3 * i,
+                           earth);
+        orbit.GM = body_component.GM;
+        ships.push_back(cqsp::core::actions::LaunchShip(universe, orbit));
+    }
+    Tick(100);
+
+    const double time = universe.date.ToSecond();
+    for (entt::entity ship : ships) {
+        ASSERT_FALSE(universe.any_of<cqsp::core::components::ships::Crash>(ship));
+        cqspt::Orbit orbit = universe.get<cqspt::Orbit>(ship);
+        const auto& kinematics = universe.get<cqspt::Kinematics>(ship);
+        const auto& future_position = universe.get<cqspt::FuturePosition>(ship);
+        cqspt::UpdateOrbit(orbit, time);
+
+        EXPECT_LT(glm::length(cqspt::toVec3(orbit) - kinematics.position), 1e-6);
+        EXPECT_LT(glm::length(cqspt::OrbitVelocityToVec3(orbit, orbit.v) - kinematics.velocity), 1e-9);
+        EXPECT_LT(glm::length(cqspt::OrbitTimeToVec3(orbit, time + cqsp::core::components::StarDate::TIME_INCREMENT) -
+                              future_position.position),
+                  1e-6);
+    }
+}
+
+TEST_F(SysOrbitTest, BodiesFollowEphemerisTest) {
+    namespace cqspt = cqsp::core::components::types;
+    ASSERT_TRUE(universe.ctx().contains<cqspt::Ephemeris>());
+    // Long enough to go through a few segments of the moon
+    Tick(1000);
+
+    const double time = universe.date.ToSecond();
+    for (entt::entity body : {earth, moon}) {
+        cqspt::Orbit orbit = universe.get<cqspt::Orbit>(body);
+        const auto& kinematics = universe.get<cqspt::Kinematics>(body);
+        const auto& future_position = universe.get<cqspt::FuturePosition>(body);
+        const double v = universe.get<cqspt::Orbit>(body).v;
+        cqspt::UpdateOrbit(orbit, time);
+
+        EXPECT_NEAR(orbit.v, v, 1e-6);
+        EXPECT_LT(glm::length(cqspt::toVec3(orbit) - kinematics.position), 1e-2);
+        EXPECT_LT(glm::length(cqspt::OrbitVelocityToVec3(orbit, orbit.v) - kinematics.velocity), 1e-8);
+        EXPECT_LT(glm::length(cqspt::OrbitTimeToVec3(orbit, time + cqsp::core::components::StarDate::TIME_INCREMENT) -
+                              future_position.position),
+                  1e-2);
+    }
+}
+
+TEST_F(SysOrbitTest, ParkedShipSkipsSOIChecksTest) {
+    namespace cqspt = cqsp::core::components::types;
+    auto& body_component = universe.get<cqsp::core::components::bodies::Body>(earth);
+    cqspt::Orbit orbit(body_component.radius + 500., 0.01, 0.1, 0.2, 0.3, 0.4, earth);
+    orbit.GM = body_component.GM;
+    entt::entity ship = cqsp::core::actions::LaunchShip(universe, orbit);
+    Tick(1);
+
+    ASSERT_TRUE(universe.all_of<cqspt::SOIPrediction>(ship));
+    EXPECT_TRUE(std::isinf(universe.get<cqspt::SOIPrediction>(ship).next_check));
+
+    // Maneuvering changes the orbit, so the prediction has to be made again
+    cqsp::core::systems::commands::PushManeuver(universe, ship, std::make_pair(glm::dvec3(0, 3, 0), 1.));
+    Tick(2);
+    const auto& prediction = universe.get<cqspt::SOIPrediction>(ship);
+    EXPECT_TRUE(cqspt::SameElements(prediction.orbit, universe.get<cqspt::Orbit>(ship)));
+    EXPECT_TRUE(std::isfinite(prediction.next_check));
+}
+
+TEST_F(SysOrbitTest, ManeuverScheduleTest) {
+    namespace cqspt = cqsp::core::components::types;
+    namespace commands = cqsp::core::systems::commands;
+    auto& body_component = universe.get<cqsp::core::components::bodies::Body>(earth);
+    cqspt::Orbit orbit(body_component.radius + 500., 0.01, 0.1, 0.2, 0.3, 0.4, earth);
+    orbit.GM = body_component.GM;
+    entt::entity ship = cqsp::core::actions::LaunchShip(universe, orbit);
+    Tick(1);
+
+    // Both are 3 ticks from now
+    const auto burn = std::make_pair(glm::dvec3(0, 0.1, 0), 1800.);
+    commands::PushManeuvers(universe, ship, {burn, burn});
+    auto& schedule = commands::GetManeuverSchedule(universe);
+    EXPECT_EQ(schedule.size(), 2);
+    auto& queue = universe.get<cqsp::core::components::CommandQueue>(ship);
+
+    const cqspt::Orbit before = universe.get<cqspt::Orbit>(ship);
+    Tick(2);
+    EXPECT_EQ(queue.maneuvers.size(), 2);
+    EXPECT_TRUE(cqspt::SameElements(before, universe.get<cqspt::Orbit>(ship)));
+
+    // One maneuver per tick
+    Tick(1);
+    EXPECT_EQ(queue.maneuvers.size(), 1);
+    EXPECT_FALSE(cqspt::SameElements(before, universe.get<cqspt::Orbit>(ship)));
+    EXPECT_EQ(schedule.size(), 1);
+
+    Tick(1);
+    EXPECT_TRUE(queue.maneuvers.empty());
+    EXPECT_TRUE(schedule.empty());
+}
+
+TEST_F(SysOrbitTest, BodyCentersTest) {
+    namespace cqspt = cqsp::core::components::types;
+    Tick(10);
+    const auto& earth_kinematics = universe.get<cqspt::Kinematics>(earth);
+    const auto& moon_kinematics = universe.get<cqspt::Kinematics>(moon);
+    const auto& earth_future = universe.get<cqspt::FuturePosition>(earth);
+    const auto& moon_future = universe.get<cqspt::FuturePosition>(moon);
+    EXPECT_EQ(moon_kinematics.center, earth_kinematics.center + earth_kinematics.position);
+    EXPECT_EQ(moon_future.center, earth_future.center + earth_future.position);
+}
+
+TEST_F(SysOrbitTest, ReparentedBodyTest) {
+    namespace cqspt = cqsp::core::components::types;
+    namespace bodies = cqsp::core::components::bodies;
+    const entt::entity sun = universe.sun;
+    Tick(1);
+
+    // Move the moon next to the earth, which only changes the orbital systems and not the number of bodies
+    universe.patch<bodies::OrbitalSystem>(earth,
+                                          [&](bodies::OrbitalSystem& system) { std::erase(system.bodies, moon); });
+    universe.patch<bodies::OrbitalSystem>(sun, [&](bodies::OrbitalSystem& system) { system.bodies.push_back(moon); });
+    cqspt::Orbit orbit = universe.get<cqspt::Orbit>(earth);
+    orbit.v += 0.1;
+    universe.get<cqspt::Orbit>(moon) = orbit;
+    Tick(1);
+
+    // Both go around the sun now, so they have the same center
+    const auto& sun_kinematics = universe.get<cqspt::Kinematics>(sun);
+    const auto& earth_kinematics = universe.get<cqspt::Kinematics>(earth);
+    const auto& moon_kinematics = universe.get<cqspt::Kinematics>(moon);
+    EXPECT_EQ(moon_kinematics.center, sun_kinematics.center + sun_kinematics.position);
+    EXPECT_EQ(moon_kinematics.center, earth_kinematics.center);
+}
+
+TEST_F(SysOrbitTest, ParallelPropagationTest) {
+    namespace cqspt = cqsp::core::components::types;
+    namespace bodies = cqsp::core::components::bodies;
+    auto& body_component = universe.get<bodies::Body>(earth);
+    // Parked ships, ships that crash, and ships that escape, all mixed together
+    std::vector<entt::entity> ships;
+    for (int i = 0; i < 600; i++) {
+        const double e = (i % 3 == 0) ? 0.5 : ((i % 3 == 1) ? 0.001 * (i % 50) : 1.5);
+        const double periapsis = (i % 3 == 0) ? body_component.radius * 0.9 : body_component.radius + 300 + i;
+        const double a = periapsis / (1 - e);
+        cqspt::Orbit orbit(a, e, 0.01 * (i % 100), 0.1 * (i % 60), 0.2 * (i % 30), 0.05 * i, earth);
+        orbit.GM = body_component.GM;
+        ships.push_back(cqsp::core::actions::LaunchShip(universe, orbit));
+    }
+    Tick(500);
+
+    const double time = universe.date.ToSecond();
+    for (size_t i = 0; i < ships.size(); i++) {
+        const entt::entity ship = ships[i];
+        if (i % 3 == 0) {
+            EXPECT_TRUE(universe.any_of<cqsp::core::components::ships::Crash>(ship));
+            continue;
+        }
+        ASSERT_FALSE(universe.any_of<cqsp::core::components::ships::Crash>(ship));
+        cqspt::Orbit orbit = universe.get<cqspt::Orbit>(ship);
+        // Every ship is in the children of the body that it orbits, and only that one
+        for (auto&& [entity, system] : universe.view<bodies::OrbitalSystem>().each()) {
+            EXPECT_EQ(std::count(system.children.begin(), system.children.end(), ship),
+                      (entity == orbit.reference_body) ? 1 : 0);
+        }
+        const auto& kinematics = universe.get<cqspt::Kinematics>(ship);
+        cqspt::UpdateOrbit(orbit, time);
+        EXPECT_LT(glm::length(cqspt::toVec3(orbit) - kinematics.position), 1e-6);
+    }
+}
+
+namespace {
+// The test planets with ships around them, moved by a SysOrbit of their own
+class PropagationWorld {
+ public:
+    PropagationWorld(const Hjson::Value& planets, size_t thread_count, bool parallel)
+        : universe(game.GetUniverse()), system(game) {
+        namespace cqspt = cqsp::core::components::types;
+        namespace bodies = cqsp::core::components::bodies;
+        game.SetThreadCount(thread_count);
+        cqsp::core::loading::PlanetLoader loader(universe);
+        loader.LoadHjson(planets);
+        system.SetParallel(parallel);
+        system.Init();
+
+        const entt::entity earth = universe.planets["earth"];
+        const auto& body_component = universe.get<bodies::Body>(earth);
+        const double moon_distance = 384400;
+        for (int i = 0; i < 800; i++) {
+            double periapsis = body_component.radius + 300 + i;
+            double e;
+            switch (i % 4) {
+                case 0:
+                    // Crashes
+                    periapsis = body_component.radius * 0.9;
+                    e = 0.5;
+                    break;
+                case 1:
+                    e = 0.001 * (i % 50);
+                    break;
+                case 2:
+                    // Escapes
+                    e = 1.5;
+                    break;
+                default:
+                    // Goes out to the moon, some of them run into it
+                    e = (moon_distance - periapsis) / (moon_distance + periapsis);
+            }
+            cqspt::Orbit orbit(periapsis / (1 - e), e, 0.01 * (i % 100), 0.1 * (i % 60), 0.2 * (i % 30), 0.05 * i,
+                               earth);
+            orbit.GM = body_component.GM;
+            ships.push_back(cqsp::core::actions::LaunchShip(universe, orbit));
+        }
+    }
+
+    void Tick() {
+        universe.date.IncrementDate();
+        system.DoSystem();
+    }
+
+    cqsp::core::Game game;
+    cqsp::core::Universe& universe;
+    cqsp::core::systems::SysOrbit system;
+    std::vector<entt::entity> ships;
+};
+
+testing::AssertionResult SameShip(PropagationWorld& expected, PropagationWorld& actual, size_t index) {
+    namespace cqspt = cqsp::core::components::types;
+    using cqsp::core::components::ships::Crash;
+    const entt::entity ship = expected.ships[index];
+    if (expected.universe.any_of<Crash>(ship) != actual.universe.any_of<Crash>(ship)) {
+        return testing::AssertionFailure() << "ship " << index << " only crashed in one of them";
+    }
+    if (expected.universe.any_of<Crash>(ship)) {
+        return testing::AssertionSuccess();
+    }
+    const auto& expected_orbit = expected.universe.get<cqspt::Orbit>(ship);
+    const auto& actual_orbit = actual.universe.get<cqspt::Orbit>(ship);
+    if (expected_orbit.reference_body != actual_orbit.reference_body) {
+        return testing::AssertionFailure() << "ship " << index << " is in a different SOI";
+    }
+    if (!cqspt::SameElements(expected_orbit, actual_orbit) || expected_orbit.v != actual_orbit.v) {
+        return testing::AssertionFailure() << "ship " << index << " has a different orbit";
+    }
+    const auto& expected_kinematics = expected.universe.get<cqspt::Kinematics>(ship);
+    const auto& actual_kinematics = actual.universe.get<cqspt::Kinematics>(ship);
+    if (expected_kinematics.position != actual_kinematics.position ||
+        expected_kinematics.velocity != actual_kinematics.velocity ||
+        expected_kinematics.center != actual_kinematics.center) {
+        return testing::AssertionFailure() << "ship " << index << " is at "
+                                           << glm::to_string(actual_kinematics.position) << " instead of "
+                                           << glm::to_string(expected_kinematics.position);
+    }
+    const auto* expected_prediction = expected.universe.try_get<cqspt::SOIPrediction>(ship);
+    const auto* actual_prediction = actual.universe.try_get<cqspt::SOIPrediction>(ship);
+    if ((expected_prediction == nullptr) != (actual_prediction == nullptr)) {
+        return testing::AssertionFailure() << "ship " << index << " only has an SOI prediction in one of them";
+    }
+    if (expected_prediction == nullptr) {
+        return testing::AssertionSuccess();
+    }
+    if (expected_prediction->next_check != actual_prediction->next_check ||
+        !cqspt::SameElements(expected_prediction->orbit, actual_prediction->orbit)) {
+        return testing::AssertionFailure() << "ship " << index << " has a different SOI prediction";
+    }
+    return testing::AssertionSuccess();
+}
+}  // namespace
+
+// The ships have to end up in the same place no matter how many threads move them
+TEST_F(SysOrbitTest, ParallelPropagationMatchesSerial) {
+    PropagationWorld serial(planets_hjson, 1, false);
+    std::vector<std::unique_ptr<PropagationWorld>> worlds;
+    for (size_t thread_count : {1, 2, 0}) {
+        worlds.push_back(std::make_unique<PropagationWorld>(planets_hjson, thread_count, true));
+    }
+
+    std::vector<entt::entity> reference_bodies;
+    for (entt::entity ship : serial.ships) {
+        reference_bodies.push_back(serial.universe.get<cqsp::core::components::types::Orbit>(ship).reference_body);
+    }
+    int transitions = 0;
+    for (int tick = 0; tick < 2000; tick++) {
+        serial.Tick();
+        for (auto& world : worlds) {
+            world->Tick();
+        }
+        for (size_t i = 0; i < serial.ships.size(); i++) {
+            for (size_t w = 0; w < worlds.size(); w++) {
+                ASSERT_TRUE(SameShip(serial, *worlds[w], i)) << "on tick " << tick << " with pool " << w;
+            }
+            if (serial.universe.any_of<cqsp::core::components::ships::Crash>(serial.ships[i])) {
+                continue;
+            }
+            const auto& orbit = serial.universe.get<cqsp::core::components::types::Orbit>(serial.ships[i]);
+            if (orbit.reference_body != reference_bodies[i]) {
+                reference_bodies[i] = orbit.reference_body;
+                transitions++;
+            }
+        }
+    }
+    // Otherwise the SOI changes weren't tested
+    EXPECT_GT(transitions, 0);
+}
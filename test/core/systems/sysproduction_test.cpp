@@ -0,0 +1,153 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/economy/sysproduction.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/actions/factoryconstructaction.h"
+#include "core/components/area.h"
+#include "core/components/infrastructure.h"
+#include "core/components/labor.h"
+#include "core/components/market.h"
+#include "core/components/organizations.h"
+#include "core/components/resource.h"
+#include "core/components/surface.h"
+#include "core/game.h"
+
+namespace components = cqsp::core::components;
+using components::ToGoodEntity;
+using cqsp::core::Node;
+
+namespace {
+const size_t good_count = 8;
+const size_t labor_count = 2;
+
+// Countries with settlements full of factories, always built the same way so that two games end up with the
+// same entities
+class ProductionWorld {
+ public:
+    explicit ProductionWorld(size_t thread_count) : game(std::make_unique<cqsp::core::Game>()) {
+        game->SetThreadCount(thread_count);
+        auto& universe = game->GetUniverse();
+        std::mt19937 gen(11);
+        std::uniform_real_distribution<> dist(0.5, 2);
+
+        std::vector<entt::entity> labor;
+        for (size_t i = 0; i < labor_count; i++) {
+            labor.push_back(universe.create());
+            universe.emplace<components::Labor>(labor.back(), ToGoodEntity(good_count - labor_count + i));
+        }
+
+        std::vector<Node> recipes;
+        for (uint32_t g = 0; g < good_count - labor_count; g++) {
+            Node recipe(universe);
+            auto& comp = recipe.emplace<components::Recipe>();
+            comp.type = components::ProductionType::factory;
+            comp.output = {ToGoodEntity(g), dist(gen)};
+            comp.input.emplace_back(ToGoodEntity((g + 1) % (good_count - labor_count)), dist(gen));
+            comp.input.emplace_back(ToGoodEntity((g + 2) % (good_count - labor_count)), dist(gen));
+            comp.capitalcost.emplace_back(ToGoodEntity((g + 2) % (good_count - labor_count)), dist(gen) * 0.01);
+            comp.workers.workers.emplace_back(labor[g % labor_count], 10);
+            recipes.push_back(recipe);
+        }
+
+        for (int c = 0; c < 3; c++) {
+            countries.push_back(universe.create());
+            universe.emplace<components::OrganizationIncome>(countries.back(), 0., 0.);
+        }
+
+        for (int s = 0; s < 40; s++) {
+            Node city(universe);
+            auto& market = city.emplace<components::Market>(good_count);
+            for (uint32_t g = 0; g < good_count; g++) {
+                market.price[ToGoodEntity(g)] = dist(gen);
+                market.taxation[ToGoodEntity(g)] = dist(gen) * 0.05;
+            }
+            city.emplace<components::Settlement>().population.push_back(universe.create());
+            city.emplace<components::infrastructure::CityInfrastructure>(100., 0.);
+            city.emplace<components::infrastructure::ConstructionSector>(10u, 0u, 1.);
+            city.emplace<components::Province>().country = countries[s % countries.size()];
+            city.emplace<components::IndustrialZone>();
+            for (int f = 0; f < 5; f++) {
+                Node factory = cqsp::core::actions::CreateFactory(city, recipes[(s + f) % recipes.size()],
+                                                                  static_cast<int>(dist(gen) * 100), 0, 1000);
+                industries.push_back(factory);
+            }
+            markets.push_back(city);
+        }
+    }
+
+    std::unique_ptr<cqsp::core::Game> game;
+    std::vector<entt::entity> countries;
+    std::vector<entt::entity> markets;
+    std::vector<entt::entity> industries;
+};
+
+void RunProduction(ProductionWorld& world, bool parallel) {
+    cqsp::core::systems::SysProduction system(*world.game);
+    system.SetParallel(parallel);
+    for (int tick = 0; tick < 20; tick++) {
+        system.DoSystem();
+    }
+}
+
+void ExpectSameLedger(const components::ResourceLedger& serial, const components::ResourceLedger& parallel) {
+    for (uint32_t g = 0; g < good_count; g++) {
+        EXPECT_EQ(serial[ToGoodEntity(g)], parallel[ToGoodEntity(g)]) << "good " << g;
+    }
+}
+}  // namespace
+
+TEST(SysProductionTest, ParallelMatchesSerial) {
+    ProductionWorld serial(1);
+    RunProduction(serial, false);
+    // Make sure that there is something to compare
+    ASSERT_NE(serial.game->GetUniverse().get<components::OrganizationIncome>(serial.countries[0]).income_taxes, 0);
+
+    for (size_t thread_count : {1, 2, 3, 0}) {
+        SCOPED_TRACE(thread_count);
+        ProductionWorld parallel(thread_count);
+        RunProduction(parallel, true);
+        auto& serial_universe = serial.game->GetUniverse();
+        auto& parallel_universe = parallel.game->GetUniverse();
+
+        for (size_t i = 0; i < serial.markets.size(); i++) {
+            auto& serial_market = serial_universe.get<components::Market>(serial.markets[i]);
+            auto& parallel_market = parallel_universe.get<components::Market>(parallel.markets[i]);
+            EXPECT_EQ(serial_market.GDP, parallel_market.GDP);
+            ExpectSameLedger(serial_market.consumption, parallel_market.consumption);
+            ExpectSameLedger(serial_market.production, parallel_market.production);
+            ExpectSameLedger(serial_market.chronic_shortages, parallel_market.chronic_shortages);
+        }
+        for (size_t i = 0; i < serial.industries.size(); i++) {
+            auto& serial_wallet = serial_universe.get<components::Wallet>(serial.industries[i]);
+            auto& parallel_wallet = parallel_universe.get<components::Wallet>(parallel.industries[i]);
+            EXPECT_EQ(serial_wallet.GetBalance(), parallel_wallet.GetBalance());
+            EXPECT_EQ(serial_wallet.GetChange(), parallel_wallet.GetChange());
+            EXPECT_EQ(serial_universe.get<components::ProductionUnit>(serial.industries[i]).utilization,
+                      parallel_universe.get<components::ProductionUnit>(parallel.industries[i]).utilization);
+        }
+        for (size_t i = 0; i < serial.countries.size(); i++) {
+            EXPECT_EQ(serial_universe.get<components::OrganizationIncome>(serial.countries[i]).income_taxes,
+                      parallel_universe.get<components::OrganizationIncome>(parallel.countries[i]).income_taxes);
+        }
+    }
+}
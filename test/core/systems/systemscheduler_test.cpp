@@ -0,0 +1,208 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/systemscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "core/game.h"
+#include "core/systems/systemaccess.h"
+
+namespace {
+using cqsp::core::Game;
+using cqsp::core::systems::ISimulationSystem;
+using cqsp::core::systems::SystemAccess;
+using cqsp::core::systems::SystemScheduler;
+
+struct Counter {
+    int value = 0;
+};
+
+struct Doubled {
+    int value = 0;
+};
+
+struct Unrelated {
+    int value = 0;
+};
+
+class SetCounter : public ISimulationSystem {
+ public:
+    explicit SetCounter(Game& game) : ISimulationSystem(game) {}
+    void DoSystem() override {
+        for (auto&& [entity, counter] : GetUniverse().view<Counter>().each()) {
+            counter.value = 1;
+        }
+    }
+    void DeclareAccess(SystemAccess& access) override { access.Write<Counter>(); }
+};
+
+class DoubleCounter : public ISimulationSystem {
+ public:
+    explicit DoubleCounter(Game& game) : ISimulationSystem(game) {}
+    void DoSystem() override {
+        for (auto&& [entity, counter, doubled] : GetUniverse().view<Counter, Doubled>().each()) {
+            doubled.value = counter.value * 2;
+        }
+    }
+    void DeclareAccess(SystemAccess& access) override { access.Read<Counter>().Write<Doubled>(); }
+};
+
+class AddCounter : public ISimulationSystem {
+ public:
+    explicit AddCounter(Game& game) : ISimulationSystem(game) {}
+    void DoSystem() override {
+        for (auto&& [entity, counter] : GetUniverse().view<Counter>().each()) {
+            counter.value += 10;
+        }
+    }
+    void DeclareAccess(SystemAccess& access) override { access.Write<Counter>(); }
+};
+
+class IncrementUnrelated : public ISimulationSystem {
+ public:
+    explicit IncrementUnrelated(Game& game) : ISimulationSystem(game) {}
+    void DoSystem() override {
+        for (auto&& [entity, unrelated] : GetUniverse().view<Unrelated>().each()) {
+            unrelated.value++;
+        }
+    }
+    void DeclareAccess(SystemAccess& access) override { access.Write<Unrelated>(); }
+};
+
+// Doesn't declare anything, so it has to see everything before it done
+class CheckDoubled : public ISimulationSystem {
+ public:
+    explicit CheckDoubled(Game& game) : ISimulationSystem(game) {}
+    void DoSystem() override {
+        for (auto&& [entity, counter, doubled] : GetUniverse().view<Counter, Doubled>().each()) {
+            if (counter.value != 11 || doubled.value != 2) {
+                failures++;
+            }
+        }
+    }
+    int failures = 0;
+};
+
+class ThrowingSystem : public ISimulationSystem {
+ public:
+    explicit ThrowingSystem(Game& game) : ISimulationSystem(game) {}
+    void DoSystem() override { throw std::runtime_error("System failed"); }
+    void DeclareAccess(SystemAccess& access) override { access.Write<Unrelated>(); }
+};
+}  // namespace
+
+TEST(Core_SystemAccess, Conflicts) {
+    Game game;
+    SystemAccess reader(game.GetUniverse());
+    reader.Read<Counter>();
+    SystemAccess other_reader(game.GetUniverse());
+    other_reader.Read<Counter, Doubled>();
+    SystemAccess writer(game.GetUniverse());
+    writer.Write<Counter>();
+    SystemAccess unrelated(game.GetUniverse());
+    unrelated.Write<Unrelated>();
+    SystemAccess undeclared(game.GetUniverse());
+
+    EXPECT_FALSE(reader.ConflictsWith(other_reader));
+    EXPECT_TRUE(reader.ConflictsWith(writer));
+    EXPECT_TRUE(writer.ConflictsWith(reader));
+    EXPECT_FALSE(writer.ConflictsWith(unrelated));
+    EXPECT_TRUE(undeclared.IsExclusive());
+    EXPECT_TRUE(undeclared.ConflictsWith(unrelated));
+}
+
+TEST(Core_SystemAccess, EntitiesConflictWithStructure) {
+    Game game;
+    SystemAccess creator(game.GetUniverse());
+    creator.Entities();
+    SystemAccess structure(game.GetUniverse());
+    structure.Structure<Unrelated>();
+    SystemAccess writer(game.GetUniverse());
+    writer.Write<Counter>();
+
+    EXPECT_TRUE(creator.ConflictsWith(structure));
+    EXPECT_TRUE(structure.ConflictsWith(creator));
+    EXPECT_FALSE(creator.ConflictsWith(writer));
+}
+
+TEST(Core_SystemScheduler, MatchesSerialOrder) {
+    Game game;
+    game.SetThreadCount(4);
+    auto& universe = game.GetUniverse();
+    for (int i = 0; i < 1000; i++) {
+        entt::entity entity = universe.create();
+        universe.emplace<Counter>(entity);
+        universe.emplace<Doubled>(entity);
+        universe.emplace<Unrelated>(entity);
+    }
+
+    std::vector<std::unique_ptr<ISimulationSystem>> systems;
+    systems.push_back(std::make_unique<SetCounter>(game));
+    systems.push_back(std::make_unique<IncrementUnrelated>(game));
+    systems.push_back(std::make_unique<DoubleCounter>(game));
+    systems.push_back(std::make_unique<AddCounter>(game));
+    systems.push_back(std::make_unique<CheckDoubled>(game));
+    auto* check = static_cast<CheckDoubled*>(systems.back().get());
+
+    SystemScheduler scheduler;
+    scheduler.Build(systems, universe);
+    std::vector<bool> to_run(systems.size(), true);
+    for (int i = 0; i < 100; i++) {
+        scheduler.Run(to_run, &game.GetThreadPool());
+    }
+    EXPECT_EQ(check->failures, 0);
+    for (auto&& [entity, unrelated] : universe.view<Unrelated>().each()) {
+        EXPECT_EQ(unrelated.value, 100);
+    }
+}
+
+TEST(Core_SystemScheduler, SkipsSystems) {
+    Game game;
+    game.SetThreadCount(4);
+    auto& universe = game.GetUniverse();
+    entt::entity entity = universe.create();
+    universe.emplace<Counter>(entity);
+    universe.emplace<Doubled>(entity);
+
+    std::vector<std::unique_ptr<ISimulationSystem>> systems;
+    systems.push_back(std::make_unique<SetCounter>(game));
+    systems.push_back(std::make_unique<AddCounter>(game));
+    systems.push_back(std::make_unique<DoubleCounter>(game));
+
+    SystemScheduler scheduler;
+    scheduler.Build(systems, universe);
+    scheduler.Run({true, false, true}, &game.GetThreadPool());
+    EXPECT_EQ(universe.get<Counter>(entity).value, 1);
+    EXPECT_EQ(universe.get<Doubled>(entity).value, 2);
+}
+
+TEST(Core_SystemScheduler, RethrowsExceptions) {
+    Game game;
+    game.SetThreadCount(2);
+    std::vector<std::unique_ptr<ISimulationSystem>> systems;
+    systems.push_back(std::make_unique<SetCounter>(game));
+    systems.push_back(std::make_unique<ThrowingSystem>(game));
+
+    SystemScheduler scheduler;
+    scheduler.Build(systems, game.GetUniverse());
+    std::vector<bool> to_run(systems.size(), true);
+    EXPECT_THROW(scheduler.Run(to_run, &game.GetThreadPool()), std::runtime_error);
+}
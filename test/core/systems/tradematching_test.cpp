@@ -0,0 +1,98 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/systems/economy/tradematching.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using cqsp::core::components::GoodEntity;
+using cqsp::core::components::Market;
+using cqsp::core::components::PlanetaryMarket;
+using cqsp::core::components::ToGoodEntity;
+using cqsp::core::systems::MatchArbitrage;
+using cqsp::core::systems::TradingMarket;
+
+namespace {
+// (seller, buyer, good)
+using Match = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+// What SysInterplanetaryTrade::ResolveTrades used to do, every seller against every buyer for every good
+std::vector<Match> MatchEveryPair(const std::vector<TradingMarket>& markets, size_t good_count) {
+    std::vector<Match> matches;
+    for (uint32_t seller = 0; seller < markets.size(); seller++) {
+        for (uint32_t buyer = 0; buyer < markets.size(); buyer++) {
+            if (seller == buyer) {
+                continue;
+            }
+            for (uint32_t g = 0; g < good_count; g++) {
+                GoodEntity good = ToGoodEntity(g);
+                if (markets[buyer].planetary_market->supply_difference[good] <= 0) {
+                    continue;
+                }
+                if (markets[buyer].market->price[good] > markets[seller].market->price[good] &&
+                    markets[seller].market->chronic_shortages[good] <= 0) {
+                    matches.emplace_back(seller, buyer, g);
+                }
+            }
+        }
+    }
+    return matches;
+}
+}  // namespace
+
+TEST(Core_TradeMatching, SameOrdersAsEveryPair) {
+    const size_t good_count = 12;
+    const size_t market_count = 40;
+    std::mt19937 gen(7);
+    // Few distinct prices, so that there are plenty of ties
+    std::uniform_int_distribution<> price_dist(1, 6);
+    std::uniform_real_distribution<> real_dist(-1, 1);
+
+    std::deque<Market> markets;
+    std::deque<PlanetaryMarket> planetary_markets;
+    std::vector<TradingMarket> trading;
+    for (size_t i = 0; i < market_count; i++) {
+        Market& market = markets.emplace_back(good_count);
+        PlanetaryMarket& planetary = planetary_markets.emplace_back(good_count);
+        for (uint32_t g = 0; g < good_count; g++) {
+            market.price[ToGoodEntity(g)] = price_dist(gen);
+            market.chronic_shortages[ToGoodEntity(g)] = std::max(real_dist(gen), 0.);
+            planetary.supply_difference[ToGoodEntity(g)] = real_dist(gen);
+        }
+        trading.push_back({static_cast<entt::entity>(i), &market, &planetary});
+    }
+
+    std::vector<Match> indexed;
+    MatchArbitrage(trading, good_count, std::pmr::get_default_resource(),
+                   [&](uint32_t seller, uint32_t buyer, GoodEntity good) {
+                       indexed.emplace_back(seller, buyer, static_cast<uint32_t>(good));
+                   });
+    std::vector<Match> expected = MatchEveryPair(trading, good_count);
+    ASSERT_FALSE(expected.empty());
+
+    // The order only has to be the same for each seller and good, which is what a stable sort by those keeps
+    auto by_seller_and_good = [](const Match& first, const Match& second) {
+        return std::tie(std::get<0>(first), std::get<2>(first)) < std::tie(std::get<0>(second), std::get<2>(second));
+    };
+    std::ranges::stable_sort(indexed, by_seller_and_good);
+    std::ranges::stable_sort(expected, by_seller_and_good);
+    EXPECT_EQ(indexed, expected);
+}
@@ -0,0 +1,60 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/autosave.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#include "core/components/market.h"
+#include "core/components/name.h"
+#include "core/util/save/save.h"
+#include "core/util/save/snapshot.h"
+
+namespace components = cqsp::core::components;
+namespace save = cqsp::core::save;
+using cqsp::core::Universe;
+
+TEST(AutosaveTest, SavesEveryInterval) {
+    const std::string folder = (std::filesystem::temp_directory_path() / "cqsp_autosave_test").string();
+    std::filesystem::remove_all(folder);
+
+    Universe universe;
+    entt::entity market = universe.create();
+    universe.emplace<components::Identifier>(market, "market");
+    universe.emplace<components::Market>(market, 0);
+
+    cqsp::core::util::ThreadPool pool(2);
+    save::Autosave autosave(pool, folder, 3);
+    EXPECT_FALSE(autosave.Tick(universe));
+    EXPECT_FALSE(autosave.Tick(universe));
+    EXPECT_TRUE(autosave.Tick(universe));
+    EXPECT_GE(autosave.GetLastStall(), 0);
+
+    // The universe can change while the save is being written
+    universe.create();
+    autosave.Wait();
+    EXPECT_FALSE(autosave.IsWriting());
+
+    Universe loaded;
+    ASSERT_TRUE(save::LoadSnapshot(loaded, save::GetSnapshotPath(folder)));
+    EXPECT_EQ(loaded.alive(), 1);
+    EXPECT_TRUE(loaded.all_of<components::Market>(market));
+    EXPECT_TRUE(std::filesystem::exists(save::GetMetaPath(folder)));
+    std::filesystem::remove_all(folder);
+}
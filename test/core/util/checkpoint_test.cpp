@@ -0,0 +1,158 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/components/market.h"
+#include "core/components/name.h"
+
+namespace components = cqsp::core::components;
+namespace save = cqsp::core::save;
+using cqsp::core::Universe;
+
+namespace {
+class CheckpointTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        folder = (std::filesystem::temp_directory_path() / "cqsp_checkpoint_test").string();
+        std::filesystem::remove_all(folder);
+        universe.date.SetDate(0);
+        // Lots of things that never change, and markets that do
+        for (int i = 0; i < 1000; i++) {
+            universe.emplace<components::Identifier>(universe.create(), "static_name_" + std::to_string(i));
+        }
+        for (int i = 0; i < 200; i++) {
+            markets.push_back(universe.create());
+            universe.emplace<components::Market>(markets.back(), 100).GDP = 1;
+        }
+        market = markets.front();
+    }
+
+    void TearDown() override { std::filesystem::remove_all(folder); }
+
+    size_t FileCount() const {
+        return std::distance(std::filesystem::directory_iterator(folder), std::filesystem::directory_iterator {});
+    }
+
+    std::string folder;
+    Universe universe;
+    std::vector<entt::entity> markets;
+    entt::entity market;
+    cqsp::core::util::ThreadPool pool {2};
+};
+}  // namespace
+
+TEST_F(CheckpointTest, OnlyWritesWhatChanged) {
+    save::CheckpointWriter writer(universe, pool, folder);
+    const size_t base = writer.Checkpoint();
+    EXPECT_EQ(writer.GetChangedRecords(), 1200);
+
+    // Nothing changed
+    EXPECT_LT(writer.Checkpoint(), 1024);
+    EXPECT_EQ(writer.GetChangedRecords(), 0);
+
+    // One market changed in place, and the date, which costs that market and not the rest of the pool
+    universe.get<components::Market>(market).GDP = 2;
+    universe.date.IncrementDate();
+    EXPECT_LT(writer.Checkpoint(), base / 100);
+    EXPECT_EQ(writer.GetChangedRecords(), 1);
+
+    // Emplaced, and then removed
+    universe.emplace<components::Wallet>(market);
+    writer.Checkpoint();
+    EXPECT_EQ(writer.GetChangedRecords(), 1);
+    universe.remove<components::Wallet>(market);
+    writer.Checkpoint();
+    EXPECT_EQ(writer.GetChangedRecords(), 1);
+
+    // Patched to the same bytes, which only the signals see
+    universe.patch<components::Market>(markets[1]);
+    writer.Checkpoint();
+    EXPECT_EQ(writer.GetChangedRecords(), 1);
+
+    Universe loaded;
+    ASSERT_TRUE(save::LoadCheckpoints(loaded, folder));
+    EXPECT_EQ(loaded.alive(), universe.alive());
+    EXPECT_EQ(loaded.get<components::Market>(market).GDP, 2);
+    EXPECT_EQ(loaded.get<components::Market>(markets[1]).GDP, 1);
+    EXPECT_FALSE(loaded.all_of<components::Wallet>(market));
+    EXPECT_EQ(loaded.date.GetDate(), 1);
+}
+
+TEST_F(CheckpointTest, MakesAndDestroysEntities) {
+    save::CheckpointWriter writer(universe, pool, folder);
+    writer.Checkpoint();
+
+    entt::entity ship = universe.create();
+    universe.emplace<components::Identifier>(ship, "new_ship");
+    universe.emplace<components::Wallet>(ship);
+    universe.destroy(markets[2]);
+    writer.Checkpoint();
+    EXPECT_EQ(writer.GetChangedRecords(), 2);
+
+    Universe loaded;
+    ASSERT_TRUE(save::LoadCheckpoints(loaded, folder));
+    EXPECT_EQ(loaded.alive(), universe.alive());
+    EXPECT_FALSE(loaded.valid(markets[2]));
+    ASSERT_TRUE(loaded.valid(ship));
+    EXPECT_EQ(loaded.get<components::Identifier>(ship).identifier, "new_ship");
+    EXPECT_TRUE(loaded.all_of<components::Wallet>(ship));
+}
+
+TEST_F(CheckpointTest, CompactsIntoOne) {
+    save::CheckpointWriter writer(universe, pool, folder);
+    for (int i = 0; i < 5; i++) {
+        universe.get<components::Market>(market).GDP = i;
+        writer.Checkpoint();
+    }
+    EXPECT_EQ(FileCount(), 5);
+    ASSERT_TRUE(save::CompactCheckpoints(folder));
+    EXPECT_EQ(FileCount(), 1);
+
+    // The writer keeps going on top of the compacted checkpoint
+    universe.get<components::Market>(market).GDP = 10;
+    writer.Checkpoint();
+    EXPECT_EQ(writer.GetChangedRecords(), 1);
+
+    Universe loaded;
+    ASSERT_TRUE(save::LoadCheckpoints(loaded, folder));
+    EXPECT_EQ(loaded.alive(), universe.alive());
+    EXPECT_EQ(loaded.get<components::Market>(market).GDP, 10);
+    EXPECT_EQ(loaded.get<components::Identifier>(entt::entity {0}).identifier, "static_name_0");
+}
+
+TEST_F(CheckpointTest, NeedsAFullCheckpoint) {
+    {
+        save::CheckpointWriter writer(universe, pool, folder);
+        writer.Checkpoint();
+        writer.Checkpoint();
+    }
+    std::filesystem::remove(std::filesystem::path(folder) / "00000000.checkpoint");
+    Universe loaded;
+    EXPECT_FALSE(save::LoadCheckpoints(loaded, folder));
+
+    // A new writer starts a new chain with a full checkpoint
+    save::CheckpointWriter writer(universe, pool, folder);
+    writer.Checkpoint();
+    EXPECT_EQ(writer.GetChangedRecords(), 1200);
+    EXPECT_TRUE(save::LoadCheckpoints(loaded, folder));
+}
@@ -0,0 +1,91 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/random/counterrandom.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "core/util/random/philox.h"
+
+using cqsp::core::util::CounterRandom;
+using cqsp::core::util::Philox4x32;
+
+// Known answers from the Random123 reference implementation
+TEST(Core_Philox, KnownAnswers) {
+    EXPECT_EQ(Philox4x32::Generate({0, 0, 0, 0}, {0, 0}),
+              (Philox4x32::Counter {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(Philox4x32::Generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+              (Philox4x32::Counter {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(Philox4x32::Generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+              (Philox4x32::Counter {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(Core_CounterRandom, SameKeySameNumbers) {
+    CounterRandom first(42, 10, 1000, 1);
+    std::vector<double> expected;
+    for (int i = 0; i < 100; i++) {
+        expected.push_back(first.GetRandomNormal(0, 1));
+    }
+
+    // Drawing from other keys in between must not change anything
+    CounterRandom other(42, 11, 1000, 1);
+    CounterRandom second(42, 10, 1000, 1);
+    for (int i = 0; i < 100; i++) {
+        other.GetRandomNormal(0, 1);
+        EXPECT_EQ(second.GetRandomNormal(0, 1), expected[i]);
+    }
+}
+
+TEST(Core_CounterRandom, KeysAreIndependent) {
+    double base = CounterRandom(42, 10, 1000, 1).GetRandomUniform();
+    EXPECT_NE(base, CounterRandom(43, 10, 1000, 1).GetRandomUniform());
+    EXPECT_NE(base, CounterRandom(42, 11, 1000, 1).GetRandomUniform());
+    EXPECT_NE(base, CounterRandom(42, 10, 1001, 1).GetRandomUniform());
+    EXPECT_NE(base, CounterRandom(42, 10, 1000, 2).GetRandomUniform());
+    EXPECT_NE(base, CounterRandom(42, 10, 1000ull + (1ull << 32), 1).GetRandomUniform());
+}
+
+TEST(Core_CounterRandom, Distributions) {
+    CounterRandom random(42, 0, 0, 0);
+    const int count = 100000;
+    double sum = 0;
+    double square_sum = 0;
+    std::vector<int> buckets(6, 0);
+    for (int i = 0; i < count; i++) {
+        double value = random.GetRandomNormal(5, 2);
+        sum += value;
+        square_sum += value * value;
+
+        int bucket = random.GetRandomInt(1, 6);
+        ASSERT_GE(bucket, 1);
+        ASSERT_LE(bucket, 6);
+        buckets[bucket - 1]++;
+
+        double uniform = random.GetRandomUniform();
+        ASSERT_GE(uniform, 0.);
+        ASSERT_LT(uniform, 1.);
+    }
+    double mean = sum / count;
+    double sd = std::sqrt(square_sum / count - mean * mean);
+    EXPECT_NEAR(mean, 5, 0.05);
+    EXPECT_NEAR(sd, 2, 0.05);
+    for (int bucket : buckets) {
+        EXPECT_NEAR(bucket, count / 6, count / 100);
+    }
+}
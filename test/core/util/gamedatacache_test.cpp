@@ -0,0 +1,129 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/gamedatacache.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "core/components/name.h"
+#include "core/components/resourceledger.h"
+#include "core/loading/loadgoods.h"
+#include "core/util/hash.h"
+
+namespace components = cqsp::core::components;
+namespace save = cqsp::core::save;
+namespace util = cqsp::core::util;
+using cqsp::core::Universe;
+
+namespace {
+class GameDataCacheTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        path = (std::filesystem::temp_directory_path() / "cqsp_gamedata_test.cache").string();
+        for (int i = 0; i < 100; i++) {
+            universe.emplace<components::Identifier>(universe.create(), "good_" + std::to_string(i));
+        }
+        universe.economy_config.production_config.max_factory_delta = 0.25;
+        Hjson::Value names;
+        names["name"] = "test_names";
+        universe.name_generators["test_names"].LoadNameGenerator(names);
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    std::string path;
+    Universe universe;
+};
+}  // namespace
+
+TEST_F(GameDataCacheTest, RoundTrip) {
+    ASSERT_TRUE(save::SaveGameDataCache(universe, 1234, path));
+
+    Universe loaded("other_universe");
+    loaded.date.SetDate(10);
+    ASSERT_TRUE(save::LoadGameDataCache(loaded, 1234, path));
+    // The universe keeps its own id and date
+    EXPECT_EQ(loaded.uuid, "other_universe");
+    EXPECT_EQ(loaded.date.GetDate(), 10);
+    EXPECT_EQ(loaded.view<components::Identifier>().size(), 100);
+    EXPECT_EQ(loaded.economy_config.production_config.max_factory_delta, 0.25);
+    ASSERT_EQ(loaded.name_generators.count("test_names"), 1);
+    EXPECT_EQ(loaded.name_generators["test_names"].GetName(), "test_names");
+}
+
+TEST_F(GameDataCacheTest, RefusesOtherKeys) {
+    ASSERT_TRUE(save::SaveGameDataCache(universe, 1234, path));
+
+    Universe loaded;
+    EXPECT_FALSE(save::LoadGameDataCache(loaded, 4321, path));
+    EXPECT_EQ(loaded.view<components::Identifier>().size(), 0);
+    EXPECT_FALSE(save::LoadGameDataCache(loaded, 1234, path + ".missing"));
+}
+
+// A cache that breaks part way through is refused, and the loaders that run instead start from a clean universe
+TEST_F(GameDataCacheTest, BrokenCacheFallsBackToTheLoaders) {
+    Hjson::Value goods(Hjson::Type::Vector);
+    for (int i = 0; i < 5; i++) {
+        Hjson::Value good;
+        good["identifier"] = "good_" + std::to_string(i);
+        goods.push_back(good);
+    }
+    Universe cached;
+    cqsp::core::loading::GoodLoader(cached).LoadHjson(goods);
+    ASSERT_EQ(cached.GoodCount(), 5);
+    ASSERT_TRUE(save::SaveGameDataCache(cached, 1234, path));
+
+    // Change the number of goods in the snapshot header, which is only checked after everything has been read
+    std::vector<char> bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const std::string snapshot_magic = "CQSPSNAP";
+    auto snapshot = std::search(bytes.begin(), bytes.end(), snapshot_magic.begin(), snapshot_magic.end());
+    ASSERT_NE(snapshot, bytes.end());
+    snapshot[12]++;
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    Universe loaded;
+    EXPECT_FALSE(save::LoadGameDataCache(loaded, 1234, path));
+    // What LoadGameData does when the cache can't be used
+    cqsp::core::loading::GoodLoader(loaded).LoadHjson(goods);
+    EXPECT_EQ(loaded.GoodCount(), 5);
+    EXPECT_EQ(loaded.goods.size(), 5);
+    EXPECT_EQ(loaded.good_map.size(), 5);
+    EXPECT_EQ(loaded.alive(), 5);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(loaded.good_map[loaded.goods["good_" + std::to_string(i)]], components::ToGoodEntity(i));
+    }
+}
+
+// The key is written to the cache, so it has to come out the same with every compiler
+TEST(GameDataKeyTest, HashIsStable) {
+    EXPECT_EQ(util::HashBytes(""), util::fnv_offset);
+    EXPECT_EQ(util::HashBytes("a"), 0xaf63dc4c8601ec8c);
+    EXPECT_EQ(util::HashBytes("bar", util::HashBytes("foo")), util::HashBytes("foobar"));
+}
@@ -0,0 +1,92 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/scratcharena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+#include "core/components/resourceledger.h"
+
+using cqsp::core::components::ResourceLedger;
+using cqsp::core::components::SparseLedger;
+using cqsp::core::components::ToGoodEntity;
+using cqsp::core::util::ScratchArena;
+
+TEST(Core_ScratchArena, TracksUsedAndPeak) {
+    ScratchArena arena(1024);
+    void* first = arena.allocate(100, 8);
+    void* second = arena.allocate(24, 32);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 32, 0);
+    EXPECT_EQ(arena.BytesUsed(), 124);
+    EXPECT_EQ(arena.PeakBytes(), 124);
+
+    arena.Reset();
+    EXPECT_EQ(arena.BytesUsed(), 0);
+    EXPECT_EQ(arena.PeakBytes(), 124);
+    // Memory is handed out again from the start
+    EXPECT_EQ(arena.allocate(100, 8), first);
+}
+
+TEST(Core_ScratchArena, GrowsAndMergesBlocks) {
+    ScratchArena arena(256);
+    for (int i = 0; i < 10; i++) {
+        static_cast<void>(arena.allocate(200, 8));
+    }
+    EXPECT_EQ(arena.BytesUsed(), 2000);
+    EXPECT_GT(arena.BytesReserved(), 2000);
+    const size_t reserved = arena.BytesReserved();
+
+    // The next tick fits in one block, and doesn't need any more memory
+    arena.Reset();
+    EXPECT_EQ(arena.BytesReserved(), reserved);
+    for (int i = 0; i < 10; i++) {
+        static_cast<void>(arena.allocate(200, 8));
+    }
+    EXPECT_EQ(arena.BytesReserved(), reserved);
+}
+
+TEST(Core_ScratchArena, Containers) {
+    ScratchArena arena;
+    std::pmr::map<int, int> map(&arena);
+    for (int i = 0; i < 100; i++) {
+        map[i] = i * 2;
+    }
+    std::pmr::vector<double> vector(1000, 1.0, &arena);
+    EXPECT_GT(arena.BytesUsed(), 1000 * sizeof(double));
+
+    SparseLedger sparse(&arena);
+    sparse[ToGoodEntity(3)] = 4;
+    SparseLedger heap = sparse;
+    EXPECT_DOUBLE_EQ(heap[ToGoodEntity(3)], 4);
+
+    ResourceLedger dense(8, &arena);
+    dense[ToGoodEntity(2)] = 5;
+    ResourceLedger other(8);
+    other[ToGoodEntity(1)] = 1;
+    // Moving between ledgers on different memory copies the values over
+    dense = std::move(other);
+    EXPECT_DOUBLE_EQ(dense[ToGoodEntity(1)], 1);
+    EXPECT_DOUBLE_EQ(dense[ToGoodEntity(2)], 0);
+    other = std::move(dense);
+    EXPECT_DOUBLE_EQ(other[ToGoodEntity(1)], 1);
+    EXPECT_FALSE(dense.IsView());
+}
@@ -0,0 +1,201 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "core/util/save/snapshot.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "core/actions/maneuver/commands.h"
+#include "core/components/maneuver.h"
+#include "core/components/market.h"
+#include "core/components/name.h"
+#include "core/components/orbit.h"
+#include "core/components/player.h"
+#include "core/components/resource.h"
+#include "core/universe.h"
+
+namespace components = cqsp::core::components;
+namespace save = cqsp::core::save;
+using cqsp::core::Universe;
+
+namespace {
+// A few goods, a market and a ship with maneuvers, with a hole in the entities
+void MakeUniverse(Universe& universe) {
+    universe.date.SetDate(1234);
+    for (int i = 0; i < 3; i++) {
+        entt::entity good = universe.create();
+        universe.emplace<components::Identifier>(good, "good_" + std::to_string(i));
+        universe.emplace<components::Price>(good, 10.0 + i);
+        universe.goods["good_" + std::to_string(i)] = good;
+        universe.good_map[good] = components::ToGoodEntity(i);
+        universe.good_vector.push_back(good);
+    }
+    universe.emplace<components::Mineral>(universe.good_vector[1]);
+    universe.destroy(universe.create());
+
+    entt::entity market = universe.create();
+    auto& ledgers = universe.emplace<components::Market>(market, universe.GoodCount());
+    ledgers.price[components::ToGoodEntity(2)] = 42;
+    ledgers.connected_markets.push_back(universe.good_vector[0]);
+    universe.emplace<components::ResourceStockpile>(market)[components::ToGoodEntity(1)] = 5;
+    universe.emplace<components::Player>(market);
+    universe.province_colors[market][0xff0000] = universe.good_vector[2];
+
+    entt::entity ship = universe.create();
+    universe.emplace<components::types::Orbit>(ship, 7000, 0.1, 0.2, 0.3, 0.4, 0.5, market);
+    universe.emplace<components::CommandQueue>(ship);
+    universe.ctx().emplace<components::ManeuverSchedule>();
+    cqsp::core::systems::commands::PushManeuvers(
+        universe, ship, {std::make_pair(glm::dvec3(1, 0, 0), 10.0), std::make_pair(glm::dvec3(0, 1, 0), 20.0)});
+}
+}  // namespace
+
+TEST(SnapshotTest, RoundTrip) {
+    Universe universe;
+    MakeUniverse(universe);
+    std::vector<char> buffer;
+    save::WriteSnapshot(universe, buffer);
+
+    Universe loaded;
+    // Anything that was in the universe before is replaced
+    loaded.create();
+    ASSERT_TRUE(save::ReadSnapshot(loaded, buffer.data(), buffer.size()));
+
+    EXPECT_EQ(loaded.GetDate(), 1234);
+    EXPECT_EQ(loaded.uuid, universe.uuid);
+    EXPECT_EQ(loaded.alive(), universe.alive());
+    ASSERT_EQ(loaded.GoodCount(), 3);
+    EXPECT_EQ(loaded.goods, universe.goods);
+    EXPECT_EQ(loaded.good_map, universe.good_map);
+    EXPECT_TRUE(loaded.all_of<components::Mineral>(loaded.good_vector[1]));
+    EXPECT_EQ(loaded.get<components::Identifier>(loaded.good_vector[2]).identifier, "good_2");
+    EXPECT_EQ(loaded.get<components::Price>(loaded.good_vector[2]).price, 12.0);
+
+    entt::entity market = loaded.view<components::Player>().front();
+    ASSERT_TRUE(loaded.valid(market));
+    auto& ledgers = loaded.get<components::Market>(market);
+    EXPECT_EQ(ledgers.price.size(), 3);
+    EXPECT_EQ(ledgers.price[components::ToGoodEntity(2)], 42);
+    EXPECT_EQ(ledgers.connected_markets, universe.get<components::Market>(market).connected_markets);
+    EXPECT_EQ(loaded.get<components::ResourceStockpile>(market)[components::ToGoodEntity(1)], 5);
+    EXPECT_EQ(loaded.colors_province[market][loaded.good_vector[2]], 0xff0000);
+
+    auto ships = loaded.view<components::CommandQueue>();
+    ASSERT_EQ(ships.size(), 1);
+    entt::entity ship = ships.front();
+    auto& orbit = loaded.get<components::types::Orbit>(ship);
+    EXPECT_EQ(orbit.semi_major_axis, 7000);
+    EXPECT_EQ(orbit.reference_body, market);
+    EXPECT_EQ(loaded.get<components::CommandQueue>(ship).maneuvers.size(), 2);
+
+    // The maneuvers are scheduled again
+    std::vector<entt::entity> due;
+    cqsp::core::systems::commands::GetManeuverSchedule(loaded).PopDue(loaded.date() + 15, due);
+    ASSERT_EQ(due.size(), 1);
+    EXPECT_EQ(due[0], ship);
+}
+
+TEST(SnapshotTest, RefusesBrokenSnapshots) {
+    Universe universe;
+    MakeUniverse(universe);
+    std::vector<char> buffer;
+    save::WriteSnapshot(universe, buffer);
+
+    Universe loaded;
+    entt::entity existing = loaded.create();
+    // Cut short
+    EXPECT_FALSE(save::ReadSnapshot(loaded, buffer.data(), buffer.size() / 2));
+    // Another version, which is left alone
+    std::vector<char> other_version = buffer;
+    other_version[8]++;
+    EXPECT_FALSE(save::ReadSnapshot(loaded, other_version.data(), other_version.size()));
+    EXPECT_TRUE(loaded.valid(existing));
+}
+
+// Snapshots that look right from the header, but break part way through, leave the game as it was
+TEST(SnapshotTest, BrokenSnapshotsLeaveTheUniverseAlone) {
+    Universe universe;
+    MakeUniverse(universe);
+    std::vector<char> buffer;
+    save::WriteSnapshot(universe, buffer);
+
+    Universe loaded;
+    MakeUniverse(loaded);
+    loaded.date.SetDate(99);
+    loaded.create();
+    const size_t alive = loaded.alive();
+    const auto goods = loaded.goods;
+
+    // Cut short, but with a size that says so, so that it fails while reading the components
+    std::vector<char> cut(buffer.begin(), buffer.begin() + buffer.size() / 2);
+    const uint64_t cut_size = cut.size();
+    std::memcpy(cut.data() + 16, &cut_size, sizeof(cut_size));
+    EXPECT_FALSE(save::ReadSnapshot(loaded, cut.data(), cut.size()));
+    // Says it has another number of goods, which is only found out at the end
+    std::vector<char> other_goods = buffer;
+    other_goods[12]++;
+    EXPECT_FALSE(save::ReadSnapshot(loaded, other_goods.data(), other_goods.size()));
+
+    EXPECT_EQ(loaded.GetDate(), 99);
+    EXPECT_EQ(loaded.alive(), alive);
+    EXPECT_EQ(loaded.goods, goods);
+    EXPECT_EQ(loaded.GoodCount(), 3);
+    EXPECT_EQ(loaded.good_map.size(), 3);
+    EXPECT_EQ(loaded.province_colors.size(), 1);
+    EXPECT_TRUE(loaded.ctx().contains<components::ManeuverSchedule>());
+
+    // And a good one still replaces it, keeping the context
+    ASSERT_TRUE(save::ReadSnapshot(loaded, buffer.data(), buffer.size()));
+    EXPECT_EQ(loaded.GetDate(), 1234);
+    EXPECT_EQ(loaded.alive(), universe.alive());
+    EXPECT_TRUE(loaded.ctx().contains<components::ManeuverSchedule>());
+}
+
+TEST(SnapshotTest, PartsAreTheSameSnapshot) {
+    Universe universe;
+    MakeUniverse(universe);
+    std::vector<char> buffer;
+    save::WriteSnapshot(universe, buffer);
+
+    cqsp::core::util::ThreadPool pool(4);
+    save::SnapshotParts snapshot;
+    // Twice, so that the second one reuses the parts
+    for (int i = 0; i < 2; i++) {
+        save::WriteSnapshot(universe, snapshot, pool);
+        std::vector<char> joined;
+        for (const auto& part : snapshot.parts) {
+            joined.insert(joined.end(), part.begin(), part.end());
+        }
+        EXPECT_EQ(joined, buffer);
+    }
+}
+
+TEST(SnapshotTest, SavesToFile) {
+    Universe universe;
+    MakeUniverse(universe);
+    const std::string path = (std::filesystem::temp_directory_path() / "cqsp_snapshot_test.snapshot").string();
+    ASSERT_TRUE(save::SaveSnapshot(universe, path));
+
+    Universe loaded;
+    EXPECT_TRUE(save::LoadSnapshot(loaded, path));
+    EXPECT_EQ(loaded.alive(), universe.alive());
+    std::filesystem::remove(path);
+    EXPECT_FALSE(save::LoadSnapshot(loaded, path));
+}
@@ -0,0 +1,97 @@
+/* Conquer Space
+ * Copyright (C) 2021-2025 Conquer Space
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "engine/asset/assetloader.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "engine/asset/textasset.h"
+#include "engine/asset/vfs/nativevfs.h"
+
+namespace {
+// Enough assets that the parallel pass splits them between several workers
+constexpr int FILLER_ASSETS = 64;
+
+void WriteFile(const std::filesystem::path& path, const std::string& text) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path);
+    file << text;
+}
+
+void WriteResources(const std::filesystem::path& directory, const std::string& name) {
+    std::string resources = "{\n";
+    resources += "    greeting: { type: text, path: " + name + ".txt }\n";
+    WriteFile(directory / (name + ".txt"), name);
+    for (int i = 0; i < FILLER_ASSETS; i++) {
+        const std::string key = name + "_" + std::to_string(i);
+        resources += "    " + key + ": { type: text, path: " + key + ".txt }\n";
+        WriteFile(directory / (key + ".txt"), key);
+    }
+    resources += "}\n";
+    WriteFile(directory / "resource.hjson", resources);
+}
+}  // namespace
+
+class AssetLoaderTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        std::filesystem::remove_all(package_root);
+        WriteFile(package_root / "info.hjson",
+                  "{\n    name: assetloadertest\n    version: 0.0.0\n    title: Test\n    author: Test\n}\n");
+        WriteResources(package_root / "first", "first");
+        WriteResources(package_root / "second", "second");
+    }
+
+    void TearDown() override { std::filesystem::remove_all(package_root); }
+
+    std::filesystem::path package_root = std::filesystem::temp_directory_path() / "cqsp_assetloader_test";
+};
+
+TEST_F(AssetLoaderTest, LaterAssetReplacesEarlier) {
+    // The resource files are read in the order that the directory lists them, so the greeting from the last one wins
+    cqsp::asset::NativeFileSystem nfs(package_root.string());
+    nfs.Initialize();
+    auto directory = nfs.OpenDirectory("");
+    std::string last;
+    for (int i = 0; i < directory->GetSize(); i++) {
+        const std::filesystem::path path = directory->GetFile(i)->Path();
+        if (path.filename() == "resource.hjson") {
+            last = path.parent_path().filename().string();
+        }
+    }
+    ASSERT_FALSE(last.empty());
+
+    cqsp::asset::AssetLoader loader;
+    auto package = loader.LoadPackage(package_root.string());
+    ASSERT_NE(package, nullptr);
+    auto* greeting = package->GetAsset<cqsp::asset::TextAsset>("greeting");
+    ASSERT_NE(greeting, nullptr);
+    EXPECT_EQ(greeting->data, last);
+
+    // Everything else is still there
+    for (const std::string name : {"first", "second"}) {
+        for (int i = 0; i < FILLER_ASSETS; i++) {
+            const std::string key = name + "_" + std::to_string(i);
+            auto* asset = package->GetAsset<cqsp::asset::TextAsset>(key);
+            ASSERT_NE(asset, nullptr) << key;
+            EXPECT_EQ(asset->data, key);
+        }
+    }
+}